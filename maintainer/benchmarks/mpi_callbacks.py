@@ -0,0 +1,108 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import os
+import sys
+import numpy as np
+from time import time
+import argparse
+
+parser = argparse.ArgumentParser(description="Benchmark particle updates "
+                                 "issued from the head node. "
+                                 "Save the results to a CSV file.")
+parser.add_argument("--particles_per_core", metavar="N", action="store",
+                    type=int, default=1000, required=False,
+                    help="Number of particles in the simulation box")
+parser.add_argument("--deferred", action="store_true",
+                    help="Batch the updates with System.deferred_updates(), "
+                    "default: false")
+parser.add_argument("--output", metavar="FILEPATH", action="store",
+                    type=str, required=False, default="benchmarks.csv",
+                    help="Output file (default: benchmarks.csv)")
+
+args = parser.parse_args()
+
+# process and check arguments
+n_iterations = 30
+assert args.particles_per_core >= 100, \
+    "{} particles per core are too few".format(args.particles_per_core)
+
+import espressomd
+
+print(espressomd.features())
+
+# System
+#############################################################
+system = espressomd.System(box_l=[1, 1, 1])
+
+n_proc = system.cell_system.get_state()['n_nodes']
+n_part = n_proc * args.particles_per_core
+system.box_l = 3 * ((n_part / 0.1)**(1. / 3.),)
+system.time_step = 0.01
+system.cell_system.skin = 0.4
+
+# Particle setup
+#############################################################
+system.part.add(pos=np.random.random((n_part, 3)) * system.box_l)
+partcls = [system.part[i] for i in range(n_part)]
+
+
+def update(i):
+    for p in partcls:
+        p.v = [i, 0., 0.]
+        p.type = i % 2
+
+
+# time update loop
+print("Timing {} updates of {} particles".format(n_iterations, n_part))
+main_tick = time()
+all_t = []
+for i in range(n_iterations):
+    tick = time()
+    if args.deferred:
+        with system.deferred_updates():
+            update(i)
+    else:
+        update(i)
+    tock = time()
+    t = (tock - tick) / n_part
+    print("iteration {}, time = {:.2e}".format(i, t))
+    all_t.append(t)
+main_tock = time()
+
+# the updates arrived on all ranks
+assert np.all(system.part[:].v[:, 0] == n_iterations - 1)
+
+# average time
+all_t = np.array(all_t)
+avg = np.average(all_t)
+ci = 1.96 * np.std(all_t) / np.sqrt(len(all_t) - 1)
+print("average: {:.3e} +/- {:.3e} (95% C.I.)".format(avg, ci))
+
+# write report
+cmd = " ".join(x for x in sys.argv[1:] if not x.startswith("--output"))
+report = ('"{script}","{arguments}",{cores},{mean:.3e},'
+          '{ci:.3e},{n},{dur:.1f}\n'.format(
+              script=os.path.basename(sys.argv[0]), arguments=cmd,
+              cores=n_proc, dur=main_tock - main_tick, n=n_part,
+              mean=avg, ci=ci))
+if not os.path.isfile(args.output):
+    report = ('"script","arguments","cores","mean","ci",'
+              '"nsteps","duration"\n' + report)
+with open(args.output, "a") as f:
+    f.write(report)
@@ -151,4 +151,15 @@ Utils::Vector3d AtomDecomposition::max_cutoff() const {
   return Utils::Vector3d::broadcast(std::numeric_limits<double>::infinity());
 }
 
-Utils::Vector3d AtomDecomposition::max_range() const { return max_cutoff(); }
\ No newline at end of file
+Utils::Vector3d AtomDecomposition::max_range() const { return max_cutoff(); }
+
+std::vector<int> AtomDecomposition::neighbor_ranks() const {
+  /* every node has ghosts of all other nodes */
+  std::vector<int> ranks;
+  for (int n = 0; n < comm.size(); n++) {
+    if (n != comm.rank()) {
+      ranks.push_back(n);
+    }
+  }
+  return ranks;
+}
\ No newline at end of file
@@ -101,6 +101,8 @@ public:
     return m_box;
   }
 
+  std::vector<int> neighbor_ranks() const override;
+
 private:
   /**
    * @brief Find cell for id.
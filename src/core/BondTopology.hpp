@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_BONDTOPOLOGY_HPP
+#define ESPRESSO_BONDTOPOLOGY_HPP
+
+#include "Particle.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <vector>
+
+/**
+ * @brief Bonds of the local particles with resolved partners.
+ *
+ * The particles taking part in a bond are numbered, and the bonds
+ * are stored as the numbers of their owner and partners, back to back,
+ * in one array per bond id. The positions and forces of the particles
+ * are kept in contiguous arrays, so that the bond kernels do not have
+ * to touch the particles themselves.
+ */
+struct BondTopology {
+  /** Particles taking part in a bond. */
+  std::vector<Particle *> particles;
+  /** Positions of @ref particles. */
+  std::vector<Utils::Vector3d> positions;
+  /** Forces on @ref particles. */
+  std::vector<Utils::Vector3d> forces;
+  /** Owner and partners of the bonds, indexed by bond id. */
+  std::vector<std::vector<int>> bonds;
+
+  /** @brief Copy the positions of the particles and zero the forces. */
+  void gather() {
+    positions.resize(particles.size());
+    forces.assign(particles.size(), Utils::Vector3d{});
+    for (std::size_t i = 0; i < particles.size(); i++) {
+      positions[i] = particles[i]->r.p;
+    }
+  }
+
+  /** @brief Add the forces to the particles. */
+  void scatter() const {
+    for (std::size_t i = 0; i < particles.size(); i++) {
+      particles[i]->f.f += forces[i];
+    }
+  }
+};
+
+#endif
@@ -196,6 +196,10 @@ Utils::Vector3d CellStructure::max_range() const {
   return decomposition().max_range();
 }
 
+std::vector<int> CellStructure::neighbor_ranks() const {
+  return decomposition().neighbor_ranks();
+}
+
 namespace {
 /**
  * @brief Apply a @ref ParticleChange to a particle index.
@@ -227,6 +231,7 @@ void CellStructure::resort_particles(int global_flag) {
   }
 
   m_rebuild_verlet_list = true;
+  m_rebuild_bond_topology = true;
 
 #ifdef ADDITIONAL_CHECKS
   check_particle_index();
@@ -234,6 +239,47 @@ void CellStructure::resort_particles(int global_flag) {
 #endif
 }
 
+void CellStructure::rebuild_bond_topology() {
+  auto &topology = m_bond_topology;
+  topology.particles.clear();
+  for (auto &bonds : topology.bonds) {
+    bonds.clear();
+  }
+  m_bond_topology_resolved = true;
+
+  /* number of each particle in the topology, by particle id */
+  std::vector<int> numbers(m_particle_index.size(), -1);
+  auto const number = [&topology, &numbers](Particle *p) {
+    auto &n = numbers[p->identity()];
+    if (n == -1) {
+      n = static_cast<int>(topology.particles.size());
+      topology.particles.push_back(p);
+    }
+    return n;
+  };
+
+  for (auto &p : local_particles()) {
+    for (const BondView bond : p.bonds()) {
+      if (bond.bond_id() >= static_cast<int>(topology.bonds.size())) {
+        topology.bonds.resize(bond.bond_id() + 1);
+      }
+      auto &bonds = topology.bonds[bond.bond_id()];
+      bonds.push_back(number(&p));
+      for (auto const partner_id : bond.partner_ids()) {
+        auto const partner = get_local_particle(partner_id);
+        if (partner == nullptr) {
+          m_bond_topology_resolved = false;
+          m_rebuild_bond_topology = false;
+          return;
+        }
+        bonds.push_back(number(partner));
+      }
+    }
+  }
+
+  m_rebuild_bond_topology = false;
+}
+
 void CellStructure::set_atom_decomposition(boost::mpi::communicator const &comm,
                                            BoxGeometry const &box) {
   set_particle_decomposition(std::make_unique<AtomDecomposition>(comm, box));
@@ -242,8 +288,9 @@ void CellStructure::set_atom_decomposition(boost::mpi::communicator const &comm,
 
 void CellStructure::set_domain_decomposition(
     boost::mpi::communicator const &comm, double range, BoxGeometry const &box,
-    LocalBox<double> const &local_geo) {
-  set_particle_decomposition(
-      std::make_unique<DomainDecomposition>(comm, range, box, local_geo));
+    LocalBox<double> const &local_geo,
+    DomainDecompositionParameters const &params) {
+  set_particle_decomposition(std::make_unique<DomainDecomposition>(
+      comm, range, box, local_geo, params));
   m_type = CELL_STRUCTURE_DOMDEC;
 }
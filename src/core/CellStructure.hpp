@@ -23,8 +23,10 @@
 #define ESPRESSO_CELLSTRUCTURE_HPP
 
 #include "AtomDecomposition.hpp"
+#include "BondTopology.hpp"
 #include "BoxGeometry.hpp"
 #include "Cell.hpp"
+#include "DomainDecomposition.hpp"
 #include "LocalBox.hpp"
 #include "Particle.hpp"
 #include "ParticleDecomposition.hpp"
@@ -132,6 +134,11 @@ private:
   unsigned m_resort_particles = Cells::RESORT_NONE;
   bool m_rebuild_verlet_list = true;
   std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
+  bool m_rebuild_bond_topology = true;
+  /** Whether all bond partners could be resolved. */
+  bool m_bond_topology_resolved = false;
+  /** Bonds of the local particles, see @ref bond_group_loop. */
+  BondTopology m_bond_topology;
 
 public:
   bool use_verlet_list = true;
@@ -248,6 +255,9 @@ public:
   /** Maximal pair range supported by current cell system. */
   Utils::Vector3d max_range() const;
 
+  /** Ranks that can own ghost particles of this node. */
+  std::vector<int> neighbor_ranks() const;
+
 private:
   Utils::Span<Cell *> local_cells();
 
@@ -483,10 +493,12 @@ public:
    * @param range Interaction range.
    * @param box Box Geometry
    * @param local_geo Geometry of the local box.
+   * @param params Parameters of the decomposition.
    */
   void set_domain_decomposition(boost::mpi::communicator const &comm,
                                 double range, BoxGeometry const &box,
-                                LocalBox<double> const &local_geo);
+                                LocalBox<double> const &local_geo,
+                                DomainDecompositionParameters const &params);
 
 public:
   template <class BondKernel> void bond_loop(BondKernel const &bond_kernel) {
@@ -495,31 +507,97 @@ public:
     }
   }
 
+  /**
+   * @brief Run a force kernel on all bonds of a bond id at a time.
+   *
+   * The bond partners are resolved once after every resort into a
+   * @ref BondTopology. Before the kernel is run, the positions of the
+   * bonded particles are copied into it, and the forces accumulated
+   * in it are added to the particles afterwards. If a partner cannot
+   * be resolved, the bonds are evaluated one by one with
+   * @p bond_kernel, which reports the broken bond as @ref bond_loop
+   * does.
+   *
+   * @tparam GroupKernel Callable with (int, Utils::Span<const int>,
+   *                     BondTopology &): the bond id, the owners and
+   *                     partners of all bonds with that id, and the
+   *                     topology they refer to.
+   * @tparam BondKernel Kernel for @ref bond_loop.
+   * @param group_kernel Kernel for the bond groups.
+   * @param bond_kernel Kernel for single bonds.
+   */
+  template <class GroupKernel, class BondKernel>
+  void bond_group_loop(GroupKernel const &group_kernel,
+                       BondKernel const &bond_kernel) {
+    if (m_rebuild_bond_topology) {
+      rebuild_bond_topology();
+    }
+
+    if (not m_bond_topology_resolved) {
+      bond_loop(bond_kernel);
+      return;
+    }
+
+    m_bond_topology.gather();
+    auto const n_bond_ids = static_cast<int>(m_bond_topology.bonds.size());
+    for (int bond_id = 0; bond_id < n_bond_ids; bond_id++) {
+      auto const &bonds = m_bond_topology.bonds[bond_id];
+      if (not bonds.empty()) {
+        group_kernel(bond_id, Utils::make_const_span(bonds), m_bond_topology);
+      }
+    }
+    m_bond_topology.scatter();
+  }
+
+  /**
+   * @brief Discard the resolved bonds of @ref bond_group_loop.
+   *
+   * Has to be called when bonds are added or removed without a
+   * resort of the particles.
+   */
+  void invalidate_bond_topology() { m_rebuild_bond_topology = true; }
+
 private:
+  /** Resolve the bond partners of the local particles and group the
+   *  bonds by their bond id.
+   */
+  void rebuild_bond_topology();
+
   /**
    * @brief Run link_cell algorithm for local cells.
    *
+   * The pairs of the ghost cells with interacting neighbors
+   * are included, see
+   * @ref ParticleDecomposition::ghost_interaction_cells.
+   *
    * @tparam Kernel Needs to be callable with (Particle, Particle, Distance).
    * @param kernel Pair kernel functor.
    */
   template <class Kernel> void link_cell(Kernel kernel) {
     auto const maybe_box = decomposition().minimum_image_distance();
-    auto const first = boost::make_indirect_iterator(local_cells().begin());
-    auto const last = boost::make_indirect_iterator(local_cells().end());
 
     if (maybe_box) {
-      Algorithm::link_cell(
-          first, last,
-          [&kernel, df = detail::MinimalImageDistance{*maybe_box}](
-              Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
+      link_cell(kernel, detail::MinimalImageDistance{*maybe_box});
     } else {
-      Algorithm::link_cell(
-          first, last,
-          [&kernel, df = detail::EuclidianDistance{}](
-              Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
+      link_cell(kernel, detail::EuclidianDistance{});
     }
   }
 
+  template <class Kernel, class DistanceFunction>
+  void link_cell(Kernel &kernel, DistanceFunction const &df) {
+    auto const pair_kernel = [&kernel, &df](Particle &p1, Particle &p2) {
+      kernel(p1, p2, df(p1, p2));
+    };
+    auto local = local_cells();
+    Algorithm::link_cell(boost::make_indirect_iterator(local.begin()),
+                         boost::make_indirect_iterator(local.end()),
+                         pair_kernel);
+    auto ghosts = decomposition().ghost_interaction_cells();
+    Algorithm::link_cell_neighbors(
+        boost::make_indirect_iterator(ghosts.begin()),
+        boost::make_indirect_iterator(ghosts.end()), pair_kernel);
+  }
+
   /** Non-bonded pair loop with verlet lists.
    *
    * @param pair_kernel Kernel to apply
@@ -585,6 +663,19 @@ public:
     }
   }
 
+  /** Rebuild the verlet list if it is outdated, without applying a kernel.
+   * Used when the pair forces are not evaluated in every time step, such
+   * that the list still refers to the positions of the last resort.
+   * @param verlet_criterion Filter for verlet lists.
+   */
+  template <class VerletCriterion>
+  void update_verlet_list(const VerletCriterion &verlet_criterion) {
+    if (use_verlet_list and m_rebuild_verlet_list) {
+      verlet_list_loop([](Particle &, Particle &, Distance const &) {},
+                       verlet_criterion);
+    }
+  }
+
 private:
   /**
    * @brief Check that particle index is commensurate with particles.
@@ -30,6 +30,7 @@
 #include <utils/mpi/sendrecv.hpp>
 
 #include <boost/mpi/collectives.hpp>
+#include <boost/range/algorithm/min_element.hpp>
 #include <boost/range/algorithm/reverse.hpp>
 #include <boost/range/numeric.hpp>
 
@@ -37,6 +38,7 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdlib>
 #include <functional>
 #include <iterator>
 #include <utility>
@@ -45,27 +47,45 @@
  *  position is in the nodes spatial domain otherwise a nullptr pointer.
  */
 Cell *DomainDecomposition::position_to_cell(const Utils::Vector3d &pos) {
+  /* the local cells start after the lower ghost layers */
+  auto const n = params.cells_per_range;
   Utils::Vector3i cpos;
 
   for (int i = 0; i < 3; i++) {
-    cpos[i] = static_cast<int>(std::floor(pos[i] * inv_cell_size[i])) + 1 -
-              cell_offset[i];
+    if (balanced) {
+      /* local boxes are not aligned to a global cell grid, the owner
+         is determined from the local box boundaries instead. */
+      auto const &left = m_local_box.my_left()[i];
+      auto const &right = m_local_box.my_right()[i];
+      cpos[i] =
+          static_cast<int>(std::floor((pos[i] - left) * inv_cell_size[i])) + n;
+      if (pos[i] < left) {
+        cpos[i] = n - 1;
+      } else if (pos[i] >= right) {
+        cpos[i] = cell_grid[i] + n;
+      } else {
+        cpos[i] = std::min(std::max(cpos[i], n), cell_grid[i] + n - 1);
+      }
+    } else {
+      cpos[i] = static_cast<int>(std::floor(pos[i] * inv_cell_size[i])) + n -
+                cell_offset[i];
+    }
 
     /* particles outside our box. Still take them if
        nonperiodic boundary. We also accept the particle if we are at
        the box boundary, and the particle is within the box. In this case
        the particle belongs here and could otherwise potentially be dismissed
        due to rounding errors. */
-    if (cpos[i] < 1) {
+    if (cpos[i] < n) {
       if ((!m_box.periodic(i) or (pos[i] >= m_box.length()[i])) &&
           m_local_box.boundary()[2 * i])
-        cpos[i] = 1;
+        cpos[i] = n;
       else
         return nullptr;
-    } else if (cpos[i] > cell_grid[i]) {
+    } else if (cpos[i] > cell_grid[i] + n - 1) {
       if ((!m_box.periodic(i) or (pos[i] < m_box.length()[i])) &&
           m_local_box.boundary()[2 * i + 1])
-        cpos[i] = cell_grid[i];
+        cpos[i] = cell_grid[i] + n - 1;
       else
         return nullptr;
     }
@@ -96,6 +116,11 @@ void DomainDecomposition::move_left_or_right(ParticleList &src,
                                              ParticleList &left,
                                              ParticleList &right,
                                              int dir) const {
+  if (balanced) {
+    move_left_or_right_balanced(src, left, right, dir);
+    return;
+  }
+
   for (auto it = src.begin(); it != src.end();) {
     if ((get_mi_coord(it->r.p[dir], m_local_box.my_left()[dir],
                       m_box.length()[dir], m_box.periodic(dir)) < 0.0) and
@@ -115,6 +140,38 @@ void DomainDecomposition::move_left_or_right(ParticleList &src,
   }
 }
 
+void DomainDecomposition::move_left_or_right_balanced(ParticleList &src,
+                                                      ParticleList &left,
+                                                      ParticleList &right,
+                                                      int dir) const {
+  auto const &my_left = m_local_box.my_left()[dir];
+  auto const &my_right = m_local_box.my_right()[dir];
+  auto const center = 0.5 * (my_left + my_right);
+  auto const periodic = m_box.periodic(dir);
+
+  for (auto it = src.begin(); it != src.end();) {
+    auto const pos = it->r.p[dir];
+    if (pos >= my_left and pos < my_right) {
+      ++it;
+      continue;
+    }
+    /* The local box can be wider than half the box, so the direction
+     * is taken from the box center rather than from the boundaries. */
+    auto const to_left =
+        get_mi_coord(pos, center, m_box.length()[dir], periodic) < 0.0;
+    if (to_left and (periodic || (m_local_box.boundary()[2 * dir] == 0))) {
+      left.insert(std::move(*it));
+      it = src.erase(it);
+    } else if (not to_left and
+               (periodic || (m_local_box.boundary()[2 * dir + 1] == 0))) {
+      right.insert(std::move(*it));
+      it = src.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void DomainDecomposition::exchange_neighbors(
     ParticleList &pl, std::vector<ParticleChange> &modified_cells) {
   auto const node_neighbors = Utils::Mpi::cart_neighbors<3>(m_comm);
@@ -236,6 +293,7 @@ void DomainDecomposition::resort(bool global,
 }
 
 void DomainDecomposition::mark_cells() {
+  auto const layers = params.cells_per_range;
   int cnt_c = 0;
 
   m_local_cells.clear();
@@ -244,9 +302,14 @@ void DomainDecomposition::mark_cells() {
   for (int o = 0; o < ghost_cell_grid[2]; o++)
     for (int n = 0; n < ghost_cell_grid[1]; n++)
       for (int m = 0; m < ghost_cell_grid[0]; m++) {
-        if ((m > 0 && m < ghost_cell_grid[0] - 1 && n > 0 &&
-             n < ghost_cell_grid[1] - 1 && o > 0 && o < ghost_cell_grid[2] - 1))
+        auto const lower = (m < layers || n < layers || o < layers);
+        if ((!lower && m < ghost_cell_grid[0] - layers &&
+             n < ghost_cell_grid[1] - layers &&
+             o < ghost_cell_grid[2] - layers))
           m_local_cells.push_back(&cells.at(cnt_c++));
+        else if (lower && params.eighth_shell)
+          /* the lower ghost layers are not used by the eighth shell */
+          cnt_c++;
         else
           m_ghost_cells.push_back(&cells.at(cnt_c++));
       }
@@ -264,41 +327,82 @@ void DomainDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
 }
 Utils::Vector3d DomainDecomposition::max_cutoff() const {
   auto dir_max_range = [this](int i) {
-    return std::min(0.5 * m_box.length()[i], m_local_box.length()[i]);
+    return std::min(0.5 * m_box.length()[i], min_local_length[i]);
   };
 
   return {dir_max_range(0), dir_max_range(1), dir_max_range(2)};
 }
 
-Utils::Vector3d DomainDecomposition::max_range() const { return cell_size; }
+Utils::Vector3d DomainDecomposition::max_range() const {
+  return params.cells_per_range * min_cell_size;
+}
+
+std::vector<int> DomainDecomposition::neighbor_ranks() const {
+  /* The ghost layer is at most one local box wide, so ghosts can only
+   * come from the nodes adjacent in the node grid, including diagonals. */
+  auto const cart_info = Utils::Mpi::cart_get<3>(m_comm);
+  std::vector<int> ranks;
+  Utils::Vector3i offset;
+  for (offset[0] = -1; offset[0] <= 1; offset[0]++)
+    for (offset[1] = -1; offset[1] <= 1; offset[1]++)
+      for (offset[2] = -1; offset[2] <= 1; offset[2]++) {
+        Utils::Vector3i pos;
+        for (int i = 0; i < 3; i++) {
+          pos[i] = (cart_info.coords[i] + offset[i] + cart_info.dims[i]) %
+                   cart_info.dims[i];
+        }
+        auto const rank = Utils::Mpi::cart_rank(m_comm, pos);
+        if (rank != m_comm.rank()) {
+          ranks.push_back(rank);
+        }
+      }
+
+  std::sort(ranks.begin(), ranks.end());
+  ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+  return ranks;
+}
 int DomainDecomposition::calc_processor_min_num_cells() const {
   /* the minimal number of cells can be lower if there are at least two nodes
      serving a direction,
      since this also ensures that the cell size is at most half the box
      length. However, if there is only one processor for a direction, there
-     have to be at least two cells for this direction. */
+     have to be at least two interaction ranges of cells for this
+     direction. */
+  auto const factor = 2 * params.cells_per_range;
   return boost::accumulate(Utils::Mpi::cart_get<3>(m_comm).dims, 1,
-                           [](int n_cells, int grid) {
-                             return (grid == 1) ? 2 * n_cells : n_cells;
+                           [factor](int n_cells, int grid) {
+                             return (grid == 1) ? factor * n_cells : n_cells;
                            });
 }
 
 void DomainDecomposition::create_cell_grid(double range) {
   auto const cart_info = Utils::Mpi::cart_get<3>(m_comm);
 
+  /* The cell grid is designed for the regular local box. */
+  Utils::Vector3d local_box_l;
+  for (int i = 0; i < 3; i++) {
+    local_box_l[i] = m_box.length()[i] / cart_info.dims[i];
+  }
+  balanced = boost::mpi::all_reduce(m_comm, local_box_l != m_local_box.length(),
+                                    std::logical_or<bool>());
+
   int n_local_cells;
   double cell_range[3];
 
+  /* the ghost layers are one interaction range of cells deep */
+  auto const n = params.cells_per_range;
+  auto const min_cell_range = range / n;
+
   /* initialize */
-  cell_range[0] = cell_range[1] = cell_range[2] = range;
+  cell_range[0] = cell_range[1] = cell_range[2] = min_cell_range;
 
   /* Min num cells can not be smaller than calc_processor_min_num_cells. */
   int min_num_cells = calc_processor_min_num_cells();
 
   if (range <= 0.) {
     /* this is the non-interacting case */
-    auto const cells_per_dir =
-        static_cast<int>(std::ceil(std::pow(min_num_cells, 1. / 3.)));
+    auto const cells_per_dir = std::max(
+        static_cast<int>(std::ceil(std::pow(min_num_cells, 1. / 3.))), n);
 
     cell_grid[0] = cells_per_dir;
     cell_grid[1] = cells_per_dir;
@@ -307,25 +411,25 @@ void DomainDecomposition::create_cell_grid(double range) {
     n_local_cells = cell_grid[0] * cell_grid[1] * cell_grid[2];
   } else {
     /* Calculate initial cell grid */
-    double volume = m_local_box.length()[0];
+    double volume = local_box_l[0];
     for (int i = 1; i < 3; i++)
-      volume *= m_local_box.length()[i];
+      volume *= local_box_l[i];
     double scale = pow(DomainDecomposition::max_num_cells / volume, 1. / 3.);
     for (int i = 0; i < 3; i++) {
       /* this is at least 1 */
-      cell_grid[i] = (int)ceil(m_local_box.length()[i] * scale);
-      cell_range[i] = m_local_box.length()[i] / cell_grid[i];
+      cell_grid[i] = (int)ceil(local_box_l[i] * scale);
+      cell_range[i] = local_box_l[i] / cell_grid[i];
 
-      if (cell_range[i] < range) {
+      if (cell_range[i] < min_cell_range) {
         /* ok, too many cells for this direction, set to minimum */
-        cell_grid[i] = (int)floor(m_local_box.length()[i] / range);
-        if (cell_grid[i] < 1) {
+        cell_grid[i] = (int)floor(local_box_l[i] / min_cell_range);
+        if (cell_grid[i] < n) {
           runtimeErrorMsg() << "interaction range " << range << " in direction "
                             << i << " is larger than the local box size "
-                            << m_local_box.length()[i];
-          cell_grid[i] = 1;
+                            << local_box_l[i];
+          cell_grid[i] = n;
         }
-        cell_range[i] = m_local_box.length()[i] / cell_grid[i];
+        cell_range[i] = local_box_l[i] / cell_grid[i];
       }
     }
 
@@ -345,14 +449,14 @@ void DomainDecomposition::create_cell_grid(double range) {
       double min_size = cell_range[0];
 
       for (int i = 1; i < 3; i++) {
-        if (cell_grid[i] > 1 && cell_range[i] < min_size) {
+        if (cell_grid[i] > n && cell_range[i] < min_size) {
           min_ind = i;
           min_size = cell_range[i];
         }
       }
 
       cell_grid[min_ind]--;
-      cell_range[min_ind] = m_local_box.length()[min_ind] / cell_grid[min_ind];
+      cell_range[min_ind] = local_box_l[min_ind] / cell_grid[min_ind];
     }
 
     /* sanity check */
@@ -364,6 +468,30 @@ void DomainDecomposition::create_cell_grid(double range) {
     }
   }
 
+  for (int i = 0; i < 3; i++) {
+    regular_cell_size[i] = local_box_l[i] / cell_grid[i];
+  }
+
+  if (balanced) {
+    /* Split the actual local box into cells at least as large as the
+       ones of the regular grid. The number of cells per direction only
+       depends on the local box length in that direction, which is the
+       same for all nodes of a slab. The cell count never exceeds the one
+       of the regular grid, which bounds the memory. */
+    for (int i = 0; i < 3; i++) {
+      auto const n_cells = static_cast<int>(
+          std::floor(m_local_box.length()[i] / regular_cell_size[i] + 1e-9));
+      if (n_cells < n) {
+        runtimeErrorMsg() << "interaction range " << range
+                          << " in direction " << i
+                          << " is larger than the local box size "
+                          << m_local_box.length()[i];
+      }
+      cell_grid[i] = std::min(std::max(n_cells, n), cell_grid[i]);
+    }
+    n_local_cells = cell_grid[0] * cell_grid[1] * cell_grid[2];
+  }
+
   /* quit program if unsuccessful */
   if (n_local_cells > DomainDecomposition::max_num_cells) {
     runtimeErrorMsg() << "no suitable cell grid found ";
@@ -374,11 +502,23 @@ void DomainDecomposition::create_cell_grid(double range) {
   /* now set all dependent variables */
   int new_cells = 1;
   for (int i = 0; i < 3; i++) {
-    ghost_cell_grid[i] = cell_grid[i] + 2;
+    ghost_cell_grid[i] = cell_grid[i] + 2 * n;
     new_cells *= ghost_cell_grid[i];
     cell_size[i] = m_local_box.length()[i] / (double)cell_grid[i];
     inv_cell_size[i] = 1.0 / cell_size[i];
-    cell_offset[i] = node_pos[i] * cell_grid[i];
+    cell_offset[i] = balanced ? 0 : node_pos[i] * cell_grid[i];
+  }
+
+  if (balanced) {
+    using boost::mpi::all_reduce;
+    using boost::mpi::minimum;
+    all_reduce(m_comm, m_local_box.length().data(), 3,
+               min_local_length.data(), minimum<double>());
+    all_reduce(m_comm, cell_size.data(), 3, min_cell_size.data(),
+               minimum<double>());
+  } else {
+    min_local_length = m_local_box.length();
+    min_cell_size = cell_size;
   }
 
   /* allocate cell array and cell pointer arrays */
@@ -386,36 +526,114 @@ void DomainDecomposition::create_cell_grid(double range) {
   cells.resize(new_cells);
   m_local_cells.resize(n_local_cells);
   m_ghost_cells.resize(new_cells - n_local_cells);
+  m_ghost_interaction_cells.clear();
+}
+
+std::vector<Utils::Vector3i> DomainDecomposition::cell_stencil() const {
+  auto const n = params.cells_per_range;
+  /* all pairs closer than the range are found in the stencil */
+  auto const range = *boost::min_element(max_range());
+
+  std::vector<Utils::Vector3i> stencil;
+  Utils::Vector3i d;
+  for (d[2] = -n; d[2] <= n; d[2]++)
+    for (d[1] = -n; d[1] <= n; d[1]++)
+      for (d[0] = -n; d[0] <= n; d[0]++) {
+        /* smallest distance between two points of the cells */
+        double dist2 = 0.;
+        for (int i = 0; i < 3; i++) {
+          auto const gap = std::max(std::abs(d[i]) - 1, 0) * min_cell_size[i];
+          dist2 += gap * gap;
+        }
+        if (dist2 < range * range) {
+          stencil.push_back(d);
+        }
+      }
+
+  return stencil;
 }
 
 void DomainDecomposition::init_cell_interactions() {
-  /* loop all local cells */
-  for (int o = 1; o < cell_grid[2] + 1; o++)
-    for (int n = 1; n < cell_grid[1] + 1; n++)
-      for (int m = 1; m < cell_grid[0] + 1; m++) {
-
-        auto const ind1 = get_linear_index(m, n, o, ghost_cell_grid);
-
-        std::vector<Cell *> red_neighbors;
-        std::vector<Cell *> black_neighbors;
-
-        /* loop all neighbor cells */
-        int lower_index[3] = {m - 1, n - 1, o - 1};
-        int upper_index[3] = {m + 1, n + 1, o + 1};
-
-        for (int p = lower_index[2]; p <= upper_index[2]; p++)
-          for (int q = lower_index[1]; q <= upper_index[1]; q++)
-            for (int r = lower_index[0]; r <= upper_index[0]; r++) {
-              auto const ind2 = get_linear_index(r, q, p, ghost_cell_grid);
-              if (ind2 > ind1) {
-                red_neighbors.push_back(&cells.at(ind2));
-              } else {
-                black_neighbors.push_back(&cells.at(ind2));
-              }
+  auto const layers = params.cells_per_range;
+  auto const stencil = cell_stencil();
+
+  if (not params.eighth_shell) {
+    /* loop all local cells */
+    for (int o = layers; o < cell_grid[2] + layers; o++)
+      for (int n = layers; n < cell_grid[1] + layers; n++)
+        for (int m = layers; m < cell_grid[0] + layers; m++) {
+
+          auto const ind1 = get_linear_index(m, n, o, ghost_cell_grid);
+
+          std::vector<Cell *> red_neighbors;
+          std::vector<Cell *> black_neighbors;
+
+          /* loop all neighbor cells */
+          for (auto const &d : stencil) {
+            auto const ind2 =
+                get_linear_index(m + d[0], n + d[1], o + d[2], ghost_cell_grid);
+            if (ind2 > ind1) {
+              red_neighbors.push_back(&cells.at(ind2));
+            } else {
+              black_neighbors.push_back(&cells.at(ind2));
             }
-        cells.at(ind1).m_neighbors =
-            Neighbors<Cell *>(red_neighbors, black_neighbors);
+          }
+          cells.at(ind1).m_neighbors =
+              Neighbors<Cell *>(red_neighbors, black_neighbors);
+        }
+    return;
+  }
+
+  /* Eighth shell: a pair of cells is computed on this node if both cells
+   * are local or in the upper ghost layers, and the lower corner of the
+   * pair is a local cell. It is assigned to the cell with the lower index,
+   * which can be a ghost cell. */
+  std::vector<std::vector<Cell *>> red_neighbors(cells.size());
+  std::vector<std::vector<Cell *>> black_neighbors(cells.size());
+  auto const in_region = [this, layers](Utils::Vector3i const &c) {
+    for (int i = 0; i < 3; i++) {
+      if (c[i] < layers or c[i] >= ghost_cell_grid[i])
+        return false;
+    }
+    return true;
+  };
+  auto const is_local = [this, layers](Utils::Vector3i const &c) {
+    for (int i = 0; i < 3; i++) {
+      if (c[i] >= cell_grid[i] + layers)
+        return false;
+    }
+    return true;
+  };
+
+  m_ghost_interaction_cells.clear();
+  Utils::Vector3i c1;
+  for (c1[2] = layers; c1[2] < ghost_cell_grid[2]; c1[2]++)
+    for (c1[1] = layers; c1[1] < ghost_cell_grid[1]; c1[1]++)
+      for (c1[0] = layers; c1[0] < ghost_cell_grid[0]; c1[0]++) {
+        auto const ind1 = get_linear_index(c1, ghost_cell_grid);
+        for (auto const &d : stencil) {
+          auto const c2 = c1 + d;
+          if (not in_region(c2))
+            continue;
+          auto const ind2 = get_linear_index(c2, ghost_cell_grid);
+          Utils::Vector3i lower;
+          for (int i = 0; i < 3; i++) {
+            lower[i] = std::min(c1[i], c2[i]);
+          }
+          if (ind2 > ind1 and is_local(lower)) {
+            red_neighbors[ind1].push_back(&cells.at(ind2));
+            black_neighbors[ind2].push_back(&cells.at(ind1));
+          }
+        }
+        if (not red_neighbors[ind1].empty() and not is_local(c1)) {
+          m_ghost_interaction_cells.push_back(&cells.at(ind1));
+        }
       }
+
+  for (std::size_t ind = 0; ind < cells.size(); ind++) {
+    cells[ind].m_neighbors =
+        Neighbors<Cell *>(red_neighbors[ind], black_neighbors[ind]);
+  }
 }
 
 namespace {
@@ -474,10 +692,17 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
   auto const comm_info = Utils::Mpi::cart_get<3>(m_comm);
   auto const node_neighbors = Utils::Mpi::cart_neighbors<3>(m_comm);
 
+  /* depth of the ghost layers */
+  auto const layers = params.cells_per_range;
+  /* the eighth shell only fills the upper ghost layers, which are sent
+     to the left */
+  auto const n_lr = params.eighth_shell ? 1 : 2;
+  auto const lower_layers = params.eighth_shell ? 0 : layers;
+
   /* calculate number of communications */
   size_t num = 0;
   for (dir = 0; dir < 3; dir++) {
-    for (lr = 0; lr < 2; lr++) {
+    for (lr = 0; lr < n_lr; lr++) {
       /* No communication for border of non periodic direction */
       if (comm_info.dims[dir] == 1)
         num++;
@@ -489,23 +714,25 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
   /* prepare communicator */
   auto ghost_comm = GhostCommunicator{m_comm, num};
 
-  /* number of cells to communicate in a direction */
-  n_comm_cells[0] = cell_grid[1] * cell_grid[2];
-  n_comm_cells[1] = cell_grid[2] * ghost_cell_grid[0];
-  n_comm_cells[2] = ghost_cell_grid[0] * ghost_cell_grid[1];
-
   cnt = 0;
   /* direction loop: x, y, z */
   for (dir = 0; dir < 3; dir++) {
-    lc[(dir + 1) % 3] = 1 - done[(dir + 1) % 3];
-    lc[(dir + 2) % 3] = 1 - done[(dir + 2) % 3];
-    hc[(dir + 1) % 3] = cell_grid[(dir + 1) % 3] + done[(dir + 1) % 3];
-    hc[(dir + 2) % 3] = cell_grid[(dir + 2) % 3] + done[(dir + 2) % 3];
+    for (auto const j : {(dir + 1) % 3, (dir + 2) % 3}) {
+      lc[j] = layers - lower_layers * done[j];
+      hc[j] = cell_grid[j] + layers - 1 + layers * done[j];
+    }
+    /* number of cells to communicate in this direction */
+    n_comm_cells[dir] = layers;
+    for (auto const j : {(dir + 1) % 3, (dir + 2) % 3}) {
+      n_comm_cells[dir] *= hc[j] - lc[j] + 1;
+    }
     /* lr loop: left right */
-    /* here we could in principle build in a one sided ghost
-       communication, simply by taking the lr loop only over one
-       value */
-    for (lr = 0; lr < 2; lr++) {
+    for (lr = 0; lr < n_lr; lr++) {
+      /* layers sent to the left (lr = 0) or to the right (lr = 1) */
+      auto const send_lc = layers + lr * (cell_grid[dir] - layers);
+      /* and the ghost layers they are received into */
+      auto const recv_lc = (1 - lr) * (cell_grid[dir] + layers);
+
       if (comm_info.dims[dir] == 1) {
         /* just copy cells on a single node */
         ghost_comm.communications[cnt].type = GHOST_LOCL;
@@ -518,13 +745,15 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
             shift(m_box, m_local_box, dir, lr);
 
         /* fill send ghost_comm cells */
-        lc[dir] = hc[dir] = 1 + lr * (cell_grid[dir] - 1);
+        lc[dir] = send_lc;
+        hc[dir] = send_lc + layers - 1;
 
         fill_comm_cell_lists(ghost_comm.communications[cnt].part_lists.data(),
                              lc, hc);
 
         /* fill recv ghost_comm cells */
-        lc[dir] = hc[dir] = 0 + (1 - lr) * (cell_grid[dir] + 1);
+        lc[dir] = recv_lc;
+        hc[dir] = recv_lc + layers - 1;
 
         /* place receive cells after send cells */
         fill_comm_cell_lists(
@@ -543,7 +772,8 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
             ghost_comm.communications[cnt].shift =
                 shift(m_box, m_local_box, dir, lr);
 
-            lc[dir] = hc[dir] = 1 + lr * (cell_grid[dir] - 1);
+            lc[dir] = send_lc;
+            hc[dir] = send_lc + layers - 1;
 
             fill_comm_cell_lists(
                 ghost_comm.communications[cnt].part_lists.data(), lc, hc);
@@ -555,7 +785,8 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
                 node_neighbors[2 * dir + (1 - lr)];
             ghost_comm.communications[cnt].part_lists.resize(n_comm_cells[dir]);
 
-            lc[dir] = hc[dir] = (1 - lr) * (cell_grid[dir] + 1);
+            lc[dir] = recv_lc;
+            hc[dir] = recv_lc + layers - 1;
 
             fill_comm_cell_lists(
                 ghost_comm.communications[cnt].part_lists.data(), lc, hc);
@@ -570,11 +801,12 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
   return ghost_comm;
 }
 
-DomainDecomposition::DomainDecomposition(boost::mpi::communicator comm,
-                                         double range,
-                                         const BoxGeometry &box_geo,
-                                         const LocalBox<double> &local_geo)
-    : m_comm(std::move(comm)), m_box(box_geo), m_local_box(local_geo) {
+DomainDecomposition::DomainDecomposition(
+    boost::mpi::communicator comm, double range, const BoxGeometry &box_geo,
+    const LocalBox<double> &local_geo,
+    DomainDecompositionParameters const &params)
+    : params(params), m_comm(std::move(comm)), m_box(box_geo),
+      m_local_box(local_geo) {
   /* set up new domain decomposition cell structure */
   create_cell_grid(range);
 
@@ -591,6 +823,9 @@ DomainDecomposition::DomainDecomposition(boost::mpi::communicator comm,
   /* collect forces has to be done in reverted order! */
   revert_comm_order(m_collect_ghost_force_comm);
 
-  assign_prefetches(m_exchange_ghosts_comm);
-  assign_prefetches(m_collect_ghost_force_comm);
+  /* the rounds of the eighth shell do not come in pairs */
+  if (not params.eighth_shell) {
+    assign_prefetches(m_exchange_ghosts_comm);
+    assign_prefetches(m_collect_ghost_force_comm);
+  }
 }
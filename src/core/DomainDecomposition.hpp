@@ -36,16 +36,40 @@
 #include <utils/Vector.hpp>
 
 #include <boost/optional.hpp>
+#include <boost/serialization/access.hpp>
 
 #include <vector>
 
+/** @brief Parameters of the domain decomposition. */
+struct DomainDecompositionParameters {
+  /** Import ghosts only from the upper neighbors (eighth shell). Pairs of
+   *  ghost particles are then computed on the node that owns the lower
+   *  corner of their cell pair, which halves the ghost volume. Requires
+   *  that no local interaction needs the lower ghosts, i.e. no bonds,
+   *  exclusions, virtual sites or collision detection.
+   */
+  bool eighth_shell = false;
+  /** Number of cells per interaction range. Cells smaller than the range
+   *  fit the interaction sphere more tightly, so fewer pair distances are
+   *  evaluated, at the cost of a larger cell stencil.
+   */
+  int cells_per_range = 1;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &eighth_shell;
+    ar &cells_per_range;
+  }
+};
+
 /** @brief Structure containing the information about the cell grid used for
  * domain decomposition.
  *
  *  The domain of a node is split into a 3D cell grid with dimension
- *  cell_grid. Together with one ghost cell
- *  layer on each side the overall dimension of the ghost cell grid is
- *  ghost_cell_grid. The domain
+ *  cell_grid. Together with @ref DomainDecompositionParameters::cells_per_range
+ *  "cells_per_range" ghost cell layers on each side the overall dimension
+ *  of the ghost cell grid is ghost_cell_grid. The domain
  *  decomposition enables one the use of the linked cell algorithm
  *  which is in turn used for setting up the Verlet list for the
  *  system. You can see a 2D graphical representation of the linked
@@ -64,6 +88,11 @@
  * communication! For single sided ghost communication one would need
  * some ghost-ghost cell interaction as well, which we do not need!
  *
+ * The single sided variant is available as the eighth shell method
+ * (@ref DomainDecompositionParameters::eighth_shell): only the upper
+ * ghost layers are imported, and every pair of cells whose componentwise
+ * lower corner is a local cell is computed on this node, including
+ * pairs of ghost cells. The lower ghost layers stay empty.
  */
 struct DomainDecomposition : public ParticleDecomposition {
   /** Grid dimensions per node. */
@@ -76,6 +105,19 @@ struct DomainDecomposition : public ParticleDecomposition {
   Utils::Vector3i ghost_cell_grid = {};
   /** inverse cell size = \see DomainDecomposition::cell_size ^ -1. */
   Utils::Vector3d inv_cell_size = {};
+  /** Whether the local boxes have unequal sizes, see
+   *  @ref balanced_decomposition.
+   */
+  bool balanced = false;
+  /** Smallest local box length over all nodes. */
+  Utils::Vector3d min_local_length = {};
+  /** Smallest cell size over all nodes. */
+  Utils::Vector3d min_cell_size = {};
+  /** Cell size of the regular local box, the lower bound of
+   *  @ref cell_size for balanced local boxes.
+   */
+  Utils::Vector3d regular_cell_size = {};
+  DomainDecompositionParameters params;
 
   boost::mpi::communicator m_comm;
   BoxGeometry m_box;
@@ -83,13 +125,16 @@ struct DomainDecomposition : public ParticleDecomposition {
   std::vector<Cell> cells;
   std::vector<Cell *> m_local_cells;
   std::vector<Cell *> m_ghost_cells;
+  /** Ghost cells with red neighbors (eighth shell only). */
+  std::vector<Cell *> m_ghost_interaction_cells;
   GhostCommunicator m_exchange_ghosts_comm;
   GhostCommunicator m_collect_ghost_force_comm;
 
 public:
   DomainDecomposition(boost::mpi::communicator comm, double range,
                       const BoxGeometry &box_geo,
-                      const LocalBox<double> &local_geo);
+                      const LocalBox<double> &local_geo,
+                      DomainDecompositionParameters const &params = {});
 
   GhostCommunicator const &exchange_ghosts_comm() const override {
     return m_exchange_ghosts_comm;
@@ -104,6 +149,9 @@ public:
   Utils::Span<Cell *> ghost_cells() override {
     return Utils::make_span(m_ghost_cells);
   }
+  Utils::Span<Cell *> ghost_interaction_cells() override {
+    return Utils::make_span(m_ghost_interaction_cells);
+  }
 
   Cell *particle_to_cell(Particle const &p) override {
     return position_to_cell(p.r.p);
@@ -117,6 +165,8 @@ public:
     return {};
   }
 
+  std::vector<int> neighbor_ranks() const override;
+
 private:
   /** Fill @c m_local_cells list and @c m_ghost_cells list for use with domain
    *  decomposition.
@@ -170,6 +220,12 @@ private:
   void move_left_or_right(ParticleList &src, ParticleList &left,
                           ParticleList &right, int dir) const;
 
+  /** @brief Version of @ref move_left_or_right for balanced local boxes,
+   *  which can be wider than half the box.
+   */
+  void move_left_or_right_balanced(ParticleList &src, ParticleList &left,
+                                   ParticleList &right, int dir) const;
+
   /**
    * @brief One round of particle exchange with the next neighbors.
    *
@@ -183,9 +239,14 @@ private:
    *  @brief Calculate cell grid dimensions, cell sizes and number of cells.
    *
    *  Calculates the cell grid, based on the local box size and the range.
+   *  The cells are at least range / @c params.cells_per_range wide.
    *  If the number of cells is larger than @c max_num_cells,
    *  it increases @c max_range until the number of cells is
-   *  smaller or equal to @c max_num_cells. It sets:
+   *  smaller or equal to @c max_num_cells. For balanced local boxes,
+   *  the grid is calculated for the regular local box and the
+   *  resulting cell size is used to split the actual local box, so that
+   *  nodes sharing a face agree on the cell grid of that face.
+   *  It sets:
    *  @c cell_grid,
    *  @c ghost_cell_grid,
    *  @c cell_size, and
@@ -199,10 +260,14 @@ private:
   /** Init cell interactions for cell system domain decomposition.
    *  Initializes the interacting neighbor cell list of a cell.
    *  This list of interacting neighbor cells is used by the Verlet
-   *  algorithm.
+   *  algorithm. Neighbor cells that are farther apart than the range
+   *  of the decomposition are skipped.
    */
   void init_cell_interactions();
 
+  /** Offsets of the neighbor cells that can hold interacting pairs. */
+  std::vector<Utils::Vector3i> cell_stencil() const;
+
   /** Create communicators for cell structure domain decomposition (see \ref
    *  GhostCommunicator).
    */
@@ -37,6 +37,15 @@
  * value, return only one value (this is achieved using a boost optional
  * that is empty on all but one node), return the value of the head node,
  * or return a reduced value (by specifying the reduction operation).
+ *
+ * Callbacks without return value that do not communicate can be
+ * registered as deferrable. While deferred mode is enabled, calls to
+ * them are queued on the head node instead of being broadcast one by
+ * one. The queue is sent in a single broadcast together with the next
+ * call of a non-deferrable callback (which includes all callbacks with
+ * a return value and the integrator), or by an explicit
+ * @ref MpiCallbacks::flush. The worker nodes run the queued callbacks
+ * in the order in which they were issued.
  */
 
 #include <utils/NumeratedContainer.hpp>
@@ -47,15 +56,22 @@
 #include <boost/mpi/collectives/all_reduce.hpp>
 #include <boost/mpi/collectives/broadcast.hpp>
 #include <boost/mpi/communicator.hpp>
+#include <boost/mpi/packed_iarchive.hpp>
+#include <boost/mpi/packed_oarchive.hpp>
 #include <boost/optional.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
+#include <boost/serialization/vector.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <initializer_list>
 #include <memory>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace Communication {
 
@@ -407,10 +423,14 @@ public:
   MpiCallbacks &operator=(MpiCallbacks const &) = delete;
 
 private:
+  struct StaticCallback {
+    void (*fp)();
+    std::unique_ptr<detail::callback_concept_t> model;
+    bool deferrable;
+  };
+
   static auto &static_callbacks() {
-    static std::vector<
-        std::pair<void (*)(), std::unique_ptr<detail::callback_concept_t>>>
-        m_callbacks;
+    static std::vector<StaticCallback> m_callbacks;
 
     return m_callbacks;
   }
@@ -419,11 +439,15 @@ public:
   explicit MpiCallbacks(boost::mpi::communicator comm,
                         bool abort_on_exit = true)
       : m_abort_on_exit(abort_on_exit), m_comm(std::move(comm)) {
-    /* Add a dummy at id 0 for loop abort. */
+    /* Add dummies at id 0 for loop abort and id 1 for batches. */
+    m_callback_map.add(nullptr);
     m_callback_map.add(nullptr);
 
-    for (auto &kv : static_callbacks()) {
-      m_func_ptr_to_id[kv.first] = m_callback_map.add(kv.second.get());
+    for (auto &cb : static_callbacks()) {
+      auto const id = m_callback_map.add(cb.model.get());
+      m_func_ptr_to_id[cb.fp] = id;
+      if (cb.deferrable)
+        m_deferrable.insert(id);
     }
   }
 
@@ -462,11 +486,16 @@ public:
    * function that must be run on all nodes.
    *
    * @param fp Pointer to the static callback function to add.
+   * @param deferrable Whether calls may be queued in deferred mode.
+   *        Only callbacks that do not communicate can be deferred.
    */
-  template <class... Args> void add(void (*fp)(Args...)) {
+  template <class... Args>
+  void add(void (*fp)(Args...), bool deferrable = false) {
     m_callbacks.emplace_back(detail::make_model(fp));
     const int id = m_callback_map.add(m_callbacks.back().get());
     m_func_ptr_to_id[reinterpret_cast<void (*)()>(fp)] = id;
+    if (deferrable)
+      m_deferrable.insert(id);
   }
 
   /**
@@ -476,10 +505,13 @@ public:
    * function that must be run on all nodes.
    *
    * @param fp Pointer to the static callback function to add.
+   * @param deferrable Whether calls may be queued in deferred mode.
+   *        Only callbacks that do not communicate can be deferred.
    */
-  template <class... Args> static void add_static(void (*fp)(Args...)) {
-    static_callbacks().emplace_back(reinterpret_cast<void (*)()>(fp),
-                                    detail::make_model(fp));
+  template <class... Args>
+  static void add_static(void (*fp)(Args...), bool deferrable = false) {
+    static_callbacks().push_back({reinterpret_cast<void (*)()>(fp),
+                                  detail::make_model(fp), deferrable});
   }
 
   /**
@@ -496,9 +528,10 @@ public:
    */
   template <class Tag, class R, class... Args, class... TagArgs>
   static void add_static(Tag tag, R (*fp)(Args...), TagArgs &&... tag_args) {
-    static_callbacks().emplace_back(
-        reinterpret_cast<void (*)()>(fp),
-        detail::make_model(tag, fp, std::forward<TagArgs>(tag_args)...));
+    static_callbacks().push_back(
+        {reinterpret_cast<void (*)()>(fp),
+         detail::make_model(tag, fp, std::forward<TagArgs>(tag_args)...),
+         false});
   }
 
 private:
@@ -542,15 +575,41 @@ private:
       throw std::out_of_range("Callback does not exists.");
     }
 
-    /* Send request to worker nodes */
+    if (m_deferred and m_deferrable.count(id)) {
+      /* Every call gets an archive of its own, so that the
+       * serialization state is the same as for a single call. */
+      m_queue_offsets.push_back(static_cast<int>(m_queue.size()));
+      boost::mpi::packed_oarchive oa(m_comm, m_queue);
+      pack(oa, id, std::forward<Args>(args)...);
+      if (m_queue.size() >= max_queue_size)
+        flush();
+      return;
+    }
+
+    /* Send request to worker nodes, preceded by the queued calls. */
     boost::mpi::packed_oarchive oa(m_comm);
+    pack_queue(oa);
+    pack(oa, id, std::forward<Args>(args)...);
+    boost::mpi::broadcast(m_comm, oa, 0);
+  }
+
+  /** @brief Pack a callback id and its arguments into a buffer. */
+  template <class... Args>
+  static void pack(boost::mpi::packed_oarchive &oa, int id, Args &&... args) {
     oa << id;
 
     /* Pack the arguments into a packed mpi buffer. */
     Utils::for_each([&oa](auto &&e) { oa << e; },
                     std::forward_as_tuple(std::forward<Args>(args)...));
+  }
 
-    boost::mpi::broadcast(m_comm, oa, 0);
+  /** @brief Move the queued calls, if any, into a buffer. */
+  void pack_queue(boost::mpi::packed_oarchive &oa) const {
+    if (not m_queue_offsets.empty()) {
+      oa << static_cast<int>(BATCH) << m_queue_offsets << m_queue;
+      m_queue_offsets.clear();
+      m_queue.clear();
+    }
   }
 
 public:
@@ -707,6 +766,25 @@ public:
       int request;
       ia >> request;
 
+      if (request == BATCH) {
+        /* Run the deferred callbacks, followed by the request
+         * that flushed them, if any. */
+        std::vector<int> offsets;
+        boost::mpi::packed_iarchive::buffer_type queue;
+        ia >> offsets >> queue;
+        for (auto const offset : offsets) {
+          boost::mpi::packed_iarchive call_ia(
+              m_comm, queue, boost::archive::no_header, offset);
+          call_ia >> request;
+          m_callback_map[request]->operator()(m_comm, call_ia);
+        }
+
+        ia >> request;
+        if (request == BATCH) {
+          continue;
+        }
+      }
+
       if (request == LOOP_ABORT) {
         break;
       }
@@ -722,6 +800,41 @@ public:
    */
   void abort_loop() { call(LOOP_ABORT); }
 
+  /**
+   * @brief Enable or disable deferred mode.
+   *
+   * In deferred mode, calls to deferrable callbacks are queued
+   * on the head node until the next call to a non-deferrable
+   * callback or to @ref flush. Disabling the mode flushes the queue.
+   * This method can only be called on the head node.
+   */
+  void set_deferred(bool deferred) {
+    if (not deferred)
+      flush();
+    m_deferred = deferred;
+  }
+
+  /** @brief Whether deferred mode is enabled. */
+  bool deferred() const { return m_deferred; }
+
+  /**
+   * @brief Send the queued calls to the worker nodes.
+   *
+   * This is a no-op if no calls are pending.
+   * This method can only be called on the head node.
+   */
+  void flush() const {
+    if (not m_queue_offsets.empty()) {
+      boost::mpi::packed_oarchive oa(m_comm);
+      pack_queue(oa);
+      oa << static_cast<int>(BATCH);
+      boost::mpi::broadcast(m_comm, oa, 0);
+    }
+  }
+
+  /** @brief Size in bytes of the pending queue. */
+  std::size_t queue_size() const { return m_queue.size(); }
+
   /**
    * @brief The boost mpi communicator used by this instance
    */
@@ -733,6 +846,36 @@ private:
    */
   enum { LOOP_ABORT = 0 };
 
+  /**
+   * @brief Id marking the begin and end of a batch of deferred calls.
+   */
+  enum { BATCH = 1 };
+
+  /**
+   * @brief Queue size in bytes above which deferred calls are flushed.
+   */
+  static constexpr std::size_t max_queue_size = 1u << 22;
+
+  /**
+   * @brief If calls to deferrable callbacks are queued.
+   */
+  bool m_deferred = false;
+
+  /**
+   * Ids of the callbacks that can be deferred.
+   */
+  std::unordered_set<int> m_deferrable;
+
+  /**
+   * Packed buffers of the pending deferred calls.
+   */
+  mutable boost::mpi::packed_oarchive::buffer_type m_queue;
+
+  /**
+   * Start of each pending deferred call in @ref m_queue.
+   */
+  mutable std::vector<int> m_queue_offsets;
+
   /**
    * @brief If @ref abort_loop should be called on destruction
    *        on the head node.
@@ -774,8 +917,9 @@ class RegisterCallback {
 public:
   RegisterCallback() = delete;
 
-  template <class... Args> explicit RegisterCallback(void (*cb)(Args...)) {
-    MpiCallbacks::add_static(cb);
+  template <class... Args>
+  explicit RegisterCallback(void (*cb)(Args...), bool deferrable = false) {
+    MpiCallbacks::add_static(cb, deferrable);
   }
 
   template <class Tag, class R, class... Args, class... TagArgs>
@@ -804,6 +948,21 @@ public:
   static ::Communication::RegisterCallback register_##cb(&(cb));               \
   }
 
+/**
+ * @brief Register a static callback without return value that can be
+ * deferred.
+ *
+ * This registers a function as an mpi callback whose calls may be
+ * queued in deferred mode. The function must not communicate.
+ * The macro should be used at global scope.
+ *
+ * @param cb A function
+ */
+#define REGISTER_CALLBACK_DEFERRABLE(cb)                                       \
+  namespace Communication {                                                    \
+  static ::Communication::RegisterCallback register_##cb(&(cb), true);         \
+  }
+
 /**
  * @brief Register a static callback whose return value is reduced.
  *
@@ -104,6 +104,17 @@ public:
    */
   virtual Utils::Span<Cell *> ghost_cells() = 0;
 
+  /**
+   * @brief Get pointer to ghost cells with interacting neighbors.
+   *
+   * Pairs of particles in these cells and their red neighbors are
+   * computed on this node, like the pairs of the local cells.
+   * The pairs within these cells are not computed.
+   *
+   * @return List of ghost cells with interacting neighbors.
+   */
+  virtual Utils::Span<Cell *> ghost_interaction_cells() { return {}; }
+
   /**
    * @brief Determine which cell a particle id belongs to.
    *
@@ -129,6 +140,16 @@ public:
    */
   virtual boost::optional<BoxGeometry> minimum_image_distance() const = 0;
 
+  /**
+   * @brief Ranks that can own ghost particles of this node.
+   *
+   * The relation is symmetric, so that it can be used for
+   * point-to-point exchanges between neighboring nodes.
+   *
+   * @return Sorted list of ranks, not containing this rank.
+   */
+  virtual std::vector<int> neighbor_ranks() const = 0;
+
   virtual ~ParticleDecomposition() = default;
 };
 
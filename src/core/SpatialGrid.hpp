@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SPATIALGRID_HPP
+#define ESPRESSO_SPATIALGRID_HPP
+
+#include "BoxGeometry.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Auxiliary uniform grid for proximity queries on point sets.
+ *
+ * Points are binned into a regular grid spanning the simulation box,
+ * independently of the cell system. This allows radius, nearest-neighbor
+ * and overlap queries with a search range that exceeds the cell size of
+ * the particle decomposition. Distances are evaluated with the minimum
+ * image convention of @p box.
+ *
+ * @tparam T Payload stored with each point.
+ */
+template <class T> class SpatialGrid {
+public:
+  using value_type = std::pair<Utils::Vector3d, T>;
+
+private:
+  BoxGeometry m_box;
+  Utils::Vector3i m_n_cells;
+  Utils::Vector3d m_cell_length;
+  std::vector<std::vector<value_type>> m_cells;
+  std::size_t m_size = 0;
+
+  int coord_to_index(double x, int dim) const {
+    if (m_box.periodic(dim)) {
+      x = Algorithm::periodic_fold(x, m_box.length()[dim]);
+    }
+    auto const i = static_cast<int>(std::floor(x / m_cell_length[dim]));
+    return std::max(0, std::min(i, m_n_cells[dim] - 1));
+  }
+
+  std::size_t linear_index(Utils::Vector3i const &idx) const {
+    return static_cast<std::size_t>(idx[0]) +
+           static_cast<std::size_t>(m_n_cells[0]) *
+               (static_cast<std::size_t>(idx[1]) +
+                static_cast<std::size_t>(m_n_cells[1]) * idx[2]);
+  }
+
+  std::size_t position_to_cell(Utils::Vector3d const &pos) const {
+    return linear_index({coord_to_index(pos[0], 0), coord_to_index(pos[1], 1),
+                         coord_to_index(pos[2], 2)});
+  }
+
+  /** Cell indices along @p dim to visit for a search range @p radius. */
+  std::vector<int> cell_range(double x, double radius, int dim) const {
+    auto const n = m_n_cells[dim];
+    std::vector<int> range;
+    if (radius >= m_box.length()[dim] or
+        2. * std::ceil(radius / m_cell_length[dim]) + 1. >= n) {
+      range.resize(n);
+      std::iota(range.begin(), range.end(), 0);
+      return range;
+    }
+
+    auto const center = coord_to_index(x, dim);
+    auto const reach = static_cast<int>(std::ceil(radius / m_cell_length[dim]));
+    for (int i = center - reach; i <= center + reach; ++i) {
+      if (m_box.periodic(dim)) {
+        range.push_back((i + n) % n);
+      } else if (i >= 0 and i < n) {
+        range.push_back(i);
+      }
+    }
+    return range;
+  }
+
+public:
+  /**
+   * @param box            Box geometry.
+   * @param min_cell_size  Lower bound for the cell length.
+   * @param max_cells      Upper bound for the total number of cells.
+   */
+  SpatialGrid(BoxGeometry const &box, double min_cell_size,
+              std::size_t max_cells = 1u << 20)
+      : m_box(box) {
+    auto const l = box.length();
+    auto const cell_size =
+        std::max({min_cell_size, std::cbrt(box.volume() / max_cells),
+                  std::numeric_limits<double>::min()});
+    for (int i = 0; i < 3; ++i) {
+      auto const n = std::floor(l[i] / cell_size);
+      m_n_cells[i] = static_cast<int>(std::max(1., std::min(n, 1024.)));
+      m_cell_length[i] = l[i] / m_n_cells[i];
+    }
+    m_cells.resize(static_cast<std::size_t>(m_n_cells[0]) * m_n_cells[1] *
+                   m_n_cells[2]);
+  }
+
+  /** Number of cells in each direction. */
+  Utils::Vector3i const &n_cells() const { return m_n_cells; }
+  /** Number of stored points. */
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  void insert(Utils::Vector3d const &pos, T const &value) {
+    m_cells[position_to_cell(pos)].emplace_back(pos, value);
+    ++m_size;
+  }
+
+  /**
+   * @brief Remove a point.
+   * @return Whether a matching point was found.
+   */
+  bool erase(Utils::Vector3d const &pos, T const &value) {
+    auto &cell = m_cells[position_to_cell(pos)];
+    auto it = std::find_if(cell.begin(), cell.end(), [&](value_type const &e) {
+      return e.first == pos and e.second == value;
+    });
+    if (it == cell.end())
+      return false;
+    *it = std::move(cell.back());
+    cell.pop_back();
+    --m_size;
+    return true;
+  }
+
+  void clear() {
+    for (auto &cell : m_cells)
+      cell.clear();
+    m_size = 0;
+  }
+
+  /**
+   * @brief Call @p kernel for all points within @p radius of @p pos.
+   *
+   * @param pos     Query position.
+   * @param radius  Search radius (inclusive).
+   * @param kernel  Callable with (value, distance vector from @p pos).
+   */
+  template <class Kernel>
+  void for_each_in_radius(Utils::Vector3d const &pos, double radius,
+                          Kernel &&kernel) const {
+    auto const radius2 = radius * radius;
+    auto const rx = cell_range(pos[0], radius, 0);
+    auto const ry = cell_range(pos[1], radius, 1);
+    auto const rz = cell_range(pos[2], radius, 2);
+    for (auto const z : rz)
+      for (auto const y : ry)
+        for (auto const x : rx)
+          for (auto const &e : m_cells[linear_index({x, y, z})]) {
+            auto const d = get_mi_vector(e.first, pos, m_box);
+            if (d.norm2() <= radius2) {
+              kernel(e.second, d);
+            }
+          }
+  }
+
+  /**
+   * @brief Check if any point accepted by @p pred lies closer than
+   * @p radius to @p pos.
+   */
+  template <class Predicate>
+  bool any_closer_than(Utils::Vector3d const &pos, double radius,
+                       Predicate &&pred) const {
+    auto const radius2 = radius * radius;
+    auto const rx = cell_range(pos[0], radius, 0);
+    auto const ry = cell_range(pos[1], radius, 1);
+    auto const rz = cell_range(pos[2], radius, 2);
+    for (auto const z : rz)
+      for (auto const y : ry)
+        for (auto const x : rx)
+          for (auto const &e : m_cells[linear_index({x, y, z})]) {
+            if (get_mi_vector(e.first, pos, m_box).norm2() < radius2 and
+                pred(e.second))
+              return true;
+          }
+    return false;
+  }
+
+  bool any_closer_than(Utils::Vector3d const &pos, double radius) const {
+    return any_closer_than(pos, radius, [](T const &) { return true; });
+  }
+
+  /**
+   * @brief Find the @p k points closest to @p pos that are accepted
+   * by @p pred.
+   *
+   * The search radius is doubled until enough points are found.
+   *
+   * @return Pairs of squared distance and value, sorted by distance.
+   */
+  template <class Predicate>
+  std::vector<std::pair<double, T>>
+  k_nearest(Utils::Vector3d const &pos, std::size_t k, Predicate &&pred) const {
+    std::vector<std::pair<double, T>> candidates;
+    if (k == 0 or m_size == 0)
+      return candidates;
+
+    auto const by_distance = [](std::pair<double, T> const &a,
+                                std::pair<double, T> const &b) {
+      return a.first < b.first;
+    };
+    auto radius = *std::min_element(m_cell_length.begin(), m_cell_length.end());
+    auto const max_radius = m_box.length().norm();
+    while (true) {
+      candidates.clear();
+      for_each_in_radius(pos, radius,
+                         [&](T const &value, Utils::Vector3d const &d) {
+                           if (pred(value))
+                             candidates.emplace_back(d.norm2(), value);
+                         });
+      if (candidates.size() >= k or radius >= max_radius)
+        break;
+      radius *= 2.;
+    }
+
+    auto const n = std::min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + n,
+                      candidates.end(), by_distance);
+    candidates.resize(n);
+    return candidates;
+  }
+};
+
+#endif
@@ -60,6 +60,16 @@ int auto_update_next_update() {
                            });
 }
 
+unsigned auto_update_next_fused_observables() {
+  auto const next_update = auto_update_next_update();
+  return boost::accumulate(
+      auto_update_accumulators, 0u,
+      [next_update](unsigned a, AutoUpdateAccumulator const &acc) {
+        return (acc.counter == next_update) ? (a | acc.acc->fused_observables())
+                                            : a;
+      });
+}
+
 void auto_update_add(AccumulatorBase *acc) {
   assert(acc);
   auto_update_accumulators.emplace_back(acc);
@@ -31,6 +31,11 @@ namespace Accumulators {
  */
 void auto_update(int steps);
 int auto_update_next_update();
+/**
+ * @brief Observables the accumulators due at the next update
+ * need, a combination of @ref FusedObservable.
+ */
+unsigned auto_update_next_fused_observables();
 void auto_update_add(AccumulatorBase *);
 void auto_update_remove(AccumulatorBase *);
 
@@ -19,6 +19,8 @@
 #ifndef CORE_ACCUMULATORS_ACCUMULATORBASE
 #define CORE_ACCUMULATORS_ACCUMULATORBASE
 
+#include "fused_observables.hpp"
+
 #include <cstddef>
 #include <vector>
 
@@ -33,6 +35,12 @@ public:
   virtual void update() = 0;
   /** Dimensions needed to reshape the flat array returned by the accumulator */
   virtual std::vector<size_t> shape() const = 0;
+  /** Observables the force calculation can accumulate for the update,
+   *  a combination of @ref FusedObservable.
+   */
+  virtual unsigned fused_observables() const {
+    return FUSED_OBSERVABLE_NONE;
+  }
 
 private:
   // Number of timesteps between automatic updates.
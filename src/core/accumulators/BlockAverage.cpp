@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BlockAverage.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Accumulators {
+std::vector<double> BlockAverage::mean() const {
+  return query(StreamQuery::MEAN);
+}
+
+std::vector<double> BlockAverage::std_error() const {
+  return query(StreamQuery::STD_ERROR);
+}
+
+std::vector<double> BlockAverage::block_errors() const {
+  std::size_t n_block_sizes;
+  return query_rows(StreamQuery::BLOCK_ERRORS, n_block_sizes);
+}
+} // namespace Accumulators
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ACCUMULATORS_BLOCK_AVERAGE_HPP
+#define CORE_ACCUMULATORS_BLOCK_AVERAGE_HPP
+
+#include "StreamingAccumulator.hpp"
+#include "observables/Observable.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Accumulators {
+
+/**
+ * @brief Mean of an observable, with the standard error of correlated
+ * samples from block averages.
+ *
+ * The samples are averaged over blocks of 1, 2, 4, ... samples. The
+ * standard error estimated from the block averages grows with the block
+ * size until the blocks are longer than the correlation time of the
+ * samples, and stays constant from there on. See Flyvbjerg and Petersen,
+ * J. Chem. Phys. 91, 461 (1989).
+ */
+class BlockAverage : public StreamingAccumulator {
+public:
+  BlockAverage(std::shared_ptr<Observables::Observable> obs, int delta_N,
+               bool distributed = false)
+      : StreamingAccumulator(std::move(obs), delta_N, make_parameters(),
+                             distributed) {}
+
+  std::vector<double> mean() const;
+  /** Largest standard error estimate from block sizes with at least 32
+   *  blocks.
+   */
+  std::vector<double> std_error() const;
+  /** Standard error estimates for the block sizes 1, 2, 4, ... with at
+   *  least two blocks, with shape (block sizes, n_values).
+   */
+  std::vector<double> block_errors() const;
+  std::vector<size_t> shape() const override { return observable()->shape(); }
+
+private:
+  static StreamParameters make_parameters() {
+    StreamParameters params;
+    params.type = StreamStatisticsType::BLOCKING;
+    return params;
+  }
+};
+
+} // namespace Accumulators
+
+#endif
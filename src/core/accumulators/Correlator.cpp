@@ -18,157 +18,234 @@
  */
 #include "Correlator.hpp"
 
+#include "CorrelatorEngine.hpp"
+#include "ParticleSlices.hpp"
+#include "communication.hpp"
 #include "integrate.hpp"
+#include "observables/PidObservable.hpp"
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
-#include <utils/math/sqr.hpp>
-#include <utils/serialization/multi_array.hpp>
+#include <utils/mpi/gather_buffer.hpp>
 
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <boost/mpi/collectives.hpp>
 #include <boost/range/algorithm/transform.hpp>
+#include <boost/serialization/access.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
 
 #include <algorithm>
-#include <array>
-#include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <functional>
-#include <numeric>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace {
-int min(int i, unsigned int j) { return std::min(i, static_cast<int>(j)); }
+using Accumulators::CompressionFunction;
+using Accumulators::CorrelationOperation;
+using Accumulators::CorrelatorEngine;
+using Accumulators::CorrelatorMethod;
+using Accumulators::ParticleSlices;
+
+/** Everything the nodes need to set up their part of a distributed
+ *  correlator.
+ */
+struct DistributedParameters {
+  /** Kinds of the observables, one if both observables are the same. */
+  std::vector<int> kinds;
+  std::vector<int> ids;
+  CorrelatorMethod method;
+  int tau_lin;
+  int hierarchy_depth;
+  CorrelationOperation operation;
+  CompressionFunction compress_A;
+  CompressionFunction compress_B;
+  Utils::Vector3d args;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &kinds;
+    ar &ids;
+    ar &method;
+    ar &tau_lin;
+    ar &hierarchy_depth;
+    ar &operation;
+    ar &compress_A;
+    ar &compress_B;
+    ar &args;
+  }
+};
+
+/** The part of a distributed correlator on one node, which correlates the
+ *  values of the particle slice of the node.
+ */
+struct LocalCorrelator {
+  ParticleSlices samples;
+  CorrelatorEngine engine;
+  /** Whether the second observable differs from the first one. */
+  bool has_B = false;
+};
+
+std::unordered_map<int, LocalCorrelator> local_correlators;
+/** Identifier of the next distributed correlator, only used on the head
+ *  node.
+ */
+int next_distributed_id = 0;
 } // namespace
 
-namespace Accumulators {
-/** Compress computing arithmetic mean: A_compressed=(A1+A2)/2 */
-std::vector<double> compress_linear(std::vector<double> const &A1,
-                                    std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A1.size());
+static void mpi_correlator_create_local(int id,
+                                        DistributedParameters const &params) {
+  ParticleSlices samples(params.kinds, params.ids);
+  auto const has_B = params.kinds.size() > 1;
+
+  auto const n_local = samples.n_local();
+  auto const dim_A = n_local * samples.values_per_particle(0);
+  auto const dim_B = n_local * samples.values_per_particle(has_B ? 1 : 0);
+  CorrelatorEngine engine(params.method, params.tau_lin,
+                          params.hierarchy_depth, dim_A, dim_B,
+                          params.operation, params.compress_A,
+                          params.compress_B, params.args);
+
+  local_correlators.emplace(
+      id, LocalCorrelator{std::move(samples), std::move(engine), has_B});
+}
 
-  std::transform(A1.begin(), A1.end(), A2.begin(), A_compressed.begin(),
-                 [](double a, double b) -> double { return 0.5 * (a + b); });
+REGISTER_CALLBACK(mpi_correlator_create_local)
 
-  return A_compressed;
+static void mpi_correlator_destroy_local(int id) {
+  local_correlators.erase(id);
 }
 
-/** Compress discarding the 1st argument and return the 2nd */
-std::vector<double> compress_discard1(std::vector<double> const &A1,
-                                      std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A2);
-  return A_compressed;
-}
+REGISTER_CALLBACK(mpi_correlator_destroy_local)
 
-/** Compress discarding the 2nd argument and return the 1st */
-std::vector<double> compress_discard2(std::vector<double> const &A1,
-                                      std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A1);
-  return A_compressed;
+/** Sample the observables on the nodes and correlate the slice of each
+ *  node.
+ *
+ *  @return Number of particles of the observables which don't exist.
+ */
+static int mpi_correlator_update_local(int id) {
+  auto &c = local_correlators.at(id);
+  auto const missing = c.samples.update();
+  if (missing == 0) {
+    c.engine.update(c.samples.values(0), c.samples.values(c.has_B ? 1 : 0));
+  }
+  return missing;
 }
 
-std::vector<double> scalar_product(std::vector<double> const &A,
-                                   std::vector<double> const &B,
-                                   Utils::Vector3d const &) {
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in scalar product: The vector sizes do not match");
-  }
+REGISTER_CALLBACK_MASTER_RANK(mpi_correlator_update_local)
 
-  return std::vector<double>(
-      1, std::inner_product(A.begin(), A.end(), B.begin(), 0.0));
+static void mpi_correlator_finalize_local(int id) {
+  local_correlators.at(id).engine.finalize();
 }
 
-std::vector<double> componentwise_product(std::vector<double> const &A,
-                                          std::vector<double> const &B,
-                                          Utils::Vector3d const &) {
-  std::vector<double> C(A.size());
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in componentwise product: The vector sizes do not match");
-  }
-
-  std::transform(A.begin(), A.end(), B.begin(), C.begin(), std::multiplies<>());
+REGISTER_CALLBACK(mpi_correlator_finalize_local)
 
-  return C;
+static void mpi_correlator_set_args_local(int id, Utils::Vector3d const &args) {
+  local_correlators.at(id).engine.set_args(args);
 }
 
-std::vector<double> tensor_product(std::vector<double> const &A,
-                                   std::vector<double> const &B,
-                                   Utils::Vector3d const &) {
-  std::vector<double> C(A.size() * B.size());
-  auto C_it = C.begin();
+REGISTER_CALLBACK(mpi_correlator_set_args_local)
 
-  for (double a : A) {
-    for (double b : B) {
-      *(C_it++) = a * b;
+/** Correlation sums of all nodes, with shape (lags, dim_corr) on the head
+ *  node.
+ */
+static std::vector<double> mpi_correlator_sums_local(int id,
+                                              CorrelationOperation operation) {
+  auto const &c = local_correlators.at(id);
+  std::vector<double> sums;
+  std::vector<std::size_t> sample_sizes;
+  c.engine.get_sums(sums, sample_sizes);
+
+  if (operation == CorrelationOperation::SCALAR_PRODUCT) {
+    std::vector<double> total(sums.size());
+    boost::mpi::reduce(comm_cart, sums.data(), static_cast<int>(sums.size()),
+                       total.data(), std::plus<double>(), 0);
+    return total;
+  }
+
+  Utils::Mpi::gather_buffer(sums, comm_cart);
+  if (this_node != 0)
+    return {};
+
+  /* the nodes send their columns of all lag times */
+  auto const n_lags = c.engine.n_values();
+  auto const &begin = c.samples.begin();
+  auto const vpp = c.samples.values_per_particle(0);
+  auto const corr_per_particle =
+      CorrelatorEngine::dim_corr(operation, vpp, vpp);
+  auto const n_cols = begin.back() * corr_per_particle;
+  std::vector<double> result(n_lags * n_cols);
+  auto in = sums.begin();
+  for (std::size_t r = 0; r + 1 < begin.size(); r++) {
+    auto const col = begin[r] * corr_per_particle;
+    auto const width = (begin[r + 1] - begin[r]) * corr_per_particle;
+    for (std::size_t lag = 0; lag < n_lags; lag++) {
+      std::copy_n(in, width, result.begin() + lag * n_cols + col);
+      in += width;
     }
   }
-
-  return C;
+  return result;
 }
 
-std::vector<double> square_distance_componentwise(std::vector<double> const &A,
-                                                  std::vector<double> const &B,
-                                                  Utils::Vector3d const &) {
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in square distance componentwise: The vector sizes do not "
-        "match.");
-  }
-
-  std::vector<double> C(A.size());
-
-  std::transform(
-      A.begin(), A.end(), B.begin(), C.begin(),
-      [](double a, double b) -> double { return Utils::sqr(a - b); });
+REGISTER_CALLBACK_MASTER_RANK(mpi_correlator_sums_local)
 
-  return C;
+static std::string engine_state(CorrelatorEngine const &engine) {
+  std::stringstream ss;
+  boost::archive::binary_oarchive oa(ss);
+  oa << engine;
+  return ss.str();
 }
 
-// note: the argument name wsquare denotes that its value is w^2 while the user
-// sets w
-std::vector<double> fcs_acf(std::vector<double> const &A,
-                            std::vector<double> const &B,
-                            Utils::Vector3d const &wsquare) {
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in fcs_acf: The vector sizes do not match.");
-  }
-
-  auto const C_size = A.size() / 3;
-  if (3 * C_size != A.size()) {
-    throw std::runtime_error("Invalid dimensions.");
-  }
-
-  std::vector<double> C(C_size, 0);
-
-  for (size_t i = 0; i < C_size; i++) {
-    for (int j = 0; j < 3; j++) {
-      auto const &a = A[3 * i + j];
-      auto const &b = B[3 * i + j];
+static void set_engine_state(CorrelatorEngine &engine,
+                             std::string const &state) {
+  namespace iostreams = boost::iostreams;
+  iostreams::array_source src(state.data(), state.size());
+  iostreams::stream<iostreams::array_source> ss(src);
+  boost::archive::binary_iarchive ia(ss);
+  ia >> engine;
+}
 
-      C[i] -= Utils::sqr(a - b) / wsquare[j];
-    }
-  }
+static std::vector<std::string> mpi_correlator_get_state_local(int id) {
+  std::vector<std::string> states;
+  boost::mpi::gather(comm_cart, engine_state(local_correlators.at(id).engine),
+                     states, 0);
+  return states;
+}
 
-  std::transform(C.begin(), C.end(), C.begin(),
-                 [](double c) -> double { return std::exp(c); });
+REGISTER_CALLBACK_MASTER_RANK(mpi_correlator_get_state_local)
 
-  return C;
+static void mpi_correlator_set_state_local(int id) {
+  std::string state;
+  boost::mpi::scatter(comm_cart, state, 0);
+  set_engine_state(local_correlators.at(id).engine, state);
 }
 
+REGISTER_CALLBACK(mpi_correlator_set_state_local)
+
+namespace Accumulators {
 void Correlator::initialize() {
   // Class members are assigned via the initializer list
 
+  if (method_name.empty() or method_name == "multi_tau") {
+    method_name = "multi_tau";
+    m_method = CorrelatorMethod::MULTI_TAU;
+  } else if (method_name == "fft") {
+    m_method = CorrelatorMethod::FFT;
+  } else {
+    throw std::runtime_error("no proper correlation method given");
+  }
+
   if (m_tau_lin == 1) { // use the default
     m_tau_lin = static_cast<int>(ceil(m_tau_max / m_dt));
     if (m_tau_lin % 2)
@@ -187,7 +264,13 @@ void Correlator::initialize() {
     throw std::runtime_error("tau_max must be >= delta_t (delta_N too large)");
   }
   // set hierarchy depth which can accommodate at least m_tau_max
-  if ((m_tau_max / m_dt) < m_tau_lin) {
+  if (m_method == CorrelatorMethod::FFT) {
+    if ((m_tau_max / m_dt) > m_tau_lin) {
+      throw std::runtime_error(
+          "tau_max must be <= tau_lin * delta_t for the fft method");
+    }
+    m_hierarchy_depth = 1;
+  } else if ((m_tau_max / m_dt) < m_tau_lin) {
     m_hierarchy_depth = 1;
   } else {
     m_hierarchy_depth = static_cast<int>(
@@ -216,19 +299,16 @@ void Correlator::initialize() {
         "no proper function for correlation operation given");
   }
   if (corr_operation_name == "componentwise_product") {
-    m_dim_corr = dim_A;
     m_shape = A_obs->shape();
-    corr_operation = &componentwise_product;
+    m_operation = CorrelationOperation::COMPONENTWISE_PRODUCT;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else if (corr_operation_name == "tensor_product") {
-    m_dim_corr = dim_A * dim_B;
     m_shape = {dim_A, dim_B};
-    corr_operation = &tensor_product;
+    m_operation = CorrelationOperation::TENSOR_PRODUCT;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else if (corr_operation_name == "square_distance_componentwise") {
-    m_dim_corr = dim_A;
     m_shape = A_obs->shape();
-    corr_operation = &square_distance_componentwise;
+    m_operation = CorrelationOperation::SQUARE_DISTANCE_COMPONENTWISE;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else if (corr_operation_name == "fcs_acf") {
     // note: user provides w=(wx,wy,wz) but we want to use
@@ -241,33 +321,32 @@ void Correlator::initialize() {
         Utils::hadamard_product(m_correlation_args, m_correlation_args);
     if (dim_A % 3)
       throw std::runtime_error("dimA must be divisible by 3 for fcs_acf");
-    m_dim_corr = dim_A / 3;
     m_shape = A_obs->shape();
     if (m_shape.back() != 3)
       throw std::runtime_error(
           "the last dimension of dimA must be 3 for fcs_acf");
     m_shape.pop_back();
-    corr_operation = &fcs_acf;
+    m_operation = CorrelationOperation::FCS_ACF;
   } else if (corr_operation_name == "scalar_product") {
-    m_dim_corr = 1;
     m_shape = {1};
-    corr_operation = &scalar_product;
+    m_operation = CorrelationOperation::SCALAR_PRODUCT;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else {
     throw std::runtime_error(
         "no proper function for correlation operation given");
   }
+  m_dim_corr = CorrelatorEngine::dim_corr(m_operation, dim_A, dim_B);
 
   // Choose the compression function
   if (compressA_name.empty()) { // this is the default
     compressA_name = "discard2";
-    compressA = &compress_discard2;
+    m_compressA = CompressionFunction::DISCARD2;
   } else if (compressA_name == "discard2") {
-    compressA = &compress_discard2;
+    m_compressA = CompressionFunction::DISCARD2;
   } else if (compressA_name == "discard1") {
-    compressA = &compress_discard1;
+    m_compressA = CompressionFunction::DISCARD1;
   } else if (compressA_name == "linear") {
-    compressA = &compress_linear;
+    m_compressA = CompressionFunction::LINEAR;
   } else {
     throw std::runtime_error(
         "no proper function for compression of first observable given");
@@ -275,42 +354,27 @@ void Correlator::initialize() {
 
   if (compressB_name.empty()) {
     compressB_name = compressA_name;
-    compressB = compressA;
+    m_compressB = m_compressA;
   } else if (compressB_name == "discard2") {
-    compressB = &compress_discard2;
+    m_compressB = CompressionFunction::DISCARD2;
   } else if (compressB_name == "discard1") {
-    compressB = &compress_discard1;
+    m_compressB = CompressionFunction::DISCARD1;
   } else if (compressB_name == "linear") {
-    compressB = &compress_linear;
+    m_compressB = CompressionFunction::LINEAR;
   } else {
     throw std::runtime_error(
         "no proper function for compression of second observable given");
   }
 
-  A.resize(std::array<int, 2>{{m_hierarchy_depth, m_tau_lin + 1}});
-  std::fill_n(A.data(), A.num_elements(), std::vector<double>(dim_A, 0));
-  B.resize(std::array<int, 2>{{m_hierarchy_depth, m_tau_lin + 1}});
-  std::fill_n(B.data(), B.num_elements(), std::vector<double>(dim_B, 0));
-
-  n_data = 0;
-  A_accumulated_average = std::vector<double>(dim_A, 0);
-  B_accumulated_average = std::vector<double>(dim_B, 0);
-
-  auto const n_result = n_values();
-  n_sweeps = std::vector<size_t>(n_result, 0);
-  n_vals = std::vector<unsigned int>(m_hierarchy_depth, 0);
-
-  result.resize(std::array<size_t, 2>{{n_result, m_dim_corr}});
-
-  for (size_t i = 0; i < n_result; i++) {
-    for (size_t j = 0; j < m_dim_corr; j++) {
-      // and initialize the values
-      result[i][j] = 0;
-    }
+  if (m_distributed) {
+    initialize_distributed();
+  } else {
+    m_engine = std::make_unique<CorrelatorEngine>(
+        m_method, m_tau_lin, m_hierarchy_depth, dim_A, dim_B, m_operation,
+        m_compressA, m_compressB, m_correlation_args);
   }
 
-  newest = std::vector<size_t>(m_hierarchy_depth, m_tau_lin);
-
+  auto const n_result = n_values();
   tau.resize(n_result);
   for (int i = 0; i < m_tau_lin + 1; i++) {
     tau[i] = i;
@@ -324,99 +388,76 @@ void Correlator::initialize() {
   }
 }
 
-void Correlator::update() {
-  if (finalized) {
+void Correlator::initialize_distributed() {
+  if (m_operation == CorrelationOperation::TENSOR_PRODUCT) {
     throw std::runtime_error(
-        "No data can be added after finalize() was called.");
+        "tensor_product is not supported by a distributed correlator");
   }
-  // We must now go through the hierarchy and make sure there is space for the
-  // new datapoint. For every hierarchy level we have to decide if it is
-  // necessary to move something
-  int highest_level_to_compress = -1;
-
-  t++;
-
-  // Let's find out how far we have to go back in the hierarchy to make space
-  // for the new value
-  int i = 0;
-  while (true) {
-    if (((t - ((m_tau_lin + 1) * ((1 << (i + 1)) - 1) + 1)) % (1 << (i + 1)) ==
-         0)) {
-      if (i < (m_hierarchy_depth - 1) && n_vals[i] > m_tau_lin) {
-        highest_level_to_compress += 1;
-        i++;
-      } else
-        break;
-    } else
-      break;
-  }
-
-  // Now we know we must make space on the levels 0..highest_level_to_compress
-  // Now let's compress the data level by level.
-
-  for (int i = highest_level_to_compress; i >= 0; i--) {
-    // We increase the index indicating the newest on level i+1 by one (plus
-    // folding)
-    newest[i + 1] = (newest[i + 1] + 1) % (m_tau_lin + 1);
-    n_vals[i + 1] += 1;
-    A[i + 1][newest[i + 1]] =
-        (*compressA)(A[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     A[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-    B[i + 1][newest[i + 1]] =
-        (*compressB)(B[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     B[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-  }
-
-  newest[0] = (newest[0] + 1) % (m_tau_lin + 1);
-  n_vals[0]++;
-
-  A[0][newest[0]] = A_obs->operator()();
+
+  DistributedParameters params;
+  params.ids = distributed_particle_ids({A_obs, B_obs});
+  params.kinds = {particle_observable_kind(*A_obs)};
   if (A_obs != B_obs) {
-    B[0][newest[0]] = B_obs->operator()();
-  } else {
-    B[0][newest[0]] = A[0][newest[0]];
-  }
+    params.kinds.push_back(particle_observable_kind(*B_obs));
+  }
+  params.method = m_method;
+  params.tau_lin = m_tau_lin;
+  params.hierarchy_depth = m_hierarchy_depth;
+  params.operation = m_operation;
+  params.compress_A = m_compressA;
+  params.compress_B = m_compressB;
+  params.args = m_correlation_args;
+
+  /* raise errors of the parameters here rather than on the nodes */
+  using Observables::PidObservable;
+  CorrelatorEngine(
+      m_method, m_tau_lin, m_hierarchy_depth,
+      std::dynamic_pointer_cast<PidObservable>(A_obs)->values_per_particle(),
+      std::dynamic_pointer_cast<PidObservable>(B_obs)->values_per_particle(),
+      m_operation, m_compressA, m_compressB, m_correlation_args);
+
+  m_distributed_id = next_distributed_id++;
+  mpi_call_all(mpi_correlator_create_local, m_distributed_id, params);
+}
 
-  // Now we update the cumulated averages and variances of A and B
-  n_data++;
-  for (size_t k = 0; k < dim_A; k++) {
-    A_accumulated_average[k] += A[0][newest[0]][k];
+Correlator::~Correlator() {
+  if (m_distributed_id >= 0) {
+    mpi_call_all(mpi_correlator_destroy_local, m_distributed_id);
   }
+}
 
-  for (size_t k = 0; k < dim_B; k++) {
-    B_accumulated_average[k] += B[0][newest[0]][k];
+void Correlator::set_correlation_args(Utils::Vector3d const &args) {
+  m_correlation_args = args;
+  if (m_distributed) {
+    mpi_call_all(mpi_correlator_set_args_local, m_distributed_id, args);
+  } else {
+    m_engine->set_args(args);
   }
+}
 
-  // Now update the lowest level correlation estimates
-  for (unsigned j = 0; j < min(m_tau_lin + 1, n_vals[0]); j++) {
-    auto const index_new = newest[0];
-    auto const index_old = (newest[0] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-    auto const temp =
-        (corr_operation)(A[0][index_old], B[0][index_new], m_correlation_args);
-    assert(temp.size() == m_dim_corr);
+void Correlator::update() {
+  if (finalized) {
+    throw std::runtime_error(
+        "No data can be added after finalize() was called.");
+  }
 
-    n_sweeps[j]++;
-    for (size_t k = 0; k < m_dim_corr; k++) {
-      result[j][k] += temp[k];
+  if (m_distributed) {
+    auto const missing =
+        mpi_call(Communication::Result::master_rank,
+                 mpi_correlator_update_local, m_distributed_id);
+    if (missing) {
+      throw std::runtime_error("Distributed correlator: " +
+                               std::to_string(missing) +
+                               " particles of the observables don't exist");
     }
+    return;
   }
-  // Now for the higher ones
-  for (int i = 1; i < highest_level_to_compress + 2; i++) {
-    for (unsigned j = (m_tau_lin + 1) / 2 + 1;
-         j < min(m_tau_lin + 1, n_vals[i]); j++) {
-      auto const index_new = newest[i];
-      auto const index_old = (newest[i] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-      auto const index_res =
-          m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
-      auto const temp = (corr_operation)(A[i][index_old], B[i][index_new],
-                                         m_correlation_args);
-      assert(temp.size() == m_dim_corr);
-
-      n_sweeps[index_res]++;
-      for (size_t k = 0; k < m_dim_corr; k++) {
-        result[index_res][k] += temp[k];
-      }
-    }
+
+  auto const A = A_obs->operator()();
+  if (A_obs != B_obs) {
+    m_engine->update(A, B_obs->operator()());
+  } else {
+    m_engine->update(A, A);
   }
 }
 
@@ -424,87 +465,35 @@ int Correlator::finalize() {
   if (finalized) {
     throw std::runtime_error("Correlator::finalize() can only be called once.");
   }
-  // We must now go through the hierarchy and make sure there is space for the
-  // new datapoint. For every hierarchy level we have to decide if it is
-  // necessary to move something
-
   // mark the correlation as finalized
   finalized = true;
 
-  for (int ll = 0; ll < m_hierarchy_depth - 1; ll++) {
-    int vals_ll; // number of values remaining in the lowest level
-    if (n_vals[ll] > m_tau_lin + 1)
-      vals_ll = m_tau_lin + static_cast<int>(n_vals[ll]) % 2;
-    else
-      vals_ll = n_vals[ll];
-
-    while (vals_ll) {
-      // Check, if we will want to push the value from the lowest level
-      int highest_level_to_compress = -1;
-      if (vals_ll % 2) {
-        highest_level_to_compress = ll;
-      }
-
-      int i = ll + 1; // lowest level for which we have to check for compression
-      // Let's find out how far we have to go back in the hierarchy to make
-      // space for the new value
-      while (highest_level_to_compress > -1) {
-        if (n_vals[i] % 2) {
-          if (i < (m_hierarchy_depth - 1) && n_vals[i] > m_tau_lin) {
-            highest_level_to_compress += 1;
-            i++;
-          } else {
-            break;
-          }
-        } else {
-          break;
-        }
-      }
-      vals_ll -= 1;
-
-      // Now we know we must make space on the levels
-      // 0..highest_level_to_compress
-      // Now let's compress the data level by level.
-
-      for (int i = highest_level_to_compress; i >= ll; i--) {
-        // We increase the index indicating the newest on level i+1 by one (plus
-        // folding)
-        newest[i + 1] = (newest[i + 1] + 1) % (m_tau_lin + 1);
-        n_vals[i + 1] += 1;
-
-        (*compressA)(A[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     A[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-        (*compressB)(B[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     B[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-      }
-      newest[ll] = (newest[ll] + 1) % (m_tau_lin + 1);
-
-      // We only need to update correlation estimates for the higher levels
-      for (int i = ll + 1; i < highest_level_to_compress + 2; i++) {
-        for (int j = (m_tau_lin + 1) / 2 + 1; j < min(m_tau_lin + 1, n_vals[i]);
-             j++) {
-          auto const index_new = newest[i];
-          auto const index_old =
-              (newest[i] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-          auto const index_res =
-              m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
-
-          auto const temp = (corr_operation)(A[i][index_old], B[i][index_new],
-                                             m_correlation_args);
-          assert(temp.size() == m_dim_corr);
-
-          n_sweeps[index_res]++;
-          for (size_t k = 0; k < m_dim_corr; k++) {
-            result[index_res][k] += temp[k];
-          }
-        }
-      }
-    }
+  if (m_distributed) {
+    mpi_call_all(mpi_correlator_finalize_local, m_distributed_id);
+  } else {
+    m_engine->finalize();
   }
   return 0;
 }
 
+void Correlator::get_sums(std::vector<double> &sums,
+                          std::vector<std::size_t> &sample_sizes) const {
+  if (m_distributed) {
+    /* all nodes have the same samples */
+    sample_sizes =
+        local_correlators.at(m_distributed_id).engine.sample_sizes();
+    sums = mpi_call(Communication::Result::master_rank,
+                    mpi_correlator_sums_local, m_distributed_id, m_operation);
+  } else {
+    m_engine->get_sums(sums, sample_sizes);
+  }
+}
+
 std::vector<double> Correlator::get_correlation() {
+  std::vector<double> sums;
+  std::vector<std::size_t> n_sweeps;
+  get_sums(sums, n_sweeps);
+
   auto const n_result = n_values();
   std::vector<double> res(n_result * m_dim_corr);
 
@@ -512,13 +501,21 @@ std::vector<double> Correlator::get_correlation() {
     auto const index = m_dim_corr * i;
     for (size_t k = 0; k < m_dim_corr; k++) {
       if (n_sweeps[i]) {
-        res[index + k] = result[i][k] / static_cast<double>(n_sweeps[i]);
+        res[index + k] = sums[index + k] / static_cast<double>(n_sweeps[i]);
       }
     }
   }
   return res;
 }
 
+std::vector<int> Correlator::get_samples_sizes() const {
+  auto const n_sweeps =
+      m_distributed
+          ? local_correlators.at(m_distributed_id).engine.sample_sizes()
+          : m_engine->sample_sizes();
+  return std::vector<int>(n_sweeps.begin(), n_sweeps.end());
+}
+
 std::vector<double> Correlator::get_lag_times() const {
   std::vector<double> res(n_values());
   boost::transform(tau, res.begin(),
@@ -530,17 +527,16 @@ std::string Correlator::get_internal_state() const {
   std::stringstream ss;
   boost::archive::binary_oarchive oa(ss);
 
-  oa << t;
+  oa << finalized;
   oa << m_shape;
-  oa << A;
-  oa << B;
-  oa << result;
-  oa << n_sweeps;
-  oa << n_vals;
-  oa << newest;
-  oa << A_accumulated_average;
-  oa << B_accumulated_average;
-  oa << n_data;
+  if (m_distributed) {
+    auto const states =
+        mpi_call(Communication::Result::master_rank,
+                 mpi_correlator_get_state_local, m_distributed_id);
+    oa << states;
+  } else {
+    oa << *m_engine;
+  }
 
   return ss.str();
 }
@@ -551,17 +547,23 @@ void Correlator::set_internal_state(std::string const &state) {
   iostreams::stream<iostreams::array_source> ss(src);
   boost::archive::binary_iarchive ia(ss);
 
-  ia >> t;
+  ia >> finalized;
   ia >> m_shape;
-  ia >> A;
-  ia >> B;
-  ia >> result;
-  ia >> n_sweeps;
-  ia >> n_vals;
-  ia >> newest;
-  ia >> A_accumulated_average;
-  ia >> B_accumulated_average;
-  ia >> n_data;
+  if (m_distributed) {
+    std::vector<std::string> states;
+    ia >> states;
+    if (states.size() != static_cast<std::size_t>(comm_cart.size())) {
+      throw std::runtime_error("A distributed correlator can only be restored "
+                               "on the same number of MPI ranks");
+    }
+    mpi_call(mpi_correlator_set_state_local, m_distributed_id);
+    std::string local_state;
+    boost::mpi::scatter(comm_cart, states, local_state, 0);
+    set_engine_state(local_correlators.at(m_distributed_id).engine,
+                     local_state);
+  } else {
+    ia >> *m_engine;
+  }
 }
 
 } // namespace Accumulators
@@ -83,6 +83,15 @@
  * The correlation has to be initialized with all necessary information, i.e.
  * all function pointers, the dimensions of A and B and their dimensions, etc.
  *
+ * Instead of the hierarchy, the FFT method keeps all lag times up to
+ * @c tau_lin and correlates the samples blockwise with fast Fourier
+ * transforms, see @ref CorrelatorEngine.
+ *
+ * Per-particle observables can be correlated in a distributed way: the
+ * particles are split into contiguous slices, one per node. On each update,
+ * every node evaluates the observables on its local particles and sends the
+ * values to the nodes owning them, which correlate their slices in place.
+ * Only the results are collected on the head node.
  *
  * TODO: There is a lot of stuff to do:
  * - Expand the file_data_source so that one can specify which
@@ -101,14 +110,12 @@
 #define _STATISTICS_CORRELATION_H
 
 #include "AccumulatorBase.hpp"
+#include "CorrelatorEngine.hpp"
 #include "integrate.hpp"
 #include "observables/Observable.hpp"
 
 #include <utils/Vector.hpp>
 
-#include <boost/multi_array.hpp>
-#include <boost/serialization/access.hpp>
-
 #include <cstddef>
 #include <memory>
 #include <string>
@@ -125,6 +132,9 @@ namespace Accumulators {
  *  <tt>newest[i]</tt> always indicates the latest entry of the hierarchic
  *  "past" For every new entry in is incremented and if @c tau_lin is reached,
  *  it starts again from the beginning.
+ *
+ *  The data itself is stored and correlated by a @ref CorrelatorEngine, on
+ *  the head node or, for distributed correlators, on all nodes.
  */
 class Correlator : public AccumulatorBase {
   using obs_ptr = std::shared_ptr<Observables::Observable>;
@@ -148,23 +158,31 @@ public:
    *      the linear compression method)
    *  @param correlation_args_ optional arguments for the correlation function
    *      (currently only used when @p corr_operation is "fcs_acf")
+   *  @param method_ correlation algorithm, "multi_tau" or "fft"
+   *  @param distributed whether per-particle observables are correlated on
+   *      the nodes which own the particles
    *
    */
   Correlator(int tau_lin, double tau_max, int delta_N, std::string compress1_,
              std::string compress2_, std::string corr_operation, obs_ptr obs1,
-             obs_ptr obs2, Utils::Vector3d correlation_args_ = {})
-      : AccumulatorBase(delta_N), finalized(false), t(0),
-        m_correlation_args(correlation_args_), m_tau_lin(tau_lin),
-        m_dt(delta_N * time_step), m_tau_max(tau_max),
+             obs_ptr obs2, Utils::Vector3d correlation_args_ = {},
+             std::string method_ = "multi_tau", bool distributed = false)
+      : AccumulatorBase(delta_N), m_correlation_args(correlation_args_),
+        m_tau_lin(tau_lin), m_dt(delta_N * time_step), m_tau_max(tau_max),
         compressA_name(std::move(compress1_)),
         compressB_name(std::move(compress2_)),
-        corr_operation_name(std::move(corr_operation)), A_obs(std::move(obs1)),
-        B_obs(std::move(obs2)) {
+        corr_operation_name(std::move(corr_operation)),
+        method_name(std::move(method_)), m_distributed(distributed),
+        A_obs(std::move(obs1)), B_obs(std::move(obs2)) {
     initialize();
   }
+  ~Correlator() override;
+  Correlator(Correlator const &) = delete;
+  Correlator &operator=(Correlator const &) = delete;
 
 private:
   void initialize();
+  void initialize_distributed();
 
 public:
   /** The function to process a new datapoint of A and B
@@ -187,6 +205,8 @@ public:
   /** Return correlation result */
   std::vector<double> get_correlation();
   size_t n_values() const {
+    if (m_method == CorrelatorMethod::FFT)
+      return m_tau_lin + 1;
     return m_tau_lin + 1 + (m_tau_lin + 1) / 2 * (m_hierarchy_depth - 1);
   }
   std::vector<size_t> shape() const override {
@@ -194,9 +214,10 @@ public:
     shape.insert(shape.begin(), n_values());
     return shape;
   }
-  std::vector<int> get_samples_sizes() const {
-    return std::vector<int>(n_sweeps.begin(), n_sweeps.end());
+  unsigned fused_observables() const override {
+    return A_obs->fused_observables() | B_obs->fused_observables();
   }
+  std::vector<int> get_samples_sizes() const;
   std::vector<double> get_lag_times() const;
 
   int tau_lin() const { return m_tau_lin; }
@@ -204,15 +225,15 @@ public:
   double dt() const { return m_dt; }
 
   Utils::Vector3d const &correlation_args() const { return m_correlation_args; }
-  void set_correlation_args(Utils::Vector3d const &args) {
-    m_correlation_args = args;
-  }
+  void set_correlation_args(Utils::Vector3d const &args);
 
   std::string const &compress1() const { return compressA_name; }
   std::string const &compress2() const { return compressB_name; }
   std::string const &correlation_operation() const {
     return corr_operation_name;
   }
+  std::string const &method() const { return method_name; }
+  bool distributed() const { return m_distributed; }
 
   /** Partial serialization of state that is not accessible via the interface.
    */
@@ -220,8 +241,13 @@ public:
   void set_internal_state(std::string const &);
 
 private:
-  bool finalized; ///< whether the correlation is finalized
-  unsigned int t; ///< global time in number of frames
+  /** Correlation sums and sample sizes, gathered from all nodes for
+   *  distributed correlators.
+   */
+  void get_sums(std::vector<double> &sums,
+                std::vector<std::size_t> &sample_sizes) const;
+
+  bool finalized = false; ///< whether the correlation is finalized
 
   Utils::Vector3d m_correlation_args; ///< additional arguments, which the
                                       ///< correlation may need (currently
@@ -237,43 +263,28 @@ private:
   std::string compressA_name;
   std::string compressB_name;
   std::string corr_operation_name; ///< Name of the correlation operator
+  std::string method_name;         ///< Name of the correlation algorithm
+
+  CorrelationOperation m_operation;
+  CompressionFunction m_compressA;
+  CompressionFunction m_compressB;
+  CorrelatorMethod m_method;
+
+  bool m_distributed;
+  /** Identifier of the parts of a distributed correlator on the nodes. */
+  int m_distributed_id = -1;
 
   std::shared_ptr<Observables::Observable> A_obs;
   std::shared_ptr<Observables::Observable> B_obs;
 
   std::vector<int> tau; ///< time differences
-  boost::multi_array<std::vector<double>, 2> A;
-  boost::multi_array<std::vector<double>, 2> B;
-
-  boost::multi_array<double, 2> result; ///< output quantity
-
-  /// number of correlation sweeps at a particular value of tau
-  std::vector<size_t> n_sweeps;
-  /// number of data values already present at a particular value of tau
-  std::vector<unsigned> n_vals;
-  /// index of the newest entry in each hierarchy level
-  std::vector<size_t> newest;
-
-  std::vector<double> A_accumulated_average; ///< all A values are added up here
-  std::vector<double> B_accumulated_average; ///< all B values are added up here
-  size_t n_data; ///< a counter for calculated averages and variances
 
   size_t dim_A;                ///< dimensionality of A
   size_t dim_B;                ///< dimensionality of B
   std::vector<size_t> m_shape; ///< dimensionality of the correlation
 
-  using correlation_operation_type = std::vector<double> (*)(
-      std::vector<double> const &, std::vector<double> const &,
-      Utils::Vector3d const &);
-
-  correlation_operation_type corr_operation;
-
-  using compression_function = std::vector<double> (*)(
-      std::vector<double> const &A1, std::vector<double> const &A2);
-
-  // compressing functions
-  compression_function compressA;
-  compression_function compressB;
+  /** Samples and correlation sums, unused for distributed correlators */
+  std::unique_ptr<CorrelatorEngine> m_engine;
 };
 
 } // namespace Accumulators
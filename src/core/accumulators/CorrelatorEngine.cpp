@@ -0,0 +1,571 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "CorrelatorEngine.hpp"
+
+#include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+#include <utils/constants.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/multi_array.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+int min(int i, unsigned int j) { return std::min(i, static_cast<int>(j)); }
+
+/** Iterative radix-2 FFT of a fixed power-of-two size. */
+class FFTPlan {
+public:
+  using complex = std::complex<double>;
+
+  explicit FFTPlan(std::size_t size)
+      : m_bitrev(size), m_twiddles(size / 2) {
+    assert(size >= 2 and (size & (size - 1)) == 0);
+    std::size_t n_bits = 0;
+    while ((std::size_t{1} << n_bits) < size)
+      n_bits++;
+    for (std::size_t i = 0; i < size; i++) {
+      std::size_t rev = 0;
+      for (std::size_t b = 0; b < n_bits; b++)
+        rev |= ((i >> b) & 1u) << (n_bits - 1 - b);
+      m_bitrev[i] = rev;
+    }
+    for (std::size_t i = 0; i < size / 2; i++) {
+      auto const phi = -2. * Utils::pi() * static_cast<double>(i) /
+                       static_cast<double>(size);
+      m_twiddles[i] = complex(std::cos(phi), std::sin(phi));
+    }
+  }
+
+  std::size_t size() const { return m_bitrev.size(); }
+
+  /** Unnormalized transform with the sign -1 (forward) or +1 (inverse)
+   *  in the exponent.
+   */
+  void transform(std::vector<complex> &data, bool inverse) const {
+    auto const n = size();
+    assert(data.size() == n);
+    for (std::size_t i = 0; i < n; i++) {
+      if (i < m_bitrev[i])
+        std::swap(data[i], data[m_bitrev[i]]);
+    }
+    for (std::size_t len = 2; len <= n; len <<= 1) {
+      auto const half = len / 2;
+      auto const stride = n / len;
+      for (std::size_t i = 0; i < n; i += len) {
+        for (std::size_t j = 0; j < half; j++) {
+          auto const w = inverse ? std::conj(m_twiddles[j * stride])
+                                 : m_twiddles[j * stride];
+          auto const u = data[i + j];
+          auto const v = data[i + j + half] * w;
+          data[i + j] = u + v;
+          data[i + j + half] = u - v;
+        }
+      }
+    }
+  }
+
+private:
+  std::vector<std::size_t> m_bitrev;
+  std::vector<complex> m_twiddles;
+};
+
+void compress(Accumulators::CompressionFunction function, double const *A1,
+              double const *A2, double *out, std::size_t dim) {
+  using Accumulators::CompressionFunction;
+  switch (function) {
+  case CompressionFunction::DISCARD1:
+    std::copy_n(A2, dim, out);
+    break;
+  case CompressionFunction::DISCARD2:
+    std::copy_n(A1, dim, out);
+    break;
+  case CompressionFunction::LINEAR:
+    for (std::size_t k = 0; k < dim; k++)
+      out[k] = 0.5 * (A1[k] + A2[k]);
+    break;
+  }
+}
+} // namespace
+
+namespace Accumulators {
+
+std::size_t CorrelatorEngine::dim_corr(CorrelationOperation operation,
+                                       std::size_t dim_A, std::size_t dim_B) {
+  switch (operation) {
+  case CorrelationOperation::SCALAR_PRODUCT:
+    return 1;
+  case CorrelationOperation::TENSOR_PRODUCT:
+    return dim_A * dim_B;
+  case CorrelationOperation::FCS_ACF:
+    return dim_A / 3;
+  default:
+    return dim_A;
+  }
+}
+
+CorrelatorEngine::CorrelatorEngine(
+    CorrelatorMethod method, int tau_lin, int hierarchy_depth,
+    std::size_t dim_A, std::size_t dim_B, CorrelationOperation operation,
+    CompressionFunction compress_A, CompressionFunction compress_B,
+    Utils::Vector3d const &args)
+    : m_method(method), m_tau_lin(tau_lin), m_hierarchy_depth(hierarchy_depth),
+      m_dim_A(dim_A), m_dim_B(dim_B),
+      m_dim_corr(dim_corr(operation, dim_A, dim_B)), m_operation(operation),
+      m_compress_A(compress_A), m_compress_B(compress_B), m_args(args) {
+  if (operation != CorrelationOperation::TENSOR_PRODUCT and dim_A != dim_B) {
+    throw std::runtime_error(
+        "Error in correlation operation: The vector sizes do not match");
+  }
+  if (operation == CorrelationOperation::FCS_ACF and dim_A % 3) {
+    throw std::runtime_error("dimA must be divisible by 3 for fcs_acf");
+  }
+
+  std::size_t n_levels, n_slots;
+  if (method == CorrelatorMethod::FFT) {
+    if (operation == CorrelationOperation::FCS_ACF) {
+      throw std::runtime_error("fcs_acf is not supported by the fft method");
+    }
+    if (hierarchy_depth != 1) {
+      throw std::runtime_error("The fft method has no hierarchy levels");
+    }
+    /* previous and current block */
+    n_levels = 2;
+    n_slots = static_cast<std::size_t>(tau_lin);
+    m_n_vals = std::vector<unsigned int>(1, 0);
+  } else {
+    n_levels = static_cast<std::size_t>(hierarchy_depth);
+    n_slots = static_cast<std::size_t>(tau_lin + 1);
+    m_n_vals = std::vector<unsigned int>(n_levels, 0);
+    m_newest = std::vector<std::size_t>(n_levels, n_slots - 1);
+  }
+
+  m_A.resize(std::array<std::size_t, 3>{{n_levels, n_slots, dim_A}});
+  std::fill_n(m_A.data(), m_A.num_elements(), 0.);
+  m_B.resize(std::array<std::size_t, 3>{{n_levels, n_slots, dim_B}});
+  std::fill_n(m_B.data(), m_B.num_elements(), 0.);
+
+  m_result.resize(std::array<std::size_t, 2>{{n_values(), m_dim_corr}});
+  std::fill_n(m_result.data(), m_result.num_elements(), 0.);
+  m_n_sweeps = std::vector<std::size_t>(n_values(), 0);
+
+  m_A_accumulated_average = std::vector<double>(dim_A, 0);
+  m_B_accumulated_average = std::vector<double>(dim_B, 0);
+}
+
+std::size_t CorrelatorEngine::n_values() const {
+  if (m_method == CorrelatorMethod::FFT)
+    return static_cast<std::size_t>(m_tau_lin + 1);
+  return static_cast<std::size_t>(m_tau_lin + 1 + (m_tau_lin + 1) / 2 *
+                                                      (m_hierarchy_depth - 1));
+}
+
+void CorrelatorEngine::correlate(CorrelationOperation op, double const *a,
+                                 double const *b, double *out) const {
+  switch (op) {
+  case CorrelationOperation::SCALAR_PRODUCT: {
+    double sum = 0.;
+    for (std::size_t k = 0; k < m_dim_A; k++)
+      sum += a[k] * b[k];
+    out[0] += sum;
+    break;
+  }
+  case CorrelationOperation::COMPONENTWISE_PRODUCT:
+    for (std::size_t k = 0; k < m_dim_A; k++)
+      out[k] += a[k] * b[k];
+    break;
+  case CorrelationOperation::TENSOR_PRODUCT:
+    for (std::size_t i = 0; i < m_dim_A; i++)
+      for (std::size_t j = 0; j < m_dim_B; j++)
+        out[i * m_dim_B + j] += a[i] * b[j];
+    break;
+  case CorrelationOperation::SQUARE_DISTANCE_COMPONENTWISE:
+    for (std::size_t k = 0; k < m_dim_A; k++)
+      out[k] += Utils::sqr(a[k] - b[k]);
+    break;
+  case CorrelationOperation::FCS_ACF:
+    // note: m_args holds w^2 while the user sets w
+    for (std::size_t i = 0; i < m_dim_A / 3; i++) {
+      double c = 0.;
+      for (int j = 0; j < 3; j++)
+        c -= Utils::sqr(a[3 * i + j] - b[3 * i + j]) / m_args[j];
+      out[i] += std::exp(c);
+    }
+    break;
+  }
+}
+
+void CorrelatorEngine::update(Utils::Span<const double> A,
+                              Utils::Span<const double> B) {
+  if (m_finalized) {
+    throw std::runtime_error(
+        "No data can be added after finalize() was called.");
+  }
+  assert(A.size() == m_dim_A);
+  assert(B.size() == m_dim_B);
+
+  for (std::size_t k = 0; k < m_dim_A; k++)
+    m_A_accumulated_average[k] += A[k];
+  for (std::size_t k = 0; k < m_dim_B; k++)
+    m_B_accumulated_average[k] += B[k];
+
+  if (m_method == CorrelatorMethod::FFT) {
+    update_fft(A, B);
+  } else {
+    update_multi_tau(A, B);
+  }
+}
+
+void CorrelatorEngine::update_multi_tau(Utils::Span<const double> A,
+                                        Utils::Span<const double> B) {
+  auto const n_slots = static_cast<std::size_t>(m_tau_lin + 1);
+  // We must now go through the hierarchy and make sure there is space for the
+  // new datapoint. For every hierarchy level we have to decide if it is
+  // necessary to move something
+  int highest_level_to_compress = -1;
+
+  m_t++;
+
+  // Let's find out how far we have to go back in the hierarchy to make space
+  // for the new value
+  int i = 0;
+  while (true) {
+    if (((m_t - ((m_tau_lin + 1) * ((1 << (i + 1)) - 1) + 1)) %
+             (1 << (i + 1)) ==
+         0)) {
+      if (i < (m_hierarchy_depth - 1) && m_n_vals[i] > m_tau_lin) {
+        highest_level_to_compress += 1;
+        i++;
+      } else
+        break;
+    } else
+      break;
+  }
+
+  // Now we know we must make space on the levels 0..highest_level_to_compress
+  // Now let's compress the data level by level.
+  for (int i = highest_level_to_compress; i >= 0; i--) {
+    // We increase the index indicating the newest on level i+1 by one (plus
+    // folding)
+    m_newest[i + 1] = (m_newest[i + 1] + 1) % n_slots;
+    m_n_vals[i + 1] += 1;
+    auto const first = (m_newest[i] + 1) % n_slots;
+    auto const second = (m_newest[i] + 2) % n_slots;
+    compress(m_compress_A, sample(m_A, i, first), sample(m_A, i, second),
+             sample(m_A, i + 1, m_newest[i + 1]), m_dim_A);
+    compress(m_compress_B, sample(m_B, i, first), sample(m_B, i, second),
+             sample(m_B, i + 1, m_newest[i + 1]), m_dim_B);
+  }
+
+  m_newest[0] = (m_newest[0] + 1) % n_slots;
+  m_n_vals[0]++;
+
+  std::copy(A.begin(), A.end(), sample(m_A, 0, m_newest[0]));
+  std::copy(B.begin(), B.end(), sample(m_B, 0, m_newest[0]));
+
+  // Now update the lowest level correlation estimates
+  for (unsigned j = 0; j < min(m_tau_lin + 1, m_n_vals[0]); j++) {
+    auto const index_new = m_newest[0];
+    auto const index_old = (m_newest[0] - j + n_slots) % n_slots;
+    correlate(m_operation, sample(m_A, 0, index_old),
+              sample(m_B, 0, index_new), m_result[j].origin());
+    m_n_sweeps[j]++;
+  }
+  // Now for the higher ones
+  for (int i = 1; i < highest_level_to_compress + 2; i++) {
+    for (unsigned j = (m_tau_lin + 1) / 2 + 1;
+         j < min(m_tau_lin + 1, m_n_vals[i]); j++) {
+      auto const index_new = m_newest[i];
+      auto const index_old = (m_newest[i] - j + n_slots) % n_slots;
+      auto const index_res =
+          m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
+      correlate(m_operation, sample(m_A, i, index_old),
+                sample(m_B, i, index_new), m_result[index_res].origin());
+      m_n_sweeps[index_res]++;
+    }
+  }
+}
+
+void CorrelatorEngine::update_fft(Utils::Span<const double> A,
+                                  Utils::Span<const double> B) {
+  auto const fill = m_n_vals[0];
+  std::copy(A.begin(), A.end(), sample(m_A, 1, fill));
+  std::copy(B.begin(), B.end(), sample(m_B, 1, fill));
+  m_t++;
+  m_n_vals[0]++;
+
+  if (m_n_vals[0] == static_cast<unsigned int>(m_tau_lin)) {
+    correlate_block(m_result, m_n_sweeps);
+    /* the current block becomes the previous one */
+    std::copy_n(sample(m_A, 1, 0), m_A[1].num_elements(), sample(m_A, 0, 0));
+    std::copy_n(sample(m_B, 1, 0), m_B[1].num_elements(), sample(m_B, 0, 0));
+    m_n_vals[0] = 0;
+  }
+}
+
+void CorrelatorEngine::count_block(std::vector<std::size_t> &n_sweeps) const {
+  auto const L = static_cast<std::size_t>(m_tau_lin);
+  auto const m = static_cast<std::size_t>(m_n_vals[0]);
+  /* without a previous block, only pairs within the block exist */
+  auto const prev = m_t > m;
+  for (std::size_t tau = 0; tau <= L; tau++) {
+    n_sweeps[tau] += prev ? m : ((tau < m) ? m - tau : 0);
+  }
+}
+
+void CorrelatorEngine::correlate_block(
+    boost::multi_array<double, 2> &result,
+    std::vector<std::size_t> &n_sweeps) const {
+  using complex = FFTPlan::complex;
+
+  auto const L = static_cast<std::size_t>(m_tau_lin);
+  auto const m = static_cast<std::size_t>(m_n_vals[0]);
+  /* whether there is a previous block to correlate with */
+  auto const prev = m_t > m;
+  if (m == 0)
+    return;
+
+  /* The first series holds the previous and the current block, the second
+   * one the current block. A pair of samples at positions n + s and n of
+   * the two series has the lag L - s. Both series have to fit into the
+   * transform without wrapping around, i.e. n + s < 2 L. */
+  std::size_t n_fft = 2;
+  while (n_fft < 2 * L)
+    n_fft <<= 1;
+  FFTPlan const plan(n_fft);
+
+  count_block(n_sweeps);
+
+  auto const a_valid = [&](std::size_t n) {
+    return (n < L) ? prev : (n - L < m);
+  };
+  auto const a_value = [&](std::size_t n, std::size_t k) {
+    return (n < L) ? m_A[0][n][k] : m_A[1][n - L][k];
+  };
+
+  std::vector<complex> work(n_fft);
+  std::vector<complex> spectrum(n_fft);
+  /* Spectrum of the cross-correlation of component ka of the first series
+   * with component kb of the second series. Both are shifted by the same
+   * constant, which leaves their differences unchanged. */
+  auto const cross_spectrum = [&](std::size_t ka, std::size_t kb,
+                                  double shift) {
+    for (std::size_t n = 0; n < n_fft; n++) {
+      auto const a = (n < 2 * L and a_valid(n)) ? a_value(n, ka) - shift : 0.;
+      auto const b = (n < m) ? m_B[1][n][kb] - shift : 0.;
+      work[n] = complex(a, b);
+    }
+    plan.transform(work, false);
+    /* separate the transforms of the two real series */
+    for (std::size_t k = 0; k < n_fft; k++) {
+      auto const z = work[k];
+      auto const z_conj = std::conj(work[(n_fft - k) % n_fft]);
+      auto const x = 0.5 * (z + z_conj);
+      auto const y = complex(0., -0.5) * (z - z_conj);
+      spectrum[k] = x * std::conj(y);
+    }
+  };
+  /* Inverse transform of the spectrum in place. */
+  auto const inverse = [&](std::vector<complex> &data) {
+    plan.transform(data, true);
+    for (auto &c : data)
+      c /= static_cast<double>(n_fft);
+  };
+
+  switch (m_operation) {
+  case CorrelationOperation::SCALAR_PRODUCT: {
+    std::vector<complex> sum(n_fft, complex{});
+    for (std::size_t k = 0; k < m_dim_A; k++) {
+      cross_spectrum(k, k, 0.);
+      for (std::size_t i = 0; i < n_fft; i++)
+        sum[i] += spectrum[i];
+    }
+    inverse(sum);
+    for (std::size_t s = 0; s <= L; s++)
+      result[L - s][0] += sum[s].real();
+    break;
+  }
+  case CorrelationOperation::COMPONENTWISE_PRODUCT:
+    for (std::size_t k = 0; k < m_dim_A; k++) {
+      cross_spectrum(k, k, 0.);
+      inverse(spectrum);
+      for (std::size_t s = 0; s <= L; s++)
+        result[L - s][k] += spectrum[s].real();
+    }
+    break;
+  case CorrelationOperation::TENSOR_PRODUCT:
+    for (std::size_t i = 0; i < m_dim_A; i++)
+      for (std::size_t j = 0; j < m_dim_B; j++) {
+        cross_spectrum(i, j, 0.);
+        inverse(spectrum);
+        for (std::size_t s = 0; s <= L; s++)
+          result[L - s][i * m_dim_B + j] += spectrum[s].real();
+      }
+    break;
+  case CorrelationOperation::SQUARE_DISTANCE_COMPONENTWISE: {
+    /* sum_n (a[n + s] - b[n])^2 over the valid pairs, expanded into the
+     * sums of squares and the cross-correlation */
+    std::vector<double> sum_a(2 * L + 1);
+    std::vector<double> sum_b(m + 1);
+    for (std::size_t k = 0; k < m_dim_A; k++) {
+      auto const shift = m_B[1][0][k];
+      cross_spectrum(k, k, shift);
+      inverse(spectrum);
+      sum_a[0] = 0.;
+      for (std::size_t n = 0; n < 2 * L; n++) {
+        auto const a = a_valid(n) ? a_value(n, k) - shift : 0.;
+        sum_a[n + 1] = sum_a[n] + a * a;
+      }
+      sum_b[0] = 0.;
+      for (std::size_t n = 0; n < m; n++)
+        sum_b[n + 1] = sum_b[n] + Utils::sqr(m_B[1][n][k] - shift);
+      for (std::size_t s = 0; s <= L; s++) {
+        auto const tau = L - s;
+        /* invalid entries of the first series are zero */
+        auto const squares_a = sum_a[std::min(s + m, 2 * L)] - sum_a[s];
+        auto const squares_b =
+            prev ? sum_b[m] : ((tau < m) ? sum_b[m] - sum_b[tau] : 0.);
+        result[tau][k] +=
+            squares_a + squares_b - 2. * spectrum[s].real();
+      }
+    }
+    break;
+  }
+  case CorrelationOperation::FCS_ACF:
+    assert(false);
+    break;
+  }
+}
+
+void CorrelatorEngine::finalize() {
+  if (m_finalized) {
+    throw std::runtime_error("Correlator::finalize() can only be called once.");
+  }
+  // We must now go through the hierarchy and make sure there is space for the
+  // new datapoint. For every hierarchy level we have to decide if it is
+  // necessary to move something
+
+  // mark the correlation as finalized
+  m_finalized = true;
+
+  if (m_method == CorrelatorMethod::FFT) {
+    correlate_block(m_result, m_n_sweeps);
+    m_n_vals[0] = 0;
+    return;
+  }
+
+  auto const n_slots = static_cast<std::size_t>(m_tau_lin + 1);
+  for (int ll = 0; ll < m_hierarchy_depth - 1; ll++) {
+    int vals_ll; // number of values remaining in the lowest level
+    if (m_n_vals[ll] > m_tau_lin + 1)
+      vals_ll = m_tau_lin + static_cast<int>(m_n_vals[ll]) % 2;
+    else
+      vals_ll = m_n_vals[ll];
+
+    while (vals_ll) {
+      // Check, if we will want to push the value from the lowest level
+      int highest_level_to_compress = -1;
+      if (vals_ll % 2) {
+        highest_level_to_compress = ll;
+      }
+
+      int i = ll + 1; // lowest level for which we have to check for compression
+      // Let's find out how far we have to go back in the hierarchy to make
+      // space for the new value
+      while (highest_level_to_compress > -1) {
+        if (m_n_vals[i] % 2) {
+          if (i < (m_hierarchy_depth - 1) && m_n_vals[i] > m_tau_lin) {
+            highest_level_to_compress += 1;
+            i++;
+          } else {
+            break;
+          }
+        } else {
+          break;
+        }
+      }
+      vals_ll -= 1;
+
+      // Now we know we must make space on the levels
+      // 0..highest_level_to_compress
+      // Now let's compress the data level by level.
+      for (int i = highest_level_to_compress; i >= ll; i--) {
+        // We increase the index indicating the newest on level i+1 by one (plus
+        // folding)
+        m_newest[i + 1] = (m_newest[i + 1] + 1) % n_slots;
+        m_n_vals[i + 1] += 1;
+        auto const first = (m_newest[i] + 1) % n_slots;
+        auto const second = (m_newest[i] + 2) % n_slots;
+        compress(m_compress_A, sample(m_A, i, first), sample(m_A, i, second),
+                 sample(m_A, i + 1, m_newest[i + 1]), m_dim_A);
+        compress(m_compress_B, sample(m_B, i, first), sample(m_B, i, second),
+                 sample(m_B, i + 1, m_newest[i + 1]), m_dim_B);
+      }
+      m_newest[ll] = (m_newest[ll] + 1) % n_slots;
+
+      // We only need to update correlation estimates for the higher levels
+      for (int i = ll + 1; i < highest_level_to_compress + 2; i++) {
+        for (int j = (m_tau_lin + 1) / 2 + 1;
+             j < min(m_tau_lin + 1, m_n_vals[i]); j++) {
+          auto const index_new = m_newest[i];
+          auto const index_old = (m_newest[i] - j + n_slots) % n_slots;
+          auto const index_res =
+              m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
+          correlate(m_operation, sample(m_A, i, index_old),
+                    sample(m_B, i, index_new), m_result[index_res].origin());
+          m_n_sweeps[index_res]++;
+        }
+      }
+    }
+  }
+}
+
+void CorrelatorEngine::get_sums(std::vector<double> &sums,
+                                std::vector<std::size_t> &sample_sizes) const {
+  auto const *result = &m_result;
+  sample_sizes = m_n_sweeps;
+
+  /* samples of an incomplete block are correlated on a copy */
+  boost::multi_array<double, 2> pending;
+  if (m_method == CorrelatorMethod::FFT and m_n_vals[0] != 0) {
+    pending.resize(std::array<std::size_t, 2>{{n_values(), m_dim_corr}});
+    pending = m_result;
+    correlate_block(pending, sample_sizes);
+    result = &pending;
+  }
+
+  sums.assign(result->data(), result->data() + result->num_elements());
+}
+
+std::vector<std::size_t> CorrelatorEngine::sample_sizes() const {
+  auto sample_sizes = m_n_sweeps;
+  if (m_method == CorrelatorMethod::FFT and m_n_vals[0] != 0)
+    count_block(sample_sizes);
+  return sample_sizes;
+}
+
+} // namespace Accumulators
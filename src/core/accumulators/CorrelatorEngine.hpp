@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ACCUMULATORS_CORRELATOR_ENGINE_HPP
+#define CORE_ACCUMULATORS_CORRELATOR_ENGINE_HPP
+/** @file
+ *  Storage and correlation algorithms of @ref Accumulators::Correlator.
+ *
+ *  The engine only sees flat arrays of values, it doesn't know where they
+ *  come from. A distributed correlator runs one engine per node on the
+ *  particles owned by that node.
+ *
+ *  Implementation in CorrelatorEngine.cpp.
+ */
+
+#include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+#include <utils/serialization/multi_array.hpp>
+
+#include <boost/multi_array.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Accumulators {
+
+/** How two samples are correlated, see @ref Correlator. */
+enum class CorrelationOperation : int {
+  SCALAR_PRODUCT,
+  COMPONENTWISE_PRODUCT,
+  TENSOR_PRODUCT,
+  SQUARE_DISTANCE_COMPONENTWISE,
+  FCS_ACF
+};
+
+/** How two samples are combined on the next hierarchy level. */
+enum class CompressionFunction : int { DISCARD1, DISCARD2, LINEAR };
+
+/** Correlation algorithm. */
+enum class CorrelatorMethod : int {
+  /** Blocking over hierarchy levels of doubling time resolution. */
+  MULTI_TAU,
+  /** All lag times up to the window length, correlated blockwise with
+   *  fast Fourier transforms.
+   */
+  FFT
+};
+
+/**
+ * @brief Contiguous storage and correlation of two time series.
+ *
+ * In the multi-tau method, the samples of all hierarchy levels are stored
+ * in two contiguous arrays of shape (depth, tau_lin + 1, dim). The
+ * compression and the correlation operations work in place on the rows of
+ * these arrays and accumulate directly into the result.
+ *
+ * In the FFT method, samples are collected in blocks of @c tau_lin samples.
+ * When a block is full, the correlation of each of its samples with the
+ * samples of the same and the previous block is computed with one complex
+ * FFT per component, which gives all lag times from 0 to @c tau_lin with a
+ * cost of @f$ \mathcal{O}(\log \tau_{lin}) @f$ per sample and component.
+ * The samples of an incomplete block are correlated on demand.
+ */
+class CorrelatorEngine {
+public:
+  CorrelatorEngine() = default;
+  /**
+   * @param method           Correlation algorithm.
+   * @param tau_lin          Number of samples per hierarchy level, or
+   *                         window length of the FFT method.
+   * @param hierarchy_depth  Number of hierarchy levels, 1 for the FFT
+   *                         method.
+   * @param dim_A            Number of values of the first observable.
+   * @param dim_B            Number of values of the second observable.
+   * @param operation        Correlation operation.
+   * @param compress_A       Compression of the first observable.
+   * @param compress_B       Compression of the second observable.
+   * @param args             Arguments of the correlation operation.
+   */
+  CorrelatorEngine(CorrelatorMethod method, int tau_lin, int hierarchy_depth,
+                   std::size_t dim_A, std::size_t dim_B,
+                   CorrelationOperation operation,
+                   CompressionFunction compress_A,
+                   CompressionFunction compress_B,
+                   Utils::Vector3d const &args);
+  CorrelatorEngine(CorrelatorEngine const &) = default;
+  /* boost::multi_array only assigns arrays of the same shape */
+  CorrelatorEngine &operator=(CorrelatorEngine const &) = delete;
+
+  /** Number of values a correlation operation yields per lag time. */
+  static std::size_t dim_corr(CorrelationOperation operation,
+                              std::size_t dim_A, std::size_t dim_B);
+
+  /** Add a sample of both observables. */
+  void update(Utils::Span<const double> A, Utils::Span<const double> B);
+  /** Correlate the samples left in the hierarchy. */
+  void finalize();
+
+  /** Number of lag times. */
+  std::size_t n_values() const;
+  std::size_t dim_corr() const { return m_dim_corr; }
+
+  /**
+   * @brief Current sums of the correlation operation.
+   * @param[out] sums          Sums for each lag time, row-major with
+   *                           @ref dim_corr columns.
+   * @param[out] sample_sizes  Number of terms of the sums.
+   */
+  void get_sums(std::vector<double> &sums,
+                std::vector<std::size_t> &sample_sizes) const;
+  /** Current number of terms of the sums, see @ref get_sums. */
+  std::vector<std::size_t> sample_sizes() const;
+
+  Utils::Vector3d const &args() const { return m_args; }
+  void set_args(Utils::Vector3d const &args) { m_args = args; }
+
+private:
+  void correlate(CorrelationOperation op, double const *a, double const *b,
+                 double *out) const;
+  void update_multi_tau(Utils::Span<const double> A,
+                        Utils::Span<const double> B);
+  void update_fft(Utils::Span<const double> A, Utils::Span<const double> B);
+  /** Correlate the current block of the FFT method with itself and the
+   *  previous block.
+   */
+  void correlate_block(boost::multi_array<double, 2> &result,
+                       std::vector<std::size_t> &n_sweeps) const;
+  /** Count the pairs of samples @ref correlate_block adds. */
+  void count_block(std::vector<std::size_t> &n_sweeps) const;
+  double *sample(boost::multi_array<double, 3> &buf, std::size_t level,
+                 std::size_t index) {
+    return buf[level][index].origin();
+  }
+  double const *sample(boost::multi_array<double, 3> const &buf,
+                       std::size_t level, std::size_t index) const {
+    return buf[level][index].origin();
+  }
+
+  CorrelatorMethod m_method = CorrelatorMethod::MULTI_TAU;
+  int m_tau_lin = 0;
+  int m_hierarchy_depth = 0;
+  std::size_t m_dim_A = 0;
+  std::size_t m_dim_B = 0;
+  std::size_t m_dim_corr = 0;
+  CorrelationOperation m_operation = CorrelationOperation::SCALAR_PRODUCT;
+  CompressionFunction m_compress_A = CompressionFunction::DISCARD2;
+  CompressionFunction m_compress_B = CompressionFunction::DISCARD2;
+  Utils::Vector3d m_args = {};
+
+  bool m_finalized = false;
+  /** Number of samples. */
+  unsigned int m_t = 0;
+  /** Samples of the hierarchy levels (multi-tau), or of the previous and
+   *  the current block (FFT), with shape (levels, slots, dim).
+   */
+  boost::multi_array<double, 3> m_A;
+  boost::multi_array<double, 3> m_B;
+  /** Sums of the correlation operation, with shape (lags, dim_corr). */
+  boost::multi_array<double, 2> m_result;
+  /** Number of terms of the sums at each lag time. */
+  std::vector<std::size_t> m_n_sweeps;
+  /** Number of samples on each level (multi-tau), or in the current
+   *  block (FFT).
+   */
+  std::vector<unsigned int> m_n_vals;
+  /** Index of the newest sample on each level. */
+  std::vector<std::size_t> m_newest;
+  std::vector<double> m_A_accumulated_average;
+  std::vector<double> m_B_accumulated_average;
+
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &m_finalized;
+    ar &m_t;
+    ar &m_A;
+    ar &m_B;
+    ar &m_result;
+    ar &m_n_sweeps;
+    ar &m_n_vals;
+    ar &m_newest;
+    ar &m_A_accumulated_average;
+    ar &m_B_accumulated_average;
+  }
+};
+
+} // namespace Accumulators
+
+#endif
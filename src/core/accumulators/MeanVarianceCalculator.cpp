@@ -19,45 +19,18 @@
 
 #include "MeanVarianceCalculator.hpp"
 
-#include <boost/archive/binary_iarchive.hpp>
-#include <boost/archive/binary_oarchive.hpp>
-#include <boost/iostreams/device/array.hpp>
-#include <boost/iostreams/stream.hpp>
-#include <boost/serialization/shared_ptr.hpp>
-#include <boost/serialization/string.hpp>
-#include <boost/serialization/vector.hpp>
-
-#include <sstream>
-#include <string>
+#include <vector>
 
 namespace Accumulators {
-void MeanVarianceCalculator::update() { m_acc(m_obs->operator()()); }
-
-std::vector<double> MeanVarianceCalculator::mean() { return m_acc.mean(); }
-
-std::vector<double> MeanVarianceCalculator::variance() {
-  return m_acc.variance();
-}
-
-std::vector<double> MeanVarianceCalculator::std_error() {
-  return m_acc.std_error();
+std::vector<double> MeanVarianceCalculator::mean() const {
+  return query(StreamQuery::MEAN);
 }
 
-std::string MeanVarianceCalculator::get_internal_state() const {
-  std::stringstream ss;
-  boost::archive::binary_oarchive oa(ss);
-
-  oa << m_acc;
-
-  return ss.str();
+std::vector<double> MeanVarianceCalculator::variance() const {
+  return query(StreamQuery::VARIANCE);
 }
 
-void MeanVarianceCalculator::set_internal_state(std::string const &state) {
-  namespace iostreams = boost::iostreams;
-  iostreams::array_source src(state.data(), state.size());
-  iostreams::stream<iostreams::array_source> ss(src);
-  boost::archive::binary_iarchive ia(ss);
-
-  ia >> m_acc;
+std::vector<double> MeanVarianceCalculator::std_error() const {
+  return query(StreamQuery::STD_ERROR);
 }
 } // namespace Accumulators
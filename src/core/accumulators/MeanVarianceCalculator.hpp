@@ -19,38 +19,32 @@
 #ifndef _ACCUMULATORS_ACCUMULATOR_H
 #define _ACCUMULATORS_ACCUMULATOR_H
 
-#include "AccumulatorBase.hpp"
+#include "StreamingAccumulator.hpp"
 #include "observables/Observable.hpp"
-#include <utils/Accumulator.hpp>
 
 #include <cstddef>
 #include <memory>
-#include <string>
 #include <vector>
 
 namespace Accumulators {
 
-class MeanVarianceCalculator : public AccumulatorBase {
+class MeanVarianceCalculator : public StreamingAccumulator {
 public:
-  // The accumulator struct has to be initialized with the correct vector size,
-  // therefore the order of init is important.
   MeanVarianceCalculator(std::shared_ptr<Observables::Observable> const &obs,
-                         int delta_N)
-      : AccumulatorBase(delta_N), m_obs(obs), m_acc(obs->n_values()) {}
-
-  void update() override;
-  std::vector<double> mean();
-  std::vector<double> variance();
-  std::vector<double> std_error();
-  /* Partial serialization of state that is not accessible
-     via the interface. */
-  std::string get_internal_state() const;
-  void set_internal_state(std::string const &);
-  std::vector<size_t> shape() const override { return m_obs->shape(); }
+                         int delta_N, bool distributed = false)
+      : StreamingAccumulator(obs, delta_N, make_parameters(), distributed) {}
+
+  std::vector<double> mean() const;
+  std::vector<double> variance() const;
+  std::vector<double> std_error() const;
+  std::vector<size_t> shape() const override { return observable()->shape(); }
 
 private:
-  std::shared_ptr<Observables::Observable> m_obs;
-  ::Utils::Accumulator m_acc;
+  static StreamParameters make_parameters() {
+    StreamParameters params;
+    params.type = StreamStatisticsType::MEAN_VARIANCE;
+    return params;
+  }
 };
 
 } // namespace Accumulators
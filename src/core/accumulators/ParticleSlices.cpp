@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "accumulators/ParticleSlices.hpp"
+
+#include "Particle.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+#include "observables/ParticleAngularVelocities.hpp"
+#include "observables/ParticleBodyAngularVelocities.hpp"
+#include "observables/ParticleBodyVelocities.hpp"
+#include "observables/ParticleForces.hpp"
+#include "observables/ParticlePositions.hpp"
+#include "observables/ParticleVelocities.hpp"
+
+#include <boost/mpi/collectives.hpp>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace Accumulators {
+namespace {
+template <class T> bool is_observable(Observables::Observable const &obs) {
+  return typeid(obs) == typeid(T);
+}
+
+template <class T>
+std::shared_ptr<Observables::PidObservable>
+make_observable(std::vector<int> ids) {
+  return std::make_shared<T>(std::move(ids));
+}
+
+/** Per-particle observable which the nodes can rebuild from its ids. */
+struct ObservableKind {
+  bool (*is_a)(Observables::Observable const &);
+  std::shared_ptr<Observables::PidObservable> (*make)(std::vector<int>);
+};
+
+/** Observables a distributed accumulator can evaluate on the nodes. */
+const std::array<ObservableKind, 6> observable_kinds = {{
+    {is_observable<Observables::ParticlePositions>,
+     make_observable<Observables::ParticlePositions>},
+    {is_observable<Observables::ParticleVelocities>,
+     make_observable<Observables::ParticleVelocities>},
+    {is_observable<Observables::ParticleForces>,
+     make_observable<Observables::ParticleForces>},
+    {is_observable<Observables::ParticleAngularVelocities>,
+     make_observable<Observables::ParticleAngularVelocities>},
+    {is_observable<Observables::ParticleBodyVelocities>,
+     make_observable<Observables::ParticleBodyVelocities>},
+    {is_observable<Observables::ParticleBodyAngularVelocities>,
+     make_observable<Observables::ParticleBodyAngularVelocities>},
+}};
+} // namespace
+
+int particle_observable_kind(Observables::Observable const &obs) {
+  auto const it = std::find_if(
+      observable_kinds.begin(), observable_kinds.end(),
+      [&obs](ObservableKind const &kind) { return kind.is_a(obs); });
+  if (it == observable_kinds.end()) {
+    throw std::runtime_error(
+        "A distributed accumulator only supports the observables "
+        "ParticlePositions, ParticleVelocities, ParticleForces, "
+        "ParticleAngularVelocities, ParticleBodyVelocities and "
+        "ParticleBodyAngularVelocities");
+  }
+  return static_cast<int>(std::distance(observable_kinds.begin(), it));
+}
+
+std::vector<int> distributed_particle_ids(
+    std::vector<std::shared_ptr<Observables::Observable>> const &observables) {
+  std::vector<int> ids;
+  for (auto const &obs : observables) {
+    auto const pid_obs =
+        std::dynamic_pointer_cast<Observables::PidObservable>(obs);
+    if (not pid_obs or pid_obs->values_per_particle() == 0) {
+      throw std::runtime_error(
+          "A distributed accumulator needs per-particle observables");
+    }
+    if (ids.empty()) {
+      ids = pid_obs->ids();
+    } else if (pid_obs->ids() != ids) {
+      throw std::runtime_error("The observables of a distributed "
+                               "accumulator need the same particles");
+    }
+    /* raise the error of unsupported observables here */
+    particle_observable_kind(*obs);
+  }
+
+  auto sorted_ids = ids;
+  std::sort(sorted_ids.begin(), sorted_ids.end());
+  if (sorted_ids.empty() or sorted_ids.front() < 0 or
+      std::adjacent_find(sorted_ids.begin(), sorted_ids.end()) !=
+          sorted_ids.end()) {
+    throw std::runtime_error(
+        "The particle ids of a distributed accumulator must be unique");
+  }
+  return ids;
+}
+
+ParticleSlices::ParticleSlices(std::vector<int> const &kinds,
+                               std::vector<int> const &ids) {
+  for (auto const kind : kinds) {
+    m_observables.emplace_back(observable_kinds.at(kind).make(ids));
+  }
+
+  auto const max_id = *std::max_element(ids.begin(), ids.end());
+  m_index.assign(static_cast<std::size_t>(max_id) + 1, -1);
+  for (std::size_t i = 0; i < ids.size(); i++)
+    m_index[ids[i]] = static_cast<int>(i);
+
+  auto const n_ids = ids.size();
+  auto const n_nodes = static_cast<std::size_t>(comm_cart.size());
+  m_begin.resize(n_nodes + 1);
+  for (std::size_t r = 0; r <= n_nodes; r++)
+    m_begin[r] = n_ids * r / n_nodes;
+
+  for (auto const &obs : m_observables) {
+    m_values.emplace_back(n_local() * obs->values_per_particle());
+  }
+}
+
+std::size_t ParticleSlices::n_local() const {
+  return m_begin[this_node + 1] - m_begin[this_node];
+}
+
+int ParticleSlices::update() {
+  auto const n_nodes = static_cast<std::size_t>(comm_cart.size());
+  /* index of the particle followed by the values of all observables */
+  auto const stride = std::accumulate(
+      m_observables.begin(), m_observables.end(), std::size_t{1},
+      [](std::size_t acc, auto const &obs) {
+        return acc + obs->values_per_particle();
+      });
+
+  std::vector<Particle> particles;
+  std::vector<std::size_t> indices;
+  for (auto const &p : cell_structure.local_particles()) {
+    auto const pid = static_cast<std::size_t>(p.p.identity);
+    if (pid < m_index.size() and m_index[pid] >= 0) {
+      particles.push_back(p);
+      /* positions in the current box, as in fetch_particles() */
+      particles.back().r.p = unfolded_position(p.r.p, p.l.i, box_geo.length());
+      particles.back().l.i = {};
+      indices.push_back(static_cast<std::size_t>(m_index[pid]));
+    }
+  }
+
+  std::vector<std::reference_wrapper<const Particle>> particle_refs(
+      particles.begin(), particles.end());
+  auto const refs = Observables::ParticleReferenceRange(particle_refs);
+  std::vector<std::vector<double>> values;
+  for (auto const &obs : m_observables) {
+    values.emplace_back(obs->evaluate_subset(refs));
+  }
+
+  /* sort the values by the node owning the particle */
+  std::vector<int> owners(indices.size());
+  std::vector<int> send_counts(n_nodes, 0);
+  for (std::size_t i = 0; i < indices.size(); i++) {
+    auto const it =
+        std::upper_bound(m_begin.begin(), m_begin.end(), indices[i]);
+    owners[i] = static_cast<int>(std::distance(m_begin.begin(), it)) - 1;
+    send_counts[owners[i]] += static_cast<int>(stride);
+  }
+  std::vector<int> send_displs(n_nodes, 0);
+  std::partial_sum(send_counts.begin(), send_counts.end() - 1,
+                   send_displs.begin() + 1);
+
+  std::vector<double> send_buf(stride * indices.size());
+  auto offsets = send_displs;
+  for (std::size_t i = 0; i < indices.size(); i++) {
+    auto out = send_buf.begin() + offsets[owners[i]];
+    *out++ = static_cast<double>(indices[i]);
+    for (std::size_t k = 0; k < m_observables.size(); k++) {
+      auto const vpp = m_observables[k]->values_per_particle();
+      out = std::copy_n(values[k].begin() + i * vpp, vpp, out);
+    }
+    offsets[owners[i]] += static_cast<int>(stride);
+  }
+
+  std::vector<int> recv_counts(n_nodes);
+  boost::mpi::all_to_all(comm_cart, send_counts, recv_counts);
+  std::vector<int> recv_displs(n_nodes, 0);
+  std::partial_sum(recv_counts.begin(), recv_counts.end() - 1,
+                   recv_displs.begin() + 1);
+  std::vector<double> recv_buf(
+      static_cast<std::size_t>(recv_displs.back() + recv_counts.back()));
+  MPI_Alltoallv(send_buf.data(), send_counts.data(), send_displs.data(),
+                MPI_DOUBLE, recv_buf.data(), recv_counts.data(),
+                recv_displs.data(), MPI_DOUBLE, comm_cart);
+
+  auto const first = m_begin[this_node];
+  for (auto in = recv_buf.begin(); in != recv_buf.end(); in += stride) {
+    auto const local = static_cast<std::size_t>(*in) - first;
+    auto value = in + 1;
+    for (std::size_t k = 0; k < m_observables.size(); k++) {
+      auto const vpp = m_observables[k]->values_per_particle();
+      std::copy_n(value, vpp, m_values[k].begin() + local * vpp);
+      value += vpp;
+    }
+  }
+
+  auto const missing =
+      static_cast<int>(n_local() - recv_buf.size() / stride);
+  return boost::mpi::all_reduce(comm_cart, missing, std::plus<int>());
+}
+
+} // namespace Accumulators
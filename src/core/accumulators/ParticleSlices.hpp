@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ACCUMULATORS_PARTICLE_SLICES_HPP
+#define CORE_ACCUMULATORS_PARTICLE_SLICES_HPP
+/** @file
+ *  Sampling of per-particle observables on the nodes, for the distributed
+ *  accumulators.
+ *
+ *  The accumulators live on the head node, the nodes can't share their
+ *  observables. Instead, the head node sends the kind of the observable
+ *  (see @ref particle_observable_kind) and the particle ids, from which
+ *  every node builds its own copy.
+ *
+ *  Implementation in ParticleSlices.cpp.
+ */
+
+#include "observables/Observable.hpp"
+#include "observables/PidObservable.hpp"
+
+#include <utils/Span.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Accumulators {
+
+/**
+ * @brief Kind of a per-particle observable the nodes can rebuild.
+ *
+ * @throws std::runtime_error if the observable isn't supported.
+ */
+int particle_observable_kind(Observables::Observable const &obs);
+
+/**
+ * @brief Check the observables of a distributed accumulator.
+ *
+ * @param observables  Observables, all of them of the same particles.
+ * @return The particle ids.
+ * @throws std::runtime_error if the observables can't be distributed.
+ */
+std::vector<int> distributed_particle_ids(
+    std::vector<std::shared_ptr<Observables::Observable>> const &observables);
+
+/**
+ * @brief Per-particle observables evaluated on the nodes owning the
+ * particles.
+ *
+ * The particle ids are split into contiguous slices, one per node. At each
+ * update, the nodes evaluate the observables on their local particles and
+ * send the values to the nodes owning the slices, so that every node ends
+ * up with the values of its slice, wherever the particles are.
+ */
+class ParticleSlices {
+public:
+  ParticleSlices() = default;
+  /**
+   * @param kinds  Observables, see @ref particle_observable_kind.
+   * @param ids    Particle ids of the observables.
+   */
+  ParticleSlices(std::vector<int> const &kinds, std::vector<int> const &ids);
+
+  /**
+   * @brief Evaluate the observables and collect the values of the slice of
+   * this node. Has to be called on all nodes.
+   *
+   * @return Number of particles of the observables which don't exist, on
+   *         all nodes. The values are incomplete if it isn't zero.
+   */
+  int update();
+
+  /** Latest values of the slice of this node for an observable. */
+  Utils::Span<const double> values(std::size_t observable) const {
+    return m_values[observable];
+  }
+  std::size_t values_per_particle(std::size_t observable) const {
+    return m_observables[observable]->values_per_particle();
+  }
+  /** Number of particles of the slice of this node. */
+  std::size_t n_local() const;
+  /** First index of the slice of each node, and the number of ids. */
+  std::vector<std::size_t> const &begin() const { return m_begin; }
+
+private:
+  std::vector<std::shared_ptr<Observables::PidObservable>> m_observables;
+  /** Position of each particle id in the observable ids, -1 if absent. */
+  std::vector<int> m_index;
+  std::vector<std::size_t> m_begin;
+  std::vector<std::vector<double>> m_values;
+};
+
+} // namespace Accumulators
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ACCUMULATORS_RUNNING_HISTOGRAM_HPP
+#define CORE_ACCUMULATORS_RUNNING_HISTOGRAM_HPP
+
+#include "StreamingAccumulator.hpp"
+#include "observables/Observable.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Accumulators {
+
+/**
+ * @brief Histogram of each value of an observable.
+ *
+ * All values share the same bins. Values outside of the range are only
+ * counted.
+ */
+class RunningHistogram : public StreamingAccumulator {
+public:
+  /**
+   * @param obs          Observable.
+   * @param delta_N      Number of time steps between updates.
+   * @param n_bins       Number of bins.
+   * @param range        Lower and upper limit of the bins, the upper limit
+   *                     belongs to the last bin.
+   * @param distributed  Whether the histograms are kept on the nodes.
+   */
+  RunningHistogram(std::shared_ptr<Observables::Observable> obs, int delta_N,
+                   int n_bins, Utils::Vector2d const &range,
+                   bool distributed = false)
+      : StreamingAccumulator(std::move(obs), delta_N,
+                             make_parameters(n_bins, range), distributed) {}
+
+  /** Counts with shape (n_values, n_bins). */
+  std::vector<double> histogram() const;
+  /** Counts below and above the range, with shape (n_values, 2). */
+  std::vector<double> outliers() const;
+  std::vector<size_t> shape() const override {
+    auto shape = observable()->shape();
+    shape.push_back(static_cast<std::size_t>(n_bins()));
+    return shape;
+  }
+  int n_bins() const { return parameters().n_bins; }
+  Utils::Vector2d range() const {
+    return {parameters().min, parameters().max};
+  }
+
+private:
+  static StreamParameters make_parameters(int n_bins,
+                                          Utils::Vector2d const &range) {
+    StreamParameters params;
+    params.type = StreamStatisticsType::HISTOGRAM;
+    params.n_bins = n_bins;
+    params.min = range[0];
+    params.max = range[1];
+    return params;
+  }
+};
+
+} // namespace Accumulators
+
+#endif
@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "accumulators/StreamStatistics.hpp"
+
+#include <utils/Accumulator.hpp>
+#include <utils/Span.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Accumulators {
+namespace {
+template <class T> std::string serialize_state(T const &statistics) {
+  std::stringstream ss;
+  boost::archive::binary_oarchive oa(ss);
+  oa << statistics;
+  return ss.str();
+}
+
+template <class T>
+void deserialize_state(T &statistics, std::string const &state) {
+  namespace iostreams = boost::iostreams;
+  iostreams::array_source src(state.data(), state.size());
+  iostreams::stream<iostreams::array_source> ss(src);
+  boost::archive::binary_iarchive ia(ss);
+  ia >> statistics;
+}
+
+[[noreturn]] void unsupported_query() {
+  throw std::runtime_error("The accumulator doesn't provide this result");
+}
+
+class MeanVarianceStatistics : public StreamStatistics {
+public:
+  explicit MeanVarianceStatistics(std::size_t dim)
+      : m_acc(dim), m_sample(dim) {}
+
+  void update(Utils::Span<const double> sample) override {
+    std::copy(sample.begin(), sample.end(), m_sample.begin());
+    m_acc(m_sample);
+    m_n++;
+  }
+
+  std::vector<double> query(StreamQuery what) const override {
+    switch (what) {
+    case StreamQuery::MEAN:
+      return m_acc.mean();
+    case StreamQuery::VARIANCE:
+      return m_acc.variance();
+    case StreamQuery::STD_ERROR:
+      return m_acc.std_error();
+    default:
+      unsupported_query();
+    }
+  }
+
+  std::size_t n_samples() const override { return m_n; }
+  void clear() override {
+    m_acc = Utils::Accumulator(m_sample.size());
+    m_n = 0;
+  }
+
+  std::string get_state() const override { return serialize_state(*this); }
+  void set_state(std::string const &state) override {
+    deserialize_state(*this, state);
+  }
+
+private:
+  Utils::Accumulator m_acc;
+  std::size_t m_n = 0;
+  /** Buffer for the update. */
+  std::vector<double> m_sample;
+
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &m_acc;
+    ar &m_n;
+  }
+};
+
+/**
+ * @brief Block averaging after Flyvbjerg and Petersen.
+ *
+ * Level @f$ k @f$ sees the averages of blocks of @f$ 2^k @f$ consecutive
+ * samples. Each level keeps the running mean and variance of its block
+ * averages, and the first half of the next block of the level above, so
+ * the memory grows with the logarithm of the number of samples.
+ */
+class BlockingStatistics : public StreamStatistics {
+public:
+  explicit BlockingStatistics(std::size_t dim) : m_dim(dim), m_carry(dim) {}
+
+  void update(Utils::Span<const double> sample) override {
+    std::copy(sample.begin(), sample.end(), m_carry.begin());
+    m_n++;
+    for (std::size_t k = 0;; k++) {
+      if (k == m_levels.size()) {
+        m_levels.emplace_back(m_dim);
+      }
+      auto &level = m_levels[k];
+      level.add(m_carry);
+      if (not level.has_pending) {
+        std::copy(m_carry.begin(), m_carry.end(), level.pending.begin());
+        level.has_pending = true;
+        break;
+      }
+      /* the block is complete, its average enters the next level */
+      for (std::size_t i = 0; i < m_dim; i++)
+        m_carry[i] = 0.5 * (level.pending[i] + m_carry[i]);
+      level.has_pending = false;
+    }
+  }
+
+  std::vector<double> query(StreamQuery what) const override {
+    switch (what) {
+    case StreamQuery::MEAN:
+      return m_levels.empty() ? std::vector<double>(m_dim, 0.)
+                              : m_levels.front().mean;
+    case StreamQuery::BLOCK_ERRORS: {
+      auto const n_levels = static_cast<std::size_t>(
+          std::count_if(m_levels.begin(), m_levels.end(),
+                        [](Level const &level) { return level.n > 1; }));
+      std::vector<double> errors(m_dim * n_levels);
+      for (std::size_t i = 0; i < m_dim; i++)
+        for (std::size_t k = 0; k < n_levels; k++)
+          errors[i * n_levels + k] = m_levels[k].std_error(i);
+      return errors;
+    }
+    case StreamQuery::STD_ERROR: {
+      std::vector<double> errors(m_dim, std::numeric_limits<double>::max());
+      if (m_n < 2)
+        return errors;
+      for (std::size_t i = 0; i < m_dim; i++) {
+        /* the largest estimate from enough blocks, which is on the plateau
+         * for samples correlated over less than the largest blocks */
+        errors[i] = m_levels.front().std_error(i);
+        for (auto const &level : m_levels) {
+          if (level.n >= min_blocks)
+            errors[i] = std::max(errors[i], level.std_error(i));
+        }
+      }
+      return errors;
+    }
+    default:
+      unsupported_query();
+    }
+  }
+
+  std::size_t n_samples() const override { return m_n; }
+  void clear() override {
+    m_levels.clear();
+    m_n = 0;
+  }
+
+  std::string get_state() const override { return serialize_state(*this); }
+  void set_state(std::string const &state) override {
+    deserialize_state(*this, state);
+  }
+
+private:
+  /** Number of blocks a block size needs to enter the error estimate. */
+  static constexpr std::size_t min_blocks = 32;
+
+  struct Level {
+    Level() = default;
+    explicit Level(std::size_t dim) : mean(dim), m2(dim), pending(dim) {}
+
+    /** Number of block averages. */
+    std::size_t n = 0;
+    std::vector<double> mean;
+    /** Sum of the squared deviations from the mean. */
+    std::vector<double> m2;
+    /** First half of the next block of the level above. */
+    std::vector<double> pending;
+    bool has_pending = false;
+
+    void add(std::vector<double> const &value) {
+      n++;
+      for (std::size_t i = 0; i < value.size(); i++) {
+        auto const delta = value[i] - mean[i];
+        mean[i] += delta / static_cast<double>(n);
+        m2[i] += delta * (value[i] - mean[i]);
+      }
+    }
+
+    double std_error(std::size_t i) const {
+      auto const n_ = static_cast<double>(n);
+      return std::sqrt(m2[i] / ((n_ - 1.) * n_));
+    }
+
+    template <class Archive>
+    void serialize(Archive &ar, long int /* version */) {
+      ar &n;
+      ar &mean;
+      ar &m2;
+      ar &pending;
+      ar &has_pending;
+    }
+  };
+
+  std::size_t m_dim;
+  std::size_t m_n = 0;
+  std::vector<Level> m_levels;
+  /** Block average which enters the next level. */
+  std::vector<double> m_carry;
+
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &m_n;
+    ar &m_levels;
+  }
+};
+
+constexpr std::size_t BlockingStatistics::min_blocks;
+
+/**
+ * @brief Histograms of fixed range. The values outside of the range,
+ * including NaN, are counted separately.
+ */
+class HistogramStatistics : public StreamStatistics {
+public:
+  HistogramStatistics(std::size_t dim, int n_bins, double min, double max)
+      : m_dim(dim), m_min(min), m_max(max) {
+    if (n_bins < 1 or not(max > min)) {
+      throw std::runtime_error(
+          "A histogram needs n_bins > 0 and a range with max > min");
+    }
+    m_n_bins = static_cast<std::size_t>(n_bins);
+    m_inv_bin_width = static_cast<double>(n_bins) / (max - min);
+    m_counts.resize(dim * m_n_bins);
+    m_outliers.resize(2 * dim);
+  }
+
+  void update(Utils::Span<const double> sample) override {
+    for (std::size_t i = 0; i < m_dim; i++) {
+      auto const x = sample[i];
+      if (x >= m_min and x <= m_max) {
+        /* the last bin includes the upper limit */
+        auto const bin = std::min(
+            m_n_bins - 1,
+            static_cast<std::size_t>((x - m_min) * m_inv_bin_width));
+        m_counts[i * m_n_bins + bin]++;
+      } else {
+        m_outliers[2 * i + ((x > m_max) ? 1 : 0)]++;
+      }
+    }
+    m_n++;
+  }
+
+  std::vector<double> query(StreamQuery what) const override {
+    switch (what) {
+    case StreamQuery::HISTOGRAM:
+      return {m_counts.begin(), m_counts.end()};
+    case StreamQuery::OUTLIERS:
+      return {m_outliers.begin(), m_outliers.end()};
+    default:
+      unsupported_query();
+    }
+  }
+
+  std::size_t n_samples() const override { return m_n; }
+  void clear() override {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    std::fill(m_outliers.begin(), m_outliers.end(), 0);
+    m_n = 0;
+  }
+
+  std::string get_state() const override { return serialize_state(*this); }
+  void set_state(std::string const &state) override {
+    deserialize_state(*this, state);
+  }
+
+private:
+  std::size_t m_dim;
+  std::size_t m_n_bins;
+  double m_min;
+  double m_max;
+  double m_inv_bin_width;
+  std::size_t m_n = 0;
+  std::vector<std::size_t> m_counts;
+  /** Counts below and above the range. */
+  std::vector<std::size_t> m_outliers;
+
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &m_n;
+    ar &m_counts;
+    ar &m_outliers;
+  }
+};
+
+/**
+ * @brief Ring buffer of samples.
+ *
+ * When the buffer is full, it is written to the spill file in one go,
+ * as native doubles with the components of a sample contiguous. Without
+ * spill file, new samples replace the oldest ones. A buffer size of 0
+ * keeps all samples in memory.
+ */
+class SampleBuffer : public StreamStatistics {
+public:
+  SampleBuffer(std::size_t dim, std::size_t capacity, std::string filename)
+      : m_dim(dim), m_capacity(capacity), m_filename(std::move(filename)) {
+    if (not m_filename.empty() and m_capacity == 0) {
+      throw std::runtime_error(
+          "A spill file needs a buffer size larger than zero");
+    }
+    m_samples.resize(m_capacity * m_dim);
+  }
+
+  void update(Utils::Span<const double> sample) override {
+    if (m_capacity == 0) {
+      m_samples.insert(m_samples.end(), sample.begin(), sample.end());
+      m_n_buffered++;
+      return;
+    }
+    if (m_n_buffered == m_capacity) {
+      if (m_filename.empty()) {
+        /* replace the oldest sample */
+        std::copy(sample.begin(), sample.end(),
+                  m_samples.begin() + m_first * m_dim);
+        m_first = (m_first + 1) % m_capacity;
+        return;
+      }
+      spill();
+    }
+    auto const slot = (m_first + m_n_buffered) % m_capacity;
+    std::copy(sample.begin(), sample.end(), m_samples.begin() + slot * m_dim);
+    m_n_buffered++;
+  }
+
+  std::vector<double> query(StreamQuery what) const override {
+    if (what != StreamQuery::SAMPLES)
+      unsupported_query();
+
+    auto const n = n_samples();
+    std::vector<double> result(m_dim * n);
+    auto const store = [&result, n, this](double const *sample,
+                                          std::size_t t) {
+      for (std::size_t i = 0; i < m_dim; i++)
+        result[i * n + t] = sample[i];
+    };
+
+    std::size_t t = 0;
+    if (m_n_spilled) {
+      std::ifstream file(m_filename, std::ios::binary);
+      auto const read_error = [this]() {
+        return std::runtime_error("Could not read the samples from the file '" +
+                                  m_filename + "'");
+      };
+      if (not file)
+        throw read_error();
+      std::vector<double> chunk(m_capacity * m_dim);
+      while (t < m_n_spilled) {
+        auto const n_chunk = std::min(m_capacity, m_n_spilled - t);
+        auto const size =
+            static_cast<std::streamsize>(n_chunk * m_dim * sizeof(double));
+        file.read(reinterpret_cast<char *>(chunk.data()), size);
+        if (file.gcount() != size)
+          throw read_error();
+        for (std::size_t j = 0; j < n_chunk; j++)
+          store(chunk.data() + j * m_dim, t + j);
+        t += n_chunk;
+      }
+    }
+    for (std::size_t j = 0; j < m_n_buffered; j++, t++) {
+      auto const slot = (m_capacity == 0) ? j : (m_first + j) % m_capacity;
+      store(m_samples.data() + slot * m_dim, t);
+    }
+    return result;
+  }
+
+  std::size_t n_samples() const override {
+    return m_n_spilled + m_n_buffered;
+  }
+  void clear() override {
+    if (m_capacity == 0)
+      m_samples.clear();
+    m_first = 0;
+    m_n_buffered = 0;
+    /* the next spill overwrites the file */
+    m_n_spilled = 0;
+  }
+
+  std::string get_state() const override { return serialize_state(*this); }
+  void set_state(std::string const &state) override {
+    deserialize_state(*this, state);
+  }
+
+private:
+  std::size_t m_dim;
+  std::size_t m_capacity;
+  std::string m_filename;
+  std::vector<double> m_samples;
+  /** Slot of the oldest sample in the buffer. */
+  std::size_t m_first = 0;
+  std::size_t m_n_buffered = 0;
+  /** Number of samples in the spill file. */
+  std::size_t m_n_spilled = 0;
+
+  void spill() {
+    auto const mode = std::ios::binary |
+                      ((m_n_spilled == 0) ? std::ios::trunc : std::ios::app);
+    std::ofstream file(m_filename, mode);
+    /* the buffer is full and starts at slot m_first */
+    auto const split = m_samples.begin() + m_first * m_dim;
+    auto const write = [&file](auto begin, auto end) {
+      file.write(reinterpret_cast<char const *>(&*begin),
+                 static_cast<std::streamsize>(
+                     static_cast<std::size_t>(end - begin) * sizeof(double)));
+    };
+    if (not m_samples.empty()) {
+      write(split, m_samples.end());
+      write(m_samples.begin(), split);
+    }
+    file.close();
+    if (not file) {
+      throw std::runtime_error("Could not write the samples to the file '" +
+                               m_filename + "'");
+    }
+    m_n_spilled += m_n_buffered;
+    m_n_buffered = 0;
+    m_first = 0;
+  }
+
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &m_samples;
+    ar &m_first;
+    ar &m_n_buffered;
+    ar &m_n_spilled;
+  }
+};
+} // namespace
+
+std::unique_ptr<StreamStatistics>
+make_stream_statistics(StreamParameters const &params, std::size_t dim) {
+  switch (params.type) {
+  case StreamStatisticsType::MEAN_VARIANCE:
+    return std::make_unique<MeanVarianceStatistics>(dim);
+  case StreamStatisticsType::BLOCKING:
+    return std::make_unique<BlockingStatistics>(dim);
+  case StreamStatisticsType::HISTOGRAM:
+    return std::make_unique<HistogramStatistics>(dim, params.n_bins,
+                                                 params.min, params.max);
+  case StreamStatisticsType::SAMPLE_BUFFER:
+    return std::make_unique<SampleBuffer>(dim, params.buffer_size,
+                                          params.filename);
+  }
+  throw std::runtime_error("Unknown statistics");
+}
+
+} // namespace Accumulators
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ACCUMULATORS_STREAM_STATISTICS_HPP
+#define CORE_ACCUMULATORS_STREAM_STATISTICS_HPP
+/** @file
+ *  Statistics of a stream of samples with bounded memory, the storage of
+ *  @ref Accumulators::StreamingAccumulator.
+ *
+ *  The statistics only see flat samples. A distributed accumulator runs
+ *  one instance per node on the particle slice of the node, so all
+ *  results are laid out component-major: the results of the slices of the
+ *  nodes are concatenated to the results of all components.
+ *
+ *  Implementation in StreamStatistics.cpp.
+ */
+
+#include <utils/Span.hpp>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Accumulators {
+
+enum class StreamStatisticsType : int {
+  /** Mean and variance of each component. */
+  MEAN_VARIANCE,
+  /** Block averages of doubling block size, for the error of the mean of
+   *  correlated samples.
+   */
+  BLOCKING,
+  /** Histogram of each component. */
+  HISTOGRAM,
+  /** The samples, in a ring buffer which can spill to a file. */
+  SAMPLE_BUFFER
+};
+
+/** Results of @ref StreamStatistics::query, per component. */
+enum class StreamQuery : int {
+  /** Mean, 1 value. */
+  MEAN,
+  /** Variance of the samples, 1 value. */
+  VARIANCE,
+  /** Standard error of the mean, 1 value. */
+  STD_ERROR,
+  /** Standard error of the mean from the block averages of each block
+   *  size, one value per block size.
+   */
+  BLOCK_ERRORS,
+  /** Counts of the histogram bins, one value per bin. */
+  HISTOGRAM,
+  /** Counts of the values below and above the histogram range, 2 values. */
+  OUTLIERS,
+  /** All stored samples, one value per sample. */
+  SAMPLES
+};
+
+struct StreamParameters {
+  StreamStatisticsType type = StreamStatisticsType::MEAN_VARIANCE;
+  /** Number of samples kept in memory by the sample buffer, 0 to keep all
+   *  of them.
+   */
+  std::size_t buffer_size = 0;
+  /** File to which the sample buffer spills the samples which don't fit
+   *  into memory. Without file, the oldest samples are dropped.
+   */
+  std::string filename;
+  int n_bins = 0;
+  double min = 0.;
+  double max = 0.;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &type;
+    ar &buffer_size;
+    ar &filename;
+    ar &n_bins;
+    ar &min;
+    ar &max;
+  }
+};
+
+/** @brief Statistics of a stream of samples with bounded memory. */
+class StreamStatistics {
+public:
+  virtual ~StreamStatistics() = default;
+
+  /** Add a sample. */
+  virtual void update(Utils::Span<const double> sample) = 0;
+  /**
+   * @brief Result of the statistics.
+   *
+   * The values of each component are contiguous.
+   * @throws std::runtime_error if the statistics don't provide the result.
+   */
+  virtual std::vector<double> query(StreamQuery what) const = 0;
+  /** Number of samples the results are based on. */
+  virtual std::size_t n_samples() const = 0;
+  /** Remove all samples. */
+  virtual void clear() = 0;
+
+  /** Serialized samples, which don't include the parameters. */
+  virtual std::string get_state() const = 0;
+  virtual void set_state(std::string const &state) = 0;
+};
+
+/**
+ * @brief Statistics of samples with @p dim components.
+ * @throws std::runtime_error if the parameters are invalid.
+ */
+std::unique_ptr<StreamStatistics>
+make_stream_statistics(StreamParameters const &params, std::size_t dim);
+
+} // namespace Accumulators
+
+#endif
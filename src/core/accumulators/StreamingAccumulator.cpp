@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "StreamingAccumulator.hpp"
+
+#include "ParticleSlices.hpp"
+#include "StreamStatistics.hpp"
+#include "communication.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/mpi/gather_buffer.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+using Accumulators::ParticleSlices;
+using Accumulators::StreamParameters;
+using Accumulators::StreamQuery;
+using Accumulators::StreamStatistics;
+
+/** Everything the nodes need to set up their part of a distributed
+ *  accumulator.
+ */
+struct DistributedParameters {
+  int kind;
+  std::vector<int> ids;
+  StreamParameters statistics;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &kind;
+    ar &ids;
+    ar &statistics;
+  }
+};
+
+/** The part of a distributed accumulator on one node, which keeps the
+ *  statistics of the particle slice of the node.
+ */
+struct LocalStream {
+  ParticleSlices samples;
+  std::unique_ptr<StreamStatistics> statistics;
+};
+
+std::unordered_map<int, LocalStream> local_streams;
+/** Identifier of the next distributed accumulator, only used on the head
+ *  node.
+ */
+int next_distributed_id = 0;
+} // namespace
+
+static void mpi_stream_create_local(int id,
+                                    DistributedParameters const &params) {
+  LocalStream s;
+  s.samples = ParticleSlices({params.kind}, params.ids);
+  auto statistics = params.statistics;
+  if (not statistics.filename.empty()) {
+    /* one spill file per node */
+    statistics.filename += "." + std::to_string(this_node);
+  }
+  s.statistics = Accumulators::make_stream_statistics(
+      statistics, s.samples.n_local() * s.samples.values_per_particle(0));
+
+  local_streams[id] = std::move(s);
+}
+
+REGISTER_CALLBACK(mpi_stream_create_local)
+
+static void mpi_stream_destroy_local(int id) { local_streams.erase(id); }
+
+REGISTER_CALLBACK(mpi_stream_destroy_local)
+
+/** Sample the observable on the nodes and update the statistics of the
+ *  slice of each node.
+ *
+ *  @return Number of particles of the observable which don't exist, and
+ *          number of nodes which failed to update their statistics.
+ */
+static Utils::VectorXi<2> mpi_stream_update_local(int id) {
+  auto &s = local_streams.at(id);
+  auto const missing = s.samples.update();
+  int failed = 0;
+  if (missing == 0) {
+    try {
+      s.statistics->update(s.samples.values(0));
+    } catch (std::runtime_error const &) {
+      failed = 1;
+    }
+  }
+  int total_failed = 0;
+  boost::mpi::reduce(comm_cart, failed, total_failed, std::plus<int>(), 0);
+  return {missing, total_failed};
+}
+
+REGISTER_CALLBACK_MASTER_RANK(mpi_stream_update_local)
+
+/** Results of the slices of all nodes, concatenated on the head node.
+ *  An error of any node, e.g. an unreadable spill file, is rethrown on
+ *  the head node.
+ */
+static std::vector<double> mpi_stream_query_local(int id, StreamQuery what) {
+  std::vector<double> result;
+  std::string error;
+  try {
+    result = local_streams.at(id).statistics->query(what);
+  } catch (std::runtime_error const &err) {
+    error = err.what();
+  }
+  std::vector<std::string> errors;
+  boost::mpi::gather(comm_cart, error, errors, 0);
+  Utils::Mpi::gather_buffer(result, comm_cart);
+  for (auto const &message : errors) {
+    if (not message.empty())
+      throw std::runtime_error(message);
+  }
+  return result;
+}
+
+REGISTER_CALLBACK_MASTER_RANK(mpi_stream_query_local)
+
+static void mpi_stream_clear_local(int id) {
+  local_streams.at(id).statistics->clear();
+}
+
+REGISTER_CALLBACK(mpi_stream_clear_local)
+
+static std::vector<std::string> mpi_stream_get_state_local(int id) {
+  std::vector<std::string> states;
+  boost::mpi::gather(comm_cart, local_streams.at(id).statistics->get_state(),
+                     states, 0);
+  return states;
+}
+
+REGISTER_CALLBACK_MASTER_RANK(mpi_stream_get_state_local)
+
+static void mpi_stream_set_state_local(int id) {
+  std::string state;
+  boost::mpi::scatter(comm_cart, state, 0);
+  local_streams.at(id).statistics->set_state(state);
+}
+
+REGISTER_CALLBACK(mpi_stream_set_state_local)
+
+namespace Accumulators {
+StreamingAccumulator::StreamingAccumulator(
+    std::shared_ptr<Observables::Observable> obs, int delta_N,
+    StreamParameters params, bool distributed)
+    : AccumulatorBase(delta_N), m_obs(std::move(obs)),
+      m_params(std::move(params)), m_distributed(distributed) {
+  if (not m_distributed) {
+    m_statistics = make_stream_statistics(m_params, m_obs->n_values());
+    return;
+  }
+
+  DistributedParameters dist_params;
+  dist_params.ids = distributed_particle_ids({m_obs});
+  dist_params.kind = particle_observable_kind(*m_obs);
+  dist_params.statistics = m_params;
+  /* raise errors of the parameters here rather than on the nodes */
+  make_stream_statistics(m_params, 1);
+
+  m_distributed_id = next_distributed_id++;
+  mpi_call_all(mpi_stream_create_local, m_distributed_id, dist_params);
+}
+
+StreamingAccumulator::~StreamingAccumulator() {
+  if (m_distributed_id >= 0) {
+    mpi_call_all(mpi_stream_destroy_local, m_distributed_id);
+  }
+}
+
+void StreamingAccumulator::update() {
+  if (not m_distributed) {
+    m_statistics->update(m_obs->operator()());
+    return;
+  }
+
+  auto const status = mpi_call(Communication::Result::master_rank,
+                               mpi_stream_update_local, m_distributed_id);
+  if (status[0]) {
+    throw std::runtime_error("Distributed accumulator: " +
+                             std::to_string(status[0]) +
+                             " particles of the observable don't exist");
+  }
+  if (status[1]) {
+    throw std::runtime_error("Distributed accumulator: " +
+                             std::to_string(status[1]) +
+                             " nodes could not write their samples to the "
+                             "spill file");
+  }
+}
+
+void StreamingAccumulator::clear() {
+  if (m_distributed) {
+    mpi_call_all(mpi_stream_clear_local, m_distributed_id);
+  } else {
+    m_statistics->clear();
+  }
+}
+
+std::vector<double> StreamingAccumulator::query(StreamQuery what) const {
+  if (m_distributed) {
+    return mpi_call(Communication::Result::master_rank, mpi_stream_query_local,
+                    m_distributed_id, what);
+  }
+  return m_statistics->query(what);
+}
+
+std::vector<double>
+StreamingAccumulator::query_rows(StreamQuery what,
+                                 std::size_t &n_rows) const {
+  auto const values = query(what);
+  auto const dim = m_obs->n_values();
+  n_rows = (dim == 0) ? 0 : values.size() / dim;
+  std::vector<double> rows(values.size());
+  for (std::size_t i = 0; i < dim; i++)
+    for (std::size_t j = 0; j < n_rows; j++)
+      rows[j * dim + i] = values[i * n_rows + j];
+  return rows;
+}
+
+std::size_t StreamingAccumulator::n_samples() const {
+  /* all nodes have the same number of samples */
+  return m_distributed
+             ? local_streams.at(m_distributed_id).statistics->n_samples()
+             : m_statistics->n_samples();
+}
+
+std::string StreamingAccumulator::get_internal_state() const {
+  std::stringstream ss;
+  boost::archive::binary_oarchive oa(ss);
+
+  if (m_distributed) {
+    auto const states =
+        mpi_call(Communication::Result::master_rank,
+                 mpi_stream_get_state_local, m_distributed_id);
+    oa << states;
+  } else {
+    oa << m_statistics->get_state();
+  }
+
+  return ss.str();
+}
+
+void StreamingAccumulator::set_internal_state(std::string const &state) {
+  namespace iostreams = boost::iostreams;
+  iostreams::array_source src(state.data(), state.size());
+  iostreams::stream<iostreams::array_source> ss(src);
+  boost::archive::binary_iarchive ia(ss);
+
+  if (m_distributed) {
+    std::vector<std::string> states;
+    ia >> states;
+    if (states.size() != static_cast<std::size_t>(comm_cart.size())) {
+      throw std::runtime_error("A distributed accumulator can only be "
+                               "restored on the same number of MPI ranks");
+    }
+    mpi_call(mpi_stream_set_state_local, m_distributed_id);
+    std::string local_state;
+    boost::mpi::scatter(comm_cart, states, local_state, 0);
+    local_streams.at(m_distributed_id).statistics->set_state(local_state);
+  } else {
+    std::string local_state;
+    ia >> local_state;
+    m_statistics->set_state(local_state);
+  }
+}
+
+} // namespace Accumulators
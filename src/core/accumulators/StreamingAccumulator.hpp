@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ACCUMULATORS_STREAMING_ACCUMULATOR_HPP
+#define CORE_ACCUMULATORS_STREAMING_ACCUMULATOR_HPP
+
+#include "AccumulatorBase.hpp"
+#include "StreamStatistics.hpp"
+#include "observables/Observable.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Accumulators {
+
+/**
+ * @brief Accumulator which keeps statistics of an observable with bounded
+ * memory, see @ref StreamStatistics.
+ *
+ * By default, the observable is evaluated and the statistics are kept on
+ * the head node. Per-particle observables can be distributed: every node
+ * evaluates the observable on its particles and keeps the statistics of
+ * its slice of the particles (see @ref ParticleSlices). Only the results
+ * are gathered on the head node, when they are requested.
+ */
+class StreamingAccumulator : public AccumulatorBase {
+public:
+  /**
+   * @param obs          Observable.
+   * @param delta_N      Number of time steps between updates.
+   * @param params       Statistics of the samples.
+   * @param distributed  Whether the statistics are kept on the nodes.
+   */
+  StreamingAccumulator(std::shared_ptr<Observables::Observable> obs,
+                       int delta_N, StreamParameters params,
+                       bool distributed);
+  ~StreamingAccumulator() override;
+  StreamingAccumulator(StreamingAccumulator const &) = delete;
+  StreamingAccumulator &operator=(StreamingAccumulator const &) = delete;
+
+  void update() override;
+  unsigned fused_observables() const override {
+    return m_obs->fused_observables();
+  }
+  /** Remove all samples. */
+  void clear();
+  bool distributed() const { return m_distributed; }
+
+  std::string get_internal_state() const;
+  void set_internal_state(std::string const &state);
+
+protected:
+  /** Result of the statistics of all components, see
+   *  @ref StreamStatistics::query.
+   */
+  std::vector<double> query(StreamQuery what) const;
+  /** Result with one value per component for each of @p n_rows rows,
+   *  row-major.
+   */
+  std::vector<double> query_rows(StreamQuery what, std::size_t &n_rows) const;
+  std::size_t n_samples() const;
+  std::shared_ptr<Observables::Observable> const &observable() const {
+    return m_obs;
+  }
+  StreamParameters const &parameters() const { return m_params; }
+
+private:
+  std::shared_ptr<Observables::Observable> m_obs;
+  StreamParameters m_params;
+  bool m_distributed;
+  /** Identifier of the parts of a distributed accumulator on the nodes. */
+  int m_distributed_id = -1;
+  /** Statistics, unused for distributed accumulators. */
+  std::unique_ptr<StreamStatistics> m_statistics;
+};
+
+} // namespace Accumulators
+
+#endif
@@ -19,7 +19,7 @@
 #ifndef CORE_ACCUMULATORS_TIMESERIES_HPP
 #define CORE_ACCUMULATORS_TIMESERIES_HPP
 
-#include "AccumulatorBase.hpp"
+#include "StreamingAccumulator.hpp"
 #include "observables/Observable.hpp"
 
 #include <cstddef>
@@ -31,34 +31,48 @@
 namespace Accumulators {
 
 /**
- * @brief Record values of an observable.
- *
- * This is a very simple accumulator that stores
- * the current value of an observable every time
- * it is updated.
+ * @brief Record of the values of an observable.
  *
+ * With a buffer size, at most that many samples are kept in memory. When
+ * the buffer is full, it is written to the spill file, or, without spill
+ * file, the oldest samples are dropped.
  */
-class TimeSeries : public AccumulatorBase {
+class TimeSeries : public StreamingAccumulator {
 public:
-  TimeSeries(std::shared_ptr<Observables::Observable> obs, int delta_N)
-      : AccumulatorBase(delta_N), m_obs(std::move(obs)) {}
-
-  void update() override;
-  std::string get_internal_state() const;
-  void set_internal_state(std::string const &);
+  /**
+   * @param obs          Observable.
+   * @param delta_N      Number of time steps between updates.
+   * @param buffer_size  Number of samples kept in memory, 0 for all.
+   * @param filename     Spill file, a distributed time series writes one
+   *                     file per node with the node number appended.
+   * @param distributed  Whether the samples are kept on the nodes.
+   */
+  TimeSeries(std::shared_ptr<Observables::Observable> obs, int delta_N,
+             std::size_t buffer_size = 0, std::string filename = {},
+             bool distributed = false)
+      : StreamingAccumulator(std::move(obs), delta_N,
+                             make_parameters(buffer_size, std::move(filename)),
+                             distributed) {}
 
-  const std::vector<std::vector<double>> &time_series() const { return m_data; }
+  std::vector<std::vector<double>> time_series() const;
   std::vector<size_t> shape() const override {
-    std::vector<size_t> shape{m_data.size()};
-    auto obs_shape = m_obs->shape();
+    std::vector<size_t> shape{n_samples()};
+    auto obs_shape = observable()->shape();
     shape.insert(shape.end(), obs_shape.begin(), obs_shape.end());
     return shape;
   }
-  void clear() { m_data.clear(); }
+  std::size_t buffer_size() const { return parameters().buffer_size; }
+  std::string const &filename() const { return parameters().filename; }
 
 private:
-  std::shared_ptr<Observables::Observable> m_obs;
-  std::vector<std::vector<double>> m_data;
+  static StreamParameters make_parameters(std::size_t buffer_size,
+                                          std::string filename) {
+    StreamParameters params;
+    params.type = StreamStatisticsType::SAMPLE_BUFFER;
+    params.buffer_size = buffer_size;
+    params.filename = std::move(filename);
+    return params;
+  }
 };
 
 } // namespace Accumulators
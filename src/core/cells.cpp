@@ -27,10 +27,13 @@
 #include "cells.hpp"
 
 #include "Particle.hpp"
+#include "collision.hpp"
 #include "communication.hpp"
+#include "config.hpp"
 #include "errorhandling.hpp"
 #include "event.hpp"
 #include "grid.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
 #include "integrate.hpp"
 #include "particle_data.hpp"
 
@@ -50,6 +53,9 @@
 /** Type of cell structure in use */
 CellStructure cell_structure;
 
+/** Parameters of the domain decomposition. */
+static DomainDecompositionParameters domain_decomposition_params;
+
 /**
  * @brief Get pairs of particles that are closer than a distance and fulfill a
  * filter criterion.
@@ -168,7 +174,8 @@ void cells_re_init(int new_cs) {
   switch (new_cs) {
   case CELL_STRUCTURE_DOMDEC:
     cell_structure.set_domain_decomposition(comm_cart, interaction_range(),
-                                            box_geo, local_geo);
+                                            box_geo, local_geo,
+                                            domain_decomposition_params);
     break;
   case CELL_STRUCTURE_NSQUARE:
     cell_structure.set_atom_decomposition(comm_cart, box_geo);
@@ -250,3 +257,60 @@ REGISTER_CALLBACK(mpi_set_use_verlet_lists_local)
 void mpi_set_use_verlet_lists(bool use_verlet_lists) {
   mpi_call_all(mpi_set_use_verlet_lists_local, use_verlet_lists);
 }
+
+static void mpi_set_domain_decomposition_parameters_local(
+    DomainDecompositionParameters const &params) {
+  domain_decomposition_params = params;
+}
+
+REGISTER_CALLBACK(mpi_set_domain_decomposition_parameters_local)
+
+void mpi_set_domain_decomposition_parameters(bool eighth_shell,
+                                             int cells_per_range) {
+  if (cells_per_range < 1) {
+    throw std::domain_error("cells_per_range must be >= 1");
+  }
+  DomainDecompositionParameters params;
+  params.eighth_shell = eighth_shell;
+  params.cells_per_range = cells_per_range;
+  mpi_call_all(mpi_set_domain_decomposition_parameters_local, params);
+}
+
+void cells_sanity_checks() {
+  if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC or
+      not domain_decomposition_params.eighth_shell)
+    return;
+
+  /* without the lower ghost layers, only pair interactions are complete */
+  for (auto const &p : cell_structure.local_particles()) {
+    if (not p.bonds().empty()) {
+      runtimeErrorMsg() << "The eighth shell domain decomposition does not "
+                           "support bonded interactions";
+      break;
+    }
+#ifdef EXCLUSIONS
+    if (not p.exclusions().empty()) {
+      runtimeErrorMsg() << "The eighth shell domain decomposition does not "
+                           "support exclusions";
+      break;
+    }
+#endif
+#ifdef VIRTUAL_SITES
+    if (p.p.is_virtual) {
+      runtimeErrorMsg() << "The eighth shell domain decomposition does not "
+                           "support virtual sites";
+      break;
+    }
+#endif
+  }
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != COLLISION_MODE_OFF) {
+    runtimeErrorMsg() << "The eighth shell domain decomposition does not "
+                         "support collision detection";
+  }
+#endif
+  if (lattice_switch != ActiveLB::NONE) {
+    runtimeErrorMsg() << "The eighth shell domain decomposition does not "
+                         "support lattice-Boltzmann";
+  }
+}
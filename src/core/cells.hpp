@@ -76,6 +76,20 @@ void mpi_bcast_cell_structure(int cs);
  */
 void mpi_set_use_verlet_lists(bool use_verlet_lists);
 
+/**
+ * @brief Set the parameters of the domain decomposition on all nodes,
+ * see @ref DomainDecompositionParameters. They take effect on the next
+ * reinitialization of the cell system.
+ *
+ * @param eighth_shell    Import ghosts only from the upper neighbors.
+ * @param cells_per_range Number of cells per interaction range.
+ */
+void mpi_set_domain_decomposition_parameters(bool eighth_shell,
+                                             int cells_per_range);
+
+/** Check that the active features are supported by the cell system. */
+void cells_sanity_checks();
+
 /** Update ghost information. If needed,
  *  the particles are also resorted.
  */
@@ -27,6 +27,7 @@
 #include "communication.hpp"
 #include "errorhandling.hpp"
 #include "event.hpp"
+#include "fused_observables.hpp"
 #include "grid.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "virtual_sites.hpp"
@@ -34,17 +35,20 @@
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
 #include <utils/math/sqr.hpp>
-#include <utils/mpi/all_compare.hpp>
-#include <utils/mpi/gather_buffer.hpp>
 
 #include <boost/algorithm/clamp.hpp>
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/nonblocking.hpp>
+#include <boost/mpi/request.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -365,6 +369,45 @@ void coldet_do_three_particle_bond(Particle &p, Particle const &p1,
 }
 
 #ifdef VIRTUAL_SITES_RELATIVE
+namespace {
+/** Number of consecutive particle ids a node reserves at a time for the
+ *  virtual sites it creates.
+ */
+constexpr int vs_id_block_size = 256;
+
+/** @brief Particle ids for virtual sites created on collision.
+ *
+ *  The ids above the largest particle id at the start of the integration
+ *  are cut into blocks of @ref vs_id_block_size, which are assigned to the
+ *  nodes round-robin. Each node can thus draw new ids without
+ *  communication.
+ */
+class VsIdBlocks {
+  int m_first_id = 0;
+  int m_rank = 0;
+  int m_n_ranks = 1;
+  int m_block = 0;
+  int m_offset = 0;
+
+public:
+  VsIdBlocks() = default;
+  VsIdBlocks(int first_id, int rank, int n_ranks)
+      : m_first_id(first_id), m_rank(rank), m_n_ranks(n_ranks) {}
+
+  /** Reserve the next id of this node. */
+  int next() {
+    if (m_offset == vs_id_block_size) {
+      ++m_block;
+      m_offset = 0;
+    }
+    return m_first_id + (m_block * m_n_ranks + m_rank) * vs_id_block_size +
+           m_offset++;
+  }
+};
+
+VsIdBlocks vs_ids;
+} // namespace
+
 void place_vs_and_relate_to_particle(const int current_vs_pid,
                                      const Utils::Vector3d &pos,
                                      int relate_to) {
@@ -379,60 +422,209 @@ void place_vs_and_relate_to_particle(const int current_vs_pid,
   p_vs->p.type = collision_params.vs_particle_type;
 }
 
-void bind_at_poc_create_bond_between_vs(const int current_vs_pid,
+void bind_at_poc_create_bond_between_vs(const int vs_pid1, const int vs_pid2,
                                         const collision_struct &c) {
   switch (get_bond_num_partners(collision_params.bond_vs)) {
   case 1: {
     // Create bond between the virtual particles
-    const int bondG[] = {current_vs_pid - 2};
-    // Only add bond if vs was created on this node
-    if (cell_structure.get_local_particle(current_vs_pid - 1))
-      get_part(current_vs_pid - 1)
-          .bonds()
-          .insert({collision_params.bond_vs, bondG});
+    const int bondG[] = {vs_pid1};
+    get_part(vs_pid2).bonds().insert({collision_params.bond_vs, bondG});
     break;
   }
   case 2: {
     // Create 1st bond between the virtual particles
     const int bondG[] = {c.pp1, c.pp2};
-    // Only add bond if vs was created on this node
-    if (cell_structure.get_local_particle(current_vs_pid - 1))
-      get_part(current_vs_pid - 1)
-          .bonds()
-          .insert({collision_params.bond_vs, bondG});
-    if (cell_structure.get_local_particle(current_vs_pid - 2))
-      get_part(current_vs_pid - 2)
-          .bonds()
-          .insert({collision_params.bond_vs, bondG});
+    get_part(vs_pid1).bonds().insert({collision_params.bond_vs, bondG});
+    get_part(vs_pid2).bonds().insert({collision_params.bond_vs, bondG});
     break;
   }
   }
 }
+#endif
 
-void glue_to_surface_bind_part_to_vs(const Particle *const p1,
-                                     const Particle *const p2,
-                                     const int vs_pid_plus_one,
-                                     const collision_struct &c) {
-  // Create bond between the virtual particles
-  const int bondG[] = {vs_pid_plus_one - 1};
+void collision_detection_on_integration_start() {
+#ifdef VIRTUAL_SITES_RELATIVE
+  if ((collision_params.mode & COLLISION_MODE_VS) ||
+      (collision_params.mode & COLLISION_MODE_GLUE_TO_SURF)) {
+    auto const global_max_seen_particle = boost::mpi::all_reduce(
+        comm_cart, cell_structure.get_max_local_particle_id(),
+        boost::mpi::maximum<int>());
+    vs_ids = VsIdBlocks(global_max_seen_particle + 1, comm_cart.rank(),
+                        comm_cart.size());
+  }
+#endif
+}
 
-  if (p1->p.type == collision_params.part_type_after_glueing) {
-    get_part(p1->p.identity).bonds().insert({collision_params.bond_vs, bondG});
-  } else {
-    get_part(p2->p.identity).bonds().insert({collision_params.bond_vs, bondG});
+namespace {
+bool is_local(Particle const *p) { return p and not p->l.ghost; }
+
+/** Check if one of the colliding particles is a ghost on this node. */
+bool has_ghost_partner(collision_struct const &c) {
+  return not is_local(cell_structure.get_local_particle(c.pp1)) or
+         not is_local(cell_structure.get_local_particle(c.pp2));
+}
+
+/**
+ * @brief Exchange queue entries with the neighboring nodes.
+ *
+ * Only the nodes that can hold one of the colliding particles, either as
+ * real particle or as ghost, take part in the exchange.
+ *
+ * @param entries Entries to send to all neighbors.
+ * @return Entries received from the neighbors.
+ */
+std::vector<collision_struct>
+exchange_with_neighbors(std::vector<collision_struct> const &entries) {
+  auto const neighbors = cell_structure.neighbor_ranks();
+
+  std::vector<std::vector<collision_struct>> recv_buffers(neighbors.size());
+  std::vector<boost::mpi::request> requests;
+  for (std::size_t i = 0; i < neighbors.size(); ++i) {
+    requests.push_back(
+        comm_cart.irecv(neighbors[i], SOME_TAG, recv_buffers[i]));
+    requests.push_back(comm_cart.isend(neighbors[i], SOME_TAG, entries));
   }
+  boost::mpi::wait_all(requests.begin(), requests.end());
+
+  std::vector<collision_struct> received;
+  for (auto const &buffer : recv_buffers) {
+    received.insert(received.end(), buffer.begin(), buffer.end());
+  }
+  return received;
 }
 
-#endif
+/** Entries of @p queue that involve a ghost particle on this node. */
+std::vector<collision_struct>
+entries_with_ghost_partner(std::vector<collision_struct> const &queue) {
+  std::vector<collision_struct> entries;
+  std::copy_if(queue.begin(), queue.end(), std::back_inserter(entries),
+               has_ghost_partner);
+  return entries;
+}
+
+/** Sort entries by particle ids, so that all nodes process them in the
+ *  same order, and remove duplicates.
+ */
+void sort_unique(std::vector<collision_struct> &queue) {
+  auto const key = [](collision_struct const &c) {
+    return std::make_pair(std::min(c.pp1, c.pp2), std::max(c.pp1, c.pp2));
+  };
+  std::sort(queue.begin(), queue.end(),
+            [&key](collision_struct const &a, collision_struct const &b) {
+              return key(a) < key(b);
+            });
+  queue.erase(std::unique(queue.begin(), queue.end(),
+                          [&key](collision_struct const &a,
+                                 collision_struct const &b) {
+                            return key(a) == key(b);
+                          }),
+              queue.end());
+}
+
+#ifdef VIRTUAL_SITES_RELATIVE
+/**
+ * @brief Bind colliding particles via virtual sites at the point of
+ * collision.
+ *
+ * Both virtual sites are created by the node that detected the collision.
+ * The owners of the colliding particles only enable their rotation.
+ *
+ * @param local_queue Collisions detected on this node.
+ * @param received    Collisions detected on neighboring nodes.
+ * @return Whether particles were added on this node.
+ */
+bool bind_at_point_of_collision(
+    std::vector<collision_struct> const &local_queue,
+    std::vector<collision_struct> const &received) {
+  for (auto const &c : received) {
+    for (auto const id : {c.pp1, c.pp2}) {
+      auto p = cell_structure.get_local_particle(id);
+      if (is_local(p)) {
+        p->p.rotation = ROTATION_X | ROTATION_Y | ROTATION_Z;
+      }
+    }
+  }
+
+  for (auto const &c : local_queue) {
+    auto &p1 = get_part(c.pp1);
+    auto &p2 = get_part(c.pp2);
+
+    // Enable rotation on the particles to which vs will be attached
+    p1.p.rotation = ROTATION_X | ROTATION_Y | ROTATION_Z;
+    p2.p.rotation = ROTATION_X | ROTATION_Y | ROTATION_Z;
+
+    // Positions of the virtual sites
+    Utils::Vector3d pos1, pos2;
+    bind_at_point_of_collision_calc_vs_pos(&p1, &p2, pos1, pos2);
 
-std::vector<collision_struct> gather_global_collision_queue() {
-  std::vector<collision_struct> res = local_collision_queue;
-  Utils::Mpi::gather_buffer(res, comm_cart);
-  boost::mpi::broadcast(comm_cart, res, 0);
+    // Particle storage locations may change when adding particles,
+    // so p1 and p2 are not used after this point
+    auto const vs_pid1 = vs_ids.next();
+    auto const vs_pid2 = vs_ids.next();
+    place_vs_and_relate_to_particle(vs_pid1, pos1, c.pp1);
+    place_vs_and_relate_to_particle(vs_pid2, pos2, c.pp2);
 
-  return res;
+    bind_at_poc_create_bond_between_vs(vs_pid1, vs_pid2, c);
+  }
+
+  return not local_queue.empty();
 }
 
+/**
+ * @brief Glue particles to the surface they collided with.
+ *
+ * Each collision is handled by the owner of the particle to be glued
+ * (stored in @c pp1), which knows all collisions of that particle
+ * in this time step.
+ *
+ * @param queue Collisions detected on this node and its neighbors.
+ * @return Whether particles were added on this node.
+ */
+bool glue_to_surface(std::vector<collision_struct> const &queue) {
+  bool added = false;
+  for (auto const &c : queue) {
+    auto const *p1 = cell_structure.get_local_particle(c.pp1);
+    auto const *p2 = cell_structure.get_local_particle(c.pp2);
+    if (not is_local(p1) or not p2) {
+      continue;
+    }
+
+    // If particles are made inert by a type change on collision:
+    // We skip the pair if one of the particles has already reacted
+    if (collision_params.part_type_after_glueing !=
+        collision_params.part_type_to_be_glued) {
+      if ((p1->p.type == collision_params.part_type_after_glueing) ||
+          (p2->p.type == collision_params.part_type_after_glueing)) {
+        continue;
+      }
+    }
+
+    Utils::Vector3d pos;
+    auto const attach_to =
+        glue_to_surface_calc_vs_pos(*p1, *p2, pos).identity();
+
+    // Add a bond between the centers of the colliding particles
+    const int bondG[] = {c.pp2};
+    get_part(c.pp1).bonds().insert({collision_params.bond_centers, bondG});
+
+    // Change type of particle being attached, to make it inert
+    get_part(c.pp1).p.type = collision_params.part_type_after_glueing;
+
+    auto const vs_pid = vs_ids.next();
+    place_vs_and_relate_to_particle(vs_pid, pos, attach_to);
+
+    // Bind the glued particle to the vs
+    const int bondVs[] = {vs_pid};
+    get_part(c.pp1).bonds().insert({collision_params.bond_vs, bondVs});
+
+    added = true;
+  }
+
+  return added;
+}
+#endif
+} // namespace
+
 static void three_particle_binding_do_search(Cell *basecell, Particle &p1,
                                              Particle &p2) {
   auto handle_cell = [&p1, &p2](Cell *c) {
@@ -527,148 +719,34 @@ void handle_collisions() {
 #ifdef VIRTUAL_SITES_RELATIVE
   if ((collision_params.mode & COLLISION_MODE_VS) ||
       (collision_params.mode & COLLISION_MODE_GLUE_TO_SURF)) {
-    // Gather the global collision queue, because only one node has a collision
-    // across node boundaries in its queue.
-    // The other node might still have to change particle properties on its
-    // non-ghost particle
-    auto gathered_queue = gather_global_collision_queue();
-
-    // Sync max_seen_part
-    auto const global_max_seen_particle = boost::mpi::all_reduce(
-        comm_cart, cell_structure.get_max_local_particle_id(),
-        boost::mpi::maximum<int>());
-
-    int current_vs_pid = global_max_seen_particle + 1;
-
-    // Iterate over global collision queue
-    for (auto &c : gathered_queue) {
-
-      // Get particle pointers
-      Particle *p1 = cell_structure.get_local_particle(c.pp1);
-      Particle *p2 = cell_structure.get_local_particle(c.pp2);
-
-      // Only nodes take part in particle creation and binding
-      // that see both particles
-
-      // If we cannot access both particles, both are ghosts,
-      // or one is ghost and one is not accessible
-      // we only increase the counter for the ext id to use based on the
-      // number of particles created by other nodes
-      if (((!p1 or p1->l.ghost) and (!p2 or p2->l.ghost)) or !p1 or !p2) {
-        // Increase local counters
-        if (collision_params.mode & COLLISION_MODE_VS) {
-          current_vs_pid++;
-        }
-        // For glue to surface, we have only one vs
-        current_vs_pid++;
-        if (collision_params.mode == COLLISION_MODE_GLUE_TO_SURF) {
-          if (p1)
-            if (p1->p.type == collision_params.part_type_to_be_glued) {
-              p1->p.type = collision_params.part_type_after_glueing;
-            }
-          if (p2)
-            if (p2->p.type == collision_params.part_type_to_be_glued) {
-              p2->p.type = collision_params.part_type_after_glueing;
-            }
-        } // mode glue to surface
-
-      } else { // We consider the pair because one particle
-               // is local to the node and the other is local or ghost
-        // If we are in the two vs mode
-        // Virtual site related to first particle in the collision
-        if (collision_params.mode & COLLISION_MODE_VS) {
-          Utils::Vector3d pos1, pos2;
-
-          // Enable rotation on the particles to which vs will be attached
-          p1->p.rotation = ROTATION_X | ROTATION_Y | ROTATION_Z;
-          p2->p.rotation = ROTATION_X | ROTATION_Y | ROTATION_Z;
-
-          // Positions of the virtual sites
-          bind_at_point_of_collision_calc_vs_pos(p1, p2, pos1, pos2);
-
-          auto handle_particle = [&](Particle *p, Utils::Vector3d const &pos) {
-            if (not p->l.ghost) {
-              place_vs_and_relate_to_particle(current_vs_pid, pos,
-                                              p->identity());
-              // Particle storage locations may have changed due to
-              // added particle
-              p1 = cell_structure.get_local_particle(c.pp1);
-              p2 = cell_structure.get_local_particle(c.pp2);
-            }
-          };
-
-          // place virtual sites on the node where the base particle is not a
-          // ghost
-          handle_particle(p1, pos1);
-          // Increment counter
-          current_vs_pid++;
-
-          handle_particle(p2, pos2);
-          // Increment counter
-          current_vs_pid++;
-          // Create bonds between the vs.
-
-          bind_at_poc_create_bond_between_vs(current_vs_pid, c);
-        } // mode VS
-
-        if (collision_params.mode & COLLISION_MODE_GLUE_TO_SURF) {
-          // If particles are made inert by a type change on collision:
-          // We skip the pair if one of the particles has already reacted
-          // but we still increase the particle counters, as other nodes
-          // can not always know whether or not a vs is placed
-          if (collision_params.part_type_after_glueing !=
-              collision_params.part_type_to_be_glued) {
-            if ((p1->p.type == collision_params.part_type_after_glueing) ||
-                (p2->p.type == collision_params.part_type_after_glueing)) {
-              current_vs_pid++;
-              continue;
-            }
-          }
-
-          Utils::Vector3d pos;
-          const Particle &attach_vs_to =
-              glue_to_surface_calc_vs_pos(*p1, *p2, pos);
-
-          // Add a bond between the centers of the colliding particles
-          // The bond is placed on the node that has p1
-          if (!p1->l.ghost) {
-            const int bondG[] = {c.pp2};
-            get_part(c.pp1).bonds().insert(
-                {collision_params.bond_centers, bondG});
-          }
-
-          // Change type of particle being attached, to make it inert
-          if (p1->p.type == collision_params.part_type_to_be_glued) {
-            p1->p.type = collision_params.part_type_after_glueing;
-          }
-          if (p2->p.type == collision_params.part_type_to_be_glued) {
-            p2->p.type = collision_params.part_type_after_glueing;
-          }
-
-          // Vs placement happens on the node that has p1
-          if (!attach_vs_to.l.ghost) {
-            place_vs_and_relate_to_particle(current_vs_pid, pos,
-                                            attach_vs_to.identity());
-            // Particle storage locations may have changed due to
-            // added particle
-            p1 = cell_structure.get_local_particle(c.pp1);
-            p2 = cell_structure.get_local_particle(c.pp2);
-            current_vs_pid++;
-          } else { // Just update the books
-            current_vs_pid++;
-          }
-          glue_to_surface_bind_part_to_vs(p1, p2, current_vs_pid, c);
+    bool added_particles = false;
+
+    if (collision_params.mode & COLLISION_MODE_VS) {
+      // A collision across a node boundary is only queued on one node,
+      // the owner of the other particle learns about it from its neighbor.
+      auto const received = exchange_with_neighbors(
+          entries_with_ghost_partner(local_collision_queue));
+      added_particles =
+          bind_at_point_of_collision(local_collision_queue, received);
+    } else {
+      // The particle to be glued goes first, the types have not
+      // changed since the collision was detected.
+      for (auto &c : local_collision_queue) {
+        if (get_part(c.pp1).p.type != collision_params.part_type_to_be_glued) {
+          std::swap(c.pp1, c.pp2);
         }
-      } // we considered the pair
-    }   // Loop over all collisions in the queue
-#ifdef ADDITIONAL_CHECKS
-    if (!Utils::Mpi::all_compare(comm_cart, current_vs_pid)) {
-      throw std::runtime_error("Nodes disagree about current_vs_pid");
+      }
+      auto queue = exchange_with_neighbors(
+          entries_with_ghost_partner(local_collision_queue));
+      queue.insert(queue.end(), local_collision_queue.begin(),
+                   local_collision_queue.end());
+      sort_unique(queue);
+      added_particles = glue_to_surface(queue);
     }
-#endif
 
-    // If any node had a collision, all nodes need to resort
-    if (!gathered_queue.empty()) {
+    // If any node added particles, all nodes need to resort
+    if (boost::mpi::all_reduce(comm_cart, added_particles,
+                               std::logical_or<bool>())) {
       cell_structure.set_resort_particles(Cells::RESORT_GLOBAL);
       cells_update_ghosts(Cells::DATA_PART_PROPERTIES | Cells::DATA_PART_BONDS);
     }
@@ -677,10 +755,34 @@ void handle_collisions() {
 
   // three-particle-binding part
   if (collision_params.mode & (COLLISION_MODE_BIND_THREE_PARTICLES)) {
-    auto gathered_queue = gather_global_collision_queue();
-    three_particle_binding_domain_decomposition(gathered_queue);
+    // Every node that can see a colliding particle is a neighbor of the
+    // owner of that particle. Collisions are therefore first sent to the
+    // owners, which forward them to their neighbors.
+    auto queue = exchange_with_neighbors(
+        entries_with_ghost_partner(local_collision_queue));
+    queue.insert(queue.end(), local_collision_queue.begin(),
+                 local_collision_queue.end());
+    sort_unique(queue);
+
+    std::vector<collision_struct> owned;
+    std::copy_if(queue.begin(), queue.end(), std::back_inserter(owned),
+                 [](collision_struct const &c) {
+                   return is_local(cell_structure.get_local_particle(c.pp1)) or
+                          is_local(cell_structure.get_local_particle(c.pp2));
+                 });
+    auto const forwarded = exchange_with_neighbors(owned);
+    queue.insert(queue.end(), forwarded.begin(), forwarded.end());
+    sort_unique(queue);
+
+    three_particle_binding_domain_decomposition(queue);
   } // if TPB
 
+  /* the new bonds are not part of the resolved bonds of the cell system */
+  cell_structure.invalidate_bond_topology();
+  /* nor of the energies and virials accumulated by the force calculation */
+  if (collision_params.mode != COLLISION_MODE_OFF)
+    fused_observables.invalidate();
+
   local_collision_queue.clear();
 }
 
@@ -21,7 +21,9 @@
 
 #include "Observable_stat.hpp"
 #include "Particle.hpp"
+#include "ParticleRange.hpp"
 #include "energy.hpp"
+#include "grid.hpp"
 
 namespace Constraints {
 class Constraint {
@@ -48,13 +50,36 @@ public:
   virtual ParticleForce force(const Particle &p,
                               const Utils::Vector3d &folded_pos, double t) = 0;
 
+  /**
+   * @brief Add the forces of the constraint to particles.
+   *
+   * @param[in,out] particles The particles to add the forces to.
+   * @param[in] t The time at which the forces should be calculated.
+   */
+  virtual void add_forces(const ParticleRange &particles, double t) {
+    for (auto &p : particles) {
+      p.f += force(p, folded_position(p.r.p, box_geo), t);
+    }
+  }
+
   /**
    * @brief Check if constraints if compatible with box size.
    */
   virtual bool fits_in_box(Utils::Vector3d const &box) const = 0;
 
+  /**
+   * @brief Check if the constraint only stores the data of the local box,
+   * which has to stay fixed.
+   */
+  virtual bool is_distributed() const { return false; }
+
   virtual void reset_force(){};
 
+  /**
+   * @brief Discard data derived from the geometry of the constraint.
+   */
+  virtual void invalidate_cache() {}
+
   virtual ~Constraint() = default;
 };
 } /* namespace Constraints */
@@ -73,14 +73,8 @@ public:
 
     reset_forces();
 
-    for (auto &p : particles) {
-      auto const pos = folded_position(p.r.p, box_geo);
-      ParticleForce force{};
-      for (auto const &c : *this) {
-        force += c->force(p, pos, t);
-      }
-
-      p.f += force;
+    for (auto const &c : *this) {
+      c->add_forces(particles, t);
     }
   }
 
@@ -95,6 +89,12 @@ public:
     }
   }
 
+  void invalidate_caches() const {
+    for (auto const &c : *this) {
+      c->invalidate_cache();
+    }
+  }
+
   void on_boxl_change() const {
     if (not this->empty()) {
       throw std::runtime_error("The box size can not be changed because there "
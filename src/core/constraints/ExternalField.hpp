@@ -20,6 +20,7 @@
 #define CONSTRAINTS_EXTERNAL_FIELD_HPP
 
 #include "Constraint.hpp"
+#include "errorhandling.hpp"
 #include "field_coupling/ForceField.hpp"
 
 namespace Constraints {
@@ -45,9 +46,26 @@ public:
     return impl.force(p, folded_pos, t);
   }
 
+  void add_forces(const ParticleRange &particles, double t) override {
+    for (auto &p : particles) {
+      auto const pos = folded_position(p.r.p, box_geo);
+      if (not impl.field().covers(pos)) {
+        runtimeErrorMsg() << "Particle " << p.p.identity << " at " << pos
+                          << " is outside of the local grid of a "
+                          << "distributed field.";
+        continue;
+      }
+      p.f.f += impl.force(p, pos, t);
+    }
+  }
+
   bool fits_in_box(Utils::Vector3d const &box) const override {
     return impl.field().fits_in_box(box);
   }
+
+  bool is_distributed() const override {
+    return impl.field().is_distributed();
+  }
 };
 } /* namespace Constraints */
 
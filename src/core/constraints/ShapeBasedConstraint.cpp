@@ -27,6 +27,7 @@
 #include "errorhandling.hpp"
 #include "forces_inline.hpp"
 #include "grid.hpp"
+#include "integrate.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "thermostat.hpp"
 
@@ -38,6 +39,8 @@
 #include <functional>
 #include <limits>
 #include <numeric>
+#include <stdexcept>
+#include <utility>
 
 namespace Constraints {
 Utils::Vector3d ShapeBasedConstraint::total_force() const {
@@ -70,6 +73,89 @@ double ShapeBasedConstraint::min_dist(const ParticleRange &particles) {
   return global_mindist;
 }
 
+void ShapeBasedConstraint::set_distance_grid_spacing(double spacing) {
+  if (spacing < 0.) {
+    throw std::domain_error("The distance grid spacing must be >= 0");
+  }
+  m_distance_grid_spacing = spacing;
+  invalidate_cache();
+}
+
+void ShapeBasedConstraint::shape_dist(const Utils::Vector3d &pos,
+                                      double &dist,
+                                      Utils::Vector3d &vec) const {
+  auto const *grid = distance_grid();
+  if (not grid or not grid->calculate_dist(pos, dist, vec)) {
+    m_shape->calculate_dist(pos, dist, vec);
+  }
+}
+
+CullingGrid const *ShapeBasedConstraint::culling_grid() const {
+#ifdef DPD
+  /* the DPD noise is drawn for all particles in front of the shape */
+  if (thermo_switch & THERMO_DPD)
+    return nullptr;
+#endif
+  if (part_rep.p.type < 0)
+    return nullptr;
+
+  auto cutoff = INACTIVE_CUTOFF;
+  for (int type = 0; type < max_seen_particle_type; type++) {
+    cutoff = std::max(cutoff, get_ia_param(type, part_rep.p.type)->max_cut);
+  }
+  /* particles can leave the local box by up to half the skin */
+  auto const halo = Utils::Vector3d::broadcast(skin);
+  auto const lower = local_geo.my_left() - halo;
+  auto const upper = local_geo.my_right() + halo;
+
+  auto const &cached = m_culling_parameters;
+  if (not m_culling_grid or cached.lower != lower or cached.upper != upper or
+      cached.cutoff != cutoff or cached.penetrable != m_penetrable or
+      cached.only_positive != m_only_positive) {
+    m_culling_grid = CullingGrid(*m_shape, lower, upper, cutoff,
+                                 m_penetrable, m_only_positive);
+    m_culling_parameters = {lower, upper, cutoff, m_penetrable,
+                            m_only_positive};
+  }
+  return m_culling_grid.get_ptr();
+}
+
+SignedDistanceGrid const *ShapeBasedConstraint::distance_grid() const {
+  if (m_distance_grid_spacing <= 0.)
+    return nullptr;
+
+  auto const halo = Utils::Vector3d::broadcast(skin);
+  auto const box = std::make_pair(local_geo.my_left() - halo,
+                                  local_geo.my_right() + halo);
+  if (not m_distance_grid_box or *m_distance_grid_box != box) {
+    m_distance_grid_box = box;
+    m_distance_grid = boost::none;
+    if (SignedDistanceGrid::size(box.first, box.second,
+                                 m_distance_grid_spacing) >
+        SignedDistanceGrid::max_size) {
+      runtimeWarningMsg() << "The distance grid spacing "
+                          << m_distance_grid_spacing
+                          << " is too small for the local box, the distance "
+                          << "to the shape is evaluated exactly";
+    } else {
+      m_distance_grid = SignedDistanceGrid(*m_shape, box.first, box.second,
+                                           m_distance_grid_spacing);
+    }
+  }
+  return m_distance_grid.get_ptr();
+}
+
+void ShapeBasedConstraint::add_forces(const ParticleRange &particles,
+                                      double t) {
+  auto const *culling = culling_grid();
+  for (auto &p : particles) {
+    auto const pos = folded_position(p.r.p, box_geo);
+    if (culling and not culling->may_interact(pos))
+      continue;
+    p.f += force(p, pos, t);
+  }
+}
+
 ParticleForce ShapeBasedConstraint::force(Particle const &p,
                                           Utils::Vector3d const &folded_pos,
                                           double t) {
@@ -79,7 +165,7 @@ ParticleForce ShapeBasedConstraint::force(Particle const &p,
   if (checkIfInteraction(ia_params)) {
     double dist = 0.;
     Utils::Vector3d dist_vec;
-    m_shape->calculate_dist(folded_pos, dist, dist_vec);
+    shape_dist(folded_pos, dist, dist_vec);
 
 #ifdef DPD
     Utils::Vector3d dpd_force{};
@@ -135,11 +221,13 @@ void ShapeBasedConstraint::add_energy(const Particle &p,
   double energy = 0.0;
 
   IA_parameters const &ia_params = *get_ia_param(p.p.type, part_rep.p.type);
+  auto const *culling = culling_grid();
 
-  if (checkIfInteraction(ia_params)) {
+  if (checkIfInteraction(ia_params) and
+      (not culling or culling->may_interact(folded_pos))) {
     double dist = 0.0;
     Utils::Vector3d vec;
-    m_shape->calculate_dist(folded_pos, dist, vec);
+    shape_dist(folded_pos, dist, vec);
     if (dist > 0) {
       energy = calc_non_bonded_pair_energy(p, part_rep, ia_params, vec, dist);
     } else if ((dist <= 0) && m_penetrable) {
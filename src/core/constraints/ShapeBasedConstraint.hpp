@@ -23,6 +23,7 @@
 #include "Observable_stat.hpp"
 #include "Particle.hpp"
 #include "ParticleRange.hpp"
+#include "constraints/ShapeGrids.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 
 #include <shapes/NoWhere.hpp>
@@ -30,7 +31,10 @@
 
 #include <utils/Vector.hpp>
 
+#include <boost/optional.hpp>
+
 #include <memory>
+#include <utility>
 
 namespace Constraints {
 
@@ -48,6 +52,14 @@ public:
   ParticleForce force(const Particle &p, const Utils::Vector3d &folded_pos,
                       double t) override;
 
+  /**
+   * @brief Add the forces of the constraint to particles.
+   *
+   * Particles in cells of the local box in which the shape is beyond
+   * the interaction range are skipped, see @ref CullingGrid.
+   */
+  void add_forces(const ParticleRange &particles, double t) override;
+
   bool fits_in_box(Utils::Vector3d const &) const override { return true; }
 
   /* finds the minimum distance to all particles */
@@ -61,10 +73,26 @@ public:
 
   void set_shape(std::shared_ptr<Shapes::Shape> const &shape) {
     m_shape = shape;
+    invalidate_cache();
   }
 
   Shapes::Shape const &shape() const { return *m_shape; }
 
+  /**
+   * @brief Tabulate the distance to the shape on the local box.
+   *
+   * @param spacing Grid spacing, 0 to evaluate the distance on the
+   *                shape.
+   */
+  void set_distance_grid_spacing(double spacing);
+  double distance_grid_spacing() const { return m_distance_grid_spacing; }
+
+  void invalidate_cache() override {
+    m_culling_grid = boost::none;
+    m_distance_grid = boost::none;
+    m_distance_grid_box = boost::none;
+  }
+
   void reset_force() override {
     m_local_force = Utils::Vector3d{0, 0, 0};
     m_outer_normal_force = 0.0;
@@ -84,6 +112,18 @@ public:
   double total_normal_force() const;
 
 private:
+  /** Distance to the shape, interpolated on the distance grid if
+   *  possible.
+   */
+  void shape_dist(const Utils::Vector3d &pos, double &dist,
+                  Utils::Vector3d &vec) const;
+  /** Culling grid of the current local box and interactions, nullptr if
+   *  all particles have to be evaluated.
+   */
+  CullingGrid const *culling_grid() const;
+  /** Distance grid of the current local box, nullptr if there is none. */
+  SignedDistanceGrid const *distance_grid() const;
+
   Particle part_rep;
 
   /** Private data members */
@@ -93,6 +133,25 @@ private:
   bool m_only_positive;
   Utils::Vector3d m_local_force;
   double m_outer_normal_force;
+
+  double m_distance_grid_spacing = 0.;
+
+  /** Parameters for which the culling grid was built. */
+  struct CullingParameters {
+    Utils::Vector3d lower;
+    Utils::Vector3d upper;
+    double cutoff;
+    bool penetrable;
+    bool only_positive;
+  };
+  mutable boost::optional<CullingGrid> m_culling_grid;
+  mutable CullingParameters m_culling_parameters;
+  mutable boost::optional<SignedDistanceGrid> m_distance_grid;
+  /** Box for which the distance grid was built, none if it is out of
+   *  date.
+   */
+  mutable boost::optional<std::pair<Utils::Vector3d, Utils::Vector3d>>
+      m_distance_grid_box;
 };
 
 } // namespace Constraints
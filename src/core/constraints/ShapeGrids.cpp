@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "constraints/ShapeGrids.hpp"
+
+#include <shapes/Shape.hpp>
+
+#include <utils/Vector.hpp>
+#include <utils/interpolation/bspline_3d.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace Constraints {
+namespace {
+/** Distance to a shape, NaN if it isn't defined at pos. */
+double shape_dist(Shapes::Shape const &shape, Utils::Vector3d const &pos,
+                  Utils::Vector3d &vec) {
+  double dist;
+  try {
+    shape.calculate_dist(pos, dist, vec);
+  } catch (std::domain_error const &) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return dist;
+}
+} // namespace
+
+constexpr int CullingGrid::max_cells;
+constexpr std::size_t SignedDistanceGrid::max_size;
+
+CullingGrid::CullingGrid(Shapes::Shape const &shape,
+                         Utils::Vector3d const &lower,
+                         Utils::Vector3d const &upper, double cutoff,
+                         bool penetrable, bool only_positive)
+    : m_lower(lower) {
+  Utils::Vector3d cell_size;
+  std::size_t n_cells = 1;
+  for (unsigned int i = 0; i < 3; i++) {
+    /* cells of half the cutoff */
+    auto const length = upper[i] - lower[i];
+    auto const n = std::ceil(2. * length / std::max(cutoff, 1e-3 * length));
+    m_n_cells[i] = std::max(1, std::min(max_cells, static_cast<int>(n)));
+    cell_size[i] = length / m_n_cells[i];
+    m_inv_cell_size[i] = 1. / cell_size[i];
+    n_cells *= static_cast<std::size_t>(m_n_cells[i]);
+  }
+
+  /* the distance varies at most by the half diagonal within a cell,
+   * with a margin for rounding errors */
+  auto const radius = 0.5 * cell_size.norm() * (1. + 1e-10);
+  /* smallest distance at which the constraint acts */
+  auto const min_dist =
+      penetrable ? (only_positive ? 0. : -cutoff)
+                 : -std::numeric_limits<double>::infinity();
+
+  m_active.resize(n_cells);
+  auto active = m_active.begin();
+  for (int i = 0; i < m_n_cells[0]; i++)
+    for (int j = 0; j < m_n_cells[1]; j++)
+      for (int k = 0; k < m_n_cells[2]; k++) {
+        auto const center =
+            lower + Utils::hadamard_product(
+                        Utils::Vector3d{i + .5, j + .5, k + .5}, cell_size);
+        Utils::Vector3d vec;
+        auto const dist = shape_dist(shape, center, vec);
+        /* cells in which the distance isn't defined stay active */
+        *active++ = not(dist - radius >= cutoff or dist + radius <= min_dist);
+      }
+}
+
+double CullingGrid::active_fraction() const {
+  return static_cast<double>(
+             std::count(m_active.begin(), m_active.end(), char{1})) /
+         static_cast<double>(m_active.size());
+}
+
+ShapeGridGeometry SignedDistanceGrid::geometry(Utils::Vector3d const &lower,
+                                               Utils::Vector3d const &upper,
+                                               double spacing) {
+  ShapeGridGeometry geometry;
+  geometry.origin = lower - Utils::Vector3d::broadcast(spacing);
+  geometry.spacing = Utils::Vector3d::broadcast(spacing);
+  for (unsigned int i = 0; i < 3; i++) {
+    /* one grid point beyond the box on both sides */
+    geometry.shape[i] =
+        static_cast<int>(std::ceil((upper[i] - lower[i]) / spacing)) + 3;
+  }
+  return geometry;
+}
+
+SignedDistanceGrid::SignedDistanceGrid(Shapes::Shape const &shape,
+                                       Utils::Vector3d const &lower,
+                                       Utils::Vector3d const &upper,
+                                       double spacing)
+    : m_geometry(geometry(lower, upper, spacing)) {
+  auto const nan = std::numeric_limits<double>::quiet_NaN();
+  auto const &n = m_geometry.shape;
+
+  m_values.resize(m_geometry.size());
+  auto value = m_values.begin();
+  for (int i = 0; i < n[0]; i++)
+    for (int j = 0; j < n[1]; j++)
+      for (int k = 0; k < n[2]; k++) {
+        auto const pos = m_geometry.origin +
+                         spacing * Utils::Vector3d{static_cast<double>(i),
+                                                   static_cast<double>(j),
+                                                   static_cast<double>(k)};
+        Utils::Vector3d vec;
+        auto const dist = shape_dist(shape, pos, vec);
+        /* the direction is undefined on the surface */
+        if (std::isnan(dist) or dist == 0.) {
+          *value++ = {nan, nan, nan, nan};
+        } else {
+          auto const dir = vec / dist;
+          *value++ = {dist, dir[0], dir[1], dir[2]};
+        }
+      }
+}
+
+bool SignedDistanceGrid::calculate_dist(Utils::Vector3d const &pos,
+                                        double &dist,
+                                        Utils::Vector3d &vec) const {
+  auto const &n = m_geometry.shape;
+  for (unsigned int i = 0; i < 3; i++) {
+    auto const x = (pos[i] - m_geometry.origin[i]) / m_geometry.spacing[i];
+    if (not(x >= 0. and x < static_cast<double>(n[i] - 1)))
+      return false;
+  }
+
+  using Utils::Interpolation::bspline_3d_accumulate;
+  auto const value = bspline_3d_accumulate<2>(
+      pos,
+      [this, &n](std::array<int, 3> const &ind) -> Utils::Vector<double, 4> {
+        auto const index =
+            (static_cast<std::size_t>(ind[0]) * n[1] + ind[1]) * n[2] + ind[2];
+        return m_values[index];
+      },
+      m_geometry.spacing, m_geometry.origin, Utils::Vector<double, 4>{});
+
+  Utils::Vector3d const dir{value[1], value[2], value[3]};
+  auto const dir_norm = dir.norm();
+  /* NaN in the stencil or strongly diverging directions */
+  if (not(dir_norm >= 0.99))
+    return false;
+
+  dist = value[0];
+  vec = (dist / dir_norm) * dir;
+  return true;
+}
+
+} // namespace Constraints
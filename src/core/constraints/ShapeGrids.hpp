@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_CONSTRAINTS_SHAPE_GRIDS_HPP
+#define CORE_CONSTRAINTS_SHAPE_GRIDS_HPP
+/** \file
+ *  Grids which accelerate the distance queries of shape based
+ *  constraints on the local box of a node.
+ *
+ *  Both grids rely on the distances of the shapes being Euclidean
+ *  distances to the surface, i.e. the distance changes at most by
+ *  @f$ |\Delta x| @f$ if a position moves by @f$ \Delta x @f$.
+ *  Positions outside of the grids have to be evaluated on the shape.
+ *
+ *  Implementation in ShapeGrids.cpp.
+ */
+
+#include <shapes/Shape.hpp>
+
+#include <utils/Vector.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Constraints {
+
+/** Regular grid over a box. */
+struct ShapeGridGeometry {
+  /** Position of the first grid point. */
+  Utils::Vector3d origin;
+  Utils::Vector3d spacing;
+  /** Number of grid points in each direction. */
+  Utils::Vector3i shape;
+
+  std::size_t size() const {
+    return static_cast<std::size_t>(shape[0]) *
+           static_cast<std::size_t>(shape[1]) *
+           static_cast<std::size_t>(shape[2]);
+  }
+};
+
+/**
+ * @brief Cells of the local box in which a constraint can act on
+ *        particles.
+ *
+ * A cell is inactive if the distance to the shape is beyond the cutoff
+ * everywhere in the cell, or if the particles in the cell are on the
+ * negative side of a penetrable shape which only acts on the positive
+ * side. Particles inside of a non-penetrable shape are always evaluated,
+ * such that the violation of the constraint is reported.
+ */
+class CullingGrid {
+public:
+  /** Largest number of cells in each direction. */
+  static constexpr int max_cells = 32;
+
+  /**
+   * @param shape          The shape.
+   * @param lower          Lower corner of the box.
+   * @param upper          Upper corner of the box.
+   * @param cutoff         Largest distance at which the constraint acts.
+   * @param penetrable     Whether particles may enter the shape.
+   * @param only_positive  Whether the constraint only acts on the
+   *                       positive side.
+   */
+  CullingGrid(Shapes::Shape const &shape, Utils::Vector3d const &lower,
+              Utils::Vector3d const &upper, double cutoff, bool penetrable,
+              bool only_positive);
+
+  /** Whether the constraint can act on a particle at pos. */
+  bool may_interact(Utils::Vector3d const &pos) const {
+    std::size_t index = 0;
+    for (unsigned int i = 0; i < 3; i++) {
+      auto const x = (pos[i] - m_lower[i]) * m_inv_cell_size[i];
+      if (not(x >= 0. and x < static_cast<double>(m_n_cells[i])))
+        return true;
+      index = index * static_cast<std::size_t>(m_n_cells[i]) +
+              static_cast<std::size_t>(x);
+    }
+    return m_active[index];
+  }
+
+  /** Fraction of the cells in which the constraint can act. */
+  double active_fraction() const;
+
+private:
+  Utils::Vector3d m_lower;
+  Utils::Vector3d m_inv_cell_size;
+  Utils::Vector3i m_n_cells;
+  std::vector<char> m_active;
+};
+
+/**
+ * @brief Signed distance to a shape, tabulated on a grid.
+ *
+ * The distance and the direction of the distance vector are sampled at
+ * the grid points and interpolated linearly in between. The interpolated
+ * direction is renormalized, so that the distance vector has the length
+ * of the interpolated distance. Queries return false where the stencil
+ * contains grid points at which the shape couldn't be evaluated, or where
+ * the direction changes too much between neighboring grid points, e.g.
+ * close to the medial axis of a union.
+ */
+class SignedDistanceGrid {
+public:
+  /** Largest number of grid points. */
+  static constexpr std::size_t max_size = std::size_t{1} << 21u;
+
+  /**
+   * @param shape      The shape.
+   * @param lower      Lower corner of the box.
+   * @param upper      Upper corner of the box.
+   * @param spacing    Grid spacing.
+   */
+  SignedDistanceGrid(Shapes::Shape const &shape, Utils::Vector3d const &lower,
+                     Utils::Vector3d const &upper, double spacing);
+
+  /** Number of grid points needed for a box. */
+  static std::size_t size(Utils::Vector3d const &lower,
+                          Utils::Vector3d const &upper, double spacing) {
+    return geometry(lower, upper, spacing).size();
+  }
+
+  /**
+   * @brief Interpolated distance.
+   * @param[in]  pos   Position.
+   * @param[out] dist  Signed distance.
+   * @param[out] vec   Distance vector.
+   * @return Whether the interpolation is valid at pos.
+   */
+  bool calculate_dist(Utils::Vector3d const &pos, double &dist,
+                      Utils::Vector3d &vec) const;
+
+private:
+  static ShapeGridGeometry geometry(Utils::Vector3d const &lower,
+                                    Utils::Vector3d const &upper,
+                                    double spacing);
+
+  ShapeGridGeometry m_geometry;
+  /** Distance and unit direction at the grid points, NaN where the shape
+   *  couldn't be evaluated.
+   */
+  std::vector<Utils::Vector<double, 4>> m_values;
+};
+
+} // namespace Constraints
+
+#endif
@@ -35,6 +35,8 @@
 #include <utils/math/tensor_product.hpp>
 #include <utils/matrix.hpp>
 
+#include <tuple>
+
 namespace Coulomb {
 inline Utils::Vector3d central_force(double const q1q2,
                                      Utils::Vector3d const &d, double dist) {
@@ -69,11 +71,15 @@ inline Utils::Vector3d central_force(double const q1q2,
   return coulomb.prefactor * f;
 }
 
+/** Short-range %Coulomb forces of a pair of charges at @p pos1 and
+ *  @p pos2. The forces are linear in @p q1q2.
+ *  @return The central force on the first charge, and the forces of the
+ *          dielectric image charges on the first and second charge.
+ */
 inline std::tuple<Utils::Vector3d, Utils::Vector3d, Utils::Vector3d>
-pair_force(Particle const &p1, Particle const &p2, Utils::Vector3d const &d,
+pair_force(double const q1q2, Utils::Vector3d const &pos1,
+           Utils::Vector3d const &pos2, Utils::Vector3d const &d,
            double dist) {
-  auto const q1q2 = p1.p.q * p2.p.q;
-
   if (q1q2 == 0) {
     return {};
   }
@@ -86,10 +92,10 @@ pair_force(Particle const &p1, Particle const &p2, Utils::Vector3d const &d,
 
     auto const f1 =
         coulomb.prefactor *
-        ELC_P3M_dielectric_layers_force_contribution(p2.r.p, p1.r.p, q1q2);
+        ELC_P3M_dielectric_layers_force_contribution(pos2, pos1, q1q2);
     auto const f2 =
         coulomb.prefactor *
-        ELC_P3M_dielectric_layers_force_contribution(p1.r.p, p2.r.p, q1q2);
+        ELC_P3M_dielectric_layers_force_contribution(pos1, pos2, q1q2);
 
     return {force, f1, f2};
   }
@@ -98,6 +104,12 @@ pair_force(Particle const &p1, Particle const &p2, Utils::Vector3d const &d,
   return {force, {}, {}};
 }
 
+inline std::tuple<Utils::Vector3d, Utils::Vector3d, Utils::Vector3d>
+pair_force(Particle const &p1, Particle const &p2, Utils::Vector3d const &d,
+           double dist) {
+  return pair_force(p1.p.q * p2.p.q, p1.r.p, p2.r.p, d, dist);
+}
+
 /**
  * @brief Pair contribution to the pressure tensor.
  *
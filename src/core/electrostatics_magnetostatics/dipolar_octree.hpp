@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_DIPOLAR_OCTREE_HPP
+#define ESPRESSO_DIPOLAR_OCTREE_HPP
+/** \file
+ *  Octree of point dipoles for the Barnes-Hut approximation of the
+ *  dipole-dipole interaction.
+ *
+ *  Every node of the tree stores the total dipole moment of its dipoles,
+ *  located at their center weighted by the dipole magnitudes. A node is
+ *  treated as a single dipole when its edge length is smaller than
+ *  @p theta times its distance to the target, otherwise its children are
+ *  visited. The dipoles of the leaves are summed up exactly.
+ */
+
+#include <utils/Vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+class DipolarOctree {
+public:
+  /** Energy, force and torque on a dipole, without the prefactor. */
+  struct Result {
+    double energy = 0.;
+    Utils::Vector3d force = {};
+    Utils::Vector3d torque = {};
+  };
+
+  /** Maximal depth of the tree, deeper nodes are leaves regardless of
+   *  their size. This bounds the recursion for coincident dipoles.
+   */
+  static constexpr int max_depth = 32;
+
+  /** @brief Build the tree.
+   *  @param pos        positions of the dipoles
+   *  @param dip        dipole moments
+   *  @param leaf_size  maximal number of dipoles in a leaf
+   */
+  DipolarOctree(std::vector<Utils::Vector3d> const &pos,
+                std::vector<Utils::Vector3d> const &dip, int leaf_size)
+      : m_leaf_size(leaf_size) {
+    assert(pos.size() == dip.size());
+    assert(leaf_size >= 1);
+    auto const n = pos.size();
+    if (n == 0)
+      return;
+
+    std::vector<int> order(n);
+    for (std::size_t i = 0; i < n; i++)
+      order[i] = static_cast<int>(i);
+
+    Utils::Vector3d lower = pos[0], upper = pos[0];
+    for (auto const &p : pos) {
+      for (int d = 0; d < 3; d++) {
+        lower[d] = std::min(lower[d], p[d]);
+        upper[d] = std::max(upper[d], p[d]);
+      }
+    }
+    auto const edge = std::max(
+        {upper[0] - lower[0], upper[1] - lower[1], upper[2] - lower[2]});
+    auto const half_edge =
+        0.5 * std::max(edge, std::numeric_limits<double>::min()) *
+        (1. + 4. * std::numeric_limits<double>::epsilon());
+
+    std::vector<int> buffer(n);
+    m_nodes.emplace_back();
+    build(0, pos, order, buffer, 0, static_cast<int>(n), 0.5 * (lower + upper),
+          half_edge, 0);
+
+    m_pos.resize(n);
+    m_dip.resize(n);
+    m_slot.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+      m_pos[i] = pos[order[i]];
+      m_dip[i] = dip[order[i]];
+      m_slot[order[i]] = static_cast<int>(i);
+    }
+    for (auto &node : m_nodes) {
+      finalize(node);
+    }
+  }
+
+  /** @brief Interaction of a dipole with all dipoles of the tree.
+   *  @param[in]     pos         position of the target
+   *  @param[in]     dip         dipole moment of the target
+   *  @param[in]     theta       opening angle, 0 for the exact sum
+   *  @param[in]     skip        index of a dipole of the tree to leave
+   *                             out, or -1
+   *  @param[in]     force_flag  calculate the force and torque
+   *  @param[in,out] result      accumulated energy, force and torque
+   */
+  void interaction(Utils::Vector3d const &pos, Utils::Vector3d const &dip,
+                   double theta, int skip, bool force_flag,
+                   Result &result) const {
+    if (m_nodes.empty())
+      return;
+    auto const skip_slot = (skip < 0) ? -1 : m_slot[skip];
+    auto const theta2 = theta * theta;
+
+    /* every level pushes at most 8 nodes and pops one */
+    std::array<int, 8 * (max_depth + 1)> stack;
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+      auto const &node = m_nodes[stack[--top]];
+      auto const contains_skip =
+          skip_slot >= node.begin and skip_slot < node.end;
+      if (not contains_skip) {
+        auto const dr = pos - node.center;
+        if (node.edge * node.edge < theta2 * dr.norm2()) {
+          kernel(dip, node.dip, dr, force_flag, result);
+          continue;
+        }
+      }
+      if (node.n_children == 0) {
+        for (int i = node.begin; i < node.end; i++) {
+          if (i != skip_slot)
+            kernel(dip, m_dip[i], pos - m_pos[i], force_flag, result);
+        }
+        continue;
+      }
+      for (int c = 0; c < node.n_children; c++)
+        stack[top++] = node.first_child + c;
+    }
+  }
+
+  /** Number of nodes, including the leaves. */
+  std::size_t n_nodes() const { return m_nodes.size(); }
+
+  /** @brief Dipole-dipole interaction.
+   *  @param[in]     dip1        dipole moment of the target
+   *  @param[in]     dip2        dipole moment of the source
+   *  @param[in]     dr          distance vector from the source to the target
+   *  @param[in]     force_flag  calculate the force and torque on the target
+   *  @param[in,out] result      accumulated energy, force and torque
+   */
+  static void kernel(Utils::Vector3d const &dip1, Utils::Vector3d const &dip2,
+                     Utils::Vector3d const &dr, bool force_flag,
+                     Result &result) {
+    auto const r2 = dr.norm2();
+    auto const r = std::sqrt(r2);
+    auto const r3 = r2 * r;
+    auto const r5 = r3 * r2;
+    auto const r7 = r5 * r2;
+
+    auto const pe1 = dip1 * dip2;
+    auto const pe2 = dip1 * dr;
+    auto const pe3 = dip2 * dr;
+    auto const pe4 = 3.0 / r5;
+
+    result.energy += pe1 / r3 - pe4 * pe2 * pe3;
+
+    if (force_flag) {
+      auto const ab = pe4 * pe1 - 15.0 * pe2 * pe3 / r7;
+      auto const cc = pe4 * pe3;
+      auto const dd = pe4 * pe2;
+      result.force += ab * dr + cc * dip1 + dd * dip2;
+      result.torque +=
+          -vector_product(dip1, dip2) / r3 + vector_product(dip1, dr) * cc;
+    }
+  }
+
+private:
+  struct Node {
+    /** Center of the dipoles, weighted by their magnitude. */
+    Utils::Vector3d center;
+    /** Total dipole moment. */
+    Utils::Vector3d dip;
+    /** Edge length of the cube. */
+    double edge;
+    /** Range of the dipoles in the sorted arrays. */
+    int begin, end;
+    /** The children are stored contiguously. */
+    int first_child = 0;
+    int n_children = 0;
+  };
+
+  int m_leaf_size;
+  std::vector<Node> m_nodes;
+  /** Positions and dipole moments, in tree order. */
+  std::vector<Utils::Vector3d> m_pos;
+  std::vector<Utils::Vector3d> m_dip;
+  /** Position of each input dipole in tree order. */
+  std::vector<int> m_slot;
+
+  /** Sort the dipoles of a node into octants and build its children. */
+  void build(int node_id, std::vector<Utils::Vector3d> const &pos,
+             std::vector<int> &order, std::vector<int> &buffer, int begin,
+             int end, Utils::Vector3d const &mid, double half_edge,
+             int depth) {
+    m_nodes[node_id].begin = begin;
+    m_nodes[node_id].end = end;
+    m_nodes[node_id].edge = 2. * half_edge;
+    m_nodes[node_id].center = mid;
+    if (end - begin <= m_leaf_size or depth >= max_depth)
+      return;
+
+    auto const octant = [&mid, &pos](int i) {
+      auto const &p = pos[i];
+      return int(p[0] >= mid[0]) + 2 * int(p[1] >= mid[1]) +
+             4 * int(p[2] >= mid[2]);
+    };
+
+    /* stable counting sort by octant */
+    std::array<int, 9> offsets{};
+    for (int i = begin; i < end; i++)
+      offsets[octant(order[i]) + 1]++;
+    for (int o = 0; o < 8; o++)
+      offsets[o + 1] += offsets[o];
+    auto fill = offsets;
+    for (int i = begin; i < end; i++)
+      buffer[begin + fill[octant(order[i])]++] = order[i];
+    std::copy(buffer.begin() + begin, buffer.begin() + end,
+              order.begin() + begin);
+
+    auto const first_child = static_cast<int>(m_nodes.size());
+    int n_children = 0;
+    for (int o = 0; o < 8; o++)
+      if (offsets[o + 1] > offsets[o])
+        n_children++;
+    m_nodes[node_id].first_child = first_child;
+    m_nodes[node_id].n_children = n_children;
+    m_nodes.resize(m_nodes.size() + n_children);
+
+    auto const quarter_edge = 0.5 * half_edge;
+    for (int o = 0, c = 0; o < 8; o++) {
+      if (offsets[o + 1] == offsets[o])
+        continue;
+      Utils::Vector3d const child_mid = {
+          mid[0] + ((o & 1) ? quarter_edge : -quarter_edge),
+          mid[1] + ((o & 2) ? quarter_edge : -quarter_edge),
+          mid[2] + ((o & 4) ? quarter_edge : -quarter_edge)};
+      build(first_child + c++, pos, order, buffer, begin + offsets[o],
+            begin + offsets[o + 1], child_mid, quarter_edge, depth + 1);
+    }
+  }
+
+  /** Total dipole moment and weighted center of a node. */
+  void finalize(Node &node) const {
+    Utils::Vector3d dip = {}, center = {};
+    double weight = 0.;
+    for (int i = node.begin; i < node.end; i++) {
+      auto const w = m_dip[i].norm();
+      dip += m_dip[i];
+      center += w * m_pos[i];
+      weight += w;
+    }
+    node.dip = dip;
+    if (weight > 0.)
+      node.center = center / weight;
+  }
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+#include "electrostatics_magnetostatics/dipolar_replicas.hpp"
+
+#include "communication.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <mpi.h>
+
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+int gather_dipoles(ParticleRange const &particles,
+                   std::vector<Utils::Vector3d> &pos,
+                   std::vector<Utils::Vector3d> &dip) {
+  std::vector<double> local;
+  for (auto const &p : particles) {
+    if (p.p.dipm != 0.0) {
+      /* here we wish the coordinates to be folded into the primary box */
+      auto const ppos = folded_position(p.r.p, box_geo);
+      auto const pdip = p.calc_dip();
+      local.insert(local.end(), ppos.begin(), ppos.end());
+      local.insert(local.end(), pdip.begin(), pdip.end());
+    }
+  }
+
+  auto const size = comm_cart.size();
+  auto const local_count = static_cast<int>(local.size());
+  std::vector<int> counts(size), displs(size);
+  MPI_Allgather(&local_count, 1, MPI_INT, counts.data(), 1, MPI_INT,
+                comm_cart);
+  std::partial_sum(counts.begin(), std::prev(counts.end()),
+                   std::next(displs.begin()));
+  auto const total = displs.back() + counts.back();
+
+  std::vector<double> global(total);
+  MPI_Allgatherv(local.data(), local_count, MPI_DOUBLE, global.data(),
+                 counts.data(), displs.data(), MPI_DOUBLE, comm_cart);
+
+  auto const n_dipoles = total / 6;
+  pos.resize(n_dipoles);
+  dip.resize(n_dipoles);
+  for (int i = 0; i < n_dipoles; i++) {
+    pos[i] = {global[6 * i + 0], global[6 * i + 1], global[6 * i + 2]};
+    dip[i] = {global[6 * i + 3], global[6 * i + 4], global[6 * i + 5]};
+  }
+
+  return displs[comm_cart.rank()] / 6;
+}
+
+std::vector<Utils::Vector3d> image_shifts(int n_replica) {
+  int n_cut[3];
+  for (int i = 0; i < 3; i++) {
+    n_cut[i] = box_geo.periodic(i) ? n_replica : 0;
+  }
+  auto const n_cut2 = Utils::sqr(n_replica);
+
+  std::vector<Utils::Vector3d> shifts;
+  for (int nx = -n_cut[0]; nx <= n_cut[0]; nx++) {
+    for (int ny = -n_cut[1]; ny <= n_cut[1]; ny++) {
+      for (int nz = -n_cut[2]; nz <= n_cut[2]; nz++) {
+        if (nx * nx + ny * ny + nz * nz <= n_cut2) {
+          shifts.push_back({nx * box_geo.length()[0],
+                            ny * box_geo.length()[1],
+                            nz * box_geo.length()[2]});
+        }
+      }
+    }
+  }
+  return shifts;
+}
+
+#endif // DIPOLES
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_DIPOLAR_REPLICAS_HPP
+#define ESPRESSO_DIPOLAR_REPLICAS_HPP
+/** \file
+ *  Helpers of the dipolar solvers which sum over all dipoles and their
+ *  periodic replicas, i.e. the direct sum and the Barnes-Hut method.
+ */
+
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+#include "ParticleRange.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <vector>
+
+/** Gather the folded positions and the dipole moments of all dipolar
+ *  particles on all nodes, ordered by node.
+ *  @param[in]  particles  local particles
+ *  @param[out] pos        folded positions
+ *  @param[out] dip        dipole moments
+ *  @return Index of the first local dipole.
+ */
+int gather_dipoles(ParticleRange const &particles,
+                   std::vector<Utils::Vector3d> &pos,
+                   std::vector<Utils::Vector3d> &dip);
+
+/** Shifts of the periodic images within the replica sphere.
+ *  @param n_replica  radius of the sphere in box lengths
+ */
+std::vector<Utils::Vector3d> image_shifts(int n_replica);
+
+#endif // DIPOLES
+#endif
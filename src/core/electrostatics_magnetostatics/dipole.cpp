@@ -26,6 +26,7 @@
 #include "actor/DipolarBarnesHut.hpp"
 #include "actor/DipolarDirectSum.hpp"
 #include "electrostatics_magnetostatics/common.hpp"
+#include "electrostatics_magnetostatics/magnetic_barnes_hut.hpp"
 #include "electrostatics_magnetostatics/magnetic_non_p3m_methods.hpp"
 #include "electrostatics_magnetostatics/mdlc_correction.hpp"
 #include "electrostatics_magnetostatics/p3m-common.hpp"
@@ -65,8 +66,8 @@ void calc_pressure_long_range() {
 }
 
 void nonbonded_sanity_check(int &state) {
-#ifdef DP3M
   switch (dipole.method) {
+#ifdef DP3M
   case DIPOLAR_MDLC_P3M:
     if (mdlc_sanity_checks())
       state = 0; // fall through
@@ -77,14 +78,18 @@ void nonbonded_sanity_check(int &state) {
   case DIPOLAR_MDLC_DS:
     if (mdlc_sanity_checks())
       state = 0; // fall through
+#endif
   case DIPOLAR_DS:
     if (magnetic_dipolar_direct_sum_sanity_checks())
       state = 0;
     break;
+  case DIPOLAR_BH_CPU:
+    if (dipolar_barnes_hut_sanity_checks())
+      state = 0;
+    break;
   default:
     break;
   }
-#endif
 }
 
 double cutoff(const Utils::Vector3d &box_l) {
@@ -193,6 +198,9 @@ void calc_long_range_force(const ParticleRange &particles) {
   case DIPOLAR_DS:
     magnetic_dipolar_direct_sum_calculations(true, false, particles);
     break;
+  case DIPOLAR_BH_CPU:
+    dipolar_barnes_hut_calculations(true, false, particles);
+    break;
   case DIPOLAR_DS_GPU: // NOLINT(bugprone-branch-clone)
     // do nothing: it's an actor
     break;
@@ -239,6 +247,9 @@ double calc_energy_long_range(const ParticleRange &particles) {
   case DIPOLAR_DS:
     energy = magnetic_dipolar_direct_sum_calculations(false, true, particles);
     break;
+  case DIPOLAR_BH_CPU:
+    energy = dipolar_barnes_hut_calculations(false, true, particles);
+    break;
   case DIPOLAR_DS_GPU: // NOLINT(bugprone-branch-clone)
     // do nothing: it's an actor
     break;
@@ -290,7 +301,16 @@ void bcast_params(const boost::mpi::communicator &comm) {
   case DIPOLAR_P3M:
     mpi::broadcast(comm, dp3m.params, 0);
     break;
+  case DIPOLAR_MDLC_DS:
+    mpi::broadcast(comm, dlc_params, 0);
+    // fall through
 #endif
+  case DIPOLAR_DS:
+    mpi::broadcast(comm, Ncut_off_magnetic_dipolar_direct_sum, 0);
+    break;
+  case DIPOLAR_BH_CPU:
+    mpi::broadcast(comm, dbh_params, 0);
+    break;
   default:
     break;
   }
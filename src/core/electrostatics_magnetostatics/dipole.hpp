@@ -47,6 +47,8 @@ enum DipolarInteraction {
   DIPOLAR_DS,
   /** Dipolar method is direct summation plus DLC. */
   DIPOLAR_MDLC_DS,
+  /** Dipolar method is the Barnes-Hut octree sum on CPU. */
+  DIPOLAR_BH_CPU,
   /** Dipolar method is direct summation on GPU. */
   DIPOLAR_DS_GPU,
 #ifdef DIPOLAR_BARNES_HUT
@@ -44,41 +44,271 @@
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
 
-#include <mpi.h>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/operations.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 icc_struct icc_cfg;
 
+namespace {
+bool is_icc_particle(Particle const &p) {
+  return p.p.identity >= icc_cfg.first_id &&
+         p.p.identity < icc_cfg.first_id + icc_cfg.n_icc;
+}
+
+/** Pair of ICC particles within the short-range cutoff. */
+struct IccPair {
+  Particle *p1;
+  Particle *p2;
+  /** Short-range force on @c p1 for unit charges */
+  Utils::Vector3d force1;
+  /** Short-range force on @c p2 for unit charges */
+  Utils::Vector3d force2;
+};
+
+/** Short-range interactions of the ICC particles. During the iteration
+ *  neither the source charges nor the ICC particles move, hence the field
+ *  of the source charges on the ICC particles is constant, and the pairs
+ *  of ICC particles do not change.
+ */
+struct IccShortRange {
+  /** Short-range field of the source charges on the local ICC particles */
+  std::vector<Utils::Vector3d> source_field;
+  /** Pairs of ICC particles */
+  std::vector<IccPair> pairs;
+};
+
 void init_forces_icc(const ParticleRange &particles,
-                     const ParticleRange &ghosts_particles);
+                     const ParticleRange &ghosts_particles) {
+  for (auto &p : particles) {
+    p.f.f = {};
+  }
+
+  for (auto &p : ghosts_particles) {
+    p.f.f = {};
+  }
+}
 
-/** Calculate the electrostatic forces between source charges (= real charges)
- *  and wall charges. For each electrostatic method, the proper functions
- *  for short- and long-range parts are called. Long-range parts are calculated
- *  directly, short-range parts need helper functions according to the particle
- *  data organisation. This is a modified version of \ref force_calc.
+/** Evaluate the short-range field of the source charges on the ICC
+ *  particles, and collect the pairs of ICC particles.
+ *  @param particles      local particles
+ *  @param ghost_particles ghost particles
+ *  @param icc_particles  local ICC particles
  */
-void force_calc_icc(const ParticleRange &particles,
-                    const ParticleRange &ghost_particles);
+IccShortRange
+init_short_range_icc(const ParticleRange &particles,
+                     const ParticleRange &ghost_particles,
+                     std::vector<Particle *> const &icc_particles) {
+  IccShortRange result;
+  init_forces_icc(particles, ghost_particles);
+
+  cell_structure.non_bonded_loop(
+      [&result](Particle &p1, Particle &p2, Distance const &d) {
+        auto const p1_icc = is_icc_particle(p1);
+        auto const p2_icc = is_icc_particle(p2);
+        if (not(p1_icc or p2_icc))
+          return;
+
+        /* forces for unit charges, including the image charges */
+        auto const forces = Coulomb::pair_force(1., p1.r.p, p2.r.p, d.vec21,
+                                                sqrt(d.dist2));
+        auto const force1 = std::get<0>(forces) + std::get<1>(forces);
+        auto const force2 = std::get<2>(forces) - std::get<0>(forces);
+        if (p1_icc and p2_icc) {
+          if (force1 != Utils::Vector3d{} or force2 != Utils::Vector3d{})
+            result.pairs.push_back({&p1, &p2, force1, force2});
+        } else if (p1_icc) {
+          p1.f.f += p2.p.q * force1;
+        } else {
+          p2.f.f += p1.p.q * force2;
+        }
+      });
+
+  cell_structure.ghosts_reduce_forces();
+
+  result.source_field.reserve(icc_particles.size());
+  for (auto const p : icc_particles) {
+    result.source_field.push_back(p->f.f);
+  }
 
-/** Variant of @ref add_non_bonded_pair_force where only %Coulomb
- *  contributions are calculated
+  return result;
+}
+
+/** Calculate the electrostatic forces between the ICC particles. Together
+ *  with the cached field of the source charges, this gives the field
+ *  acting on the ICC particles. This is a modified version of
+ *  @ref force_calc.
  */
-inline void add_non_bonded_pair_force_icc(Particle &p1, Particle &p2,
-                                          Utils::Vector3d const &d, double dist,
-                                          double dist2) {
-  auto forces = Coulomb::pair_force(p1, p2, d, dist);
-
-  p1.f.f += std::get<0>(forces);
-  p2.f.f -= std::get<0>(forces);
-#ifdef P3M
-  p1.f.f += std::get<1>(forces);
-  p2.f.f += std::get<2>(forces);
-#endif
+void force_calc_icc(const ParticleRange &particles,
+                    const ParticleRange &ghost_particles,
+                    std::vector<IccPair> const &pairs) {
+  init_forces_icc(particles, ghost_particles);
+
+  for (auto const &pair : pairs) {
+    auto const q1q2 = pair.p1->p.q * pair.p2->p.q;
+    pair.p1->f.f += q1q2 * pair.force1;
+    pair.p2->f.f += q1q2 * pair.force2;
+  }
+
+  Coulomb::calc_long_range_force(particles);
 }
+
+/** Anderson mixing of the fixed-point iteration @f$ x \to G(x) @f$ for the
+ *  surface charge densities. The next iterate is the linear combination of
+ *  the previous iterates whose residuals @f$ G(x) - x @f$ minimize the
+ *  residual norm, see @cite walker11a. The least-squares problem is solved
+ *  via the normal equations, which only need one reduction per iteration.
+ *  Without history, the update reduces to the relaxation
+ *  @f$ x + \beta (G(x) - x) @f$.
+ */
+class AndersonMixing {
+  int m_depth;
+  double m_beta;
+  bool m_has_previous = false;
+  std::vector<double> m_x_prev;
+  std::vector<double> m_f_prev;
+  /** Differences of consecutive iterates and residuals, oldest first */
+  std::vector<std::vector<double>> m_dx;
+  std::vector<std::vector<double>> m_df;
+
+  /** Solve the symmetric system @p a @p x = @p b by Gaussian elimination.
+   *  @return whether the system is regular.
+   */
+  static bool solve(std::vector<double> &a, std::vector<double> &b) {
+    auto const n = b.size();
+    for (std::size_t k = 0; k < n; ++k) {
+      auto pivot = k;
+      for (auto i = k + 1; i < n; ++i) {
+        if (std::abs(a[i * n + k]) > std::abs(a[pivot * n + k]))
+          pivot = i;
+      }
+      if (a[pivot * n + k] == 0.)
+        return false;
+      for (std::size_t j = 0; j < n; ++j) {
+        std::swap(a[k * n + j], a[pivot * n + j]);
+      }
+      std::swap(b[k], b[pivot]);
+      for (auto i = k + 1; i < n; ++i) {
+        auto const factor = a[i * n + k] / a[k * n + k];
+        for (auto j = k; j < n; ++j) {
+          a[i * n + j] -= factor * a[k * n + j];
+        }
+        b[i] -= factor * b[k];
+      }
+    }
+    for (auto k = n; k-- > 0;) {
+      for (auto j = k + 1; j < n; ++j) {
+        b[k] -= a[k * n + j] * b[j];
+      }
+      b[k] /= a[k * n + k];
+    }
+    return true;
+  }
+
+public:
+  AndersonMixing(int depth, double beta) : m_depth(depth), m_beta(beta) {}
+
+  /** Calculate the next iterate from the current iterate @p x and the
+   *  fixed-point map @p g = G(x). Collective call.
+   */
+  std::vector<double> next(std::vector<double> const &x,
+                           std::vector<double> const &g) {
+    auto const n_local = x.size();
+    std::vector<double> f(n_local);
+    for (std::size_t i = 0; i < n_local; ++i) {
+      f[i] = g[i] - x[i];
+    }
+
+    std::vector<double> x_new(n_local);
+    for (std::size_t i = 0; i < n_local; ++i) {
+      x_new[i] = (1. - m_beta) * x[i] + m_beta * g[i];
+    }
+    if (m_depth == 0)
+      return x_new;
+
+    if (m_has_previous) {
+      if (m_dx.size() == static_cast<std::size_t>(m_depth)) {
+        m_dx.erase(m_dx.begin());
+        m_df.erase(m_df.begin());
+      }
+      m_dx.emplace_back(n_local);
+      m_df.emplace_back(n_local);
+      for (std::size_t i = 0; i < n_local; ++i) {
+        m_dx.back()[i] = x[i] - m_x_prev[i];
+        m_df.back()[i] = f[i] - m_f_prev[i];
+      }
+    }
+    m_x_prev = x;
+    m_f_prev = f;
+    m_has_previous = true;
+
+    auto const m = m_df.size();
+    if (m == 0)
+      return x_new;
+
+    /* Gram matrix of the residual differences (upper triangle) and their
+     * projections onto the current residual, reduced in one step. */
+    std::vector<double> local(m * (m + 1) / 2 + m, 0.);
+    auto it = local.begin();
+    for (std::size_t k = 0; k < m; ++k) {
+      for (auto l = k; l < m; ++l, ++it) {
+        for (std::size_t i = 0; i < n_local; ++i) {
+          *it += m_df[k][i] * m_df[l][i];
+        }
+      }
+    }
+    for (std::size_t k = 0; k < m; ++k, ++it) {
+      for (std::size_t i = 0; i < n_local; ++i) {
+        *it += m_df[k][i] * f[i];
+      }
+    }
+    std::vector<double> global(local.size());
+    boost::mpi::all_reduce(comm_cart, local.data(),
+                           static_cast<int>(local.size()), global.data(),
+                           std::plus<double>());
+
+    std::vector<double> a(m * m);
+    std::vector<double> gamma(m);
+    auto jt = global.begin();
+    double trace = 0.;
+    for (std::size_t k = 0; k < m; ++k) {
+      for (auto l = k; l < m; ++l, ++jt) {
+        a[k * m + l] = a[l * m + k] = *jt;
+      }
+      trace += a[k * m + k];
+    }
+    std::copy(jt, global.end(), gamma.begin());
+    /* Tikhonov regularization against nearly collinear residuals */
+    for (std::size_t k = 0; k < m; ++k) {
+      a[k * m + k] += 1e-12 * trace;
+    }
+
+    if (trace == 0. or not solve(a, gamma)) {
+      m_dx.clear();
+      m_df.clear();
+      return x_new;
+    }
+
+    for (std::size_t k = 0; k < m; ++k) {
+      for (std::size_t i = 0; i < n_local; ++i) {
+        x_new[i] -= gamma[k] * (m_dx[k][i] + m_beta * m_df[k][i]);
+      }
+    }
+    return x_new;
+  }
+};
+} // namespace
+
 void icc_iteration(const ParticleRange &particles,
                    const ParticleRange &ghost_particles) {
   if (icc_cfg.n_icc == 0)
@@ -89,70 +319,86 @@ void icc_iteration(const ParticleRange &particles,
   auto const pref = 1.0 / (coulomb.prefactor * 2 * Utils::pi());
   icc_cfg.citeration = 0;
 
+  std::vector<Particle *> icc_particles;
+  for (auto &p : particles) {
+    if (is_icc_particle(p)) {
+      icc_particles.push_back(&p);
+    }
+  }
+
+  auto const short_range =
+      init_short_range_icc(particles, ghost_particles, icc_particles);
+  AndersonMixing mixing(icc_cfg.anderson_depth, icc_cfg.relax);
+
+  std::vector<double> charge_density_old(icc_particles.size());
+  std::vector<double> charge_density_update(icc_particles.size());
+
   double globalmax = 0.;
 
   for (int j = 0; j < icc_cfg.num_iteration; j++) {
     double charge_density_max = 0.;
 
-    force_calc_icc(particles, ghost_particles); /* Calculate electrostatic
+    force_calc_icc(particles, ghost_particles,
+                   short_range.pairs); /* Calculate electrostatic
                             forces (SR+LR) excluding source source interaction*/
     cell_structure.ghosts_reduce_forces();
 
+    for (std::size_t k = 0; k < icc_particles.size(); ++k) {
+      auto const &p = *icc_particles[k];
+      auto const id = p.p.identity - icc_cfg.first_id;
+      /* the dielectric-related prefactor: */
+      auto const del_eps =
+          (icc_cfg.ein[id] - icc_cfg.eout) / (icc_cfg.ein[id] + icc_cfg.eout);
+      /* calculate the electric field at the certain position */
+      auto const local_e_field =
+          p.f.f / p.p.q + short_range.source_field[k] + icc_cfg.ext_field;
+
+      if (local_e_field.norm2() == 0) {
+        runtimeErrorMsg()
+            << "ICC found zero electric field on a charge. This must "
+               "never happen";
+      }
+
+      charge_density_old[k] = p.p.q / icc_cfg.areas[id];
+      charge_density_update[k] =
+          del_eps * pref * (local_e_field * icc_cfg.normals[id]) +
+          2 * icc_cfg.eout / (icc_cfg.eout + icc_cfg.ein[id]) *
+              icc_cfg.sigma[id];
+    }
+
+    auto const charge_density_new =
+        mixing.next(charge_density_old, charge_density_update);
+
     double diff = 0;
 
-    for (auto &p : particles) {
-      if (p.p.identity < icc_cfg.n_icc + icc_cfg.first_id &&
-          p.p.identity >= icc_cfg.first_id) {
-        auto const id = p.p.identity - icc_cfg.first_id;
-        /* the dielectric-related prefactor: */
-        auto const del_eps =
-            (icc_cfg.ein[id] - icc_cfg.eout) / (icc_cfg.ein[id] + icc_cfg.eout);
-        /* calculate the electric field at the certain position */
-        auto const local_e_field = p.f.f / p.p.q + icc_cfg.ext_field;
-
-        if (local_e_field.norm2() == 0) {
-          runtimeErrorMsg()
-              << "ICC found zero electric field on a charge. This must "
-                 "never happen";
-        }
+    for (std::size_t k = 0; k < icc_particles.size(); ++k) {
+      auto &p = *icc_particles[k];
+      auto const id = p.p.identity - icc_cfg.first_id;
 
-        auto const charge_density_old = p.p.q / icc_cfg.areas[id];
-
-        charge_density_max =
-            std::max(charge_density_max, std::abs(charge_density_old));
-
-        auto const charge_density_update =
-            del_eps * pref * (local_e_field * icc_cfg.normals[id]) +
-            2 * icc_cfg.eout / (icc_cfg.eout + icc_cfg.ein[id]) *
-                icc_cfg.sigma[id];
-        /* relative variation: never use an estimator which can be negative
-         * here */
-        auto const charge_density_new =
-            (1. - icc_cfg.relax) * charge_density_old +
-            (icc_cfg.relax) * charge_density_update;
-
-        /* Take the largest error to check for convergence */
-        auto const relative_difference =
-            std::abs((charge_density_new - charge_density_old) /
-                     (charge_density_max +
-                      std::abs(charge_density_new + charge_density_old)));
-
-        diff = std::max(diff, relative_difference);
-
-        p.p.q = charge_density_new * icc_cfg.areas[id];
-
-        /* check if the charge now is more than 1e6, to determine if ICC still
-         * leads to reasonable results. This is kind of an arbitrary measure
-         * but does a good job spotting divergence! */
-        if (std::abs(p.p.q) > 1e6) {
-          runtimeErrorMsg()
-              << "too big charge assignment in icc! q >1e6 , assigned "
-                 "charge= "
-              << p.p.q;
-
-          diff = 1e90; /* A very high value is used as error code */
-          break;
-        }
+      charge_density_max =
+          std::max(charge_density_max, std::abs(charge_density_old[k]));
+
+      /* Take the largest error to check for convergence */
+      auto const relative_difference =
+          std::abs((charge_density_new[k] - charge_density_old[k]) /
+                   (charge_density_max +
+                    std::abs(charge_density_new[k] + charge_density_old[k])));
+
+      diff = std::max(diff, relative_difference);
+
+      p.p.q = charge_density_new[k] * icc_cfg.areas[id];
+
+      /* check if the charge now is more than 1e6, to determine if ICC still
+       * leads to reasonable results. This is kind of an arbitrary measure
+       * but does a good job spotting divergence! */
+      if (std::abs(p.p.q) > 1e6) {
+        runtimeErrorMsg()
+            << "too big charge assignment in icc! q >1e6 , assigned "
+               "charge= "
+            << p.p.q;
+
+        diff = 1e90; /* A very high value is used as error code */
+        break;
       }
     } /* cell particles */
     /* Update charges on ghosts. */
@@ -175,30 +421,6 @@ void icc_iteration(const ParticleRange &particles,
   on_particle_charge_change();
 }
 
-void force_calc_icc(const ParticleRange &particles,
-                    const ParticleRange &ghost_particles) {
-  init_forces_icc(particles, ghost_particles);
-
-  cell_structure.non_bonded_loop(
-      [](Particle &p1, Particle &p2, Distance const &d) {
-        /* calc non-bonded interactions */
-        add_non_bonded_pair_force_icc(p1, p2, d.vec21, sqrt(d.dist2), d.dist2);
-      });
-
-  Coulomb::calc_long_range_force(particles);
-}
-
-void init_forces_icc(const ParticleRange &particles,
-                     const ParticleRange &ghosts_particles) {
-  for (auto &p : particles) {
-    p.f.f = {};
-  }
-
-  for (auto &p : ghosts_particles) {
-    p.f.f = {};
-  }
-}
-
 void mpi_icc_init_local(const icc_struct &icc_cfg_) {
   icc_cfg = icc_cfg_;
 
@@ -216,9 +438,10 @@ int mpi_icc_init() {
 }
 
 void icc_set_params(int n_icc, double convergence, double relaxation,
-                    Utils::Vector3d &ext_field, int max_iterations,
-                    int first_id, double eps_out, std::vector<double> &areas,
-                    std::vector<double> &e_in, std::vector<double> &sigma,
+                    int anderson_depth, Utils::Vector3d &ext_field,
+                    int max_iterations, int first_id, double eps_out,
+                    std::vector<double> &areas, std::vector<double> &e_in,
+                    std::vector<double> &sigma,
                     std::vector<Utils::Vector3d> &normals) {
   if (n_icc < 0)
     throw std::runtime_error("ICC: invalid number of particles. " +
@@ -229,6 +452,9 @@ void icc_set_params(int n_icc, double convergence, double relaxation,
   if (relaxation < 0 or relaxation > 2)
     throw std::runtime_error("ICC: invalid relaxation value. " +
                              std::to_string(relaxation));
+  if (anderson_depth < 0)
+    throw std::runtime_error("ICC: invalid anderson_depth. " +
+                             std::to_string(anderson_depth));
   if (max_iterations <= 0)
     throw std::runtime_error("ICC: invalid max_iterations. " +
                              std::to_string(max_iterations));
@@ -250,6 +476,7 @@ void icc_set_params(int n_icc, double convergence, double relaxation,
   icc_cfg.n_icc = n_icc;
   icc_cfg.convergence = convergence;
   icc_cfg.relax = relaxation;
+  icc_cfg.anderson_depth = anderson_depth;
   icc_cfg.ext_field = ext_field;
   icc_cfg.num_iteration = max_iterations;
   icc_cfg.first_id = first_id;
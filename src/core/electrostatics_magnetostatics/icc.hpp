@@ -37,8 +37,16 @@
  *  acting on the induced charges has to be determined. As P3M and the
  *  other Coulomb solvers calculate all mutual forces, the force
  *  calculation was modified to avoid the calculation of the short
- *  range part of the source-source force calculation. For different
- *  particle data organisation schemes this is performed differently.
+ *  range part of the source-source force calculation. The short-range
+ *  field of the source charges is evaluated once per call of
+ *  @ref icc_iteration, and the pairs of ICC particles are cached, so
+ *  that the iterations only revisit these pairs and the long-range part.
+ *
+ *  The self-consistent charges are found by a fixed-point iteration,
+ *  which starts from the charges of the previous time step. It is
+ *  optionally accelerated by Anderson mixing @cite walker11a, where the
+ *  next iterate is extrapolated from the residuals of the last
+ *  @ref icc_struct::anderson_depth iterations.
  */
 
 #ifndef CORE_ICC_HPP
@@ -76,6 +84,9 @@ struct icc_struct {
   Utils::Vector3d ext_field = {0, 0, 0};
   /** relaxation parameter */
   double relax;
+  /** number of previous iterates used for Anderson mixing,
+   *  0 for plain successive over-relaxation */
+  int anderson_depth = 0;
   /** last number of iterations */
   int citeration = 0;
   /** first ICC particle id */
@@ -89,6 +100,7 @@ struct icc_struct {
     ar &convergence;
     ar &eout;
     ar &relax;
+    ar &anderson_depth;
     ar &areas;
     ar &ein;
     ar &normals;
@@ -115,9 +127,10 @@ int mpi_icc_init();
 /** Set ICC parameters
  */
 void icc_set_params(int n_ic, double convergence, double relaxation,
-                    Utils::Vector3d &ext_field, int max_iterations,
-                    int first_id, double eps_out, std::vector<double> &areas,
-                    std::vector<double> &e_in, std::vector<double> &sigma,
+                    int anderson_depth, Utils::Vector3d &ext_field,
+                    int max_iterations, int first_id, double eps_out,
+                    std::vector<double> &areas, std::vector<double> &e_in,
+                    std::vector<double> &sigma,
                     std::vector<Utils::Vector3d> &normals);
 
 /** clear ICC vector allocations
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+#include "electrostatics_magnetostatics/magnetic_barnes_hut.hpp"
+
+#include "electrostatics_magnetostatics/common.hpp"
+#include "electrostatics_magnetostatics/dipolar_octree.hpp"
+#include "electrostatics_magnetostatics/dipolar_replicas.hpp"
+#include "electrostatics_magnetostatics/dipole.hpp"
+
+#include "communication.hpp"
+#include "errorhandling.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+DipolarBarnesHut_params dbh_params{};
+
+double dipolar_barnes_hut_calculations(bool force_flag, bool energy_flag,
+                                       ParticleRange const &particles) {
+  assert(force_flag || energy_flag);
+
+  std::vector<Utils::Vector3d> pos, dip;
+  auto const first = gather_dipoles(particles, pos, dip);
+  DipolarOctree const tree(pos, dip, dbh_params.leaf_size);
+  auto const shifts = image_shifts(dbh_params.n_replica);
+
+  double energy = 0.;
+  int index = first;
+  for (auto &p : particles) {
+    if (p.p.dipm == 0.0)
+      continue;
+
+    DipolarOctree::Result result;
+    for (auto const &shift : shifts) {
+      /* the particle only interacts with its own periodic images */
+      auto const skip = (shift == Utils::Vector3d{}) ? index : -1;
+      tree.interaction(pos[index] + shift, dip[index], dbh_params.theta, skip,
+                       force_flag, result);
+    }
+    energy += result.energy;
+    if (force_flag) {
+      p.f.f += dipole.prefactor * result.force;
+      p.f.torque += dipole.prefactor * result.torque;
+    }
+    index++;
+  }
+
+  return 0.5 * dipole.prefactor * energy;
+}
+
+int dipolar_barnes_hut_sanity_checks() {
+  if (box_geo.periodic(0) and box_geo.periodic(1) and box_geo.periodic(2) and
+      dbh_params.n_replica == 0) {
+    runtimeErrorMsg() << "Dipolar Barnes-Hut sum does not support a periodic "
+                         "system with zero replica.";
+    return 1;
+  }
+  return 0;
+}
+
+void dipolar_barnes_hut_set_params(double theta, int leaf_size,
+                                   int n_replica) {
+  if (theta < 0.) {
+    throw std::domain_error("Parameter 'theta' must be >= 0");
+  }
+  if (leaf_size < 1) {
+    throw std::domain_error("Parameter 'leaf_size' must be >= 1");
+  }
+  if (n_replica < 0) {
+    throw std::domain_error("Parameter 'n_replica' must be >= 0");
+  }
+
+  dbh_params.theta = theta;
+  dbh_params.leaf_size = leaf_size;
+  dbh_params.n_replica = n_replica;
+
+  Dipole::set_method_local(DIPOLAR_BH_CPU);
+  mpi_bcast_coulomb_params();
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_MAGNETIC_BARNES_HUT_HPP
+#define ESPRESSO_MAGNETIC_BARNES_HUT_HPP
+/** \file
+ *  Barnes-Hut octree sum of the magnetic dipole-dipole interaction on the
+ *  CPU.
+ *
+ *  All dipoles are gathered on every node, which builds the same octree
+ *  (see @ref DipolarOctree) and evaluates it for its local particles.
+ *  Periodic directions are handled like in the direct sum with replicas:
+ *  the images within a sphere of @c n_replica box lengths are added.
+ *
+ *  Implementation in magnetic_barnes_hut.cpp.
+ */
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+#include "ParticleRange.hpp"
+
+#include <boost/serialization/access.hpp>
+
+struct DipolarBarnesHut_params {
+  /** Opening angle, 0 for the exact sum. */
+  double theta = 0.5;
+  /** Maximal number of dipoles in a leaf of the octree. */
+  int leaf_size = 8;
+  /** Number of replicas in the periodic directions. */
+  int n_replica = 0;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &theta;
+    ar &leaf_size;
+    ar &n_replica;
+  }
+};
+
+/** Parameters of the Barnes-Hut method. */
+extern DipolarBarnesHut_params dbh_params;
+
+/** Calculate the magnetic forces, torques and the energy of the local
+ *  particles.
+ *  @return Energy of the local particles.
+ */
+double dipolar_barnes_hut_calculations(bool force_flag, bool energy_flag,
+                                       ParticleRange const &particles);
+
+/** Sanity checks for the Barnes-Hut method.
+ *  @return 1 if the method cannot be used with the current box.
+ */
+int dipolar_barnes_hut_sanity_checks();
+
+/** Switch on Barnes-Hut magnetostatics.
+ *  @param theta      opening angle
+ *  @param leaf_size  maximal number of dipoles in a leaf
+ *  @param n_replica  number of replicas in the periodic directions
+ */
+void dipolar_barnes_hut_set_params(double theta, int leaf_size, int n_replica);
+
+#endif
+#endif
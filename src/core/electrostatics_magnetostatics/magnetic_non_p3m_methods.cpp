@@ -26,6 +26,7 @@
 #include "electrostatics_magnetostatics/magnetic_non_p3m_methods.hpp"
 
 #include "electrostatics_magnetostatics/common.hpp"
+#include "electrostatics_magnetostatics/dipolar_replicas.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
 
 #include "cells.hpp"
@@ -33,8 +34,13 @@
 #include "errorhandling.hpp"
 #include "grid.hpp"
 
+#include <utils/Vector.hpp>
 #include <utils/constants.hpp>
-#include <utils/math/sqr.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
 
 /**
  * Calculate dipolar energy and optionally force between two particles.
@@ -134,169 +140,180 @@ double dawaanr_calculations(bool force_flag, bool energy_flag,
 int Ncut_off_magnetic_dipolar_direct_sum = 0;
 
 int magnetic_dipolar_direct_sum_sanity_checks() {
-  /* left for the future, at this moment nothing to do */
-
-  return 0;
-}
-
-double
-magnetic_dipolar_direct_sum_calculations(bool force_flag, bool energy_flag,
-                                         ParticleRange const &particles) {
-
-  assert(n_nodes == 1);
-  assert(force_flag || energy_flag);
-
   if (box_geo.periodic(0) and box_geo.periodic(1) and box_geo.periodic(2) and
       Ncut_off_magnetic_dipolar_direct_sum == 0) {
-    throw std::runtime_error("Dipolar direct sum with replica does not support "
-                             "a periodic system with zero replica.");
-  };
+    runtimeErrorMsg() << "Dipolar direct sum with replica does not support "
+                         "a periodic system with zero replica.";
+    return 1;
+  }
+  return 0;
+}
 
+namespace {
+/** Positions and dipole moments of all dipoles, structure of arrays. */
+struct DipoleArrays {
   std::vector<double> x, y, z;
   std::vector<double> mx, my, mz;
-  std::vector<double> fx, fy, fz;
-  std::vector<double> tx, ty, tz;
-
-  auto const n_part = particles.size();
-
-  x.resize(n_part);
-  y.resize(n_part);
-  z.resize(n_part);
+};
 
-  mx.resize(n_part);
-  my.resize(n_part);
-  mz.resize(n_part);
-
-  if (force_flag) {
-    fx.resize(n_part);
-    fy.resize(n_part);
-    fz.resize(n_part);
-    tx.resize(n_part);
-    ty.resize(n_part);
-    tz.resize(n_part);
-  }
+/** Energy, force and torque on one dipole, without the prefactor. */
+struct DipoleSums {
+  double energy = 0.;
+  double f[3] = {0., 0., 0.};
+  double t[3] = {0., 0., 0.};
+};
 
-  int dip_particles = 0;
-  for (auto const &p : particles) {
-    if (p.p.dipm != 0.0) {
-      const Utils::Vector3d dip = p.calc_dip();
-
-      mx[dip_particles] = dip[0];
-      my[dip_particles] = dip[1];
-      mz[dip_particles] = dip[2];
-
-      /* here we wish the coordinates to be folded into the primary box */
-      auto const ppos = folded_position(p.r.p, box_geo);
-      x[dip_particles] = ppos[0];
-      y[dip_particles] = ppos[1];
-      z[dip_particles] = ppos[2];
-
-      if (force_flag) {
-        fx[dip_particles] = 0;
-        fy[dip_particles] = 0;
-        fz[dip_particles] = 0;
-        tx[dip_particles] = 0;
-        ty[dip_particles] = 0;
-        tz[dip_particles] = 0;
-      }
+/** Number of independent partial sums in @ref sum_dipoles. The pairs of
+ *  the inner loop are processed in blocks of this size, such that the
+ *  compiler can vectorize the loop without reordering the sums.
+ */
+constexpr int n_lanes = 4;
+
+/** @brief Interaction of one dipole with a range of dipoles.
+ *  @tparam force_flag   calculate the force and torque
+ *  @param[in]     d     all dipoles
+ *  @param[in]     i     target dipole
+ *  @param[in]     s     image shift of the target
+ *  @param[in]     begin first source dipole
+ *  @param[in]     end   past the last source dipole
+ *  @param[in,out] sums  accumulated energy, force and torque
+ */
+template <bool force_flag>
+void sum_dipoles(DipoleArrays const &d, std::size_t i,
+                 Utils::Vector3d const &s, std::size_t begin, std::size_t end,
+                 DipoleSums &sums) {
+  auto const xi = d.x[i] + s[0], yi = d.y[i] + s[1], zi = d.z[i] + s[2];
+  auto const mxi = d.mx[i], myi = d.my[i], mzi = d.mz[i];
+
+  double energy[n_lanes] = {};
+  double fx[n_lanes] = {}, fy[n_lanes] = {}, fz[n_lanes] = {};
+  double tx[n_lanes] = {}, ty[n_lanes] = {}, tz[n_lanes] = {};
+
+  auto const kernel = [&](std::size_t j, int lane) {
+    auto const rnx = xi - d.x[j];
+    auto const rny = yi - d.y[j];
+    auto const rnz = zi - d.z[j];
+    auto const r2 = rnx * rnx + rny * rny + rnz * rnz;
+    auto const r = std::sqrt(r2);
+    auto const r3 = r2 * r;
+    auto const r5 = r3 * r2;
+
+    auto const pe1 = mxi * d.mx[j] + myi * d.my[j] + mzi * d.mz[j];
+    auto const pe2 = mxi * rnx + myi * rny + mzi * rnz;
+    auto const pe3 = d.mx[j] * rnx + d.my[j] * rny + d.mz[j] * rnz;
+    auto const pe4 = 3.0 / r5;
+
+    energy[lane] += pe1 / r3 - pe4 * pe2 * pe3;
+
+    if (force_flag) {
+      auto const r7 = r5 * r2;
+      auto const a = pe4 * pe1;
+      auto const b = -15.0 * pe2 * pe3 / r7;
+      auto const c = pe4 * pe3;
+      auto const dd = pe4 * pe2;
+
+      fx[lane] += (a + b) * rnx + c * mxi + dd * d.mx[j];
+      fy[lane] += (a + b) * rny + c * myi + dd * d.my[j];
+      fz[lane] += (a + b) * rnz + c * mzi + dd * d.mz[j];
+
+      auto const ax = myi * d.mz[j] - d.my[j] * mzi;
+      auto const ay = d.mx[j] * mzi - mxi * d.mz[j];
+      auto const az = mxi * d.my[j] - d.mx[j] * myi;
+
+      auto const bx = myi * rnz - rny * mzi;
+      auto const by = rnx * mzi - mxi * rnz;
+      auto const bz = mxi * rny - rnx * myi;
+
+      tx[lane] += -ax / r3 + bx * c;
+      ty[lane] += -ay / r3 + by * c;
+      tz[lane] += -az / r3 + bz * c;
+    }
+  };
 
-      dip_particles++;
+  auto j = begin;
+  for (; j + n_lanes <= end; j += n_lanes) {
+    for (int lane = 0; lane < n_lanes; lane++) {
+      kernel(j + lane, lane);
     }
   }
-
-  /* energy calculation */
-  double energy = 0.;
-
-  int NCUT[3];
-  for (int i = 0; i < 3; i++) {
-    NCUT[i] = box_geo.periodic(i) ? Ncut_off_magnetic_dipolar_direct_sum : 0;
+  for (int lane = 0; j < end; j++, lane++) {
+    kernel(j, lane);
   }
-  auto const NCUT2 = Utils::sqr(Ncut_off_magnetic_dipolar_direct_sum);
-
-  for (int i = 0; i < dip_particles; i++) {
-    for (int j = 0; j < dip_particles; j++) {
-      auto const pe1 = mx[i] * mx[j] + my[i] * my[j] + mz[i] * mz[j];
-      auto const rx = x[i] - x[j];
-      auto const ry = y[i] - y[j];
-      auto const rz = z[i] - z[j];
-
-      for (int nx = -NCUT[0]; nx <= NCUT[0]; nx++) {
-        auto const rnx = rx + nx * box_geo.length()[0];
-        auto const rnx2 = rnx * rnx;
-        for (int ny = -NCUT[1]; ny <= NCUT[1]; ny++) {
-          auto const rny = ry + ny * box_geo.length()[1];
-          auto const rny2 = rny * rny;
-          for (int nz = -NCUT[2]; nz <= NCUT[2]; nz++) {
-            if (!(i == j && nx == 0 && ny == 0 && nz == 0) and
-                (nx * nx + ny * ny + nz * nz <= NCUT2)) {
-              auto const rnz = rz + nz * box_geo.length()[2];
-              auto const r2 = rnx2 + rny2 + rnz * rnz;
-              auto const r = sqrt(r2);
-              auto const r3 = r2 * r;
-              auto const r5 = r3 * r2;
-              auto const r7 = r5 * r2;
-
-              auto const pe2 = mx[i] * rnx + my[i] * rny + mz[i] * rnz;
-              auto const pe3 = mx[j] * rnx + my[j] * rny + mz[j] * rnz;
-              auto const pe4 = 3.0 / r5;
-
-              // Energy
-              energy += pe1 / r3 - pe4 * pe2 * pe3;
-
-              if (force_flag) {
-                // Forces
-                auto const a = pe4 * pe1;
-                auto const b = -15.0 * pe2 * pe3 / r7;
-                auto const c = pe4 * pe3;
-                auto const d = pe4 * pe2;
-
-                fx[i] += (a + b) * rnx + c * mx[i] + d * mx[j];
-                fy[i] += (a + b) * rny + c * my[i] + d * my[j];
-                fz[i] += (a + b) * rnz + c * mz[i] + d * mz[j];
-
-                // Torques
-                auto const ax = my[i] * mz[j] - my[j] * mz[i];
-                auto const ay = mx[j] * mz[i] - mx[i] * mz[j];
-                auto const az = mx[i] * my[j] - mx[j] * my[i];
-
-                auto const bx = my[i] * rnz - rny * mz[i];
-                auto const by = rnx * mz[i] - mx[i] * rnz;
-                auto const bz = mx[i] * rny - rnx * my[i];
-
-                tx[i] += -ax / r3 + bx * c;
-                ty[i] += -ay / r3 + by * c;
-                tz[i] += -az / r3 + bz * c;
-              } /* if force_flag  */
-            }   /* if distance criterion */
-          }     /* for nz */
-        }       /* for ny */
-      }         /* for nx */
-    }           /* for j */
-  }             /* for i */
-
-  /* update particle forces and torques */
-  if (force_flag) {
 
-    dip_particles = 0;
+  for (int lane = 0; lane < n_lanes; lane++) {
+    sums.energy += energy[lane];
+    sums.f[0] += fx[lane];
+    sums.f[1] += fy[lane];
+    sums.f[2] += fz[lane];
+    sums.t[0] += tx[lane];
+    sums.t[1] += ty[lane];
+    sums.t[2] += tz[lane];
+  }
+}
 
-    for (auto &p : particles) {
-      if (p.p.dipm != 0.0) {
+template <bool force_flag>
+double direct_sum(ParticleRange const &particles) {
+  std::vector<Utils::Vector3d> pos, dip;
+  auto i = static_cast<std::size_t>(gather_dipoles(particles, pos, dip));
+  auto const n_dipoles = pos.size();
+  auto const shifts = image_shifts(Ncut_off_magnetic_dipolar_direct_sum);
+
+  DipoleArrays dipoles;
+  for (auto v : {&dipoles.x, &dipoles.y, &dipoles.z, &dipoles.mx,
+                 &dipoles.my, &dipoles.mz}) {
+    v->resize(n_dipoles);
+  }
+  for (std::size_t k = 0; k < n_dipoles; k++) {
+    dipoles.x[k] = pos[k][0];
+    dipoles.y[k] = pos[k][1];
+    dipoles.z[k] = pos[k][2];
+    dipoles.mx[k] = dip[k][0];
+    dipoles.my[k] = dip[k][1];
+    dipoles.mz[k] = dip[k][2];
+  }
 
-        p.f.f[0] += dipole.prefactor * fx[dip_particles];
-        p.f.f[1] += dipole.prefactor * fy[dip_particles];
-        p.f.f[2] += dipole.prefactor * fz[dip_particles];
+  /* every node sums up the interactions of its own particles with all
+   * dipoles and their images */
+  double energy = 0.;
+  for (auto &p : particles) {
+    if (p.p.dipm == 0.0)
+      continue;
 
-        p.f.torque[0] += dipole.prefactor * tx[dip_particles];
-        p.f.torque[1] += dipole.prefactor * ty[dip_particles];
-        p.f.torque[2] += dipole.prefactor * tz[dip_particles];
+    DipoleSums sums;
+    for (auto const &shift : shifts) {
+      if (shift == Utils::Vector3d{}) {
+        /* skip the self-interaction in the primary box */
+        sum_dipoles<force_flag>(dipoles, i, shift, 0, i, sums);
+        sum_dipoles<force_flag>(dipoles, i, shift, i + 1, n_dipoles, sums);
+      } else {
+        sum_dipoles<force_flag>(dipoles, i, shift, 0, n_dipoles, sums);
+      }
+    }
 
-        dip_particles++;
+    energy += sums.energy;
+    if (force_flag) {
+      for (int k = 0; k < 3; k++) {
+        p.f.f[k] += dipole.prefactor * sums.f[k];
+        p.f.torque[k] += dipole.prefactor * sums.t[k];
       }
     }
-  } /* if force_flag */
+    i++;
+  }
 
   return 0.5 * dipole.prefactor * energy;
 }
+} // namespace
+
+double
+magnetic_dipolar_direct_sum_calculations(bool force_flag, bool energy_flag,
+                                         ParticleRange const &particles) {
+  assert(force_flag || energy_flag);
+
+  if (force_flag) {
+    return direct_sum<true>(particles);
+  }
+  return direct_sum<false>(particles);
+}
 
 int dawaanr_set_params() {
   if (n_nodes > 1) {
@@ -314,12 +331,6 @@ int dawaanr_set_params() {
 }
 
 int mdds_set_params(int n_cut) {
-  if (n_nodes > 1) {
-    runtimeErrorMsg() << "MPI parallelization not supported by "
-                      << "DipolarDirectSumWithReplicaCpu.";
-    return ES_ERROR;
-  }
-
   Ncut_off_magnetic_dipolar_direct_sum = n_cut;
 
   if (Ncut_off_magnetic_dipolar_direct_sum == 0) {
@@ -33,6 +33,8 @@
  *   by explicitly summing the dipole-dipole interaction over several copies of
  *   the system.
  *   Uses spherical summation order.
+ *   All dipoles are gathered on every node, which sums up the interactions
+ *   of its local particles.
  *
  */
 #include "config.hpp"
@@ -63,11 +65,13 @@ int dawaanr_set_params();
    =============================================================================
 */
 
-/** Sanity checks for the magnetic dipolar direct sum*/
+/** Sanity checks for the magnetic dipolar direct sum.
+ *  @return 1 if the method cannot be used with the current box.
+ */
 int magnetic_dipolar_direct_sum_sanity_checks();
 
-/** Core of the method: here you compute all the magnetic forces, torques and
- *  the energy for the whole system using direct sum
+/** Core of the method: here you compute the magnetic forces, torques and
+ *  the energy of the local particles using direct sum
  */
 double magnetic_dipolar_direct_sum_calculations(bool force_flag,
                                                 bool energy_flag,
@@ -75,7 +79,7 @@ double magnetic_dipolar_direct_sum_calculations(bool force_flag,
 
 /** Switch on direct sum magnetostatics.
  *  @param n_cut cut off for the explicit summation
- *  @return ES_ERROR, if not on a single CPU
+ *  @return ES_OK
  */
 int mdds_set_params(int n_cut);
 
@@ -31,6 +31,7 @@
 #include "energy_inline.hpp"
 #include "event.hpp"
 #include "forces.hpp"
+#include "fused_observables.hpp"
 #include "integrate.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "reduce_observable_stat.hpp"
@@ -40,6 +41,11 @@
 #include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
 
+#include <boost/range/algorithm/transform.hpp>
+
+#include <cassert>
+#include <functional>
+
 ActorList energyActors;
 
 /** Energy of the system */
@@ -69,21 +75,30 @@ void energy_calc(const double time) {
     obs_energy.kinetic[0] += calc_kinetic_energy(p);
   }
 
-  short_range_loop(
-      [](Particle &p1, int bond_id, Utils::Span<Particle *> partners) {
-        auto const &iaparams = bonded_ia_params[bond_id];
-        auto const result = calc_bonded_energy(iaparams, p1, partners);
-        if (result) {
-          obs_energy.bonded_contribution(bond_id)[0] += result.get();
-          return false;
-        }
-        return true;
-      },
-      [](Particle const &p1, Particle const &p2, Distance const &d) {
-        add_non_bonded_pair_energy(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
-                                   obs_energy);
-      },
-      maximal_cutoff(), maximal_cutoff_bonded());
+  /* the short-range energies may have been accumulated by the last force
+   * calculation */
+  if (fused_observables.valid(FUSED_OBSERVABLE_ENERGY)) {
+    auto const &fused = fused_observables.energy;
+    assert(fused.data_().size() == obs_energy.data_().size());
+    boost::transform(fused.data_(), obs_energy.data_(),
+                     obs_energy.data_().begin(), std::plus<>{});
+  } else {
+    short_range_loop(
+        [](Particle &p1, int bond_id, Utils::Span<Particle *> partners) {
+          auto const &iaparams = bonded_ia_params[bond_id];
+          auto const result = calc_bonded_energy(iaparams, p1, partners);
+          if (result) {
+            obs_energy.bonded_contribution(bond_id)[0] += result.get();
+            return false;
+          }
+          return true;
+        },
+        [](Particle const &p1, Particle const &p2, Distance const &d) {
+          add_non_bonded_pair_energy(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
+                                     obs_energy);
+        },
+        maximal_cutoff(), maximal_cutoff_bonded());
+  }
 
   calc_long_range_energies(cell_structure.local_particles());
 
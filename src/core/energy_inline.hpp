@@ -42,6 +42,7 @@
 #include "nonbonded_interactions/morse.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "nonbonded_interactions/nonbonded_tab.hpp"
+#include "nonbonded_interactions/pair_splines.hpp"
 #include "nonbonded_interactions/smooth_step.hpp"
 #include "nonbonded_interactions/soft_sphere.hpp"
 #include "nonbonded_interactions/thole.hpp"
@@ -68,19 +69,13 @@
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/variant.hpp>
 
-/** Calculate non-bonded energies between a pair of particles.
- *  @param p1         particle 1.
- *  @param p2         particle 2.
+/** Energy of the isotropic non-bonded potentials of a type pair.
  *  @param ia_params  the interaction parameters between the two particles
- *  @param d          vector between p1 and p2.
- *  @param dist       distance between p1 and p2.
- *  @return the short-range interaction energy between the two particles
+ *  @param dist       distance between the particles
+ *  @return the sum of the energies
  */
-inline double calc_non_bonded_pair_energy(Particle const &p1,
-                                          Particle const &p2,
-                                          IA_parameters const &ia_params,
-                                          Utils::Vector3d const &d,
-                                          double const dist) {
+inline double calc_central_pair_energy(IA_parameters const &ia_params,
+                                       double const dist) {
 
   double ret = 0;
 
@@ -143,11 +138,6 @@ inline double calc_non_bonded_pair_energy(Particle const &p1,
   ret += ljcos2_pair_energy(ia_params, dist);
 #endif
 
-#ifdef THOLE
-  /* Thole damping */
-  ret += thole_pair_energy(p1, p2, ia_params, d, dist);
-#endif
-
 #ifdef TABULATED
   /* tabulated */
   ret += tabulated_pair_energy(ia_params, dist);
@@ -158,6 +148,37 @@ inline double calc_non_bonded_pair_energy(Particle const &p1,
   ret += ljcos_pair_energy(ia_params, dist);
 #endif
 
+  return ret;
+}
+
+/** Calculate non-bonded energies between a pair of particles.
+ *  @param p1         particle 1.
+ *  @param p2         particle 2.
+ *  @param ia_params  the interaction parameters between the two particles
+ *  @param d          vector between p1 and p2.
+ *  @param dist       distance between p1 and p2.
+ *  @return the short-range interaction energy between the two particles
+ */
+inline double calc_non_bonded_pair_energy(Particle const &p1,
+                                          Particle const &p2,
+                                          IA_parameters const &ia_params,
+                                          Utils::Vector3d const &d,
+                                          double const dist) {
+
+  double ret;
+  double t = 0.;
+  auto const *spline = get_pair_spline(p1.p.type, p2.p.type);
+  if (auto const *interval = spline ? spline->find(dist * dist, t) : nullptr) {
+    ret = PairSpline::evaluate(interval->energy, t);
+  } else {
+    ret = calc_central_pair_energy(ia_params, dist);
+  }
+
+#ifdef THOLE
+  /* Thole damping */
+  ret += thole_pair_energy(p1, p2, ia_params, d, dist);
+#endif
+
 #ifdef GAY_BERNE
   /* Gay-Berne */
   ret += gb_pair_energy(p1.r.calc_director(), p2.r.calc_director(), ia_params,
@@ -30,12 +30,14 @@
 #include "collision.hpp"
 #include "communication.hpp"
 #include "config.hpp"
+#include "constraints.hpp"
 #include "cuda_init.hpp"
 #include "cuda_interface.hpp"
 #include "cuda_utils.hpp"
 #include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
 #include "errorhandling.hpp"
+#include "fused_observables.hpp"
 #include "global.hpp"
 #include "grid.hpp"
 #include "grid_based_algorithms/electrokinetics.hpp"
@@ -43,7 +45,9 @@
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "immersed_boundaries.hpp"
 #include "integrate.hpp"
+#include "load_balancing.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "nonbonded_interactions/pair_splines.hpp"
 #include "npt.hpp"
 #include "partCfg_global.hpp"
 #include "particle_data.hpp"
@@ -111,6 +115,11 @@ void on_integration_start() {
 #endif
   interactions_sanity_checks();
   lb_lbfluid_on_integration_start();
+  LoadBalancing::sanity_checks();
+  cells_sanity_checks();
+#ifdef COLLISION_DETECTION
+  collision_detection_on_integration_start();
+#endif
 
   /********************************************/
   /* end sanity checks                        */
@@ -160,6 +169,7 @@ void on_observable_calc() {
    * information */
   cells_update_ghosts(global_ghost_flags());
   update_dependent_particles();
+  pair_splines_update();
 #ifdef ELECTROSTATICS
   if (reinit_electrostatics) {
     Coulomb::on_observable_calc();
@@ -222,12 +232,16 @@ void on_coulomb_change() {
 }
 
 void on_short_range_ia_change() {
+  pair_splines_invalidate();
   cells_re_init(cell_structure.decomposition_type());
 
   recalc_forces = true;
 }
 
-void on_constraint_change() { recalc_forces = true; }
+void on_constraint_change() {
+  Constraints::constraints.invalidate_caches();
+  recalc_forces = true;
+}
 
 void on_lbboundary_change() {
 #if defined(LB_BOUNDARIES) || defined(LB_BOUNDARIES_GPU)
@@ -239,6 +253,8 @@ void on_lbboundary_change() {
 
 void on_boxl_change() {
   grid_changed_box_l(box_geo);
+  /* the accumulated virials depend on the box length */
+  fused_observables.invalidate();
   /* Electrostatics cutoffs mostly depend on the system size,
    * therefore recalculate them. */
   cells_re_init(cell_structure.decomposition_type());
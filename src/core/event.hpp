@@ -75,7 +75,7 @@ void on_coulomb_change();
 /** called every time short ranged interaction parameters are changed. */
 void on_short_range_ia_change();
 
-/** called every time a constraint is changed. */
+/** called every time a constraint or its shape is changed. */
 void on_constraint_change();
 
 /** called every time the box length has changed. This routine
@@ -51,6 +51,8 @@ public:
   }
 
   bool fits_in_box(const Utils::Vector3d &) const { return true; }
+  bool covers(const Utils::Vector3d &) const { return true; }
+  bool is_distributed() const { return false; }
 };
 } // namespace Fields
 } // namespace FieldCoupling
@@ -32,7 +32,10 @@
 #endif
 #include <boost/multi_array.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <vector>
 
@@ -50,6 +53,59 @@ void deep_copy(boost::multi_array<T, 3> &dst,
   dst.reindex(std::array<typename boost::multi_array<T, 3>::index, 3>{
       {b[0], b[1], b[2]}});
 }
+
+/**
+ * @brief Grid indices in one direction which the interpolation needs
+ *        for positions in an interval.
+ *
+ * With periodic boundaries, the positions are folded into the box,
+ * so the indices can wrap around.
+ *
+ * @param n        Number of grid points.
+ * @param h        Grid spacing.
+ * @param origin   Position of the first grid point.
+ * @param lower    Lower end of the interval.
+ * @param upper    Upper end of the interval.
+ * @param box_l    Box length.
+ * @param periodic Whether the box is periodic.
+ * @return The indices in ascending order.
+ */
+inline std::vector<int> stencil_indices(int n, double h, double origin,
+                                        double lower, double upper,
+                                        double box_l, bool periodic) {
+  std::vector<char> needed(static_cast<std::size_t>(n), 0);
+  /* the interpolation of order 2 uses the grid points below and above */
+  auto const mark = [&](double a, double b) {
+    auto const first =
+        std::max(0, static_cast<int>(std::floor((a - origin) / h)));
+    auto const last =
+        std::min(n - 1, static_cast<int>(std::floor((b - origin) / h)) + 1);
+    for (int i = first; i <= last; i++) {
+      needed[i] = 1;
+    }
+  };
+
+  if (periodic and upper - lower >= box_l) {
+    mark(0., box_l);
+  } else if (periodic) {
+    auto const a = lower - std::floor(lower / box_l) * box_l;
+    auto const b = a + (upper - lower);
+    mark(a, std::min(b, box_l));
+    if (b > box_l) {
+      mark(0., b - box_l);
+    }
+  } else {
+    mark(lower, upper);
+  }
+
+  std::vector<int> indices;
+  for (int i = 0; i < n; i++) {
+    if (needed[i]) {
+      indices.push_back(i);
+    }
+  }
+  return indices;
+}
 } // namespace detail
 
 /**
@@ -58,6 +114,10 @@ void deep_copy(boost::multi_array<T, 3> &dst,
  *  This is an interpolation wrapper around a boost::multi_array,
  *  which can be evaluated on any point in space by spline interpolation.
  *
+ *  A distributed field only stores the grid points with selected
+ *  indices, usually the ones needed on the local box of a node,
+ *  and can only be evaluated where @ref covers is true.
+ *
  *  @tparam T      Underlying type of the field values, see @ref value_type
  *  @tparam codim  Dimension of the field: 3 for a vector field,
  *                 1 for a scalar field.
@@ -73,23 +133,65 @@ public:
   using storage_type = boost::multi_array<value_type, 3>;
 
 private:
-  storage_type m_global_field;
+  storage_type m_field;
   Utils::Vector3d m_grid_spacing;
   Utils::Vector3d m_origin;
+  /** Shape of the global grid. */
+  Utils::Vector3i m_shape;
+  /** Position in @ref m_field of every global grid index, -1 if the
+   *  grid point isn't stored. Empty if all grid points are stored.
+   */
+  std::array<std::vector<int>, 3> m_local_index;
 
 public:
   Interpolated(const boost::const_multi_array_ref<value_type, 3> &global_field,
                const Utils::Vector3d &grid_spacing,
                const Utils::Vector3d &origin)
-      : m_global_field(global_field), m_grid_spacing(grid_spacing),
-        m_origin(origin) {}
+      : m_field(global_field), m_grid_spacing(grid_spacing), m_origin(origin),
+        m_shape{global_field.shape(), global_field.shape() + 3} {}
+
+  /**
+   * @brief Distributed field.
+   *
+   * @param local_field    Values at the grid points with the global
+   *                       indices in @p indices.
+   * @param indices        Global indices in each direction, ascending.
+   * @param global_shape   Shape of the global grid.
+   * @param grid_spacing   Grid spacing.
+   * @param origin         Position of the first grid point.
+   */
+  Interpolated(const boost::const_multi_array_ref<value_type, 3> &local_field,
+               const std::array<std::vector<int>, 3> &indices,
+               const Utils::Vector3i &global_shape,
+               const Utils::Vector3d &grid_spacing,
+               const Utils::Vector3d &origin)
+      : m_field(local_field), m_grid_spacing(grid_spacing), m_origin(origin),
+        m_shape(global_shape) {
+    for (int i = 0; i < 3; i++) {
+      assert(local_field.shape()[i] == indices[i].size());
+      m_local_index[i].assign(static_cast<std::size_t>(global_shape[i]), -1);
+      for (std::size_t j = 0; j < indices[i].size(); j++) {
+        m_local_index[i].at(indices[i][j]) = static_cast<int>(j);
+      }
+    }
+  }
 
 private:
   void copy(const Interpolated &rhs) {
-    detail::deep_copy(m_global_field, rhs.m_global_field);
+    detail::deep_copy(m_field, rhs.m_field);
 
     m_grid_spacing = rhs.m_grid_spacing;
     m_origin = rhs.m_origin;
+    m_shape = rhs.m_shape;
+    m_local_index = rhs.m_local_index;
+  }
+
+  /** Value at a grid point with global indices. */
+  value_type const &node(const std::array<int, 3> &ind) const {
+    if (m_local_index[0].empty())
+      return m_field(ind);
+    return m_field[m_local_index[0][ind[0]]][m_local_index[1][ind[1]]]
+                  [m_local_index[2][ind[2]]];
   }
 
 public:
@@ -100,16 +202,50 @@ public:
   }
 
   Utils::Vector3d grid_spacing() const { return m_grid_spacing; }
-  storage_type const &field_data() const { return m_global_field; }
+  storage_type const &field_data() const { return m_field; }
   Utils::Vector3d origin() const { return m_origin; }
-  Utils::Vector3i shape() const {
-    return {m_global_field.shape(), m_global_field.shape() + 3};
-  }
+  Utils::Vector3i shape() const { return m_shape; }
+  bool is_distributed() const { return not m_local_index[0].empty(); }
 
   /** Serialize field */
   std::vector<T> field_data_flat() const {
-    auto const *data = reinterpret_cast<T const *>(m_global_field.data());
-    return std::vector<T>(data, data + codim * m_global_field.num_elements());
+    auto const *data = reinterpret_cast<T const *>(m_field.data());
+    return std::vector<T>(data, data + codim * m_field.num_elements());
+  }
+
+  /**
+   * @brief Distributed copy of the field.
+   *
+   * @param indices  Global indices of the grid points to keep in each
+   *                 direction, ascending.
+   */
+  Interpolated subgrid(const std::array<std::vector<int>, 3> &indices) const {
+    storage_type local_field(boost::extents[indices[0].size()]
+                                           [indices[1].size()]
+                                           [indices[2].size()]);
+    for (std::size_t i = 0; i < indices[0].size(); i++)
+      for (std::size_t j = 0; j < indices[1].size(); j++)
+        for (std::size_t k = 0; k < indices[2].size(); k++) {
+          local_field[i][j][k] =
+              node({{indices[0][i], indices[1][j], indices[2][k]}});
+        }
+    return {local_field, indices, m_shape, m_grid_spacing, m_origin};
+  }
+
+  /**
+   * @brief Whether the grid points needed at pos are stored.
+   */
+  bool covers(const Utils::Vector3d &pos) const {
+    if (not is_distributed())
+      return true;
+    for (int i = 0; i < 3; i++) {
+      auto const ind = static_cast<int>(
+          std::floor((pos[i] - m_origin[i]) / m_grid_spacing[i]));
+      if (ind < 0 or ind + 1 >= m_shape[i] or m_local_index[i][ind] < 0 or
+          m_local_index[i][ind + 1] < 0)
+        return false;
+    }
+    return true;
   }
 
   /*
@@ -118,8 +254,7 @@ public:
   value_type operator()(const Utils::Vector3d &pos, double = {}) const {
     using Utils::Interpolation::bspline_3d_accumulate;
     return bspline_3d_accumulate<2>(
-        pos,
-        [this](const std::array<int, 3> &ind) { return m_global_field(ind); },
+        pos, [this](const std::array<int, 3> &ind) { return node(ind); },
         m_grid_spacing, m_origin, value_type{});
   }
 
@@ -129,8 +264,7 @@ public:
   jacobian_type jacobian(const Utils::Vector3d &pos, double = {}) const {
     using Utils::Interpolation::bspline_3d_gradient_accumulate;
     return bspline_3d_gradient_accumulate<2>(
-        pos,
-        [this](const std::array<int, 3> &ind) { return m_global_field(ind); },
+        pos, [this](const std::array<int, 3> &ind) { return node(ind); },
         m_grid_spacing, m_origin, jacobian_type{});
   }
 
@@ -30,20 +30,26 @@
 #include "collision.hpp"
 #include "comfixed_global.hpp"
 #include "communication.hpp"
+#include "bond_error.hpp"
 #include "constraints.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
 #include "electrostatics_magnetostatics/icc.hpp"
 #include "electrostatics_magnetostatics/p3m_gpu.hpp"
+#include "energy_inline.hpp"
 #include "forcecap.hpp"
 #include "forces_inline.hpp"
+#include "fused_observables.hpp"
 #include "grid_based_algorithms/electrokinetics.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
 #include "immersed_boundaries.hpp"
 #include "integrate.hpp"
+#include "integrators/respa.hpp"
+#include "load_balancing.hpp"
 #include "nonbonded_interactions/VerletCriterion.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
+#include "pressure_inline.hpp"
 #include "short_range_loop.hpp"
 #include "virtual_sites.hpp"
 
@@ -53,7 +59,8 @@
 
 ActorList forceActors;
 
-void init_forces(const ParticleRange &particles, double time_step) {
+void init_forces(const ParticleRange &particles, double time_step,
+                 bool propagated) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
   /* The force initialization depends on the used thermostat and the
      thermodynamic ensemble */
@@ -67,7 +74,8 @@ void init_forces(const ParticleRange &particles, double time_step) {
      set torque to zero for all and rescale quaternions
   */
   for (auto &p : particles) {
-    p.f = init_local_particle_force(p, time_step);
+    if (not propagated or p.p.is_virtual)
+      p.f = init_local_particle_force(p, time_step);
   }
 
   /* initialize ghost forces with zero
@@ -84,7 +92,8 @@ void init_forces_ghosts(const ParticleRange &particles) {
   }
 }
 
-void force_calc(CellStructure &cell_structure, double time_step) {
+void force_calc(CellStructure &cell_structure, double time_step,
+                bool propagated, unsigned observables) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   espressoSystemInterface.update();
@@ -98,16 +107,22 @@ void force_calc(CellStructure &cell_structure, double time_step) {
 #ifdef ELECTROSTATICS
   icc_iteration(particles, cell_structure.ghost_particles());
 #endif
-  init_forces(particles, time_step);
+  init_forces(particles, time_step, propagated);
 
-  for (auto &forceActor : forceActors) {
-    forceActor->computeForces(espressoSystemInterface);
+  /* force groups of the multiple time stepping */
+  auto const weights = respa_force_weights();
+  RespaForceAccumulator respa_forces(particles, ghost_particles);
+
+  if (respa_forces.add_group(weights.long_range)) {
+    for (auto &forceActor : forceActors) {
+      forceActor->computeForces(espressoSystemInterface);
 #ifdef ROTATION
-    forceActor->computeTorques(espressoSystemInterface);
+      forceActor->computeTorques(espressoSystemInterface);
 #endif
-  }
+    }
 
-  calc_long_range_forces(particles);
+    calc_long_range_forces(particles);
+  }
 
 #ifdef ELECTROSTATICS
   auto const coulomb_cutoff = Coulomb::cutoff(box_geo.length());
@@ -121,20 +136,123 @@ void force_calc(CellStructure &cell_structure, double time_step) {
   auto const dipole_cutoff = INACTIVE_CUTOFF;
 #endif
 
-  short_range_loop(
-      add_bonded_force,
-      [](Particle &p1, Particle &p2, Distance const &d) {
+  auto const verlet_criterion =
+      VerletCriterion{skin, interaction_range(), coulomb_cutoff, dipole_cutoff,
+                      collision_detection_cutoff()};
+  auto const pair_kernel = [](Particle &p1, Particle &p2, Distance const &d) {
+    auto const force =
         add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2);
 #ifdef COLLISION_DETECTION
-        if (collision_params.mode != COLLISION_MODE_OFF)
-          detect_collision(p1, p2, d.dist2);
+    if (collision_params.mode != COLLISION_MODE_OFF)
+      detect_collision(p1, p2, d.dist2);
 #endif
-      },
-      maximal_cutoff(), maximal_cutoff_bonded(),
-      VerletCriterion{skin, interaction_range(), coulomb_cutoff, dipole_cutoff,
-                      collision_detection_cutoff()});
+    return force;
+  };
+
+  /* the requested observables are accumulated in the same pass over the
+   * particles as the forces */
+  fused_observables.reset(observables);
+  auto *const fused_energy = (observables & FUSED_OBSERVABLE_ENERGY)
+                                 ? &fused_observables.energy
+                                 : nullptr;
+  auto *const fused_pressure = (observables & FUSED_OBSERVABLE_PRESSURE)
+                                   ? &fused_observables.pressure
+                                   : nullptr;
+  /* false if a contribution could not be accumulated */
+  bool fused_complete = true;
+
+  auto const fused_pair_kernel = [&pair_kernel, fused_energy, fused_pressure](
+                                     Particle &p1, Particle &p2,
+                                     Distance const &d) {
+    auto const force = pair_kernel(p1, p2, d);
+    auto const dist = sqrt(d.dist2);
+    if (fused_energy)
+      add_non_bonded_pair_energy(p1, p2, d.vec21, dist, d.dist2,
+                                 *fused_energy);
+    /* the virial reuses the pair force */
+    if (fused_pressure)
+      add_non_bonded_pair_virials(p1, p2, d.vec21, dist, force,
+                                  *fused_pressure);
+  };
+
+  auto const fused_bond_kernel = [&fused_complete, fused_energy,
+                                  fused_pressure](
+                                     Particle &p1, int bond_id,
+                                     Utils::Span<Particle *> partners) {
+    if (add_bonded_force(p1, bond_id, partners))
+      return true;
+    auto const &iaparams = bonded_ia_params[bond_id];
+    try {
+      if (fused_energy) {
+        auto const result = calc_bonded_energy(iaparams, p1, partners);
+        if (result)
+          fused_energy->bonded_contribution(bond_id)[0] += result.get();
+      }
+      if (fused_pressure) {
+        auto const result = calc_bonded_pressure_tensor(iaparams, p1, partners);
+        if (result) {
+          auto const &tensor = result.get();
+          for (int k = 0; k < 3; k++)
+            for (int l = 0; l < 3; l++)
+              fused_pressure->bonded_contribution(bond_id)[k * 3 + l] +=
+                  tensor(k, l);
+        }
+      }
+    } catch (BondUnknownTypeError const &) {
+      /* leave the error to the separate calculation of the observable */
+      fused_complete = false;
+    }
+    return false;
+  };
+
+  /* the bonds are evaluated grouped by bond id, with the partners
+   * resolved once per resort */
+  auto const bond_loop = [&]() {
+    if (maximal_cutoff_bonded() < 0.)
+      return;
+    if (observables == FUSED_OBSERVABLE_NONE) {
+      cell_structure.bond_group_loop(add_bonded_group_force, add_bonded_force);
+    } else {
+      cell_structure.bond_loop(fused_bond_kernel);
+    }
+  };
+
+  auto const pair_loop = [&]() {
+    if (observables == FUSED_OBSERVABLE_NONE) {
+      short_range_loop(add_bonded_force, pair_kernel, maximal_cutoff(),
+                       INACTIVE_CUTOFF, verlet_criterion);
+    } else {
+      short_range_loop(add_bonded_force, fused_pair_kernel, maximal_cutoff(),
+                       INACTIVE_CUTOFF, verlet_criterion);
+    }
+  };
+
+  LoadBalancing::start_force_timer();
+  if (weights.bonded == weights.short_range) {
+    if (respa_forces.add_group(weights.short_range)) {
+      bond_loop();
+      pair_loop();
+    } else {
+      cell_structure.update_verlet_list(verlet_criterion);
+      fused_complete = false;
+    }
+  } else {
+    if (respa_forces.add_group(weights.short_range)) {
+      pair_loop();
+    } else {
+      cell_structure.update_verlet_list(verlet_criterion);
+      fused_complete = false;
+    }
+    if (respa_forces.add_group(weights.bonded)) {
+      bond_loop();
+    } else {
+      fused_complete = false;
+    }
+  }
+  respa_forces.finalize();
 
   Constraints::constraints.add_forces(particles, sim_time);
+  LoadBalancing::stop_force_timer();
 
   if (max_oif_objects) {
     // There are two global quantities that need to be evaluated:
@@ -177,6 +295,8 @@ void force_calc(CellStructure &cell_structure, double time_step) {
 
   // mark that forces are now up-to-date
   recalc_forces = false;
+  if (fused_complete)
+    fused_observables.flags = observables;
 }
 
 void calc_long_range_forces(const ParticleRange &particles) {
@@ -34,13 +34,20 @@
 #include "actor/ActorList.hpp"
 #include "bonded_interactions/bonded_interaction_data.hpp"
 #include "cells.hpp"
+#include "fused_observables.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 
 extern ActorList forceActors;
 
 /** initialize real particle forces with thermostat forces and
-    ghost particle forces with zero. */
-void init_forces(const ParticleRange &particles, double time_step);
+    ghost particle forces with zero.
+    @param particles  local particles
+    @param time_step  time step
+    @param propagated whether the propagation kernel already initialized
+                      the forces of the non-virtual local particles
+ */
+void init_forces(const ParticleRange &particles, double time_step,
+                 bool propagated = false);
 
 /** Set forces of all ghosts to zero */
 void init_forces_ghosts(const ParticleRange &particles);
@@ -54,8 +61,18 @@ void init_forces_ghosts(const ParticleRange &particles);
  *  <li> Calculate non-bonded short range interaction forces
  *  <li> Calculate long range interaction forces
  *  </ol>
+ *
+ *  @param cell_structure  cell structure
+ *  @param time_step       time step
+ *  @param propagated      whether the propagation kernel already initialized
+ *                         the forces of the non-virtual local particles
+ *  @param observables     observables to accumulate in
+ *                         @ref fused_observables, a combination of
+ *                         @ref FusedObservable
  */
-void force_calc(CellStructure &cell_structure, double time_step);
+void force_calc(CellStructure &cell_structure, double time_step,
+                bool propagated = false,
+                unsigned observables = FUSED_OBSERVABLE_NONE);
 
 /** Calculate long range forces (P3M, ...). */
 void calc_long_range_forces(const ParticleRange &particles);
@@ -41,6 +41,7 @@
 #include "nonbonded_interactions/morse.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "nonbonded_interactions/nonbonded_tab.hpp"
+#include "nonbonded_interactions/pair_splines.hpp"
 #include "nonbonded_interactions/smooth_step.hpp"
 #include "nonbonded_interactions/soft_sphere.hpp"
 #include "nonbonded_interactions/thole.hpp"
@@ -60,7 +61,9 @@
 #include "dpd.hpp"
 #endif
 
+#include "BondTopology.hpp"
 #include "Particle.hpp"
+#include "bond_error.hpp"
 #include "errorhandling.hpp"
 #include "exclusions.hpp"
 #include "rotation.hpp"
@@ -70,9 +73,12 @@
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
+#include <boost/container/static_vector.hpp>
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
 
+#include <array>
+#include <cstddef>
 #include <tuple>
 
 /** Initialize the forces for a ghost particle */
@@ -100,8 +106,8 @@ inline ParticleForce external_force(Particle const &p) {
   return f;
 }
 
-inline ParticleForce thermostat_force(Particle const &p, double time_step) {
-  extern LangevinThermostat langevin;
+inline ParticleForce thermostat_force(LangevinThermostat const &langevin,
+                                      Particle const &p, double time_step) {
   if (!(thermo_switch & THERMO_LANGEVIN)) {
     return {};
   }
@@ -117,19 +123,34 @@ inline ParticleForce thermostat_force(Particle const &p, double time_step) {
 #endif
 }
 
+inline ParticleForce thermostat_force(Particle const &p, double time_step) {
+  extern LangevinThermostat langevin;
+  return thermostat_force(langevin, p, time_step);
+}
+
 /** Initialize the forces for a real particle */
 inline ParticleForce init_local_particle_force(Particle const &part,
                                                double time_step) {
   return thermostat_force(part, time_step) + external_force(part);
 }
 
-inline ParticleForce calc_non_bonded_pair_force(Particle const &p1,
-                                                Particle const &p2,
-                                                IA_parameters const &ia_params,
-                                                Utils::Vector3d const &d,
-                                                double const dist) {
+/** Initialize the forces for a real particle with the noise of a given
+ *  state of the Langevin thermostat.
+ */
+inline ParticleForce
+init_local_particle_force(LangevinThermostat const &langevin,
+                          Particle const &part, double time_step) {
+  return thermostat_force(langevin, part, time_step) + external_force(part);
+}
 
-  ParticleForce pf{};
+/** Force factor of the isotropic non-bonded potentials of a type pair.
+ *  @param ia_params  the interaction parameters between the two particles
+ *  @param dist       distance between the particles
+ *  @return the sum of the force factors, the force is their product with
+ *  the distance vector
+ */
+inline double calc_central_pair_force_factor(IA_parameters const &ia_params,
+                                             double const dist) {
   double force_factor = 0;
 /* Lennard-Jones */
 #ifdef LENNARD_JONES
@@ -183,13 +204,31 @@ inline ParticleForce calc_non_bonded_pair_force(Particle const &p1,
 #ifdef LJCOS2
   force_factor += ljcos2_pair_force_factor(ia_params, dist);
 #endif
-/* Thole damping */
-#ifdef THOLE
-  pf.f += thole_pair_force(p1, p2, ia_params, d, dist);
-#endif
 /* tabulated */
 #ifdef TABULATED
   force_factor += tabulated_pair_force_factor(ia_params, dist);
+#endif
+  return force_factor;
+}
+
+inline ParticleForce calc_non_bonded_pair_force(Particle const &p1,
+                                                Particle const &p2,
+                                                IA_parameters const &ia_params,
+                                                Utils::Vector3d const &d,
+                                                double const dist) {
+
+  ParticleForce pf{};
+  double force_factor;
+  double t = 0.;
+  auto const *spline = get_pair_spline(p1.p.type, p2.p.type);
+  if (auto const *interval = spline ? spline->find(dist * dist, t) : nullptr) {
+    force_factor = PairSpline::evaluate(interval->force_factor, t);
+  } else {
+    force_factor = calc_central_pair_force_factor(ia_params, dist);
+  }
+/* Thole damping */
+#ifdef THOLE
+  pf.f += thole_pair_force(p1, p2, ia_params, d, dist);
 #endif
 /* Gay-Berne */
 #ifdef GAY_BERNE
@@ -224,10 +263,12 @@ inline ParticleForce calc_opposing_force(ParticleForce const &pf,
  *  @param[in] d        vector between @p p1 and @p p2.
  *  @param dist         distance between @p p1 and @p p2.
  *  @param dist2        distance squared between @p p1 and @p p2.
+ *  @return Force of the non-bonded pair potentials on @p p1, without
+ *  electrostatics, magnetostatics and thermostat.
  */
-inline void add_non_bonded_pair_force(Particle &p1, Particle &p2,
-                                      Utils::Vector3d const &d, double dist,
-                                      double dist2) {
+inline Utils::Vector3d add_non_bonded_pair_force(Particle &p1, Particle &p2,
+                                                 Utils::Vector3d const &d,
+                                                 double dist, double dist2) {
   IA_parameters const &ia_params = *get_ia_param(p1.p.type, p2.p.type);
   ParticleForce pf{};
 
@@ -241,6 +282,7 @@ inline void add_non_bonded_pair_force(Particle &p1, Particle &p2,
 #endif
       pf += calc_non_bonded_pair_force(p1, p2, ia_params, d, dist);
   }
+  auto const pair_force = pf.f;
 
   /***********************************************/
   /* short-range electrostatics                  */
@@ -294,6 +336,8 @@ inline void add_non_bonded_pair_force(Particle &p1, Particle &p2,
 
   p1.f += pf;
   p2.f += calc_opposing_force(pf, d);
+
+  return pair_force;
 }
 
 /** Compute the bonded interaction force between particle pairs.
@@ -469,4 +513,165 @@ inline bool add_bonded_force(Particle &p1, int bond_id,
   }
 }
 
+namespace detail {
+/** Report a broken bond of a bond group.
+ *  @param topology    bond topology
+ *  @param bond        owner and partners of the bond
+ *  @param n_partners  number of partners
+ */
+inline void bond_group_broken_error(BondTopology const &topology,
+                                    int const *bond, int n_partners) {
+  boost::container::static_vector<int, 3> partner_ids;
+  for (int i = 1; i <= n_partners; i++) {
+    partner_ids.push_back(topology.particles[bond[i]]->identity());
+  }
+  bond_broken_error(topology.particles[bond[0]]->identity(),
+                    Utils::make_const_span(partner_ids));
+}
+
+/** Forces of a group of pair bonds of the same bond type. */
+template <class Bond>
+void add_pair_bond_group_force(Bond const &iaparams,
+                               Utils::Span<const int> bonds,
+                               BondTopology &topology) {
+  auto const &pos = topology.positions;
+  auto &force = topology.forces;
+  for (std::size_t i = 0; i < bonds.size(); i += 2) {
+    auto const i1 = bonds[i];
+    auto const i2 = bonds[i + 1];
+    auto const dx = get_mi_vector(pos[i1], pos[i2], box_geo);
+    auto const result = iaparams.force(dx);
+    if (result) {
+      force[i1] += result.get();
+      force[i2] -= result.get();
+
+#ifdef NPT
+      npt_add_virial_force_contribution(result.get(), dx);
+#endif
+    } else {
+      bond_group_broken_error(topology, bonds.data() + i, 1);
+    }
+  }
+}
+
+/** Forces of a group of angle bonds of the same bond type. */
+template <class Bond>
+void add_angle_bond_group_force(Bond const &iaparams,
+                                Utils::Span<const int> bonds,
+                                BondTopology &topology) {
+  auto const &pos = topology.positions;
+  auto &force = topology.forces;
+  for (std::size_t i = 0; i < bonds.size(); i += 3) {
+    auto const i1 = bonds[i];
+    auto const i2 = bonds[i + 1];
+    auto const i3 = bonds[i + 2];
+    auto const forces = iaparams.forces(pos[i1], pos[i2], pos[i3]);
+
+    using std::get;
+    force[i1] += get<0>(forces);
+    force[i2] += get<1>(forces);
+    force[i3] += get<2>(forces);
+  }
+}
+
+/** Forces of a group of dihedral bonds of the same bond type. */
+template <class Bond>
+void add_dihedral_bond_group_force(Bond const &iaparams,
+                                   Utils::Span<const int> bonds,
+                                   BondTopology &topology) {
+  auto const &pos = topology.positions;
+  auto &force = topology.forces;
+  for (std::size_t i = 0; i < bonds.size(); i += 4) {
+    auto const i1 = bonds[i];
+    auto const i2 = bonds[i + 1];
+    auto const i3 = bonds[i + 2];
+    auto const i4 = bonds[i + 3];
+    auto const result = iaparams.forces(pos[i2], pos[i1], pos[i3], pos[i4]);
+    if (result) {
+      using std::get;
+      auto const &forces = result.get();
+
+      force[i1] += get<0>(forces);
+      force[i2] += get<1>(forces);
+      force[i3] += get<2>(forces);
+      force[i4] += get<3>(forces);
+    } else {
+      bond_group_broken_error(topology, bonds.data() + i, 3);
+    }
+  }
+}
+
+/** Visitor that evaluates the forces of all bonds of a bond id.
+ *
+ *  The common bond types are evaluated by a kernel for their type on
+ *  the positions and forces of the topology, all other types bond by
+ *  bond with @ref add_bonded_force on the particles.
+ */
+class BondGroupForce : public boost::static_visitor<void> {
+  int m_bond_id;
+  Utils::Span<const int> m_bonds;
+  BondTopology &m_topology;
+
+public:
+  BondGroupForce(int bond_id, Utils::Span<const int> bonds,
+                 BondTopology &topology)
+      : m_bond_id(bond_id), m_bonds(bonds), m_topology(topology) {}
+
+  void operator()(FeneBond const &iaparams) const {
+    add_pair_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+  void operator()(HarmonicBond const &iaparams) const {
+    add_pair_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+  void operator()(AngleHarmonicBond const &iaparams) const {
+    add_angle_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+  void operator()(AngleCosineBond const &iaparams) const {
+    add_angle_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+  void operator()(AngleCossquareBond const &iaparams) const {
+    add_angle_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+  void operator()(DihedralBond const &iaparams) const {
+    add_dihedral_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+#ifdef TABULATED
+  void operator()(TabulatedDistanceBond const &iaparams) const {
+    add_pair_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+  void operator()(TabulatedAngleBond const &iaparams) const {
+    add_angle_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+  void operator()(TabulatedDihedralBond const &iaparams) const {
+    add_dihedral_bond_group_force(iaparams, m_bonds, m_topology);
+  }
+#endif
+
+  template <class Bond> void operator()(Bond const &) const {
+    auto const &particles = m_topology.particles;
+    for (std::size_t i = 0; i < m_bonds.size(); i += Bond::num + 1) {
+      std::array<Particle *, Bond::num> partners;
+      for (int j = 0; j < Bond::num; j++) {
+        partners[j] = particles[m_bonds[i + 1 + j]];
+      }
+      if (add_bonded_force(*particles[m_bonds[i]], m_bond_id,
+                           Utils::make_span(partners))) {
+        bond_group_broken_error(m_topology, m_bonds.data() + i, Bond::num);
+      }
+    }
+  }
+};
+} // namespace detail
+
+/** Add the forces of all bonds of a bond id.
+ *  @param bond_id   bond id
+ *  @param bonds     owners and partners of the bonds, back to back
+ *  @param topology  bond topology the bonds refer to
+ */
+inline void add_bonded_group_force(int bond_id, Utils::Span<const int> bonds,
+                                   BondTopology &topology) {
+  boost::apply_visitor(detail::BondGroupForce{bond_id, bonds, topology},
+                       bonded_ia_params[bond_id]);
+}
+
 #endif
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fused_observables.hpp"
+
+#include "Observable_stat.hpp"
+#include "integrate.hpp"
+
+FusedObservables fused_observables;
+
+void FusedObservables::reset(unsigned observables) {
+  flags = FUSED_OBSERVABLE_NONE;
+  if (observables & FUSED_OBSERVABLE_ENERGY)
+    energy = Observable_stat{1};
+  if (observables & FUSED_OBSERVABLE_PRESSURE)
+    pressure = Observable_stat{9};
+}
+
+bool FusedObservables::valid(FusedObservable observable) const {
+  /* any change of the particles or interactions since the force
+   * calculation requests new forces */
+  return (flags & observable) and not recalc_forces;
+}
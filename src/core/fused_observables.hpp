@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_FUSED_OBSERVABLES_HPP
+#define ESPRESSO_FUSED_OBSERVABLES_HPP
+/** \file
+ *  Energies and virials accumulated by the force calculation.
+ *
+ *  When an automatically updated accumulator samples the energy or the
+ *  pressure right after an integration step, @ref force_calc can
+ *  accumulate the bonded and short-range non-bonded contributions in the
+ *  same pass over the particle pairs as the forces. @ref energy_calc and
+ *  @ref pressure_calc then only add the kinetic, long-range and external
+ *  contributions.
+ *
+ *  Implementation in fused_observables.cpp.
+ */
+
+#include "Observable_stat.hpp"
+
+/** Observables that can be accumulated by the force calculation. */
+enum FusedObservable : unsigned {
+  FUSED_OBSERVABLE_NONE = 0u,
+  FUSED_OBSERVABLE_ENERGY = 1u,
+  FUSED_OBSERVABLE_PRESSURE = 2u
+};
+
+/** Bonded and short-range non-bonded contributions of the local particles
+ *  to the energy and the pressure tensor.
+ */
+struct FusedObservables {
+  /** Accumulated observables, a combination of @ref FusedObservable. */
+  unsigned flags = FUSED_OBSERVABLE_NONE;
+  /** Energy contributions. */
+  Observable_stat energy{1};
+  /** Virial contributions, not divided by the volume. */
+  Observable_stat pressure{9};
+
+  /** Clear the observables in @p observables before a force calculation.
+   *  The flags are set once all contributions were added.
+   */
+  void reset(unsigned observables);
+  /** Whether @p observable was accumulated for the current particle
+   *  positions and interactions.
+   */
+  bool valid(FusedObservable observable) const;
+  /** Discard the accumulated observables. */
+  void invalidate() { flags = FUSED_OBSERVABLE_NONE; }
+};
+
+/** Observables accumulated by the last force calculation. */
+extern FusedObservables fused_observables;
+
+#endif
@@ -37,7 +37,10 @@
 
 #include <mpi.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <vector>
 
 /**********************************************
  * variables
@@ -48,6 +51,8 @@ LocalBox<double> local_geo;
 
 Utils::Vector3i node_grid{};
 
+std::array<std::vector<double>, 3> node_boundaries{};
+
 /************************************************************/
 
 void init_node_grid() { grid_changed_n_nodes(); }
@@ -57,7 +62,16 @@ int map_position_node_array(const Utils::Vector3d &pos) {
 
   Utils::Vector3i im;
   for (int i = 0; i < 3; i++) {
-    im[i] = static_cast<int>(std::floor(f_pos[i] / local_geo.length()[i]));
+    auto const &bounds = node_boundaries[i];
+    if (bounds.empty()) {
+      im[i] = static_cast<int>(std::floor(f_pos[i] / local_geo.length()[i]));
+    } else {
+      auto const f = f_pos[i] / box_geo.length()[i];
+      im[i] = static_cast<int>(
+                  std::upper_bound(bounds.begin(), bounds.end(), f) -
+                  bounds.begin()) -
+              1;
+    }
     im[i] = boost::algorithm::clamp(im[i], 0, node_grid[i] - 1);
   }
 
@@ -95,8 +109,39 @@ LocalBox<double> regular_decomposition(const BoxGeometry &box,
   return {my_left, local_length, boundaries};
 }
 
+LocalBox<double>
+balanced_decomposition(const BoxGeometry &box, Utils::Vector3i const &node_pos,
+                       Utils::Vector3i const &node_grid_par,
+                       std::array<std::vector<double>, 3> const &bounds) {
+  auto const regular = regular_decomposition(box, node_pos, node_grid_par);
+  auto my_left = regular.my_left();
+  auto local_length = regular.length();
+
+  for (int i = 0; i < 3; i++) {
+    if (bounds[i].empty())
+      continue;
+    auto const lower = bounds[i][node_pos[i]];
+    auto const upper = bounds[i][node_pos[i] + 1];
+    my_left[i] = lower * box.length()[i];
+    local_length[i] = upper * box.length()[i] - my_left[i];
+    /* the right boundary must not fall short of the left boundary of
+       the next node, otherwise particles in between have no owner. */
+    while (my_left[i] + local_length[i] < upper * box.length()[i]) {
+      local_length[i] = std::nextafter(local_length[i], box.length()[i]);
+    }
+  }
+
+  return {my_left, local_length, regular.boundary()};
+}
+
 void grid_changed_box_l(const BoxGeometry &box) {
-  local_geo = regular_decomposition(box, calc_node_pos(comm_cart), node_grid);
+  auto const node_pos = calc_node_pos(comm_cart);
+  auto const balanced =
+      std::any_of(node_boundaries.begin(), node_boundaries.end(),
+                  [](auto const &b) { return not b.empty(); });
+  local_geo = balanced ? balanced_decomposition(box, node_pos, node_grid,
+                                                node_boundaries)
+                       : regular_decomposition(box, node_pos, node_grid);
 }
 
 void grid_changed_n_nodes() {
@@ -107,6 +152,9 @@ void grid_changed_n_nodes() {
 
   calc_node_neighbors(comm_cart);
 
+  for (auto &b : node_boundaries)
+    b.clear();
+
   grid_changed_box_l(box_geo);
 }
 
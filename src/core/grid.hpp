@@ -38,12 +38,22 @@
 
 #include <boost/mpi/communicator.hpp>
 
+#include <array>
+#include <vector>
+
 extern BoxGeometry box_geo;
 extern LocalBox<double> local_geo;
 
 /** The number of nodes in each spatial dimension. */
 extern Utils::Vector3i node_grid;
 
+/** Boundaries of the subdomains along each axis, in units of the box
+ *  length. An axis with @c node_grid[i]+1 entries ranging from 0 to 1
+ *  is split at these positions, an empty axis is split regularly.
+ *  Set by the load balancer, see load_balancing.hpp.
+ */
+extern std::array<std::vector<double>, 3> node_boundaries;
+
 /** Make sure that the node grid is set, eventually
  *  determine one automatically.
  */
@@ -112,4 +122,23 @@ inline Utils::Vector3d unfolded_position(const Utils::Vector3d &pos,
 LocalBox<double> regular_decomposition(const BoxGeometry &box,
                                        Utils::Vector3i const &node_pos,
                                        Utils::Vector3i const &node_grid);
+
+/**
+ * @brief Composition of the simulation box into slabs of unequal width.
+ *
+ * Along each axis, the subdomain of the node extends between the
+ * fractional boundaries @p boundaries[i][node_pos[i]] and
+ * @p boundaries[i][node_pos[i] + 1]. Axes without boundaries are
+ * split regularly.
+ *
+ * @param box Geometry of the simulation box
+ * @param node_pos Position of node in the node grid
+ * @param node_grid Nodes in each direction
+ * @param boundaries Fractional subdomain boundaries per axis
+ * @return Geometry for the node
+ */
+LocalBox<double>
+balanced_decomposition(const BoxGeometry &box, Utils::Vector3i const &node_pos,
+                       Utils::Vector3i const &node_grid,
+                       std::array<std::vector<double>, 3> const &boundaries);
 #endif
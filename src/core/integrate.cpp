@@ -28,6 +28,8 @@
 
 #include "integrate.hpp"
 #include "integrators/brownian_inline.hpp"
+#include "integrators/fire.hpp"
+#include "integrators/respa.hpp"
 #include "integrators/steepest_descent.hpp"
 #include "integrators/stokesian_dynamics_inline.hpp"
 #include "integrators/velocity_verlet_inline.hpp"
@@ -38,6 +40,7 @@
 #include "cells.hpp"
 #include "collision.hpp"
 #include "communication.hpp"
+#include "electrostatics_magnetostatics/icc.hpp"
 #include "errorhandling.hpp"
 #include "event.hpp"
 #include "forces.hpp"
@@ -45,6 +48,7 @@
 #include "grid.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
+#include "load_balancing.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
 #include "rattle.hpp"
@@ -83,6 +87,38 @@ void notify_sig_int() {
   ctrl_C = 0;              // reset
   set_py_interrupt = true; // global to notify Python
 }
+
+/** Whether the integrator minimizes the energy instead of propagating
+ *  the equations of motion.
+ */
+bool integrator_is_minimizer() {
+  return integ_switch == INTEG_METHOD_STEEPEST_DESCENT or
+         integ_switch == INTEG_METHOD_FIRE;
+}
+
+/** Whether the propagation kernel initializes the forces of the next force
+ *  calculation, see @ref velocity_verlet_fused_step_1. Selected at the
+ *  start of the integration.
+ */
+bool fused_propagation = false;
+
+/** Whether the active features allow to initialize the forces during the
+ *  propagation, i.e. no particle is modified between the propagation and
+ *  the force calculation.
+ */
+bool fused_propagation_allowed() {
+  if (integ_switch != INTEG_METHOD_NVT)
+    return false;
+#ifdef BOND_CONSTRAINT
+  if (n_rigidbonds)
+    return false;
+#endif
+#ifdef ELECTROSTATICS
+  if (icc_cfg.n_icc)
+    return false;
+#endif
+  return true;
+}
 } // namespace
 
 void integrator_sanity_checks() {
@@ -95,11 +131,34 @@ void integrator_sanity_checks() {
       runtimeErrorMsg()
           << "The steepest descent integrator is incompatible with thermostats";
     break;
+  case INTEG_METHOD_FIRE:
+    if (thermo_switch != THERMO_OFF)
+      runtimeErrorMsg()
+          << "The FIRE integrator is incompatible with thermostats";
+    break;
   case INTEG_METHOD_NVT:
     if (thermo_switch & (THERMO_NPT_ISO | THERMO_BROWNIAN | THERMO_SD))
       runtimeErrorMsg() << "The VV integrator is incompatible with the "
                            "currently active combination of thermostats";
     break;
+  case INTEG_METHOD_RESPA:
+    if (thermo_switch & (THERMO_NPT_ISO | THERMO_BROWNIAN | THERMO_SD))
+      runtimeErrorMsg() << "The r-RESPA integrator is incompatible with the "
+                           "currently active combination of thermostats";
+    /* forces of GPU actors are only added after the weighting */
+    if (not forceActors.empty())
+      runtimeErrorMsg() << "The r-RESPA integrator is incompatible with "
+                           "GPU force actors";
+#ifdef COLLISION_DETECTION
+    /* collisions are detected in the pair loop, which is skipped in the
+     * steps between two short-range force evaluations */
+    if (collision_params.mode != COLLISION_MODE_OFF and
+        respa_parameters().short_range != 1)
+      runtimeErrorMsg() << "The r-RESPA integrator is incompatible with "
+                           "collision detection unless the short-range "
+                           "interval is 1";
+#endif
+    break;
 #ifdef NPT
   case INTEG_METHOD_NPT_ISO:
     if (thermo_switch != THERMO_OFF and thermo_switch != THERMO_NPT_ISO)
@@ -130,8 +189,18 @@ bool integrator_step_1(ParticleRange &particles) {
     if (steepest_descent_step(particles))
       return true; // early exit
     break;
+  case INTEG_METHOD_FIRE:
+    if (fire_step(particles))
+      return true; // early exit
+    break;
   case INTEG_METHOD_NVT:
-    velocity_verlet_step_1(particles);
+    if (fused_propagation)
+      velocity_verlet_fused_step_1(particles);
+    else
+      velocity_verlet_step_1(particles);
+    break;
+  case INTEG_METHOD_RESPA:
+    respa_step_1(particles);
     break;
 #ifdef NPT
   case INTEG_METHOD_NPT_ISO:
@@ -157,9 +226,11 @@ bool integrator_step_1(ParticleRange &particles) {
 void integrator_step_2(ParticleRange &particles) {
   switch (integ_switch) {
   case INTEG_METHOD_STEEPEST_DESCENT:
+  case INTEG_METHOD_FIRE:
     // Nothing
     break;
   case INTEG_METHOD_NVT:
+  case INTEG_METHOD_RESPA:
     velocity_verlet_step_2(particles);
     break;
 #ifdef NPT
@@ -181,7 +252,7 @@ void integrator_step_2(ParticleRange &particles) {
   }
 }
 
-int integrate(int n_steps, int reuse_forces) {
+int integrate(int n_steps, int reuse_forces, unsigned observables) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   /* Prepare the integrator */
@@ -191,6 +262,12 @@ int integrate(int n_steps, int reuse_forces) {
   if (check_runtime_errors(comm_cart))
     return 0;
 
+  fused_propagation = fused_propagation_allowed();
+
+  /* observables accumulated by an earlier force calculation are not
+   * valid once the particles move */
+  fused_observables.invalidate();
+
   /* Verlet list criterion */
 
   /* Integration Step: Preparation for first integration step:
@@ -207,9 +284,10 @@ int integrate(int n_steps, int reuse_forces) {
     // Communication step: distribute ghost positions
     cells_update_ghosts(global_ghost_flags());
 
-    force_calc(cell_structure, time_step);
+    force_calc(cell_structure, time_step, false,
+               (n_steps == 0) ? observables : FUSED_OBSERVABLE_NONE);
 
-    if (integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
+    if (not integrator_is_minimizer()) {
 #ifdef ROTATION
       convert_initial_torques(cell_structure.local_particles());
 #endif
@@ -253,7 +331,7 @@ int integrate(int n_steps, int reuse_forces) {
     /* Correct those particle positions that participate in a rigid/constrained
      * bond */
     if (n_rigidbonds) {
-      correct_position_shake(cell_structure);
+      correct_position_constraints(cell_structure);
     }
 #endif
 
@@ -269,7 +347,9 @@ int integrate(int n_steps, int reuse_forces) {
 
     particles = cell_structure.local_particles();
 
-    force_calc(cell_structure, time_step);
+    /* the observables are only sampled after the last step */
+    force_calc(cell_structure, time_step, fused_propagation,
+               (step == n_steps - 1) ? observables : FUSED_OBSERVABLE_NONE);
 
 #ifdef VIRTUAL_SITES
     virtual_sites()->after_force_calc();
@@ -278,12 +358,12 @@ int integrate(int n_steps, int reuse_forces) {
 #ifdef BOND_CONSTRAINT
     // SHAKE velocity updates
     if (n_rigidbonds) {
-      correct_velocity_shake(cell_structure);
+      correct_velocity_constraints(cell_structure);
     }
 #endif
 
     // propagate one-step functionalities
-    if (integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
+    if (not integrator_is_minimizer()) {
       lb_lbfluid_propagate();
       lb_lbcoupling_propagate();
 
@@ -296,6 +376,8 @@ int integrate(int n_steps, int reuse_forces) {
 #endif
     }
 
+    LoadBalancing::on_integration_step();
+
     integrated_steps++;
 
     if (check_runtime_errors(comm_cart))
@@ -368,13 +450,20 @@ int python_integrate(int n_steps, bool recalc_forces_par,
   }
 
   using Accumulators::auto_update;
+  using Accumulators::auto_update_next_fused_observables;
   using Accumulators::auto_update_next_update;
 
   for (int i = 0; i < n_steps;) {
     /* Integrate to either the next accumulator update, or the
      * end, depending on what comes first. */
-    auto const steps = std::min((n_steps - i), auto_update_next_update());
-    if (mpi_integrate(steps, reuse_forces))
+    auto const next_update = auto_update_next_update();
+    auto const steps = std::min((n_steps - i), next_update);
+    /* the last force calculation before the update also accumulates
+     * the short-range energies and virials the accumulators need */
+    auto const observables = (steps == next_update)
+                                 ? auto_update_next_fused_observables()
+                                 : FUSED_OBSERVABLE_NONE;
+    if (mpi_integrate(steps, reuse_forces, observables))
       return ES_ERROR;
 
     reuse_forces = 1;
@@ -392,27 +481,28 @@ int python_integrate(int n_steps, bool recalc_forces_par,
   return ES_OK;
 }
 
-static int mpi_steepest_descent_local(int steps, int) {
+static int mpi_minimize_energy_local(int steps, int) {
   return integrate(steps, -1);
 }
-REGISTER_CALLBACK_MASTER_RANK(mpi_steepest_descent_local)
+REGISTER_CALLBACK_MASTER_RANK(mpi_minimize_energy_local)
 
-int mpi_steepest_descent(int steps) {
+int mpi_minimize_energy(int steps) {
   return mpi_call(Communication::Result::master_rank,
-                  mpi_steepest_descent_local, steps, 0);
+                  mpi_minimize_energy_local, steps, 0);
 }
 
-static int mpi_integrate_local(int n_steps, int reuse_forces) {
-  integrate(n_steps, reuse_forces);
+static int mpi_integrate_local(int n_steps, int reuse_forces,
+                               unsigned observables) {
+  integrate(n_steps, reuse_forces, observables);
 
   return check_runtime_errors_local();
 }
 
 REGISTER_CALLBACK_REDUCTION(mpi_integrate_local, std::plus<int>())
 
-int mpi_integrate(int n_steps, int reuse_forces) {
+int mpi_integrate(int n_steps, int reuse_forces, unsigned observables) {
   return mpi_call(Communication::Result::reduction, std::plus<int>(),
-                  mpi_integrate_local, n_steps, reuse_forces);
+                  mpi_integrate_local, n_steps, reuse_forces, observables);
 }
 
 void integrate_set_steepest_descent(const double f_max, const double gamma,
@@ -422,11 +512,26 @@ void integrate_set_steepest_descent(const double f_max, const double gamma,
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
 }
 
+void integrate_set_fire(double f_max, double dt_max, double dt_min,
+                        double max_displacement, int n_delay, double f_inc,
+                        double f_dec, double alpha_start, double f_alpha) {
+  fire_init(FireParameters{f_max, dt_max, dt_min, max_displacement, n_delay,
+                           f_inc, f_dec, alpha_start, f_alpha});
+  integ_switch = INTEG_METHOD_FIRE;
+  mpi_bcast_parameter(FIELD_INTEG_SWITCH);
+}
+
 void integrate_set_nvt() {
   integ_switch = INTEG_METHOD_NVT;
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
 }
 
+void integrate_set_respa(int bonded, int short_range, int long_range) {
+  respa_init(bonded, short_range, long_range);
+  integ_switch = INTEG_METHOD_RESPA;
+  mpi_bcast_parameter(FIELD_INTEG_SWITCH);
+}
+
 void integrate_set_bd() {
   integ_switch = INTEG_METHOD_BD;
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
@@ -27,6 +27,8 @@
  *  Implementation in \ref integrate.cpp.
  */
 
+#include "fused_observables.hpp"
+
 /** \name Integrator switches */
 /**@{*/
 #define INTEG_METHOD_NPT_ISO 0
@@ -34,6 +36,8 @@
 #define INTEG_METHOD_STEEPEST_DESCENT 2
 #define INTEG_METHOD_BD 3
 #define INTEG_METHOD_SD 7
+#define INTEG_METHOD_RESPA 8
+#define INTEG_METHOD_FIRE 9
 /**@}*/
 
 /** Switch determining which integrator to use. */
@@ -99,9 +103,14 @@ void integrator_sanity_checks();
  *  High-level documentation of the integration and thermostatting schemes
  *  can be found in doc/sphinx/system_setup.rst and /doc/sphinx/running.rst
  *
+ *  The force calculation of the last step (or the initial one if
+ *  @p n_steps is zero) also accumulates @p observables in
+ *  @ref fused_observables.
+ *
  *  @return number of steps that have been integrated
  */
-int integrate(int n_steps, int reuse_forces);
+int integrate(int n_steps, int reuse_forces,
+              unsigned observables = FUSED_OBSERVABLE_NONE);
 
 /** @brief Run the integration loop. Can be interrupted with Ctrl+C.
  *
@@ -116,28 +125,45 @@ int python_integrate(int n_steps, bool recalc_forces, bool reuse_forces);
 /** Start integrator.
  *  @param n_steps       how many steps to do.
  *  @param reuse_forces  whether to trust the old forces for the first half step
+ *  @param observables   observables to accumulate in the last force
+ *                       calculation, a combination of @ref FusedObservable
  *  @return nonzero on error
  */
-int mpi_integrate(int n_steps, int reuse_forces);
+int mpi_integrate(int n_steps, int reuse_forces,
+                  unsigned observables = FUSED_OBSERVABLE_NONE);
 
-/** Steepest descent main integration loop
+/** Energy minimization main integration loop, for the steepest descent
+ *  and the FIRE integrators.
  *
  *  Integration stops when the maximal force is lower than the user limit
- *  @ref SteepestDescentParameters::f_max "f_max" or when the maximal number
+ *  @ref SteepestDescentParameters::f_max "f_max" resp.
+ *  @ref FireParameters::f_max "f_max" or when the maximal number
  *  of steps @p steps is reached.
  *
  *  @param steps Maximal number of integration steps
  *  @return number of integrated steps
  */
-int mpi_steepest_descent(int steps);
+int mpi_minimize_energy(int steps);
 
 /** @brief Set the steepest descent integrator for energy minimization. */
 void integrate_set_steepest_descent(double f_max, double gamma,
                                     double max_displacement);
 
+/** @brief Set the FIRE integrator for energy minimization. */
+void integrate_set_fire(double f_max, double dt_max, double dt_min,
+                        double max_displacement, int n_delay, double f_inc,
+                        double f_dec, double alpha_start, double f_alpha);
+
 /** @brief Set the velocity Verlet integrator for the NVT ensemble. */
 void integrate_set_nvt();
 
+/** @brief Set the velocity Verlet integrator with multiple time steps.
+ *  @param bonded       interval of the bonded forces
+ *  @param short_range  interval of the short-range forces
+ *  @param long_range   interval of the long-range forces
+ */
+void integrate_set_respa(int bonded, int short_range, int long_range);
+
 /** @brief Set the Brownian Dynamics integrator. */
 void integrate_set_bd();
 
@@ -35,13 +35,20 @@
 
 inline void brownian_dynamics_propagator(BrownianThermostat const &brownian,
                                          const ParticleRange &particles) {
+  BrownianNoise const noise(brownian, particles);
+  auto noise_pos = noise.pos.begin();
+  auto noise_vel = noise.vel.begin();
+#ifdef ROTATION
+  auto noise_pos_rot = noise.pos_rot.begin();
+  auto noise_vel_rot = noise.vel_rot.begin();
+#endif
   for (auto &p : particles) {
     // Don't propagate translational degrees of freedom of vs
     if (!(p.p.is_virtual) or thermo_virtual) {
       p.r.p += bd_drag(brownian.gamma, p, time_step);
       p.m.v = bd_drag_vel(brownian.gamma, p);
-      p.r.p += bd_random_walk(brownian, p, time_step);
-      p.m.v += bd_random_walk_vel(brownian, p);
+      p.r.p += bd_random_walk(brownian, p, time_step, *noise_pos++);
+      p.m.v += bd_random_walk_vel(brownian, p, *noise_vel++);
       /* Verlet criterion check */
       if ((p.r.p - p.l.p_old).norm2() > Utils::sqr(0.5 * skin))
         cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
@@ -52,8 +59,8 @@ inline void brownian_dynamics_propagator(BrownianThermostat const &brownian,
     convert_torque_to_body_frame_apply_fix(p);
     p.r.quat = bd_drag_rot(brownian.gamma_rotation, p, time_step);
     p.m.omega = bd_drag_vel_rot(brownian.gamma_rotation, p);
-    p.r.quat = bd_random_walk_rot(brownian, p, time_step);
-    p.m.omega += bd_random_walk_vel_rot(brownian, p);
+    p.r.quat = bd_random_walk_rot(brownian, p, time_step, *noise_pos_rot++);
+    p.m.omega += bd_random_walk_vel_rot(brownian, p, *noise_vel_rot++);
 #endif // ROTATION
   }
   sim_time += time_step;
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "integrators/fire.hpp"
+
+#include "CellStructure.hpp"
+#include "Particle.hpp"
+#include "ParticleRange.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "config.hpp"
+#include "integrate.hpp"
+#include "rotation.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/mask.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/operations.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+/** Currently active FIRE parameters */
+static FireParameters params{};
+
+/** State of the minimizer, identical on all nodes */
+namespace {
+double dt = 0.;
+double alpha = 0.;
+/** Consecutive steps with positive power */
+int n_positive = 0;
+/** Steps since the initialization */
+int n_steps = 0;
+
+/** Remove the components of fixed coordinates from a vector. */
+Utils::Vector3d mask_fixed(Particle const &p, Utils::Vector3d vec) {
+  for (int j = 0; j < 3; j++) {
+    if (p.p.ext_flag & COORD_FIXED(j))
+      vec[j] = 0.;
+  }
+  return vec;
+}
+
+#ifdef ROTATION
+/** Torque on the rotational degrees of freedom, in the body frame. */
+Utils::Vector3d free_torque(Particle const &p) {
+  return mask(p.p.rotation, convert_vector_space_to_body(p, p.f.torque));
+}
+#endif
+} // namespace
+
+bool fire_step(const ParticleRange &particles) {
+  /* power, squared norms of the velocities and of the forces */
+  Utils::Vector3d local_sums{};
+  auto f2_max = 0.;
+  for (auto const &p : particles) {
+    if (not p.p.is_virtual) {
+      auto const f = mask_fixed(p, p.f.f);
+      local_sums[0] += f * p.m.v;
+      local_sums[1] += mask_fixed(p, p.m.v).norm2();
+      local_sums[2] += f.norm2();
+      f2_max = std::max(f2_max, f.norm2());
+    }
+#ifdef ROTATION
+    if (p.p.rotation) {
+      auto const torque = free_torque(p);
+      auto const omega = mask(p.p.rotation, p.m.omega);
+      local_sums[0] += torque * omega;
+      local_sums[1] += omega.norm2();
+      local_sums[2] += torque.norm2();
+      f2_max = std::max(f2_max, torque.norm2());
+    }
+#endif
+  }
+
+  namespace mpi = boost::mpi;
+  Utils::Vector3d sums;
+  mpi::all_reduce(comm_cart, local_sums.data(), 3, sums.data(),
+                  std::plus<double>());
+  auto const f2_max_global =
+      mpi::all_reduce(comm_cart, f2_max, mpi::maximum<double>());
+
+  /* a vanishing force norm is a stationary point, which FIRE cannot leave */
+  if (sums[2] == 0. or std::sqrt(f2_max_global) < params.f_max)
+    return true;
+
+  /* new velocity: mix_v * v + mix_f * F, or 0 when going uphill */
+  auto const downhill = sums[0] > 0.;
+  auto mix_v = 0.;
+  auto mix_f = 0.;
+  if (downhill) {
+    mix_v = 1. - alpha;
+    mix_f = alpha * std::sqrt(sums[1] / sums[2]);
+    if (++n_positive > params.n_delay) {
+      dt = std::min(dt * params.f_inc, params.dt_max);
+      alpha *= params.f_alpha;
+    }
+  } else {
+    n_positive = 0;
+    /* no reduction of the time step during the initial delay */
+    if (n_steps >= params.n_delay) {
+      dt = std::max(dt * params.f_dec, params.dt_min);
+      alpha = params.alpha_start;
+    }
+  }
+  n_steps++;
+
+  auto const skin2 = Utils::sqr(0.5 * skin);
+  for (auto &p : particles) {
+    if (not p.p.is_virtual) {
+      auto const f = mask_fixed(p, p.f.f);
+      Utils::Vector3d dx{};
+      for (int j = 0; j < 3; j++) {
+        if (p.p.ext_flag & COORD_FIXED(j))
+          continue;
+        /* half step back to the last downhill configuration */
+        if (not downhill)
+          dx[j] = -0.5 * dt * p.m.v[j];
+        p.m.v[j] = mix_v * p.m.v[j] + mix_f * f[j] + dt * f[j] / p.p.mass;
+        dx[j] += dt * p.m.v[j];
+      }
+      auto const dx_norm = dx.norm();
+      if (dx_norm > params.max_displacement)
+        dx *= params.max_displacement / dx_norm;
+      p.r.p += dx;
+
+      /* Verlet criterion check */
+      if ((p.r.p - p.l.p_old).norm2() > skin2)
+        cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
+    }
+#ifdef ROTATION
+    if (p.p.rotation) {
+      auto const torque = free_torque(p);
+      auto omega = mask(p.p.rotation, p.m.omega);
+      Utils::Vector3d dphi{};
+      if (not downhill)
+        dphi = -0.5 * dt * omega;
+      for (int j = 0; j < 3; j++) {
+        omega[j] = mix_v * omega[j] + mix_f * torque[j] +
+                   dt * torque[j] / p.p.rinertia[j];
+      }
+      dphi += dt * omega;
+      auto const angle = dphi.norm();
+      if (angle > 0.) {
+        p.r.quat = local_rotate_particle_body(
+            p, dphi / angle, std::min(angle, params.max_displacement));
+      }
+      p.m.omega = omega;
+    }
+#endif
+  }
+
+  return false;
+}
+
+void mpi_bcast_fire_worker() {
+  boost::mpi::broadcast(comm_cart, params, 0);
+  dt = std::max(0.1 * params.dt_max, params.dt_min);
+  alpha = params.alpha_start;
+  n_positive = 0;
+  n_steps = 0;
+}
+
+REGISTER_CALLBACK(mpi_bcast_fire_worker)
+
+void fire_init(FireParameters const &parameters) {
+  if (parameters.f_max < 0.) {
+    throw std::domain_error("The maximal force must be >= 0");
+  }
+  if (parameters.dt_max <= 0.) {
+    throw std::domain_error("The maximal time step must be > 0");
+  }
+  if (parameters.dt_min <= 0. or parameters.dt_min > parameters.dt_max) {
+    throw std::domain_error("The minimal time step must be in (0, dt_max]");
+  }
+  if (parameters.max_displacement <= 0.) {
+    throw std::domain_error("The maximal displacement must be > 0");
+  }
+  if (parameters.n_delay < 0) {
+    throw std::domain_error("The delay must be >= 0");
+  }
+  if (parameters.f_inc < 1.) {
+    throw std::domain_error("The time step growth factor must be >= 1");
+  }
+  if (parameters.f_dec <= 0. or parameters.f_dec >= 1.) {
+    throw std::domain_error("The time step reduction factor must be in (0, 1)");
+  }
+  if (parameters.alpha_start < 0. or parameters.alpha_start > 1.) {
+    throw std::domain_error("The mixing coefficient must be in [0, 1]");
+  }
+  if (parameters.f_alpha <= 0. or parameters.f_alpha > 1.) {
+    throw std::domain_error("The mixing reduction factor must be in (0, 1]");
+  }
+
+  params = parameters;
+
+  mpi_call_all(mpi_bcast_fire_worker);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef INTEGRATORS_FIRE_HPP
+#define INTEGRATORS_FIRE_HPP
+
+/** \file
+ *  Fast inertial relaxation engine (FIRE) for energy minimization.
+ *
+ *  The particles follow damped molecular dynamics with an adaptive time
+ *  step (@cite bitzek06a). The velocities are turned towards the forces
+ *  while the power @f$ P = \vec{F} \cdot \vec{v} @f$ is positive; when it
+ *  becomes negative, the system is moved back by half a step, the
+ *  velocities are reset and the time step is reduced (FIRE 2.0,
+ *  @cite guenole20a). The velocities are mixed with the forces before
+ *  the semi-implicit Euler update, such that a single global reduction
+ *  per step suffices. Rotational degrees of freedom are relaxed with the
+ *  angular velocities and torques in the body frame.
+ *
+ *  The particle velocities store the state of the minimizer.
+ */
+
+#include "ParticleRange.hpp"
+
+#include <boost/serialization/access.hpp>
+
+/** Parameters of the FIRE algorithm */
+struct FireParameters {
+  /** Maximal particle force
+   *
+   *  If the maximal force or torque experienced by particles in the system
+   *  is inferior to this threshold, minimization stops.
+   */
+  double f_max;
+  /** Largest time step */
+  double dt_max;
+  /** Smallest time step */
+  double dt_min;
+  /** Maximal particle displacement or rotation angle per step */
+  double max_displacement;
+  /** Number of steps with positive power before the time step grows */
+  int n_delay;
+  /** Growth factor of the time step */
+  double f_inc;
+  /** Reduction factor of the time step */
+  double f_dec;
+  /** Initial mixing coefficient */
+  double alpha_start;
+  /** Reduction factor of the mixing coefficient */
+  double f_alpha;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &f_max;
+    ar &dt_max;
+    ar &dt_min;
+    ar &max_displacement;
+    ar &n_delay;
+    ar &f_inc;
+    ar &f_dec;
+    ar &alpha_start;
+    ar &f_alpha;
+  }
+};
+
+/** FIRE initializer
+ *
+ *  Sets the parameters in @ref FireParameters and restarts the minimizer
+ *  with the time step @ref FireParameters::dt_max "dt_max" / 10.
+ */
+void fire_init(FireParameters const &parameters);
+
+/** FIRE integrator step
+ *  @return whether the maximum force/torque encountered is below the user
+ *          limit @ref FireParameters::f_max "f_max".
+ */
+bool fire_step(const ParticleRange &particles);
+
+#endif
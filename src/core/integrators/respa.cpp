@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "integrators/respa.hpp"
+
+#include "Particle.hpp"
+#include "ParticleRange.hpp"
+#include "communication.hpp"
+#include "config.hpp"
+#include "integrate.hpp"
+#include "integrators/velocity_verlet_inline.hpp"
+
+#include <boost/mpi/collectives/broadcast.hpp>
+
+#include <stdexcept>
+
+/** Currently active r-RESPA parameters */
+static RespaParameters params{};
+
+/** Time steps since the start of the cycle of force evaluations */
+static int respa_step = 0;
+
+RespaParameters const &respa_parameters() { return params; }
+
+RespaWeights respa_force_weights() {
+  RespaWeights weights{};
+  if (integ_switch != INTEG_METHOD_RESPA)
+    return weights;
+
+  auto const weight = [](int interval) {
+    return (respa_step % interval == 0) ? static_cast<double>(interval) : 0.;
+  };
+  weights.bonded = weight(params.bonded);
+  weights.short_range = weight(params.short_range);
+  weights.long_range = weight(params.long_range);
+  return weights;
+}
+
+void respa_step_1(const ParticleRange &particles) {
+  velocity_verlet_step_1(particles);
+  respa_step++;
+}
+
+void RespaForceAccumulator::scale(double factor) {
+  auto const scale_force = [factor](Particle &p) {
+    p.f.f *= factor;
+#ifdef ROTATION
+    p.f.torque *= factor;
+#endif
+  };
+  for (auto &p : m_particles)
+    scale_force(p);
+  for (auto &p : m_ghosts)
+    scale_force(p);
+}
+
+void mpi_bcast_respa_worker() {
+  boost::mpi::broadcast(comm_cart, params, 0);
+  respa_step = 0;
+  recalc_forces = true;
+}
+
+REGISTER_CALLBACK(mpi_bcast_respa_worker)
+
+void respa_init(int bonded, int short_range, int long_range) {
+  if (bonded < 1 or short_range < 1 or long_range < 1) {
+    throw std::domain_error("The r-RESPA intervals must be >= 1");
+  }
+
+  params.bonded = bonded;
+  params.short_range = short_range;
+  params.long_range = long_range;
+
+  mpi_call_all(mpi_bcast_respa_worker);
+}
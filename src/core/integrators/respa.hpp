@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef INTEGRATORS_RESPA_HPP
+#define INTEGRATORS_RESPA_HPP
+
+/** \file
+ *  Multiple time stepping (r-RESPA, @cite tuckerman92a) for the velocity
+ *  Verlet integrator.
+ *
+ *  The forces are split into groups, each of which is evaluated every
+ *  few time steps only. The positions are propagated with the inner time
+ *  step @ref time_step. A group with interval @f$ n @f$ is evaluated in
+ *  every @f$ n @f$-th step and then enters the velocity half-steps of
+ *  @ref velocity_verlet_step_2 and @ref velocity_verlet_step_1 with the
+ *  weight @f$ n @f$, i.e. as the impulse of the outer time step
+ *  @f$ n \Delta t @f$. In the steps in between, it does not contribute.
+ *  For nested intervals, this is the impulse form of r-RESPA.
+ *
+ *  The thermostat, external forces, constraints and the coupling to the
+ *  lattice-Boltzmann fluid are evaluated in every step.
+ */
+
+#include "ParticleRange.hpp"
+
+#include <boost/serialization/access.hpp>
+
+/** Evaluation intervals of the force groups, in time steps. */
+struct RespaParameters {
+  /** Bonded interactions. */
+  int bonded = 1;
+  /** Non-bonded short-range interactions, including the real-space part
+   *  of the long-range methods.
+   */
+  int short_range = 1;
+  /** k-space part of the long-range methods. */
+  int long_range = 1;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &bonded;
+    ar &short_range;
+    ar &long_range;
+  }
+};
+
+/** Weights of the force groups in the current time step, 0 for groups
+ *  that are not evaluated.
+ */
+struct RespaWeights {
+  double bonded = 1.;
+  double short_range = 1.;
+  double long_range = 1.;
+};
+
+/** Set the intervals of the force groups on all nodes and restart the
+ *  cycle of the force evaluations.
+ */
+void respa_init(int bonded, int short_range, int long_range);
+
+/** Current parameters of the multiple time stepping. */
+RespaParameters const &respa_parameters();
+
+/** Weights of the force groups for the force calculation at the current
+ *  time step. All weights are 1 unless the r-RESPA integrator is active.
+ */
+RespaWeights respa_force_weights();
+
+/** Advance the cycle of force evaluations by one time step. */
+void respa_step_1(const ParticleRange &particles);
+
+/** @brief Sum force groups of different weights into the particle forces.
+ *
+ *  Forces can only be added to the particles, hence the forces already
+ *  present are rescaled whenever the weight changes, such that
+ *  @ref finalize yields the weighted sum of all groups.
+ */
+class RespaForceAccumulator {
+  ParticleRange m_particles;
+  ParticleRange m_ghosts;
+  double m_weight = 1.;
+
+  void scale(double factor);
+
+public:
+  RespaForceAccumulator(ParticleRange const &particles,
+                        ParticleRange const &ghosts)
+      : m_particles(particles), m_ghosts(ghosts) {}
+
+  /** Start the next force group.
+   *  @param weight  weight of the group
+   *  @return whether the group has to be evaluated.
+   */
+  bool add_group(double weight) {
+    if (weight == 0.)
+      return false;
+    if (weight != m_weight) {
+      scale(m_weight / weight);
+      m_weight = weight;
+    }
+    return true;
+  }
+
+  /** Apply the weights, forces added afterwards have weight 1. */
+  void finalize() {
+    if (m_weight != 1.) {
+      scale(m_weight);
+      m_weight = 1.;
+    }
+  }
+};
+
+#endif
@@ -25,11 +25,57 @@
 #include "Particle.hpp"
 #include "ParticleRange.hpp"
 #include "cells.hpp"
+#include "forces_inline.hpp"
 #include "integrate.hpp"
 #include "rotation.hpp"
+#include "thermostat.hpp"
 
 #include <utils/math/sqr.hpp>
 
+/** Propagate the velocity and position of a particle, see
+ *  @ref velocity_verlet_propagate_vel_pos.
+ *  @return whether the particle moved farther than half the skin.
+ */
+inline bool velocity_verlet_propagate_vel_pos_particle(Particle &p,
+                                                       double skin2) {
+#ifdef ROTATION
+  propagate_omega_quat_particle(p, time_step);
+#endif
+
+  // Don't propagate translational degrees of freedom of vs
+  if (p.p.is_virtual)
+    return false;
+  for (int j = 0; j < 3; j++) {
+    if (!(p.p.ext_flag & COORD_FIXED(j))) {
+      /* Propagate velocities: v(t+0.5*dt) = v(t) + 0.5 * dt * a(t) */
+      p.m.v[j] += 0.5 * time_step * p.f.f[j] / p.p.mass;
+
+      /* Propagate positions (only NVT): p(t + dt)   = p(t) + dt *
+       * v(t+0.5*dt) */
+      p.r.p[j] += time_step * p.m.v[j];
+    }
+  }
+
+  /* Verlet criterion check*/
+  return (p.r.p - p.l.p_old).norm2() > skin2;
+}
+
+/** Propagate the velocity of a particle, see
+ *  @ref velocity_verlet_propagate_vel_final.
+ */
+inline void velocity_verlet_propagate_vel_final_particle(Particle &p) {
+  // Virtual sites are not propagated during integration
+  if (p.p.is_virtual)
+    return;
+
+  for (int j = 0; j < 3; j++) {
+    if (!(p.p.ext_flag & COORD_FIXED(j))) {
+      /* Propagate velocity: v(t+dt) = v(t+0.5*dt) + 0.5*dt * a(t+dt) */
+      p.m.v[j] += 0.5 * time_step * p.f.f[j] / p.p.mass;
+    }
+  }
+}
+
 /** Propagate the velocities and positions. Integration steps before force
  *  calculation of the Velocity Verlet integrator: <br> \f[ v(t+0.5 \Delta t) =
  *  v(t) + 0.5 \Delta t f(t)/m \f] <br> \f[ p(t+\Delta t) = p(t) + \Delta t
@@ -38,29 +84,12 @@
 inline void velocity_verlet_propagate_vel_pos(const ParticleRange &particles) {
 
   auto const skin2 = Utils::sqr(0.5 * skin);
+  bool resort = false;
   for (auto &p : particles) {
-#ifdef ROTATION
-    propagate_omega_quat_particle(p, time_step);
-#endif
-
-    // Don't propagate translational degrees of freedom of vs
-    if (p.p.is_virtual)
-      continue;
-    for (int j = 0; j < 3; j++) {
-      if (!(p.p.ext_flag & COORD_FIXED(j))) {
-        /* Propagate velocities: v(t+0.5*dt) = v(t) + 0.5 * dt * a(t) */
-        p.m.v[j] += 0.5 * time_step * p.f.f[j] / p.p.mass;
-
-        /* Propagate positions (only NVT): p(t + dt)   = p(t) + dt *
-         * v(t+0.5*dt) */
-        p.r.p[j] += time_step * p.m.v[j];
-      }
-    }
-
-    /* Verlet criterion check*/
-    if ((p.r.p - p.l.p_old).norm2() > skin2)
-      cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
+    resort |= velocity_verlet_propagate_vel_pos_particle(p, skin2);
   }
+  if (resort)
+    cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
 }
 
 /** Final integration step of the Velocity Verlet integrator
@@ -70,16 +99,7 @@ inline void
 velocity_verlet_propagate_vel_final(const ParticleRange &particles) {
 
   for (auto &p : particles) {
-    // Virtual sites are not propagated during integration
-    if (p.p.is_virtual)
-      continue;
-
-    for (int j = 0; j < 3; j++) {
-      if (!(p.p.ext_flag & COORD_FIXED(j))) {
-        /* Propagate velocity: v(t+dt) = v(t+0.5*dt) + 0.5*dt * a(t+dt) */
-        p.m.v[j] += 0.5 * time_step * p.f.f[j] / p.p.mass;
-      }
-    }
+    velocity_verlet_propagate_vel_final_particle(p);
   }
 }
 
@@ -88,11 +108,40 @@ inline void velocity_verlet_step_1(const ParticleRange &particles) {
   sim_time += time_step;
 }
 
+/** First integration step of the Velocity Verlet integrator, fused with
+ *  the force initialization of the next force calculation.
+ *
+ *  The thermostat and external forces of a non-virtual particle only depend
+ *  on its own state after the propagation, hence they are evaluated in the
+ *  same pass over the particles, with the RNG counter of the next force
+ *  calculation. The forces of the virtual sites depend on their update
+ *  and are left to @ref init_forces. Only valid if nothing modifies the
+ *  particles between the propagation and the force calculation.
+ */
+inline void velocity_verlet_fused_step_1(const ParticleRange &particles) {
+  auto thermostat = langevin;
+  if (thermo_switch & THERMO_LANGEVIN)
+    thermostat.rng_increment();
+
+  auto const skin2 = Utils::sqr(0.5 * skin);
+  bool resort = false;
+  for (auto &p : particles) {
+    resort |= velocity_verlet_propagate_vel_pos_particle(p, skin2);
+    if (not p.p.is_virtual)
+      p.f = init_local_particle_force(thermostat, p, time_step);
+  }
+  if (resort)
+    cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
+  sim_time += time_step;
+}
+
 inline void velocity_verlet_step_2(const ParticleRange &particles) {
-  velocity_verlet_propagate_vel_final(particles);
+  for (auto &p : particles) {
+    velocity_verlet_propagate_vel_final_particle(p);
 #ifdef ROTATION
-  convert_torques_propagate_omega(particles, time_step);
+    convert_torque_propagate_omega(p, time_step);
 #endif
+  }
 }
 
 #endif
@@ -24,6 +24,7 @@
 #include "bonded_interactions/bonded_interaction_data.hpp"
 #include "bonded_interactions/bonded_tab.hpp"
 #include "event.hpp"
+#include "nonbonded_interactions/pair_splines.hpp"
 
 #include "serialization/IA_parameters.hpp"
 
@@ -35,6 +36,7 @@
 
 void mpi_bcast_all_ia_params_local() {
   boost::mpi::broadcast(comm_cart, ia_params, 0);
+  pair_splines_invalidate();
 }
 
 REGISTER_CALLBACK(mpi_bcast_all_ia_params_local)
@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ * Native checkpoint container.
+ *
+ * The dynamic state of the system is written into a single file:
+ * \verbatim
+   header         (struct FileHeader)
+   global state   (binary archive of struct GlobalState)
+   chunk sizes    (uint64 [number of chunks])
+   chunks         (binary archives of up to particles_per_chunk particles)
+   LB populations (double [grid x][grid y][grid z][19], 8-byte aligned)
+   \endverbatim
+ * Every process serializes its particles into chunks and all processes
+ * write their chunks concurrently. On reading, the chunks are split
+ * evenly among the processes, independently of the number of processes
+ * at the time of writing; the particles are then sorted into the cell
+ * system by the next global resort. The LB populations are stored in
+ * global lattice order, every process reads and writes its local
+ * sub-lattice via an MPI subarray view.
+ *
+ * Static parameters (interactions, thermostat couplings, actors, ...)
+ * are not part of the container, they are restored by the Python
+ * checkpointing.
+ */
+
+#include "mpiio.hpp"
+
+#include "Particle.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "config.hpp"
+#include "errorhandling.hpp"
+#include "event.hpp"
+#include "grid_based_algorithms/OptionalCounter.hpp"
+#include "grid_based_algorithms/lb.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+#include "grid_based_algorithms/lb_particle_coupling.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_data.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Counter.hpp>
+#include <utils/index.hpp>
+#include <utils/mpi/gather_buffer.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/operations.hpp>
+#include <boost/optional.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/optional.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Mpiio {
+
+namespace {
+constexpr char checkpoint_magic[4] = {'E', 'C', 'K', 'P'};
+constexpr std::uint32_t checkpoint_version = 1;
+constexpr std::size_t particles_per_chunk = 4096;
+constexpr auto archive_flags = boost::archive::no_header;
+
+struct FileHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t n_ranks;
+  std::uint32_t lb_n_vel;
+  std::uint64_t n_particles;
+  std::uint64_t n_chunks;
+  std::uint64_t global_size;
+  std::uint64_t lb_offset;
+  std::int32_t lb_grid[3];
+  std::int32_t padding;
+};
+
+/** Replicated state that evolves during the simulation. */
+struct GlobalState {
+  double sim_time = 0.;
+  /** RNG counter and seed of the seeded thermostats. */
+  std::map<std::string, std::pair<std::uint64_t, std::uint32_t>> thermostats;
+  boost::optional<Utils::Counter<uint64_t>> lb_fluid_counter;
+  OptionalCounter lb_coupling_counter;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &sim_time &thermostats &lb_fluid_counter &lb_coupling_counter;
+  }
+};
+
+template <class F> void for_each_thermostat(F &&f) {
+  f("langevin", langevin);
+  f("brownian", brownian);
+#ifdef NPT
+  f("npt_iso", npt_iso);
+#endif
+  f("thermalized_bond", thermalized_bond);
+#ifdef DPD
+  f("dpd", dpd);
+#endif
+#ifdef STOKESIAN_DYNAMICS
+  f("stokesian", stokesian);
+#endif
+}
+
+GlobalState get_global_state() {
+  GlobalState state;
+  state.sim_time = sim_time;
+  for_each_thermostat([&state](char const *name, BaseThermostat const &t) {
+    if (not t.is_seed_required())
+      state.thermostats[name] = {t.rng_counter(), t.rng_seed()};
+  });
+  if (lattice_switch == ActiveLB::CPU) {
+    state.lb_fluid_counter = rng_counter_fluid;
+    state.lb_coupling_counter = lb_particle_coupling.rng_counter_coupling;
+  }
+  return state;
+}
+
+void set_global_state(GlobalState const &state) {
+  sim_time = state.sim_time;
+  for_each_thermostat([&state](char const *name, BaseThermostat &t) {
+    auto const it = state.thermostats.find(name);
+    if (it != state.thermostats.end()) {
+      t.rng_initialize(it->second.second);
+      t.set_rng_counter(it->second.first);
+    }
+  });
+  if (lattice_switch == ActiveLB::CPU) {
+    if (state.lb_fluid_counter)
+      rng_counter_fluid = state.lb_fluid_counter;
+    if (state.lb_coupling_counter)
+      lb_particle_coupling.rng_counter_coupling = state.lb_coupling_counter;
+  }
+}
+
+template <class T> std::vector<char> pack(T const &value) {
+  namespace io = boost::iostreams;
+  std::vector<char> buf;
+  {
+    io::stream_buffer<io::back_insert_device<std::vector<char>>> os{
+        io::back_inserter(buf)};
+    boost::archive::binary_oarchive oa{os, archive_flags};
+    oa << value;
+  }
+  return buf;
+}
+
+template <class T> void unpack(char const *data, std::size_t size, T &value) {
+  namespace io = boost::iostreams;
+  io::array_source src(data, size);
+  io::stream<io::array_source> ss(src);
+  boost::archive::binary_iarchive ia(ss, archive_flags);
+  ia >> value;
+}
+
+/** Subarray type of the local LB sub-lattice in the global lattice. */
+MPI_Datatype lb_subarray() {
+  int sizes[4], subsizes[4], starts[4];
+  for (int i = 0; i < 3; ++i) {
+    sizes[i] = lblattice.global_grid[i];
+    subsizes[i] = lblattice.grid[i];
+    starts[i] = lblattice.local_index_offset[i];
+  }
+  sizes[3] = subsizes[3] = D3Q19::n_vel;
+  starts[3] = 0;
+  MPI_Datatype type;
+  MPI_Type_create_subarray(4, sizes, subsizes, starts, MPI_ORDER_C,
+                           MPI_DOUBLE, &type);
+  MPI_Type_commit(&type);
+  return type;
+}
+
+/** Apply @p f to the storage index of each local LB node, in the order of
+ *  @ref lb_subarray.
+ */
+template <class F> void for_each_lb_node(F &&f) {
+  auto const h = lblattice.halo_size;
+  for (int x = 0; x < lblattice.grid[0]; ++x)
+    for (int y = 0; y < lblattice.grid[1]; ++y)
+      for (int z = 0; z < lblattice.grid[2]; ++z)
+        f(static_cast<Lattice::index_t>(Utils::get_linear_index(
+            x + h, y + h, z + h, lblattice.halo_grid)));
+}
+
+std::size_t n_local_lb_nodes() {
+  return static_cast<std::size_t>(lblattice.grid[0]) * lblattice.grid[1] *
+         lblattice.grid[2];
+}
+
+void check(int ret, char const *what, std::string const &fn) {
+  if (ret) {
+    fprintf(stderr, "MPI-IO Error: Could not %s file \"%s\".\n", what,
+            fn.c_str());
+    errexit();
+  }
+}
+} // namespace
+
+void mpi_checkpoint_write(const char *filename) {
+  if (lattice_switch == ActiveLB::GPU)
+    throw std::runtime_error(
+        "Native checkpoints do not support the GPU LB fluid");
+
+  std::string const fn(filename);
+  std::string const tmp = fn + ".__tmp__";
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  /* Serialize the local particles in chunks */
+  std::vector<char> chunks;
+  std::vector<std::uint64_t> chunk_sizes;
+  {
+    auto const particles = cell_structure.local_particles();
+    std::vector<Particle> chunk;
+    chunk.reserve(particles_per_chunk);
+    auto const flush = [&]() {
+      auto const buf = pack(chunk);
+      chunks.insert(chunks.end(), buf.begin(), buf.end());
+      chunk_sizes.push_back(buf.size());
+      chunk.clear();
+    };
+    for (auto const &p : particles) {
+      chunk.push_back(p);
+      if (chunk.size() == particles_per_chunk)
+        flush();
+    }
+    if (not chunk.empty())
+      flush();
+  }
+
+  /* Layout of the file */
+  std::uint64_t n_local = cell_structure.local_particles().size();
+  std::uint64_t n_particles = 0;
+  MPI_Allreduce(&n_local, &n_particles, 1, MPI_UINT64_T, MPI_SUM,
+                MPI_COMM_WORLD);
+  int const n_local_chunks = static_cast<int>(chunk_sizes.size());
+  std::vector<int> chunk_counts(size), chunk_displ(size, 0);
+  MPI_Allgather(&n_local_chunks, 1, MPI_INT, chunk_counts.data(), 1, MPI_INT,
+                MPI_COMM_WORLD);
+  for (int i = 1; i < size; ++i)
+    chunk_displ[i] = chunk_displ[i - 1] + chunk_counts[i - 1];
+  auto const n_chunks =
+      static_cast<std::uint64_t>(chunk_displ.back() + chunk_counts.back());
+
+  std::vector<std::uint64_t> all_chunk_sizes(rank == 0 ? n_chunks : 0);
+  MPI_Gatherv(chunk_sizes.data(), n_local_chunks, MPI_UINT64_T,
+              all_chunk_sizes.data(), chunk_counts.data(), chunk_displ.data(),
+              MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+  std::vector<char> global;
+  if (rank == 0)
+    global = pack(get_global_state());
+  std::uint64_t global_size = global.size();
+  MPI_Bcast(&global_size, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+  std::uint64_t local_bytes = chunks.size(), chunk_pref = 0, total_bytes = 0;
+  MPI_Exscan(&local_bytes, &chunk_pref, 1, MPI_UINT64_T, MPI_SUM,
+             MPI_COMM_WORLD);
+  if (rank == 0)
+    chunk_pref = 0;
+  MPI_Allreduce(&local_bytes, &total_bytes, 1, MPI_UINT64_T, MPI_SUM,
+                MPI_COMM_WORLD);
+
+  auto const table_offset = sizeof(FileHeader) + global_size;
+  auto const chunks_offset =
+      table_offset + n_chunks * sizeof(std::uint64_t);
+  auto const lb_offset = (chunks_offset + total_bytes + 7u) / 8u * 8u;
+
+  FileHeader header{};
+  std::memcpy(header.magic, checkpoint_magic, sizeof(checkpoint_magic));
+  header.version = checkpoint_version;
+  header.n_ranks = static_cast<std::uint32_t>(size);
+  header.n_particles = n_particles;
+  header.n_chunks = n_chunks;
+  header.global_size = global_size;
+  header.lb_offset = lb_offset;
+  if (lattice_switch == ActiveLB::CPU) {
+    header.lb_n_vel = D3Q19::n_vel;
+    for (int i = 0; i < 3; ++i)
+      header.lb_grid[i] = lblattice.global_grid[i];
+  }
+
+  MPI_File f;
+  int ret = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(tmp.c_str()),
+                          MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
+                          &f);
+  check(ret, "open", tmp);
+  ret = MPI_File_set_size(f, 0);
+
+  if (rank == 0) {
+    ret |= MPI_File_write_at(f, 0, &header, sizeof(header), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+    ret |= MPI_File_write_at(f, sizeof(header), global.data(),
+                             static_cast<int>(global.size()), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+    ret |= MPI_File_write_at(f, static_cast<MPI_Offset>(table_offset),
+                             all_chunk_sizes.data(),
+                             static_cast<int>(all_chunk_sizes.size()),
+                             MPI_UINT64_T, MPI_STATUS_IGNORE);
+  }
+  ret |= MPI_File_write_at_all(
+      f, static_cast<MPI_Offset>(chunks_offset + chunk_pref), chunks.data(),
+      static_cast<int>(chunks.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+
+  if (header.lb_n_vel) {
+    std::vector<double> pops;
+    pops.reserve(n_local_lb_nodes() * D3Q19::n_vel);
+    for_each_lb_node([&pops](Lattice::index_t index) {
+      auto const pop = lb_get_population(index);
+      pops.insert(pops.end(), pop.begin(), pop.end());
+    });
+    auto type = lb_subarray();
+    ret |= MPI_File_set_view(f, static_cast<MPI_Offset>(lb_offset),
+                             MPI_DOUBLE, type, const_cast<char *>("native"),
+                             MPI_INFO_NULL);
+    ret |= MPI_File_write_all(f, pops.data(), static_cast<int>(pops.size()),
+                              MPI_DOUBLE, MPI_STATUS_IGNORE);
+    MPI_Type_free(&type);
+  }
+  MPI_File_close(&f);
+  check(ret, "write", tmp);
+
+  /* Replace an existing checkpoint only after a complete write */
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == 0 and std::rename(tmp.c_str(), fn.c_str()) != 0) {
+    fprintf(stderr, "MPI-IO Error: Could not rename \"%s\".\n", tmp.c_str());
+    errexit();
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+void mpi_checkpoint_read(const char *filename) {
+  std::string const fn(filename);
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  MPI_File f;
+  int ret = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(fn.c_str()),
+                          MPI_MODE_RDONLY, MPI_INFO_NULL, &f);
+  if (ret) {
+    throw std::runtime_error("Could not open checkpoint '" + fn + "'");
+  }
+
+  FileHeader header;
+  ret = MPI_File_read_at_all(f, 0, &header, sizeof(header), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+  auto const fail = [&f](std::string const &msg) {
+    MPI_File_close(&f);
+    throw std::runtime_error(msg);
+  };
+  if (ret or std::memcmp(header.magic, checkpoint_magic,
+                         sizeof(checkpoint_magic)) != 0)
+    fail("'" + fn + "' is not a checkpoint");
+  if (header.version != checkpoint_version)
+    fail("Unsupported checkpoint version " + std::to_string(header.version));
+  if (header.lb_n_vel) {
+    if (lattice_switch != ActiveLB::CPU)
+      fail("The checkpoint contains a CPU LB fluid, which has to be set up "
+           "before reading it");
+    for (int i = 0; i < 3; ++i)
+      if (header.lb_grid[i] != lblattice.global_grid[i])
+        fail("The LB grid differs from the LB grid of the checkpoint");
+  }
+
+  /* Global state and chunk table, replicated on all processes */
+  std::vector<char> global(header.global_size);
+  std::vector<std::uint64_t> chunk_sizes(header.n_chunks);
+  ret = MPI_File_read_at_all(f, sizeof(header), global.data(),
+                             static_cast<int>(global.size()), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+  auto const table_offset = sizeof(header) + header.global_size;
+  ret |= MPI_File_read_at_all(f, static_cast<MPI_Offset>(table_offset),
+                              chunk_sizes.data(),
+                              static_cast<int>(chunk_sizes.size()),
+                              MPI_UINT64_T, MPI_STATUS_IGNORE);
+  check(ret, "read", fn);
+
+  GlobalState state;
+  unpack(global.data(), global.size(), state);
+  set_global_state(state);
+
+  /* Even share of the chunks */
+  auto const begin = header.n_chunks * rank / size;
+  auto const end = header.n_chunks * (rank + 1) / size;
+  std::uint64_t offset =
+      table_offset + header.n_chunks * sizeof(std::uint64_t);
+  for (std::uint64_t i = 0; i < begin; ++i)
+    offset += chunk_sizes[i];
+  std::uint64_t n_bytes = 0;
+  for (auto i = begin; i < end; ++i)
+    n_bytes += chunk_sizes[i];
+
+  std::vector<char> chunks(n_bytes);
+  ret = MPI_File_read_at_all(f, static_cast<MPI_Offset>(offset), chunks.data(),
+                             static_cast<int>(chunks.size()), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+  check(ret, "read", fn);
+
+  cell_structure.remove_all_particles();
+  {
+    std::vector<Particle> particles;
+    std::uint64_t pos = 0;
+    for (auto i = begin; i < end; ++i) {
+      particles.clear();
+      unpack(chunks.data() + pos, chunk_sizes[i], particles);
+      pos += chunk_sizes[i];
+      for (auto &p : particles)
+        cell_structure.add_particle(std::move(p));
+    }
+  }
+
+  if (header.lb_n_vel) {
+    std::vector<double> pops(n_local_lb_nodes() * D3Q19::n_vel);
+    auto type = lb_subarray();
+    ret = MPI_File_set_view(f, static_cast<MPI_Offset>(header.lb_offset),
+                            MPI_DOUBLE, type, const_cast<char *>("native"),
+                            MPI_INFO_NULL);
+    ret |= MPI_File_read_all(f, pops.data(), static_cast<int>(pops.size()),
+                             MPI_DOUBLE, MPI_STATUS_IGNORE);
+    MPI_Type_free(&type);
+    check(ret, "read", fn);
+
+    auto it = pops.begin();
+    for_each_lb_node([&it](Lattice::index_t index) {
+      Utils::Vector19d pop;
+      std::copy(it, it + D3Q19::n_vel, pop.begin());
+      lb_set_population(index, pop);
+      it += D3Q19::n_vel;
+    });
+  }
+  MPI_File_close(&f);
+
+  /* Type bookkeeping of the restored particles */
+  int max_type = -1;
+  std::vector<std::pair<int, int>> id_types;
+  for (auto const &p : cell_structure.local_particles()) {
+    max_type = std::max(max_type, p.p.type);
+    id_types.emplace_back(p.identity(), p.p.type);
+  }
+  max_type = boost::mpi::all_reduce(comm_cart, max_type,
+                                    boost::mpi::maximum<int>());
+  if (max_type >= 0) {
+    make_particle_type_exist_local(max_type);
+  }
+  Utils::Mpi::gather_buffer(id_types, comm_cart);
+  if (this_node == 0) {
+    rebuild_type_maps(id_types);
+  }
+
+  clear_particle_node();
+  on_particle_change();
+}
+
+} // namespace Mpiio
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_MPIIO_COMPACT_CODEC_HPP
+#define ESPRESSO_MPIIO_COMPACT_CODEC_HPP
+/** \file
+ *  Codec for the blocks of the compact trajectory format.
+ *
+ *  A block holds the particles of a contiguous id range, sorted by id.
+ *  Its layout is a sequence of variable-length integers (7 bits per
+ *  byte, least significant group first):
+ *  - number of particles;
+ *  - number of id runs, followed by (gap, length) pairs of runs of
+ *    consecutive ids, where the gap is counted from the end of the
+ *    previous run (or from zero for the first run);
+ *  - for each particle, the three components of the quantized position
+ *    as zigzag-encoded differences to the previous particle in the block;
+ *  - if present, the quantized velocities encoded in the same way.
+ *
+ *  Particles with consecutive ids are typically close in space (e.g.
+ *  monomers of a chain), so that the differences are small and most
+ *  coordinates fit into one or two bytes.
+ */
+
+#include <utils/Vector.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Mpiio {
+namespace Compact {
+
+/** Map signed integers to unsigned ones with small magnitude first. */
+inline std::uint64_t zigzag(std::int64_t v) {
+  return (static_cast<std::uint64_t>(v) << 1) ^
+         static_cast<std::uint64_t>(v >> 63);
+}
+
+/** Inverse of @ref zigzag. */
+inline std::int64_t unzigzag(std::uint64_t u) {
+  return static_cast<std::int64_t>(u >> 1) ^ -static_cast<std::int64_t>(u & 1u);
+}
+
+inline void put_varint(std::vector<char> &out, std::uint64_t v) {
+  while (v >= 0x80u) {
+    out.push_back(static_cast<char>((v & 0x7Fu) | 0x80u));
+    v >>= 7;
+  }
+  out.push_back(static_cast<char>(v));
+}
+
+inline std::uint64_t get_varint(char const *&it, char const *end) {
+  std::uint64_t v = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (it == end)
+      throw std::runtime_error("Truncated compact trajectory block");
+    auto const byte = static_cast<unsigned char>(*it++);
+    v |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+    if (not(byte & 0x80u))
+      return v;
+  }
+  throw std::runtime_error("Corrupt compact trajectory block");
+}
+
+/** Particle data of one block, sorted by id. */
+struct Block {
+  std::vector<int> ids;
+  std::vector<Utils::Vector3d> positions;
+  std::vector<Utils::Vector3d> velocities;
+};
+
+namespace detail {
+inline void encode_vectors(std::vector<char> &out,
+                           std::vector<Utils::Vector3d> const &values,
+                           double precision) {
+  std::int64_t prev[3] = {0, 0, 0};
+  for (auto const &v : values) {
+    for (int i = 0; i < 3; ++i) {
+      auto const q = static_cast<std::int64_t>(std::llround(v[i] / precision));
+      put_varint(out, zigzag(q - prev[i]));
+      prev[i] = q;
+    }
+  }
+}
+
+inline void decode_vectors(char const *&it, char const *end, std::size_t n,
+                           double precision,
+                           std::vector<Utils::Vector3d> &values) {
+  std::int64_t prev[3] = {0, 0, 0};
+  for (std::size_t j = 0; j < n; ++j) {
+    Utils::Vector3d v;
+    for (int i = 0; i < 3; ++i) {
+      prev[i] += unzigzag(get_varint(it, end));
+      v[i] = static_cast<double>(prev[i]) * precision;
+    }
+    values.push_back(v);
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Encode a block.
+ *
+ * @param block          Particle data, ids in ascending order. The
+ *                       velocities are only written if not empty.
+ * @param precision      Quantization step of the positions.
+ * @param vel_precision  Quantization step of the velocities.
+ */
+inline std::vector<char> encode_block(Block const &block, double precision,
+                                      double vel_precision) {
+  std::vector<char> out;
+  auto const n = block.ids.size();
+  put_varint(out, n);
+
+  /* runs of consecutive ids */
+  std::vector<std::uint64_t> runs;
+  std::int64_t end = 0;
+  for (std::size_t i = 0; i < n;) {
+    auto j = i + 1;
+    while (j < n and block.ids[j] == block.ids[j - 1] + 1)
+      ++j;
+    runs.push_back(static_cast<std::uint64_t>(block.ids[i] - end));
+    runs.push_back(j - i);
+    end = block.ids[j - 1] + 1;
+    i = j;
+  }
+  put_varint(out, runs.size() / 2);
+  for (auto const r : runs)
+    put_varint(out, r);
+
+  detail::encode_vectors(out, block.positions, precision);
+  if (not block.velocities.empty())
+    detail::encode_vectors(out, block.velocities, vel_precision);
+
+  return out;
+}
+
+/**
+ * @brief Decode a block produced by @ref encode_block and append its
+ * particles to @p block.
+ */
+inline void decode_block(char const *begin, char const *end, double precision,
+                         double vel_precision, bool has_velocities,
+                         Block &block) {
+  auto it = begin;
+  auto const n = get_varint(it, end);
+  auto const n_runs = get_varint(it, end);
+  std::int64_t id = 0;
+  std::uint64_t n_ids = 0;
+  for (std::uint64_t r = 0; r < n_runs; ++r) {
+    id += static_cast<std::int64_t>(get_varint(it, end));
+    auto const length = get_varint(it, end);
+    n_ids += length;
+    if (n_ids > n)
+      throw std::runtime_error("Corrupt compact trajectory block");
+    for (std::uint64_t k = 0; k < length; ++k)
+      block.ids.push_back(static_cast<int>(id++));
+  }
+  if (n_ids != n)
+    throw std::runtime_error("Corrupt compact trajectory block");
+
+  detail::decode_vectors(it, end, n, precision, block.positions);
+  if (has_velocities)
+    detail::decode_vectors(it, end, n, vel_precision, block.velocities);
+}
+
+} // namespace Compact
+} // namespace Mpiio
+
+#endif
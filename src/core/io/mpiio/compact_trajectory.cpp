@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ * Compact trajectory format.
+ *
+ * A trajectory consists of two files:
+ * - "<prefix>.ctrj" holds the frames back to back. Each frame starts
+ *   with a header, followed by one block per writing process:
+ *   \verbatim
+     char     magic[4] = "ECTF"
+     uint32   version
+     uint32   flags (bit 0: velocities present)
+     uint32   number of blocks
+     uint64   number of particles
+     double   time
+     double   box_l[3]
+     double   position precision
+     double   velocity precision
+     uint64   block sizes in bytes [number of blocks]
+     char     blocks[]
+     \endverbatim
+ *   The blocks hold ascending, disjoint id ranges, so that the
+ *   concatenation of the decoded blocks is sorted by id. The block layout
+ *   is described in compact_codec.hpp.
+ * - "<prefix>.cidx" holds one record (uint64 offset, uint64 size,
+ *   double time) per frame, which allows random access to the frames.
+ *
+ * All values are stored in native byte order.
+ */
+
+#include "compact_codec.hpp"
+#include "mpiio.hpp"
+
+#include "Particle.hpp"
+#include "errorhandling.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Mpiio {
+
+namespace {
+constexpr char frame_magic[4] = {'E', 'C', 'T', 'F'};
+constexpr std::uint32_t frame_version = 1;
+constexpr std::uint32_t flag_velocities = 1u;
+
+/** Fixed part of the frame header. */
+struct FrameHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t flags;
+  std::uint32_t n_blocks;
+  std::uint64_t n_particles;
+  double time;
+  double box_l[3];
+  double precision;
+  double vel_precision;
+};
+
+struct IndexRecord {
+  std::uint64_t offset;
+  std::uint64_t size;
+  double time;
+};
+
+/** Particle data exchanged during the redistribution. */
+struct Record {
+  int id;
+  double pos[3];
+  double vel[3];
+};
+
+std::string data_file(std::string const &prefix) { return prefix + ".ctrj"; }
+std::string index_file(std::string const &prefix) { return prefix + ".cidx"; }
+
+/** Redistribute the particle data such that each process holds the
+ *  particles of a contiguous id range, sorted by id.
+ */
+std::vector<Record> sort_by_id(std::vector<Record> const &local) {
+  int size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  int local_max = -1;
+  for (auto const &r : local)
+    local_max = std::max(local_max, r.id);
+  int max_id;
+  MPI_Allreduce(&local_max, &max_id, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+  /* Equal-width id ranges per process */
+  auto const owner = [size, max_id](int id) {
+    return static_cast<int>(static_cast<std::int64_t>(id) * size /
+                            (static_cast<std::int64_t>(max_id) + 1));
+  };
+
+  std::vector<int> send_counts(size, 0), send_displ(size, 0);
+  for (auto const &r : local)
+    send_counts[owner(r.id)] += static_cast<int>(sizeof(Record));
+  for (int i = 1; i < size; ++i)
+    send_displ[i] = send_displ[i - 1] + send_counts[i - 1];
+
+  std::vector<Record> send_buf(local.size());
+  {
+    auto pos = send_displ;
+    for (auto const &r : local) {
+      auto &p = pos[owner(r.id)];
+      send_buf[p / sizeof(Record)] = r;
+      p += static_cast<int>(sizeof(Record));
+    }
+  }
+
+  std::vector<int> recv_counts(size), recv_displ(size, 0);
+  MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT,
+               MPI_COMM_WORLD);
+  for (int i = 1; i < size; ++i)
+    recv_displ[i] = recv_displ[i - 1] + recv_counts[i - 1];
+
+  std::vector<Record> recv_buf(
+      (recv_displ.back() + recv_counts.back()) / sizeof(Record));
+  MPI_Alltoallv(send_buf.data(), send_counts.data(), send_displ.data(),
+                MPI_BYTE, recv_buf.data(), recv_counts.data(),
+                recv_displ.data(), MPI_BYTE, MPI_COMM_WORLD);
+
+  std::sort(recv_buf.begin(), recv_buf.end(),
+            [](Record const &a, Record const &b) { return a.id < b.id; });
+  return recv_buf;
+}
+
+/** End of the last complete frame according to the index file. */
+std::uint64_t trajectory_end(std::string const &prefix) {
+  std::ifstream index(index_file(prefix), std::ios::binary | std::ios::ate);
+  if (not index or index.tellg() < std::streamoff(sizeof(IndexRecord)))
+    return 0;
+  IndexRecord last;
+  index.seekg(-std::streamoff(sizeof(IndexRecord)), std::ios::end);
+  index.read(reinterpret_cast<char *>(&last), sizeof(last));
+  return last.offset + last.size;
+}
+
+void mpiio_error(char const *what, std::string const &fn, int ret) {
+  char buf[MPI_MAX_ERROR_STRING];
+  int buf_len;
+  MPI_Error_string(ret, buf, &buf_len);
+  buf[buf_len] = '\0';
+  fprintf(stderr, "MPI-IO Error: %s \"%s\": %s\n", what, fn.c_str(), buf);
+  errexit();
+}
+} // namespace
+
+void mpi_compact_write(const char *filename, double precision,
+                       bool velocities, double vel_precision, double time,
+                       const ParticleRange &particles) {
+  std::string const prefix(filename);
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  std::vector<Record> local;
+  local.reserve(particles.size());
+  for (auto const &p : particles) {
+    Record r{};
+    r.id = p.p.identity;
+    auto const pos = unfolded_position(p.r.p, p.l.i, box_geo.length());
+    std::copy(pos.begin(), pos.end(), r.pos);
+    std::copy(p.m.v.begin(), p.m.v.end(), r.vel);
+    local.push_back(r);
+  }
+
+  auto const sorted = sort_by_id(local);
+
+  Compact::Block block;
+  block.ids.reserve(sorted.size());
+  block.positions.reserve(sorted.size());
+  for (auto const &r : sorted) {
+    block.ids.push_back(r.id);
+    block.positions.emplace_back(Utils::Vector3d{r.pos[0], r.pos[1], r.pos[2]});
+    if (velocities)
+      block.velocities.emplace_back(
+          Utils::Vector3d{r.vel[0], r.vel[1], r.vel[2]});
+  }
+  auto const payload = Compact::encode_block(block, precision, vel_precision);
+
+  /* Layout of the frame */
+  auto const block_size = static_cast<std::uint64_t>(payload.size());
+  std::uint64_t n_local = sorted.size(), n_total = 0;
+  std::uint64_t block_pref = 0, frame_offset = 0;
+  std::vector<std::uint64_t> block_sizes(size);
+  MPI_Gather(&block_size, 1, MPI_UINT64_T, block_sizes.data(), 1,
+             MPI_UINT64_T, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&n_local, &n_total, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Exscan(&block_size, &block_pref, 1, MPI_UINT64_T, MPI_SUM,
+             MPI_COMM_WORLD);
+  if (rank == 0)
+    frame_offset = trajectory_end(prefix);
+  MPI_Bcast(&frame_offset, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+  auto const header_size =
+      sizeof(FrameHeader) + static_cast<std::uint64_t>(size) * sizeof(uint64_t);
+  std::uint64_t frame_size = header_size + block_pref + block_size;
+  MPI_Bcast(&frame_size, 1, MPI_UINT64_T, size - 1, MPI_COMM_WORLD);
+
+  auto const fn = data_file(prefix);
+  MPI_File f;
+  auto ret = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(fn.c_str()),
+                           MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
+                           &f);
+  if (ret)
+    mpiio_error("Could not open file", fn, ret);
+
+  if (rank == 0) {
+    FrameHeader header{};
+    std::memcpy(header.magic, frame_magic, sizeof(frame_magic));
+    header.version = frame_version;
+    header.flags = velocities ? flag_velocities : 0u;
+    header.n_blocks = static_cast<std::uint32_t>(size);
+    header.n_particles = n_total;
+    header.time = time;
+    for (int i = 0; i < 3; ++i)
+      header.box_l[i] = box_geo.length()[i];
+    header.precision = precision;
+    header.vel_precision = vel_precision;
+
+    std::vector<char> buf(header_size);
+    std::memcpy(buf.data(), &header, sizeof(header));
+    std::memcpy(buf.data() + sizeof(header), block_sizes.data(),
+                block_sizes.size() * sizeof(std::uint64_t));
+    ret |= MPI_File_write_at(f, static_cast<MPI_Offset>(frame_offset),
+                             buf.data(), static_cast<int>(buf.size()),
+                             MPI_BYTE, MPI_STATUS_IGNORE);
+  }
+  ret |= MPI_File_write_at_all(
+      f, static_cast<MPI_Offset>(frame_offset + header_size + block_pref),
+      payload.data(), static_cast<int>(payload.size()), MPI_BYTE,
+      MPI_STATUS_IGNORE);
+  /* Drop data of incomplete frames from earlier runs */
+  ret |= MPI_File_set_size(f,
+                           static_cast<MPI_Offset>(frame_offset + frame_size));
+  MPI_File_close(&f);
+  if (ret) {
+    fprintf(stderr, "MPI-IO Error: Could not write file \"%s\".\n",
+            fn.c_str());
+    errexit();
+  }
+
+  /* Only index the frame after it has been written completely */
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == 0) {
+    IndexRecord record{frame_offset, frame_size, time};
+    auto const ifn = index_file(prefix);
+    if (frame_offset == 0)
+      std::remove(ifn.c_str());
+    FILE *idx = fopen(ifn.c_str(), "ab");
+    if (not idx or fwrite(&record, sizeof(record), 1, idx) != 1) {
+      fprintf(stderr, "MPI-IO Error: Could not write %s.\n", ifn.c_str());
+      errexit();
+    }
+    fclose(idx);
+  }
+}
+
+std::size_t compact_n_frames(const char *filename) {
+  std::ifstream index(index_file(filename), std::ios::binary | std::ios::ate);
+  if (not index)
+    return 0;
+  return static_cast<std::size_t>(index.tellg()) / sizeof(IndexRecord);
+}
+
+CompactFrame compact_read_frame(const char *filename, std::size_t frame) {
+  std::string const prefix(filename);
+  if (frame >= compact_n_frames(filename))
+    throw std::runtime_error("Frame " + std::to_string(frame) +
+                             " not found in compact trajectory '" + prefix +
+                             "'");
+
+  IndexRecord record;
+  {
+    std::ifstream index(index_file(prefix), std::ios::binary);
+    index.seekg(static_cast<std::streamoff>(frame * sizeof(IndexRecord)));
+    index.read(reinterpret_cast<char *>(&record), sizeof(record));
+  }
+
+  std::vector<char> buf(record.size);
+  {
+    std::ifstream data(data_file(prefix), std::ios::binary);
+    data.seekg(static_cast<std::streamoff>(record.offset));
+    data.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+    if (not data)
+      throw std::runtime_error("Could not read frame " +
+                               std::to_string(frame) + " of '" +
+                               data_file(prefix) + "'");
+  }
+
+  FrameHeader header;
+  if (buf.size() < sizeof(header))
+    throw std::runtime_error("Corrupt compact trajectory frame");
+  std::memcpy(&header, buf.data(), sizeof(header));
+  if (std::memcmp(header.magic, frame_magic, sizeof(frame_magic)) != 0 or
+      header.version != frame_version)
+    throw std::runtime_error("Not a compact trajectory: '" +
+                             data_file(prefix) + "'");
+
+  auto const header_size =
+      sizeof(FrameHeader) + header.n_blocks * sizeof(std::uint64_t);
+  if (buf.size() < header_size)
+    throw std::runtime_error("Corrupt compact trajectory frame");
+  std::vector<std::uint64_t> block_sizes(header.n_blocks);
+  std::memcpy(block_sizes.data(), buf.data() + sizeof(header),
+              block_sizes.size() * sizeof(std::uint64_t));
+
+  auto const has_velocities = (header.flags & flag_velocities) != 0;
+  Compact::Block block;
+  block.ids.reserve(header.n_particles);
+  block.positions.reserve(header.n_particles);
+  auto it = buf.data() + header_size;
+  for (auto const n : block_sizes) {
+    if (n > static_cast<std::uint64_t>(buf.data() + buf.size() - it))
+      throw std::runtime_error("Corrupt compact trajectory frame");
+    Compact::decode_block(it, it + n, header.precision, header.vel_precision,
+                          has_velocities, block);
+    it += n;
+  }
+
+  CompactFrame result;
+  result.time = header.time;
+  result.box_l = {header.box_l[0], header.box_l[1], header.box_l[2]};
+  result.precision = header.precision;
+  result.vel_precision = header.vel_precision;
+  result.ids = std::move(block.ids);
+  result.positions = std::move(block.positions);
+  result.velocities = std::move(block.velocities);
+  return result;
+}
+
+} // namespace Mpiio
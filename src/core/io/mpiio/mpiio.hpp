@@ -26,6 +26,12 @@
 #define _MPIIO_HPP
 
 #include "ParticleRange.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cstddef>
+#include <vector>
+
 namespace Mpiio {
 
 /** Constants which indicate what to output. To indicate the output of
@@ -57,6 +63,74 @@ void mpi_mpiio_common_write(const char *filename, unsigned fields,
  */
 void mpi_mpiio_common_read(const char *filename, unsigned fields);
 
+/** Write the dynamic state of the system into a single checkpoint file.
+ *  To be called by all MPI processes.
+ *
+ *  The checkpoint contains all particle properties including bonds and
+ *  exclusions, the simulation time, the RNG state of the thermostats and
+ *  of the LB fluid and the LB populations. An existing file is only
+ *  replaced once the new checkpoint has been written completely.
+ *
+ * \param filename A null-terminated filename.
+ */
+void mpi_checkpoint_write(const char *filename);
+
+/** Restore the state written by @ref mpi_checkpoint_write. To be called
+ *  by all MPI processes, which do not need to match the number of
+ *  processes at the time of writing. Replaces all particles. An LB fluid
+ *  with the same grid has to be set up before, if the checkpoint
+ *  contains one. Throws std::runtime_error on all processes if the file
+ *  is not a compatible checkpoint.
+ *
+ * \param filename A null-terminated filename.
+ */
+void mpi_checkpoint_read(const char *filename);
+
+/** One frame of a compact trajectory, sorted by particle id. */
+struct CompactFrame {
+  double time;
+  Utils::Vector3d box_l;
+  double precision;
+  double vel_precision;
+  std::vector<int> ids;
+  /** Unfolded positions. */
+  std::vector<Utils::Vector3d> positions;
+  /** Velocities, empty if they were not written. */
+  std::vector<Utils::Vector3d> velocities;
+};
+
+/** Append a frame to a compact trajectory. To be called by all MPI
+ *  processes. Aborts ESPResSo if an error occurs.
+ *
+ *  The unfolded positions (and optionally the velocities) are quantized
+ *  to multiples of @p precision resp. @p vel_precision. The particles
+ *  are redistributed such that each process holds a contiguous id range,
+ *  then every process delta-encodes its range and all processes write
+ *  concurrently to the file "<filename>.ctrj". The offset of each frame
+ *  is recorded in the index file "<filename>.cidx".
+ *
+ * \param filename A null-terminated filename prefix.
+ * \param precision Quantization step of the positions.
+ * \param velocities Whether to write the velocities.
+ * \param vel_precision Quantization step of the velocities.
+ * \param time Simulation time of the frame.
+ * \param particles range of particles to serialize.
+ */
+void mpi_compact_write(const char *filename, double precision,
+                       bool velocities, double vel_precision, double time,
+                       const ParticleRange &particles);
+
+/** Number of frames in a compact trajectory. */
+std::size_t compact_n_frames(const char *filename);
+
+/** Read a single frame of a compact trajectory via its index.
+ *  Can be called on any process, throws std::runtime_error on failure.
+ *
+ * \param filename A null-terminated filename prefix.
+ * \param frame Index of the frame.
+ */
+CompactFrame compact_read_frame(const char *filename, std::size_t frame);
+
 } // namespace Mpiio
 
 #endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/reader/field_hdf5.hpp"
+
+#include <boost/mpi/communicator.hpp>
+
+#include <hdf5.h>
+#include <mpi.h>
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Reader {
+namespace {
+/** Owner of an HDF5 identifier. */
+class Handle {
+  hid_t m_id;
+  herr_t (*m_close)(hid_t);
+
+public:
+  Handle(hid_t id, herr_t (*close)(hid_t), std::string const &what)
+      : m_id(id), m_close(close) {
+    if (m_id < 0) {
+      throw std::runtime_error("Could not " + what);
+    }
+  }
+  Handle(Handle &&other) noexcept : m_id(other.m_id), m_close(other.m_close) {
+    other.m_id = -1;
+  }
+  Handle(Handle const &) = delete;
+  Handle &operator=(Handle const &) = delete;
+  ~Handle() {
+    if (m_id >= 0)
+      m_close(m_id);
+  }
+  hid_t id() const { return m_id; }
+};
+
+void check(herr_t status, std::string const &what) {
+  if (status < 0) {
+    throw std::runtime_error("Could not " + what);
+  }
+}
+
+Handle open_file(boost::mpi::communicator const &comm,
+                 std::string const &file_name) {
+  Handle fapl(H5Pcreate(H5P_FILE_ACCESS), H5Pclose,
+              "create the file access properties");
+  check(H5Pset_fapl_mpio(fapl.id(), comm, MPI_INFO_NULL),
+        "set up MPI-IO for '" + file_name + "'");
+  return {H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl.id()), H5Fclose,
+          "open '" + file_name + "'"};
+}
+
+std::array<hsize_t, 4> extents(Handle const &dataspace,
+                               std::string const &dataset_name) {
+  if (H5Sget_simple_extent_ndims(dataspace.id()) != 4) {
+    throw std::runtime_error("Dataset '" + dataset_name +
+                             "' needs to have the shape [n, m, o, codim]");
+  }
+  std::array<hsize_t, 4> dims;
+  check(H5Sget_simple_extent_dims(dataspace.id(), dims.data(), nullptr),
+        "read the shape of '" + dataset_name + "'");
+  return dims;
+}
+
+/** Contiguous runs of ascending indices as pairs of start and length. */
+std::vector<std::pair<hsize_t, hsize_t>> runs(std::vector<int> const &indices) {
+  std::vector<std::pair<hsize_t, hsize_t>> result;
+  for (auto const i : indices) {
+    auto const index = static_cast<hsize_t>(i);
+    if (not result.empty() and
+        result.back().first + result.back().second == index) {
+      result.back().second++;
+    } else {
+      result.emplace_back(index, 1);
+    }
+  }
+  return result;
+}
+} // namespace
+
+std::array<int, 4> field_shape(boost::mpi::communicator const &comm,
+                               std::string const &file_name,
+                               std::string const &dataset_name) {
+  auto const file = open_file(comm, file_name);
+  Handle const dataset(H5Dopen2(file.id(), dataset_name.c_str(), H5P_DEFAULT),
+                       H5Dclose, "open dataset '" + dataset_name + "'");
+  Handle const dataspace(H5Dget_space(dataset.id()), H5Sclose,
+                         "get the shape of '" + dataset_name + "'");
+  auto const dims = extents(dataspace, dataset_name);
+  return {{static_cast<int>(dims[0]), static_cast<int>(dims[1]),
+           static_cast<int>(dims[2]), static_cast<int>(dims[3])}};
+}
+
+std::vector<double> read_field(boost::mpi::communicator const &comm,
+                               std::string const &file_name,
+                               std::string const &dataset_name,
+                               std::array<std::vector<int>, 3> const &indices) {
+  auto const file = open_file(comm, file_name);
+  Handle const dataset(H5Dopen2(file.id(), dataset_name.c_str(), H5P_DEFAULT),
+                       H5Dclose, "open dataset '" + dataset_name + "'");
+  Handle const file_space(H5Dget_space(dataset.id()), H5Sclose,
+                          "get the shape of '" + dataset_name + "'");
+  auto const dims = extents(file_space, dataset_name);
+
+  /* the union of the hyperslabs is read in row-major order, which is the
+   * order of the grid points in the local array */
+  check(H5Sselect_none(file_space.id()), "select grid points");
+  for (auto const &x : runs(indices[0])) {
+    for (auto const &y : runs(indices[1])) {
+      for (auto const &z : runs(indices[2])) {
+        std::array<hsize_t, 4> const start = {{x.first, y.first, z.first, 0}};
+        std::array<hsize_t, 4> const count = {
+            {x.second, y.second, z.second, dims[3]}};
+        check(H5Sselect_hyperslab(file_space.id(), H5S_SELECT_OR,
+                                  start.data(), nullptr, count.data(),
+                                  nullptr),
+              "select grid points");
+      }
+    }
+  }
+
+  auto const size =
+      static_cast<hsize_t>(H5Sget_select_npoints(file_space.id()));
+  std::vector<double> data(size);
+  Handle const memory_space(H5Screate_simple(1, &size, nullptr), H5Sclose,
+                            "create the memory space");
+  Handle const transfer(H5Pcreate(H5P_DATASET_XFER), H5Pclose,
+                        "create the transfer properties");
+  check(H5Pset_dxpl_mpio(transfer.id(), H5FD_MPIO_COLLECTIVE),
+        "set up collective reading");
+  check(H5Dread(dataset.id(), H5T_NATIVE_DOUBLE, memory_space.id(),
+                file_space.id(), transfer.id(), data.data()),
+        "read dataset '" + dataset_name + "'");
+  return data;
+}
+
+} // namespace Reader
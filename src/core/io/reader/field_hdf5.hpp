@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_IO_READER_FIELD_HDF5_HPP
+#define ESPRESSO_IO_READER_FIELD_HDF5_HPP
+/** \file
+ *  Parallel reading of gridded fields from HDF5 files.
+ *
+ *  A field is a dataset of shape (n0, n1, n2, codim) with the values at
+ *  the grid points in row-major order. Every node reads only the grid
+ *  points it needs, all nodes read collectively with MPI-IO.
+ *
+ *  Implementation in field_hdf5.cpp.
+ */
+
+#include "config.hpp"
+
+#ifdef H5MD
+
+#include <boost/mpi/communicator.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace Reader {
+
+/** @brief Shape of a field dataset.
+ *  @param comm          Communicator of the nodes that open the file.
+ *  @param file_name     Path to the HDF5 file.
+ *  @param dataset_name  Path to the dataset in the file.
+ *  @return the numbers of grid points in each direction, followed by the
+ *  number of components.
+ */
+std::array<int, 4> field_shape(boost::mpi::communicator const &comm,
+                               std::string const &file_name,
+                               std::string const &dataset_name);
+
+/** @brief Read selected grid points of a field dataset.
+ *
+ *  Collective on @p comm.
+ *
+ *  @param comm          Communicator of the nodes that read the file.
+ *  @param file_name     Path to the HDF5 file.
+ *  @param dataset_name  Path to the dataset in the file.
+ *  @param indices       Grid indices to read in each direction, ascending.
+ *  @return the values at the selected grid points in row-major order.
+ */
+std::vector<double> read_field(boost::mpi::communicator const &comm,
+                               std::string const &file_name,
+                               std::string const &dataset_name,
+                               std::array<std::vector<int>, 3> const &indices);
+
+} // namespace Reader
+
+#endif // H5MD
+#endif
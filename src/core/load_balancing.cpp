@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Dynamic load balancing of the domain decomposition.
+ *
+ *  The loads of the nodes are summed up per slab of the node grid, one
+ *  reduction for all three axes. The head node moves the boundaries of
+ *  each axis independently and broadcasts them. Every node then rebuilds
+ *  its local box and cell system; particles that left the local box are
+ *  moved by the next global resort.
+ */
+
+#include "load_balancing.hpp"
+
+#include "cells.hpp"
+#include "communication.hpp"
+#include "config.hpp"
+#include "constraints.hpp"
+#include "errorhandling.hpp"
+#include "grid.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+
+#ifdef ELECTROSTATICS
+#include "electrostatics_magnetostatics/coulomb.hpp"
+#endif
+#ifdef DIPOLES
+#include "electrostatics_magnetostatics/dipole.hpp"
+#endif
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/mpi/operations.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace LoadBalancing {
+namespace {
+Parameters params{};
+/** Integration steps since the parameters were set. */
+int steps = 0;
+/** Force time accumulated since the last rebalancing attempt. */
+double force_time = 0.;
+std::chrono::steady_clock::time_point force_timer_start;
+double imbalance = 1.;
+
+/** Whether a constraint only stores the data of the current local box. */
+bool has_distributed_constraints() {
+  return std::any_of(Constraints::constraints.begin(),
+                     Constraints::constraints.end(),
+                     [](auto const &c) { return c->is_distributed(); });
+}
+
+/** Name of an active method that requires regular subdomains. */
+const char *unsupported_method() {
+  if (lattice_switch != ActiveLB::NONE)
+    return "lattice-Boltzmann";
+  if (has_distributed_constraints())
+    return "distributed fields";
+#ifdef ELECTROSTATICS
+  switch (coulomb.method) {
+  case COULOMB_P3M:
+  case COULOMB_P3M_GPU:
+  case COULOMB_ELC_P3M:
+    return "P3M";
+  case COULOMB_SCAFACOS:
+    return "ScaFaCoS";
+  default:
+    break;
+  }
+#endif
+#ifdef DIPOLES
+  switch (dipole.method) {
+  case DIPOLAR_P3M:
+  case DIPOLAR_MDLC_P3M:
+    return "dipolar P3M";
+  case DIPOLAR_SCAFACOS:
+    return "ScaFaCoS";
+  default:
+    break;
+  }
+#endif
+  return nullptr;
+}
+
+bool is_balanced() {
+  return std::any_of(node_boundaries.begin(), node_boundaries.end(),
+                     [](auto const &b) { return not b.empty(); });
+}
+
+void rebuild_decomposition() {
+  grid_changed_box_l(box_geo);
+  if (cell_structure.decomposition_type() == CELL_STRUCTURE_DOMDEC) {
+    cells_re_init(CELL_STRUCTURE_DOMDEC);
+  }
+}
+
+double local_load() {
+  if (params.metric == Metric::FORCE_TIME)
+    return force_time;
+  return static_cast<double>(cell_structure.local_particles().size());
+}
+
+/** Collective rebalancing attempt.
+ *  @param force  rebalance even if the imbalance is tolerable
+ */
+void rebalance(bool force) {
+  if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC)
+    return;
+  if (auto const method = unsupported_method()) {
+    if (force) {
+      runtimeErrorMsg() << "Load balancing is not supported with " << method;
+    }
+    return;
+  }
+
+  auto const load = local_load();
+  force_time = 0.;
+
+  /* loads of all slabs of all axes */
+  auto const node_pos = calc_node_pos(comm_cart);
+  std::vector<double> slab_loads(node_grid[0] + node_grid[1] + node_grid[2]);
+  for (int i = 0, offset = 0; i < 3; offset += node_grid[i++]) {
+    slab_loads[offset + node_pos[i]] = load;
+  }
+
+  std::vector<double> total_loads(slab_loads.size());
+  double max_load = 0.;
+  boost::mpi::reduce(comm_cart, slab_loads.data(),
+                     static_cast<int>(slab_loads.size()), total_loads.data(),
+                     std::plus<double>(), 0);
+  boost::mpi::reduce(comm_cart, load, max_load,
+                     boost::mpi::maximum<double>(), 0);
+
+  bool changed = false;
+  auto boundaries = node_boundaries;
+  if (this_node == 0) {
+    auto const total =
+        std::accumulate(total_loads.begin(), total_loads.begin() + node_grid[0],
+                        0.);
+    auto const mean = total / comm_cart.size();
+    imbalance = (mean > 0.) ? max_load / mean : 1.;
+
+    if (total > 0. and (force or imbalance > 1. + params.tolerance)) {
+      auto const dd = get_domain_decomposition();
+      for (int i = 0, offset = 0; i < 3; offset += node_grid[i++]) {
+        auto const n = node_grid[i];
+        if (n == 1)
+          continue;
+        /* slabs hold at least the ghost layer depth in regular cells */
+        auto const min_width = dd->params.cells_per_range *
+                               dd->regular_cell_size[i] / box_geo.length()[i];
+        if (n * min_width >= 1.)
+          continue;
+        auto current = boundaries[i];
+        if (current.empty()) {
+          current.resize(n + 1);
+          for (int k = 0; k <= n; k++)
+            current[k] = static_cast<double>(k) / n;
+        }
+        std::vector<double> const loads(total_loads.begin() + offset,
+                                        total_loads.begin() + offset + n);
+        boundaries[i] =
+            balance_boundaries(current, loads, min_width, params.relaxation);
+        changed = true;
+      }
+    }
+  }
+
+  boost::mpi::broadcast(comm_cart, imbalance, 0);
+  boost::mpi::broadcast(comm_cart, changed, 0);
+  if (changed) {
+    boost::mpi::broadcast(comm_cart, boundaries, 0);
+    node_boundaries = boundaries;
+    rebuild_decomposition();
+  }
+}
+} // namespace
+
+std::vector<double> balance_boundaries(std::vector<double> const &boundaries,
+                                       std::vector<double> const &loads,
+                                       double min_width, double relaxation) {
+  auto const n = static_cast<int>(loads.size());
+  assert(boundaries.size() == loads.size() + 1);
+
+  std::vector<double> cumulative(n + 1, 0.);
+  std::partial_sum(loads.begin(), loads.end(), std::next(cumulative.begin()));
+  auto const total = cumulative.back();
+
+  auto result = boundaries;
+  if (total <= 0.)
+    return result;
+
+  int slab = 0;
+  for (int k = 1; k < n; k++) {
+    auto const target = total * k / n;
+    while (slab < n - 1 and cumulative[slab + 1] < target)
+      slab++;
+    /* the target lies in a slab with non-zero load */
+    auto const fraction = (target - cumulative[slab]) / loads[slab];
+    auto const balanced =
+        boundaries[slab] + fraction * (boundaries[slab + 1] - boundaries[slab]);
+    result[k] = boundaries[k] + relaxation * (balanced - boundaries[k]);
+  }
+
+  result.front() = 0.;
+  result.back() = 1.;
+  for (int k = 1; k < n; k++) {
+    result[k] = std::min(std::max(result[k], k * min_width),
+                         1. - (n - k) * min_width);
+    result[k] = std::max(result[k], result[k - 1] + min_width);
+  }
+
+  return result;
+}
+
+Parameters const &parameters() { return params; }
+
+double last_imbalance() { return imbalance; }
+
+static void mpi_set_parameters_local(Parameters const &new_params) {
+  params = new_params;
+  steps = 0;
+  force_time = 0.;
+}
+
+REGISTER_CALLBACK(mpi_set_parameters_local)
+
+void mpi_set_parameters(int interval, Metric metric, double tolerance,
+                        double relaxation) {
+  if (interval < 0) {
+    throw std::domain_error("Load balancing interval must be >= 0");
+  }
+  if (tolerance < 0.) {
+    throw std::domain_error("Load balancing tolerance must be >= 0");
+  }
+  if (relaxation <= 0. or relaxation > 1.) {
+    throw std::domain_error("Load balancing relaxation must be in (0, 1]");
+  }
+  if (interval > 0 and has_distributed_constraints()) {
+    throw std::runtime_error(
+        "Load balancing is not supported with distributed fields");
+  }
+  Parameters new_params;
+  new_params.interval = interval;
+  new_params.metric = metric;
+  new_params.tolerance = tolerance;
+  new_params.relaxation = relaxation;
+  mpi_call_all(mpi_set_parameters_local, new_params);
+}
+
+static void mpi_rebalance_local() { rebalance(true); }
+
+REGISTER_CALLBACK(mpi_rebalance_local)
+
+double mpi_rebalance() {
+  mpi_call_all(mpi_rebalance_local);
+  return imbalance;
+}
+
+static void mpi_reset_local() {
+  if (not is_balanced())
+    return;
+  for (auto &b : node_boundaries)
+    b.clear();
+  rebuild_decomposition();
+}
+
+REGISTER_CALLBACK(mpi_reset_local)
+
+void mpi_reset() {
+  if (is_balanced() and has_distributed_constraints()) {
+    throw std::runtime_error(
+        "The node boundaries of distributed fields cannot be moved");
+  }
+  mpi_call_all(mpi_reset_local);
+}
+
+void on_integration_step() {
+  if (params.interval > 0 and ++steps % params.interval == 0) {
+    rebalance(false);
+  }
+}
+
+void sanity_checks() {
+  if (params.interval == 0 and not is_balanced())
+    return;
+  if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC)
+    return;
+  if (auto const method = unsupported_method()) {
+    runtimeErrorMsg() << "Load balancing is not supported with " << method;
+  }
+}
+
+void start_force_timer() {
+  if (params.metric == Metric::FORCE_TIME)
+    force_timer_start = std::chrono::steady_clock::now();
+}
+
+void stop_force_timer() {
+  if (params.metric == Metric::FORCE_TIME) {
+    std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - force_timer_start;
+    force_time += elapsed.count();
+  }
+}
+
+} // namespace LoadBalancing
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_LOAD_BALANCING_HPP
+#define ESPRESSO_LOAD_BALANCING_HPP
+
+/** \file
+ *  Dynamic load balancing of the domain decomposition.
+ *
+ *  The subdomain boundaries are moved along each axis of the node grid,
+ *  such that every slab of nodes carries the same share of the load.
+ *  All nodes of a slab share the same boundaries (rectilinear
+ *  partitioning), hence the cell grids of neighboring nodes match on
+ *  their common faces and the ghost communication keeps its structure.
+ *  The boundaries are stored in @ref node_boundaries.
+ *
+ *  Implementation in load_balancing.cpp.
+ */
+
+#include <boost/serialization/access.hpp>
+
+#include <vector>
+
+namespace LoadBalancing {
+
+/** Measure of the work of a node. */
+enum class Metric : int {
+  /** Number of local particles. */
+  PARTICLES = 0,
+  /** Wall time spent in the short-range force calculation. */
+  FORCE_TIME = 1
+};
+
+/** Parameters of the load balancer. */
+struct Parameters {
+  /** Number of integration steps between two rebalancing attempts,
+   *  0 disables the automatic rebalancing.
+   */
+  int interval = 0;
+  Metric metric = Metric::PARTICLES;
+  /** Largest tolerated ratio of the maximal to the mean node load,
+   *  minus one.
+   */
+  double tolerance = 0.1;
+  /** Fraction of the way towards the balanced boundaries that is
+   *  moved in one rebalancing, in (0, 1].
+   */
+  double relaxation = 0.5;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &interval;
+    ar &metric;
+    ar &tolerance;
+    ar &relaxation;
+  }
+};
+
+/** Current parameters of the load balancer. */
+Parameters const &parameters();
+
+/** Set the parameters of the load balancer on all nodes.
+ *
+ *  @param interval    steps between two rebalancing attempts, 0 to disable
+ *  @param metric      measure of the node load
+ *  @param tolerance   tolerated load imbalance
+ *  @param relaxation  fraction of the boundary displacement per attempt
+ */
+void mpi_set_parameters(int interval, Metric metric, double tolerance,
+                        double relaxation);
+
+/** Rebalance the domain decomposition now, regardless of the tolerance.
+ *
+ *  @return Load imbalance before the rebalancing, i.e. the ratio of the
+ *  maximal to the mean node load.
+ */
+double mpi_rebalance();
+
+/** Restore the regular domain decomposition. */
+void mpi_reset();
+
+/** Imbalance measured by the last rebalancing attempt. */
+double last_imbalance();
+
+/** Count the integration steps and rebalance when due.
+ *  Has to be called on all nodes after every integration step.
+ */
+void on_integration_step();
+
+/** Check that the active methods support non-uniform subdomains. */
+void sanity_checks();
+
+/** @name Force time measurement */
+/**@{*/
+void start_force_timer();
+void stop_force_timer();
+/**@}*/
+
+/** @brief Move the subdomain boundaries along one axis.
+ *
+ *  The load of each slab is assumed to be evenly distributed across its
+ *  width. The boundaries that split the cumulative load into equal shares
+ *  are found by linear interpolation, then the current boundaries are
+ *  moved towards them by the fraction @p relaxation. No slab becomes
+ *  narrower than @p min_width.
+ *
+ *  @param boundaries  current boundaries, from 0 to 1
+ *  @param loads       load of each slab
+ *  @param min_width   minimal slab width
+ *  @param relaxation  fraction of the displacement to apply
+ *  @return New boundaries.
+ */
+std::vector<double> balance_boundaries(std::vector<double> const &boundaries,
+                                       std::vector<double> const &loads,
+                                       double min_width, double relaxation);
+
+} // namespace LoadBalancing
+
+#endif
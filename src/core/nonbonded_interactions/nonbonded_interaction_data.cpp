@@ -29,6 +29,7 @@
 #include "electrostatics_magnetostatics/dipole.hpp"
 #include "grid.hpp"
 #include "interactions.hpp"
+#include "nonbonded_interactions/pair_splines.hpp"
 #include "serialization/IA_parameters.hpp"
 
 #include <boost/archive/binary_iarchive.hpp>
@@ -222,6 +223,7 @@ void realloc_ia_params(int nsize) {
 
   max_seen_particle_type = nsize;
   std::swap(ia_params, new_params);
+  pair_splines_invalidate();
 }
 
 void reset_ia_params() {
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Implementation of pair_splines.hpp.
+ */
+#include "nonbonded_interactions/pair_splines.hpp"
+
+#include "communication.hpp"
+#include "energy_inline.hpp"
+#include "errorhandling.hpp"
+#include "event.hpp"
+#include "forces_inline.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/index.hpp>
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+std::vector<PairSpline> pair_splines;
+
+namespace {
+PairSplineParameters params;
+/** Whether @ref pair_splines matches the current interactions. */
+bool pair_splines_valid = false;
+
+/** @brief Cubic Hermite polynomial of a function on an interval.
+ *
+ *  The values and derivatives at the ends are extrapolated from points
+ *  inside the interval, such that a kink or a jump at either end doesn't
+ *  spoil the polynomial, even where the square root of the squared
+ *  distance rounds to the other side of a cutoff.
+ *
+ *  @param f   function of the squared distance
+ *  @param a   lower end of the interval
+ *  @param b   upper end of the interval
+ */
+std::array<double, 4>
+hermite_polynomial(std::function<double(double)> const &f, double a,
+                   double b) {
+  auto const ds = b - a;
+  auto const h = 1e-3 * ds;
+  /* quadratic extrapolation from three points, derivatives are scaled to
+   * the local coordinate */
+  auto const end = [&f, h, ds](double x, double dir) {
+    auto const y1 = f(x + dir * h);
+    auto const y2 = f(x + dir * 2. * h);
+    auto const y3 = f(x + dir * 3. * h);
+    return std::make_pair(3. * y1 - 3. * y2 + y3,
+                          -dir * (2.5 * y1 - 4. * y2 + 1.5 * y3) * ds / h);
+  };
+  auto const lower = end(a, 1.);
+  auto const upper = end(b, -1.);
+  auto const y0 = lower.first, m0 = lower.second;
+  auto const y1 = upper.first, m1 = upper.second;
+  return {{y0, m0, 3. * (y1 - y0) - 2. * m0 - m1, 2. * (y0 - y1) + m0 + m1}};
+}
+
+/** Deviation of a polynomial from the function it interpolates.
+ *  @param f       function of the squared distance
+ *  @param c       polynomial of the interval
+ *  @param a       lower end of the interval
+ *  @param b       upper end of the interval
+ *  @param[in,out] scale   largest magnitude of the function seen so far
+ *  @return the largest deviation at the test points.
+ */
+double deviation(std::function<double(double)> const &f,
+                 std::array<double, 4> const &c, double a, double b,
+                 double &scale) {
+  scale = std::max(
+      {scale, std::abs(c[0]), std::abs(c[0] + c[1] + c[2] + c[3])});
+  auto error = 0.;
+  for (auto const t : {0.25, 0.5, 0.75}) {
+    auto const y = f(a + t * (b - a));
+    scale = std::max(scale, std::abs(y));
+    error = std::max(error, std::abs(PairSpline::evaluate(c, t) - y));
+  }
+  return error;
+}
+
+bool is_finite(std::array<double, 4> const &c) {
+  return std::all_of(c.begin(), c.end(),
+                     [](double x) { return std::isfinite(x); });
+}
+
+/** Distances at which one of the isotropic potentials of a type pair is
+ *  cut off or switches between functional forms. The largest one is the
+ *  cutoff of the pair.
+ */
+std::vector<double> central_pair_breakpoints(IA_parameters const &ia) {
+  std::vector<double> r;
+#ifdef LENNARD_JONES
+  r.push_back(ia.lj.cut + ia.lj.offset);
+  r.push_back(ia.lj.min + ia.lj.offset);
+#endif
+#ifdef WCA
+  r.push_back(ia.wca.cut);
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  r.push_back(ia.ljgen.cut + ia.ljgen.offset);
+  r.push_back(ia.ljgen.offset);
+#endif
+#ifdef SMOOTH_STEP
+  r.push_back(ia.smooth_step.cut);
+#endif
+#ifdef HERTZIAN
+  r.push_back(ia.hertzian.sig);
+#endif
+#ifdef GAUSSIAN
+  r.push_back(ia.gaussian.cut);
+#endif
+#ifdef BMHTF_NACL
+  r.push_back(ia.bmhtf.cut);
+#endif
+#ifdef MORSE
+  r.push_back(ia.morse.cut);
+#endif
+#ifdef BUCKINGHAM
+  r.push_back(ia.buckingham.cut);
+  r.push_back(ia.buckingham.discont);
+#endif
+#ifdef SOFT_SPHERE
+  r.push_back(ia.soft_sphere.cut + ia.soft_sphere.offset);
+  r.push_back(ia.soft_sphere.offset);
+#endif
+#ifdef HAT
+  r.push_back(ia.hat.r);
+#endif
+#ifdef LJCOS
+  r.push_back(ia.ljcos.cut + ia.ljcos.offset);
+  r.push_back(ia.ljcos.rmin + ia.ljcos.offset);
+#endif
+#ifdef LJCOS2
+  r.push_back(ia.ljcos2.cut + ia.ljcos2.offset);
+  r.push_back(ia.ljcos2.offset + ia.ljcos2.rchange);
+  r.push_back(ia.ljcos2.offset + ia.ljcos2.rchange + ia.ljcos2.w);
+#endif
+#ifdef TABULATED
+  /* the tables are interpolated linearly between the knots */
+  r.push_back(ia.tab.cutoff());
+  if (ia.tab.cutoff() > 0.) {
+    r.push_back(ia.tab.minval);
+    for (std::size_t i = 1; i + 1 < ia.tab.force_tab.size(); ++i) {
+      r.push_back(ia.tab.minval + static_cast<double>(i) / ia.tab.invstepsize);
+    }
+  }
+#endif
+  return r;
+}
+
+void mpi_set_pair_spline_params_local(bool active, double tolerance,
+                                      double r_min) {
+  params.active = active;
+  params.tolerance = tolerance;
+  params.r_min = r_min;
+  on_short_range_ia_change();
+}
+} // namespace
+
+REGISTER_CALLBACK(mpi_set_pair_spline_params_local)
+
+PairSpline::PairSpline(double dist2_min, double dist2_max,
+                       std::vector<Interval> intervals)
+    : m_dist2_min(dist2_min), m_dist2_max(dist2_max),
+      m_inv_step(static_cast<double>(intervals.size()) /
+                 (dist2_max - dist2_min)),
+      m_intervals(std::move(intervals)) {
+  assert(not m_intervals.empty());
+  assert(dist2_max > dist2_min);
+  m_intervals.push_back({{{0., 0., 0., 0.}}, {{0., 0., 0., 0.}}, false});
+}
+
+boost::optional<PairSpline>
+make_pair_spline(std::function<double(double)> const &force_factor,
+                 std::function<double(double)> const &energy, double r_min,
+                 double r_max, std::vector<double> breakpoints,
+                 double tolerance, std::size_t max_intervals) {
+  assert(r_min > 0.);
+  assert(r_max > r_min);
+  std::function<double(double)> const force_factor_s = [&](double s) {
+    return force_factor(std::sqrt(s));
+  };
+  std::function<double(double)> const energy_s = [&](double s) {
+    return energy(std::sqrt(s));
+  };
+
+  /* breakpoints inside of the grid, in squared distance */
+  breakpoints.erase(std::remove_if(breakpoints.begin(), breakpoints.end(),
+                                   [r_min, r_max](double r) {
+                                     return r <= r_min or r >= r_max;
+                                   }),
+                    breakpoints.end());
+  for (auto &r : breakpoints) {
+    r *= r;
+  }
+  std::sort(breakpoints.begin(), breakpoints.end());
+
+  auto const s_min = r_min * r_min;
+  auto const s_max = r_max * r_max;
+  for (std::size_t n = 64; n <= max_intervals; n *= 2) {
+    auto const ds = (s_max - s_min) / static_cast<double>(n);
+    std::vector<PairSpline::Interval> intervals(n);
+    auto force_scale = 0., force_error = 0.;
+    auto energy_scale = 0., energy_error = 0.;
+    auto breakpoint = breakpoints.begin();
+    for (std::size_t i = 0; i < n; ++i) {
+      auto const a = s_min + static_cast<double>(i) * ds;
+      auto const b = (i + 1 == n) ? s_max : a + ds;
+      while (breakpoint != breakpoints.end() and *breakpoint <= a) {
+        ++breakpoint;
+      }
+      auto &interval = intervals[i];
+      interval.analytic = breakpoint != breakpoints.end() and *breakpoint < b;
+      if (interval.analytic)
+        continue;
+
+      interval.force_factor = hermite_polynomial(force_factor_s, a, b);
+      interval.energy = hermite_polynomial(energy_s, a, b);
+      if (not is_finite(interval.force_factor) or
+          not is_finite(interval.energy))
+        return {};
+      force_error = std::max(force_error,
+                             deviation(force_factor_s, interval.force_factor,
+                                       a, b, force_scale));
+      energy_error = std::max(
+          energy_error,
+          deviation(energy_s, interval.energy, a, b, energy_scale));
+    }
+    if (force_error <= tolerance * force_scale and
+        energy_error <= tolerance * energy_scale) {
+      return PairSpline(s_min, s_max, std::move(intervals));
+    }
+  }
+  return {};
+}
+
+PairSplineParameters const &pair_spline_params() { return params; }
+
+void mpi_set_pair_spline_params(bool active, double tolerance, double r_min) {
+  mpi_call_all(mpi_set_pair_spline_params_local, active, tolerance, r_min);
+}
+
+void pair_splines_invalidate() {
+  pair_splines.clear();
+  pair_splines_valid = false;
+}
+
+void pair_splines_update() {
+  if (not params.active or pair_splines_valid)
+    return;
+
+  std::vector<PairSpline> splines(ia_params.size());
+  for (int i = 0; i < max_seen_particle_type; i++) {
+    for (int j = i; j < max_seen_particle_type; j++) {
+      auto const &ia = *get_ia_param(i, j);
+      auto breakpoints = central_pair_breakpoints(ia);
+      if (breakpoints.empty())
+        continue;
+      auto const r_max =
+          *std::max_element(breakpoints.begin(), breakpoints.end());
+      if (r_max <= params.r_min)
+        continue;
+
+      auto spline = make_pair_spline(
+          [&ia](double r) { return calc_central_pair_force_factor(ia, r); },
+          [&ia](double r) { return calc_central_pair_energy(ia, r); },
+          params.r_min, r_max, std::move(breakpoints), params.tolerance);
+      if (spline) {
+        splines[Utils::upper_triangular(i, j, max_seen_particle_type)] =
+            std::move(*spline);
+      } else if (this_node == 0) {
+        runtimeWarningMsg()
+            << "The non-bonded interactions between the particle types " << i
+            << " and " << j << " are evaluated analytically, since no "
+            << "spline with up to " << PAIR_SPLINE_MAX_INTERVALS
+            << " intervals meets the tolerance";
+      }
+    }
+  }
+  pair_splines = std::move(splines);
+  pair_splines_valid = true;
+}
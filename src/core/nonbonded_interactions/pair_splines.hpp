@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NB_IA_PAIR_SPLINES_HPP
+#define CORE_NB_IA_PAIR_SPLINES_HPP
+/** \file
+ *  Automatic tabulation of the isotropic non-bonded pair potentials.
+ *
+ *  When the tabulation is active, the force factors and energies of all
+ *  isotropic potentials of a type pair are summed into one cubic spline
+ *  on a uniform grid in the squared distance, so that the short-range
+ *  loop evaluates a single polynomial per pair and no square roots,
+ *  powers or exponentials. The grid is refined until the spline matches
+ *  the analytic potentials within a relative tolerance. Intervals which
+ *  contain a cutoff or a switching distance of one of the potentials,
+ *  and distances below the tabulation range, are evaluated analytically.
+ *
+ *  The splines are rebuilt on all nodes before the next force or
+ *  observable calculation after the interactions changed.
+ *
+ *  Implementation in pair_splines.cpp.
+ */
+
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/index.hpp>
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/** Cubic spline of the force factor and the energy of a type pair on a
+ *  uniform grid in the squared distance.
+ */
+class PairSpline {
+public:
+  /** Cubic Hermite polynomials of one interval in the local coordinate
+   *  \f$ t \in [0, 1) \f$, lowest order first.
+   */
+  struct Interval {
+    std::array<double, 4> force_factor;
+    std::array<double, 4> energy;
+    /** Whether the potentials have to be evaluated analytically. */
+    bool analytic;
+  };
+
+  PairSpline() = default;
+  /** @param dist2_min   squared distance of the first knot
+   *  @param dist2_max   squared distance of the last knot, beyond which
+   *                     all potentials vanish
+   *  @param intervals   polynomials of the intervals between the knots
+   */
+  PairSpline(double dist2_min, double dist2_max,
+             std::vector<Interval> intervals);
+
+  bool empty() const { return m_intervals.empty(); }
+  /** Number of intervals between the knots. */
+  std::size_t size() const {
+    return empty() ? 0 : m_intervals.size() - 1;
+  }
+  double dist2_min() const { return m_dist2_min; }
+  double dist2_max() const { return m_dist2_max; }
+
+  /** @brief Find the interval of a squared distance.
+   *  @param[in]  dist2  squared distance of the pair
+   *  @param[out] t      local coordinate in the interval
+   *  @return the interval, or nullptr if the potentials have to be
+   *  evaluated analytically.
+   */
+  Interval const *find(double dist2, double &t) const {
+    if (dist2 < m_dist2_min)
+      return nullptr;
+    auto const x = (dist2 - m_dist2_min) * m_inv_step;
+    auto const n = m_intervals.size() - 1;
+    /* the last entry vanishes and covers all distances beyond the grid */
+    auto const i = (x < static_cast<double>(n)) ? static_cast<std::size_t>(x)
+                                                : n;
+    t = x - static_cast<double>(i);
+    auto const &interval = m_intervals[i];
+    return interval.analytic ? nullptr : &interval;
+  }
+
+  /** Evaluate a polynomial of an interval. */
+  static double evaluate(std::array<double, 4> const &c, double t) {
+    return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+  }
+
+private:
+  double m_dist2_min = 0.;
+  double m_dist2_max = 0.;
+  double m_inv_step = 0.;
+  std::vector<Interval> m_intervals;
+};
+
+/** Largest number of intervals of a spline. */
+constexpr std::size_t PAIR_SPLINE_MAX_INTERVALS = 1u << 14u;
+
+/** @brief Tabulate a force factor and an energy.
+ *
+ *  The number of intervals starts at 64 and is doubled until the maximal
+ *  deviation of the spline from @p force_factor and @p energy in the
+ *  interior of the intervals is below @p tolerance times the largest
+ *  magnitude of the respective function on the grid.
+ *
+ *  @param force_factor  force divided by the distance
+ *  @param energy        potential energy
+ *  @param r_min         smallest tabulated distance, > 0
+ *  @param r_max         distance beyond which both functions vanish
+ *  @param breakpoints   distances at which the functions have a kink or
+ *                       a discontinuity
+ *  @param tolerance     relative tolerance
+ *  @param max_intervals largest number of intervals
+ *  @return the spline, or nothing if the tolerance cannot be met.
+ */
+boost::optional<PairSpline>
+make_pair_spline(std::function<double(double)> const &force_factor,
+                 std::function<double(double)> const &energy, double r_min,
+                 double r_max, std::vector<double> breakpoints,
+                 double tolerance,
+                 std::size_t max_intervals = PAIR_SPLINE_MAX_INTERVALS);
+
+/** Parameters of the automatic tabulation. */
+struct PairSplineParameters {
+  bool active = false;
+  /** Relative tolerance of the splines. */
+  double tolerance = 1e-6;
+  /** Smallest tabulated distance. */
+  double r_min = 0.;
+};
+
+/** Splines of the type pairs, indexed like @ref ia_params. Empty if the
+ *  tabulation is inactive or out of date.
+ */
+extern std::vector<PairSpline> pair_splines;
+
+/** @brief Spline of the isotropic potentials between two particle types.
+ *  @return the spline, or nullptr if the pair is evaluated analytically.
+ */
+inline PairSpline const *get_pair_spline(int i, int j) {
+  if (pair_splines.empty())
+    return nullptr;
+  auto const &spline = pair_splines[Utils::upper_triangular(
+      std::min(i, j), std::max(i, j), max_seen_particle_type)];
+  return spline.empty() ? nullptr : &spline;
+}
+
+PairSplineParameters const &pair_spline_params();
+
+/** @brief Set the parameters of the automatic tabulation on all nodes.
+ *  @param active      whether to tabulate the potentials
+ *  @param tolerance   relative tolerance of the splines
+ *  @param r_min       smallest tabulated distance
+ */
+void mpi_set_pair_spline_params(bool active, double tolerance, double r_min);
+
+/** Discard the splines after a change of the interactions. */
+void pair_splines_invalidate();
+
+/** Rebuild the splines if the tabulation is active and they are out of
+ *  date.
+ */
+void pair_splines_update();
+
+#endif
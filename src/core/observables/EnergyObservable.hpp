@@ -30,6 +30,9 @@ namespace Observables {
 class Energy : public Observable {
 public:
   std::vector<size_t> shape() const override { return {1}; }
+  unsigned fused_observables() const override {
+    return FUSED_OBSERVABLE_ENERGY;
+  }
   std::vector<double> operator()() const override {
     std::vector<double> res{1};
     res[0] = observable_compute_energy();
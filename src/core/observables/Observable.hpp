@@ -20,6 +20,8 @@
 #ifndef OBSERVABLES_OBSERVABLE_HPP
 #define OBSERVABLES_OBSERVABLE_HPP
 
+#include "fused_observables.hpp"
+
 #include <cstddef>
 #include <functional>
 #include <numeric>
@@ -52,6 +54,11 @@ public:
 
   /** Dimensions needed to reshape the flat array returned by the observable */
   virtual std::vector<size_t> shape() const = 0;
+
+  /** Observables the force calculation can accumulate ahead of an
+   *  automatic update, a combination of @ref FusedObservable.
+   */
+  virtual unsigned fused_observables() const { return FUSED_OBSERVABLE_NONE; }
 };
 
 } // Namespace Observables
@@ -36,7 +36,7 @@ public:
   std::vector<double>
   evaluate(Utils::Span<std::reference_wrapper<const Particle>> particles,
            const ParticleObservables::traits<Particle> &traits) const override {
-    std::vector<double> res(n_values());
+    std::vector<double> res(3 * particles.size());
 
 #ifdef ROTATION
     size_t i = 0;
@@ -53,6 +53,7 @@ public:
   }
 
   std::vector<size_t> shape() const override { return {ids().size(), 3}; }
+  size_t values_per_particle() const override { return 3; }
 };
 
 } // Namespace Observables
@@ -37,7 +37,7 @@ public:
   std::vector<double>
   evaluate(Utils::Span<std::reference_wrapper<const Particle>> particles,
            const ParticleObservables::traits<Particle> &traits) const override {
-    std::vector<double> res(n_values());
+    std::vector<double> res(3 * particles.size());
     for (size_t i = 0; i < particles.size(); i++) {
 #ifdef ROTATION
       const Utils::Vector3d vel_body = convert_vector_space_to_body(
@@ -51,6 +51,7 @@ public:
     return res;
   }
   std::vector<size_t> shape() const override { return {ids().size(), 3}; }
+  size_t values_per_particle() const override { return 3; }
 };
 
 } // Namespace Observables
@@ -37,7 +37,7 @@ public:
   std::vector<double>
   evaluate(ParticleReferenceRange particles,
            const ParticleObservables::traits<Particle> &traits) const override {
-    std::vector<double> res(n_values());
+    std::vector<double> res(3 * particles.size());
     for (size_t i = 0; i < particles.size(); i++) {
       res[3 * i + 0] = particles[i].get().f.f[0];
       res[3 * i + 1] = particles[i].get().f.f[1];
@@ -46,6 +46,7 @@ public:
     return res;
   };
   std::vector<size_t> shape() const override { return {ids().size(), 3}; }
+  size_t values_per_particle() const override { return 3; }
 };
 
 } // Namespace Observables
@@ -32,9 +32,11 @@
 
 #include <boost/range/algorithm/copy.hpp>
 
+#include <cassert>
 #include <cstddef>
 #include <functional>
 #include <iterator>
+#include <numeric>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -61,6 +63,20 @@ public:
   explicit PidObservable(std::vector<int> ids) : m_ids(std::move(ids)) {}
   std::vector<double> operator()() const final;
   std::vector<int> const &ids() const { return m_ids; }
+
+  /** Number of values per particle of observables which map each particle
+   *  to values of its own, 0 for observables which combine the particles.
+   *  Only the former can be evaluated on a subset of their particles.
+   */
+  virtual std::size_t values_per_particle() const { return 0; }
+
+  /** Evaluate a per-particle observable on some of its particles, e.g. the
+   *  ones local to a node. The values are ordered like @p particles.
+   */
+  std::vector<double> evaluate_subset(ParticleReferenceRange particles) const {
+    assert(values_per_particle() != 0);
+    return this->evaluate(particles, ParticleObservables::traits<Particle>{});
+  }
 };
 
 namespace detail {
@@ -85,6 +101,21 @@ template <class T> struct shape_impl<std::vector<T>> {
     return ret;
   }
 };
+
+/**
+ * Number of values per particle for algorithms returning a `std::vector`
+ * with one entry per particle, 0 for all other algorithms.
+ */
+template <class T> struct values_per_particle_impl {
+  static size_t eval() { return 0; }
+};
+template <class T> struct values_per_particle_impl<std::vector<T>> {
+  static size_t eval() {
+    auto const shape = shape_impl<T>::eval(1);
+    return std::accumulate(shape.begin(), shape.end(), size_t{1},
+                           std::multiplies<>());
+  }
+};
 } // namespace detail
 
 /**
@@ -111,6 +142,13 @@ public:
         declval<ParticleReferenceRange>()))>::eval(ids().size());
   }
 
+  size_t values_per_particle() const override {
+    using std::declval;
+
+    return detail::values_per_particle_impl<decltype(declval<ObsType>()(
+        declval<ParticleReferenceRange>()))>::eval();
+  }
+
   std::vector<double>
   evaluate(ParticleReferenceRange particles,
            const ParticleObservables::traits<Particle> &traits) const override {
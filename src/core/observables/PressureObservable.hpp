@@ -29,6 +29,9 @@ namespace Observables {
 class Pressure : public Observable {
 public:
   std::vector<size_t> shape() const override { return {1}; }
+  unsigned fused_observables() const override {
+    return FUSED_OBSERVABLE_PRESSURE;
+  }
   std::vector<double> operator()() const override {
     auto const ptensor = observable_compute_pressure_tensor();
     std::vector<double> res{1};
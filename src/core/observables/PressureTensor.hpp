@@ -29,6 +29,9 @@ namespace Observables {
 class PressureTensor : public Observable {
 public:
   std::vector<size_t> shape() const override { return {3, 3}; }
+  unsigned fused_observables() const override {
+    return FUSED_OBSERVABLE_PRESSURE;
+  }
   std::vector<double> operator()() const override {
     return observable_compute_pressure_tensor().as_vector();
   }
@@ -316,23 +316,23 @@ struct UpdateVisitor : public boost::static_visitor<void> {
 };
 } // namespace
 
-void mpi_send_update_message_local(int node, int id) {
+void mpi_send_update_message_local(int node, int id,
+                                   UpdateMessage const &msg) {
   if (node == comm_cart.rank()) {
-    UpdateMessage msg{};
-    comm_cart.recv(0, SOME_TAG, msg);
     boost::apply_visitor(UpdateVisitor{id}, msg);
   }
 
   on_particle_change();
 }
 
-REGISTER_CALLBACK(mpi_send_update_message_local)
+REGISTER_CALLBACK_DEFERRABLE(mpi_send_update_message_local)
 
 /**
  * @brief Send a particle update message.
  *
- * This sends the message to the node that is responsible for the particle,
- * where
+ * This sends the message along with the callback, so that the update
+ * can be deferred. The node that is responsible for the particle applies
+ * it, where
  * @p msg is called with the particle as argument. The message then performs the
  * change to the particle that is encoded in it. The mechanism to call a functor
  * based on the active type of a variant is called visitation. Here we can use
@@ -349,18 +349,7 @@ REGISTER_CALLBACK(mpi_send_update_message_local)
 void mpi_send_update_message(int id, const UpdateMessage &msg) {
   auto const pnode = get_particle_node(id);
 
-  mpi_call(mpi_send_update_message_local, pnode, id);
-
-  /* If the particle is remote, send the
-   * message to the target, otherwise we
-   * can just apply the update directly. */
-  if (pnode != comm_cart.rank()) {
-    comm_cart.send(pnode, SOME_TAG, msg);
-  } else {
-    boost::apply_visitor(UpdateVisitor{id}, msg);
-  }
-
-  on_particle_change();
+  mpi_call_all(mpi_send_update_message_local, pnode, id, msg);
 }
 
 template <typename S, S Particle::*s, typename T, T S::*m>
@@ -654,10 +643,9 @@ int mpi_place_new_particle(int p_id, const Utils::Vector3d &pos) {
                   p_id, pos);
 }
 
-void mpi_place_particle_local(int pnode, int p_id) {
+void mpi_place_particle_local(int pnode, int p_id,
+                              Utils::Vector3d const &pos) {
   if (pnode == this_node) {
-    Utils::Vector3d pos;
-    comm_cart.recv(0, SOME_TAG, pos);
     local_place_particle(p_id, pos, 0);
   }
 
@@ -665,7 +653,7 @@ void mpi_place_particle_local(int pnode, int p_id) {
   on_particle_change();
 }
 
-REGISTER_CALLBACK(mpi_place_particle_local)
+REGISTER_CALLBACK_DEFERRABLE(mpi_place_particle_local)
 
 /** Move particle to a position on a node.
  *  Also calls \ref on_particle_change.
@@ -674,16 +662,7 @@ REGISTER_CALLBACK(mpi_place_particle_local)
  *  \param pos   the particles position.
  */
 void mpi_place_particle(int node, int p_id, const Utils::Vector3d &pos) {
-  mpi_call(mpi_place_particle_local, node, p_id);
-
-  if (node == this_node)
-    local_place_particle(p_id, pos, 0);
-  else {
-    comm_cart.send(node, SOME_TAG, pos);
-  }
-
-  cell_structure.set_resort_particles(Cells::RESORT_GLOBAL);
-  on_particle_change();
+  mpi_call_all(mpi_place_particle_local, node, p_id, pos);
 }
 
 int place_particle(int p_id, const double *pos) {
@@ -948,7 +927,7 @@ void mpi_remove_particle_local(int, int part) {
   on_particle_change();
 }
 
-REGISTER_CALLBACK(mpi_remove_particle_local)
+REGISTER_CALLBACK_DEFERRABLE(mpi_remove_particle_local)
 
 /** Remove a particle.
  *  Also calls \ref on_particle_change.
@@ -1060,7 +1039,7 @@ void mpi_send_exclusion_local(int part1, int part2, int _delete) {
   on_particle_change();
 }
 
-REGISTER_CALLBACK(mpi_send_exclusion_local)
+REGISTER_CALLBACK_DEFERRABLE(mpi_send_exclusion_local)
 
 /** Send exclusions.
  *  Also calls \ref on_particle_change.
@@ -1169,6 +1148,13 @@ void add_id_to_type_map(int part_id, int type) {
     particle_type_map.at(type).insert(part_id);
 }
 
+void rebuild_type_maps(std::vector<std::pair<int, int>> const &id_types) {
+  for (auto &kv : particle_type_map)
+    kv.second.clear();
+  for (auto const &id_type : id_types)
+    add_id_to_type_map(id_type.first, id_type.second);
+}
+
 int number_of_particles_with_type(int type) {
   if (particle_type_map.count(type) == 0)
     throw std::runtime_error("The provided particle type " +
@@ -45,6 +45,8 @@
 
 #include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 
 /************************************************
  * defines
@@ -347,6 +349,12 @@ void mpi_rescale_particles(int dir, double scale);
 void auto_exclusions(int distance);
 
 void init_type_map(int type);
+/** Add a particle id to the type map, if @p type is tracked. */
+void add_id_to_type_map(int part_id, int type);
+/** Replace the particles of the tracked types in the type map.
+ *  @param id_types  id and type of all particles
+ */
+void rebuild_type_maps(std::vector<std::pair<int, int>> const &id_types);
 
 /* find a particle of given type and return its id */
 int get_random_p_id(int type, int random_index_in_type_map);
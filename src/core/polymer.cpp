@@ -30,23 +30,45 @@
 #include "polymer.hpp"
 
 #include "BoxGeometry.hpp"
+#include "Particle.hpp"
+#include "SpatialGrid.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
 #include "constraints.hpp"
 #include "constraints/Constraints.hpp"
 #include "constraints/ShapeBasedConstraint.hpp"
+#include "event.hpp"
 #include "grid.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_data.hpp"
 #include "random.hpp"
-#include "statistics.hpp"
+#include "spatial_queries.hpp"
 
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
 #include <utils/math/vec_rotate.hpp>
+#include <utils/uniform.hpp>
 
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/all_to_all.hpp>
+#include <boost/mpi/collectives/gather.hpp>
 #include <boost/optional.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 template <class RNG> static Utils::Vector3d random_position(RNG &rng) {
@@ -67,24 +89,143 @@ template <class RNG> static Utils::Vector3d random_unit_vector(RNG &rng) {
   return v;
 }
 
+namespace {
+/** Positions of the monomers of a chain, tagged with the chain index. */
+using Chain = std::pair<int, std::vector<Utils::Vector3d>>;
+
+/** Counter-based stream of uniform random numbers in [0, 1) for one chain.
+ *  The stream only depends on the seed, the chain index and the round, so
+ *  that the chains do not depend on the node they are grown on.
+ */
+class ChainRNG {
+  uint32_t m_seed;
+  int m_chain;
+  int m_round;
+  uint64_t m_counter = 0;
+  std::array<double, 4> m_buffer{};
+  std::size_t m_next = 4;
+
+public:
+  ChainRNG(int seed, int chain, int round)
+      : m_seed(static_cast<uint32_t>(seed)), m_chain(chain), m_round(round) {}
+
+  double operator()() {
+    if (m_next == m_buffer.size()) {
+      auto const integers = Random::philox_4_uint64s<RNGSalt::POLYMER>(
+          m_counter++, m_seed, m_chain, m_round);
+      std::transform(integers.begin(), integers.end(), m_buffer.begin(),
+                     [](uint64_t value) { return Utils::uniform(value); });
+      m_next = 0;
+    }
+    return m_buffer[m_next++];
+  }
+};
+
+/** Lower corner and length of the local box of a node. */
+using Domain = std::pair<Utils::Vector3d, Utils::Vector3d>;
+/** Domains of all nodes. */
+using DomainList = std::vector<Domain>;
+
+/** Distance of @p pos to a domain along each direction. */
+Utils::Vector3d domain_gaps(Domain const &domain, Utils::Vector3d const &pos) {
+  Utils::Vector3d gaps;
+  for (unsigned i = 0; i < 3; ++i) {
+    auto const half_length = 0.5 * domain.second[i];
+    auto const center = domain.first[i] + half_length;
+    auto const d = get_mi_coord(pos[i], center, box_geo.length()[i],
+                                box_geo.periodic(i));
+    gaps[i] = std::max(0., std::fabs(d) - half_length);
+  }
+  return gaps;
+}
+
+/** Check whether @p pos is closer than @p halo to a domain. */
+bool in_domain_halo(Domain const &domain, Utils::Vector3d const &pos,
+                    double halo) {
+  auto const gaps = domain_gaps(domain, pos);
+  return std::all_of(gaps.begin(), gaps.end(),
+                     [halo](double gap) { return gap <= halo; });
+}
+
+/** Send every item to all nodes whose domain is within @p halo of one
+ *  of the item's positions.
+ *
+ *  Only the nodes whose domain is within @p halo of the region the
+ *  positions span around the local domain are considered.
+ *
+ *  @param items      items to distribute
+ *  @param positions  callable returning the positions of an item
+ *  @param domains    domains of all nodes
+ *  @param halo       distance up to which an item is relevant to a domain
+ *  @return Items received from all nodes, including this one.
+ */
+template <class T, class Positions>
+std::vector<T> exchange_halo(std::vector<T> const &items, Positions positions,
+                             DomainList const &domains, double halo) {
+  auto const &local = domains[this_node];
+  Utils::Vector3d reach{};
+  for (auto const &item : items) {
+    for (auto const &p : positions(item)) {
+      auto const gaps = domain_gaps(local, p);
+      for (unsigned i = 0; i < 3; ++i) {
+        reach[i] = std::max(reach[i], gaps[i]);
+      }
+    }
+  }
+
+  std::vector<int> neighbors;
+  for (int node = 0; node < comm_cart.size(); ++node) {
+    auto const &domain = domains[node];
+    auto const gaps =
+        domain_gaps(local, domain.first + 0.5 * domain.second) -
+        0.5 * domain.second;
+    bool close = true;
+    for (unsigned i = 0; i < 3; ++i) {
+      close &= gaps[i] <= reach[i] + halo;
+    }
+    if (close) {
+      neighbors.push_back(node);
+    }
+  }
+
+  std::vector<std::vector<T>> send_buf(comm_cart.size());
+  for (auto const &item : items) {
+    auto const &pos = positions(item);
+    for (auto const node : neighbors) {
+      if (std::any_of(pos.begin(), pos.end(),
+                      [&](Utils::Vector3d const &p) {
+                        return in_domain_halo(domains[node], p, halo);
+                      })) {
+        send_buf[node].push_back(item);
+      }
+    }
+  }
+
+  std::vector<std::vector<T>> recv_buf(comm_cart.size());
+  boost::mpi::all_to_all(comm_cart, send_buf, recv_buf);
+
+  std::vector<T> received;
+  for (auto &buf : recv_buf) {
+    std::move(buf.begin(), buf.end(), std::back_inserter(received));
+  }
+  return received;
+}
+
 /** Determines whether a given position @p pos is valid, i.e., it doesn't
  *  collide with existing or buffered particles, nor with existing constraints
  *  (if @c respect_constraints).
  *  @param pos                   the trial position in question
- *  @param positions             buffered positions to respect
- *  @param partCfg               existing particles to respect
- *  @param min_distance          threshold for the minimum distance between
- *                               trial position and buffered/existing particles
- *  @param respect_constraints   whether to respect constraints
+ *  @param obstacles             positions to respect
+ *  @param params                polymer parameters
  *  @return true if valid position, false if not.
  */
-static bool
-is_valid_position(Utils::Vector3d const &pos,
-                  std::vector<std::vector<Utils::Vector3d>> const &positions,
-                  PartCfg &partCfg, double const min_distance,
-                  int const respect_constraints) {
+bool is_valid_position(
+    Utils::Vector3d const &pos,
+    std::initializer_list<std::reference_wrapper<SpatialGrid<int> const>>
+        obstacles,
+    PolymerParameters const &params) {
   // check if constraint is violated
-  if (respect_constraints) {
+  if (params.respect_constraints) {
     Utils::Vector3d const folded_pos = folded_position(pos, box_geo);
 
     for (auto &c : Constraints::constraints) {
@@ -103,76 +244,85 @@ is_valid_position(Utils::Vector3d const &pos,
     }
   }
 
-  if (min_distance > 0) {
-    // check for collision with existing particles
-    if (distto(partCfg, pos, -1) < min_distance) {
-      return false;
-    }
-
-    for (auto const &p : positions) {
-      for (auto const &m : p) {
-        if (get_mi_vector(pos, m, box_geo).norm() < min_distance) {
-          return false;
-        }
+  if (params.min_distance > 0) {
+    // check for collision with existing and buffered particles
+    for (auto const &grid : obstacles) {
+      if (grid.get().any_closer_than(pos, params.min_distance)) {
+        return false;
       }
     }
   }
   return true;
 }
 
-std::vector<std::vector<Utils::Vector3d>>
-draw_polymer_positions(PartCfg &partCfg, int const n_polymers,
-                       int const beads_per_chain, double const bond_length,
-                       std::vector<Utils::Vector3d> const &start_positions,
-                       double const min_distance, int const max_tries,
-                       int const use_bond_angle, double const bond_angle,
-                       int const respect_constraints, int const seed) {
-  auto rng = [mt = Random::mt19937(static_cast<unsigned>(seed)),
-              dist = std::uniform_real_distribution<double>(
-                  0.0, 1.0)]() mutable { return dist(mt); };
+/** Start position of a chain in a given round. */
+Utils::Vector3d start_position(PolymerParameters const &params, int chain,
+                               int round) {
+  if (static_cast<std::size_t>(chain) < params.start_positions.size()) {
+    return params.start_positions[chain];
+  }
+  auto rng = ChainRNG(params.seed, chain, round);
+  return random_position(rng);
+}
 
-  std::vector<std::vector<Utils::Vector3d>> positions(n_polymers);
-  for (auto &p : positions) {
-    p.reserve(beads_per_chain);
+/** Grow a single chain by backtracking.
+ *
+ *  @param params      polymer parameters
+ *  @param chain       index of the chain
+ *  @param round       index of the round, selects the random stream
+ *  @param is_valid    callable checking a trial position against
+ *                     everything but the chain itself
+ *  @param own         grid for the monomers of the chain, empty on exit
+ *  @return The monomer positions, or nothing if the chain could not be
+ *          completed.
+ */
+template <class Validator>
+boost::optional<std::vector<Utils::Vector3d>>
+grow_chain(PolymerParameters const &params, int chain, int round,
+           Validator const &is_valid, SpatialGrid<int> &own) {
+  auto rng = ChainRNG(params.seed, chain, round);
+  /* The start position uses the first draws of the stream. */
+  if (static_cast<std::size_t>(chain) >= params.start_positions.size()) {
+    random_position(rng);
   }
 
-  auto is_valid_pos = [&positions, &partCfg, min_distance,
-                       respect_constraints](Utils::Vector3d const &v) {
-    return is_valid_position(v, positions, partCfg, min_distance,
-                             respect_constraints);
+  std::vector<Utils::Vector3d> positions;
+  positions.reserve(params.beads_per_chain);
+
+  auto const is_valid_pos = [&](Utils::Vector3d const &v) {
+    return is_valid(v) and
+           not(params.min_distance > 0 and
+               own.any_closer_than(v, params.min_distance));
   };
 
-  for (size_t p = 0; p < start_positions.size(); p++) {
-    if (is_valid_pos(start_positions[p])) {
-      positions[p].push_back(start_positions[p]);
-    } else {
-      throw std::runtime_error("Invalid start positions.");
-    }
-  }
+  auto push_back = [&](Utils::Vector3d const &pos) {
+    own.insert(pos, static_cast<int>(positions.size()));
+    positions.push_back(pos);
+  };
 
-  /* Draw a monomer position, obeying angle and starting position
-   * constraints where appropriate. */
-  auto draw_monomer_position = [&](int p, int m) {
-    if (m == 0) {
-      return (p < start_positions.size()) ? start_positions[p]
-                                          : random_position(rng);
-    }
+  auto pop_back = [&]() {
+    own.erase(positions.back(), static_cast<int>(positions.size()) - 1);
+    positions.pop_back();
+  };
 
-    if (not use_bond_angle or m < 2) {
-      return positions[p][m - 1] + bond_length * random_unit_vector(rng);
+  /* Draw a monomer position, obeying angle constraints where
+   * appropriate. */
+  auto draw_monomer_position = [&](int m) {
+    if (not params.use_bond_angle or m < 2) {
+      return positions[m - 1] + params.bond_length * random_unit_vector(rng);
     }
 
-    auto const last_vec = positions[p][m - 1] - positions[p][m - 2];
-    return positions[p][m - 1] +
+    auto const last_vec = positions[m - 1] - positions[m - 2];
+    return positions[m - 1] +
            Utils::vec_rotate(vector_product(last_vec, random_unit_vector(rng)),
-                             bond_angle, -last_vec);
+                             params.bond_angle, -last_vec);
   };
 
   /* Try up to max_tries times to draw a valid position */
   auto draw_valid_monomer_position =
-      [&](int p, int m) -> boost::optional<Utils::Vector3d> {
-    for (unsigned _ = 0; _ < max_tries; _++) {
-      auto const trial_pos = draw_monomer_position(p, m);
+      [&](int m) -> boost::optional<Utils::Vector3d> {
+    for (int _ = 0; _ < params.max_tries; _++) {
+      auto const trial_pos = draw_monomer_position(m);
 
       if (is_valid_pos(trial_pos)) {
         return trial_pos;
@@ -182,41 +332,305 @@ draw_polymer_positions(PartCfg &partCfg, int const n_polymers,
     return {};
   };
 
-  // create remaining monomers' positions by backtracking.
-  for (int p = 0; p < n_polymers; ++p) {
-    for (int attempts_poly = 0; attempts_poly < max_tries; attempts_poly++) {
-      int rejections = 0;
-      while (positions[p].size() < beads_per_chain) {
-        auto pos = draw_valid_monomer_position(p, positions[p].size());
-
-        if (pos) {
-          /* Move on one position */
-          positions[p].push_back(*pos);
-        } else if (not positions[p].empty()) {
-          /* Go back one position and try again */
-          positions[p].pop_back();
-          rejections++;
-          if (rejections > max_tries) {
-            /* Give up for this try. */
-            break;
-          }
-        } else {
-          /* Give up for this try. */
-          break;
+  auto const start = start_position(params, chain, round);
+  if (is_valid_pos(start)) {
+    push_back(start);
+  }
+
+  int rejections = 0;
+  auto const n_beads = static_cast<std::size_t>(params.beads_per_chain);
+  while (not positions.empty() and positions.size() < n_beads) {
+    auto pos = draw_valid_monomer_position(static_cast<int>(positions.size()));
+
+    if (pos) {
+      /* Move on one position */
+      push_back(*pos);
+    } else if (positions.size() > 1) {
+      /* Go back one position and try again */
+      pop_back();
+      rejections++;
+      if (rejections > params.max_tries) {
+        /* Give up for this round. */
+        break;
+      }
+    } else {
+      /* Give up for this round. */
+      break;
+    }
+  }
+
+  /* Leave the grid empty for the next chain. */
+  for (std::size_t m = 0; m < positions.size(); ++m) {
+    own.erase(positions[m], static_cast<int>(m));
+  }
+  if (positions.size() == n_beads) {
+    return positions;
+  }
+  return {};
+}
+} // namespace
+
+/** Grow the chains whose start position lies in the local domain.
+ *
+ *  @return The chains owned by this node, and whether all chains
+ *          could be placed.
+ */
+static std::pair<std::vector<Chain>, bool>
+local_draw_polymer_positions(PolymerParameters const &params) {
+  auto const halo =
+      (params.beads_per_chain - 1) * params.bond_length + params.min_distance;
+  auto const check_overlap = params.min_distance > 0;
+  /* Without overlap checks, the grids stay empty. */
+  auto const max_cells = [check_overlap](std::size_t n_points) {
+    return check_overlap ? std::max<std::size_t>(n_points, 1) : 1;
+  };
+  auto const n_monomers =
+      static_cast<std::size_t>(params.n_polymers) * params.beads_per_chain;
+
+  DomainList domains;
+  boost::mpi::all_gather(
+      comm_cart, std::make_pair(local_geo.my_left(), local_geo.length()),
+      domains);
+
+  /* Existing particles which chains grown on this node may touch. */
+  SpatialGrid<int> existing(box_geo, params.min_distance,
+                            max_cells(cell_structure.local_particles().size() *
+                                      comm_cart.size()));
+  if (check_overlap) {
+    std::vector<Utils::Vector3d> local_positions;
+    for (auto const &p : cell_structure.local_particles()) {
+      local_positions.push_back(p.r.p);
+    }
+    auto const positions = exchange_halo(
+        local_positions,
+        [](Utils::Vector3d const &pos) {
+          return std::array<Utils::Vector3d, 1>{{pos}};
+        },
+        domains, halo);
+    for (auto const &pos : positions) {
+      existing.insert(pos, -1);
+    }
+  }
+
+  SpatialGrid<int> accepted(box_geo, params.min_distance,
+                            max_cells(n_monomers));
+  SpatialGrid<int> own(box_geo, params.min_distance,
+                       max_cells(params.beads_per_chain));
+  auto const is_valid = [&](Utils::Vector3d const &pos) {
+    return is_valid_position(pos, {existing, accepted}, params);
+  };
+  auto const chain_positions = [](Chain const &c) -> auto const & {
+    return c.second;
+  };
+
+  std::vector<Chain> result;
+  std::vector<int> pending(params.n_polymers);
+  std::iota(pending.begin(), pending.end(), 0);
+  std::vector<bool> is_placed(pending.size(), false);
+
+  for (int round = 0; round < std::max(params.max_tries, 1); ++round) {
+    /* Grow the local chains independently of each other. */
+    std::vector<Chain> grown;
+    for (auto const chain : pending) {
+      auto const start = start_position(params, chain, round);
+      if (map_position_node_array(start) != this_node)
+        continue;
+
+      if (auto positions = grow_chain(params, chain, round, is_valid, own)) {
+        grown.emplace_back(chain, std::move(*positions));
+      }
+    }
+
+    /* A chain is rejected if it overlaps with a new chain of lower index. */
+    std::vector<Chain> new_chains;
+    if (check_overlap) {
+      auto const candidates =
+          exchange_halo(grown, chain_positions, domains, halo);
+      SpatialGrid<int> candidate_grid(box_geo, params.min_distance,
+                                      max_cells(n_monomers));
+      for (auto const &c : candidates) {
+        for (auto const &pos : c.second) {
+          candidate_grid.insert(pos, c.first);
         }
       }
 
-      /* If the polymer has not full length, we  try again. Otherwise we can
-       * move on to the next polymer. */
-      if (positions[p].size() == beads_per_chain) {
-        break;
+      for (auto &c : grown) {
+        auto const overlaps = std::any_of(
+            c.second.begin(), c.second.end(), [&](Utils::Vector3d const &pos) {
+              return candidate_grid.any_closer_than(
+                  pos, params.min_distance,
+                  [&c](int other) { return other < c.first; });
+            });
+        if (not overlaps) {
+          new_chains.push_back(std::move(c));
+        }
+      }
+
+      for (auto const &c :
+           exchange_halo(new_chains, chain_positions, domains, halo)) {
+        for (auto const &pos : c.second) {
+          accepted.insert(pos, c.first);
+        }
+      }
+    } else {
+      new_chains = std::move(grown);
+    }
+
+    /* Update the list of chains still to be placed. */
+    std::vector<int> placed;
+    for (auto const &c : new_chains) {
+      placed.push_back(c.first);
+    }
+    std::vector<std::vector<int>> all_placed;
+    boost::mpi::all_gather(comm_cart, placed, all_placed);
+    for (auto const &ids : all_placed) {
+      for (auto const id : ids) {
+        is_placed[id] = true;
       }
     }
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [&is_placed](int id) { return is_placed[id]; }),
+                  pending.end());
+    std::move(new_chains.begin(), new_chains.end(),
+              std::back_inserter(result));
+
+    if (pending.empty()) {
+      break;
+    }
+  }
+
+  return {std::move(result), pending.empty()};
+}
+
+void mpi_draw_polymer_positions_local(PolymerParameters const &params) {
+  auto const result = local_draw_polymer_positions(params);
+  boost::mpi::gather(comm_cart, result.first, 0);
+}
+
+REGISTER_CALLBACK(mpi_draw_polymer_positions_local)
+
+/** Check that the user-provided start positions are valid. */
+static void check_start_positions(PolymerParameters const &params) {
+  if (params.min_distance <= 0. and not params.respect_constraints)
+    return;
+
+  auto const overlaps =
+      mpi_overlaps(params.start_positions, params.min_distance);
+  SpatialGrid<int> others(box_geo, params.min_distance,
+                          params.start_positions.size());
+  for (std::size_t i = 0; i < params.start_positions.size(); ++i) {
+    auto const &pos = params.start_positions[i];
+    if (overlaps[i] or not is_valid_position(pos, {others}, params)) {
+      throw std::runtime_error("Invalid start positions.");
+    }
+    others.insert(pos, static_cast<int>(i));
+  }
+}
 
-    /* We did not get a complete polymer, but have exceeded the maximal
-     * number of tries, which means failure. */
-    if (positions[p].size() < beads_per_chain)
-      throw std::runtime_error("Failed to create polymer positions.");
+std::vector<std::vector<Utils::Vector3d>>
+draw_polymer_positions(int const n_polymers, int const beads_per_chain,
+                       double const bond_length,
+                       std::vector<Utils::Vector3d> const &start_positions,
+                       double const min_distance, int const max_tries,
+                       int const use_bond_angle, double const bond_angle,
+                       int const respect_constraints, int const seed) {
+  PolymerParameters params;
+  params.n_polymers = n_polymers;
+  params.beads_per_chain = beads_per_chain;
+  params.bond_length = bond_length;
+  params.start_positions = start_positions;
+  params.min_distance = min_distance;
+  params.max_tries = max_tries;
+  params.use_bond_angle = use_bond_angle;
+  params.bond_angle = bond_angle;
+  params.respect_constraints = respect_constraints;
+  params.seed = seed;
+
+  check_start_positions(params);
+
+  mpi_call(mpi_draw_polymer_positions_local, params);
+  auto const local = local_draw_polymer_positions(params);
+  std::vector<std::vector<Chain>> chains;
+  boost::mpi::gather(comm_cart, local.first, chains, 0);
+
+  if (not local.second) {
+    throw std::runtime_error("Failed to create polymer positions.");
+  }
+
+  std::vector<std::vector<Utils::Vector3d>> positions(n_polymers);
+  for (auto &node_chains : chains) {
+    for (auto &c : node_chains) {
+      positions[c.first] = std::move(c.second);
+    }
   }
   return positions;
 }
+
+/** Create the monomers of the chains grown on this node.
+ *  @return Whether all chains could be placed.
+ */
+static bool local_create_polymers(PolymerParameters const &params,
+                                  int start_id, int type, int bond_id) {
+  auto const result = local_draw_polymer_positions(params);
+  if (not result.second) {
+    return false;
+  }
+
+  for (auto const &c : result.first) {
+    auto const n_monomers = static_cast<int>(c.second.size());
+    for (int m = 0; m < n_monomers; ++m) {
+      auto const id = start_id + c.first * params.beads_per_chain + m;
+
+      Particle p;
+      p.p.identity = id;
+      p.p.type = type;
+      p.r.p = c.second[m];
+      fold_position(p.r.p, p.l.i, box_geo);
+
+      auto *added = cell_structure.add_particle(std::move(p));
+      if (bond_id >= 0 and m > 0) {
+        std::array<int, 1> const partners = {{id - 1}};
+        added->bonds().insert(BondView(bond_id, partners));
+      }
+    }
+  }
+
+  on_particle_change();
+  return true;
+}
+
+void mpi_create_polymers_local(PolymerParameters const &params, int start_id,
+                               int type, int bond_id) {
+  local_create_polymers(params, start_id, type, bond_id);
+}
+
+REGISTER_CALLBACK(mpi_create_polymers_local)
+
+void create_polymers(PolymerParameters const &params, int start_id, int type,
+                     int bond_id) {
+  auto const n_monomers = params.n_polymers * params.beads_per_chain;
+  for (int id = start_id; id < start_id + n_monomers; ++id) {
+    if (particle_exists(id)) {
+      throw std::runtime_error("Particle " + std::to_string(id) +
+                               " already exists.");
+    }
+  }
+  if (bond_id >= 0 and
+      (static_cast<std::size_t>(bond_id) >= bonded_ia_params.size() or
+       number_of_partners(bonded_ia_params[bond_id]) != 1)) {
+    throw std::runtime_error("Bond " + std::to_string(bond_id) +
+                             " is not a pair bond.");
+  }
+  check_start_positions(params);
+  make_particle_type_exist(type);
+
+  mpi_call(mpi_create_polymers_local, params, start_id, type, bond_id);
+  if (not local_create_polymers(params, start_id, type, bond_id)) {
+    throw std::runtime_error("Failed to create polymer positions.");
+  }
+
+  clear_particle_node();
+  for (int id = start_id; id < start_id + n_monomers; ++id) {
+    add_id_to_type_map(id, type);
+  }
+}
@@ -29,14 +29,49 @@
  *  Implementation in polymer.cpp.
  */
 
-#include "PartCfg.hpp"
-
 #include <utils/Vector.hpp>
 
 #include <vector>
 
+/** Parameters of the polymer generation. */
+struct PolymerParameters {
+  /** how many polymers to create */
+  int n_polymers = 0;
+  /** monomers per chain */
+  int beads_per_chain = 0;
+  /** length of the bonds between two monomers */
+  double bond_length = 0.;
+  /** starting positions of each polymers */
+  std::vector<Utils::Vector3d> start_positions;
+  /** minimum distance between all particles */
+  double min_distance = 0.;
+  /** how often a monomer/polymer should be reset if current position
+   *  collides with a previous particle */
+  int max_tries = 0;
+  /** whether to use the @ref bond_angle argument */
+  bool use_bond_angle = false;
+  /** desired bond-angle to be fixed */
+  double bond_angle = 0.;
+  /** whether to respect constraints */
+  bool respect_constraints = false;
+  /** seed for RNG */
+  int seed = 0;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &n_polymers &beads_per_chain &bond_length &start_positions
+        &min_distance &max_tries &use_bond_angle &bond_angle
+            &respect_constraints &seed;
+  }
+};
+
 /** Determines valid polymer positions and returns them.
- *  @param  partCfg           particle collection
+ *
+ *  The chains are grown in parallel: each chain is assigned to the node
+ *  whose domain contains its first monomer, and draws its random numbers
+ *  from its own Philox stream. The result is therefore independent of the
+ *  number of nodes. Chains which overlap with a chain of lower index are
+ *  regrown in the next round.
+ *
  *  @param  n_polymers        how many polymers to create
  *  @param  beads_per_chain   monomers per chain
  *  @param  bond_length       length of the bonds between two monomers
@@ -50,10 +85,24 @@
  *  @param  seed              seed for RNG
  */
 std::vector<std::vector<Utils::Vector3d>>
-draw_polymer_positions(PartCfg &partCfg, int n_polymers, int beads_per_chain,
-                       double bond_length,
+draw_polymer_positions(int n_polymers, int beads_per_chain, double bond_length,
                        std::vector<Utils::Vector3d> const &start_positions,
                        double min_distance, int max_tries, int use_bond_angle,
                        double bond_angle, int respect_constraints, int seed);
 
+/** Generate polymer chains and create their monomers as particles.
+ *
+ *  The positions are drawn as in @ref draw_polymer_positions. Each node
+ *  creates the particles of the chains it has grown, without sending
+ *  them through the head node. Monomer @c m of chain @c p gets the id
+ *  <tt>start_id + p * beads_per_chain + m</tt>.
+ *
+ *  @param params    polymer parameters
+ *  @param start_id  id of the first monomer
+ *  @param type      type of the monomers
+ *  @param bond_id   bond between consecutive monomers, or -1 for none
+ */
+void create_polymers(PolymerParameters const &params, int start_id, int type,
+                     int bond_id);
+
 #endif
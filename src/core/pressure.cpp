@@ -31,6 +31,7 @@
 #include "communication.hpp"
 #include "config.hpp"
 #include "event.hpp"
+#include "fused_observables.hpp"
 #include "grid.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "pressure_inline.hpp"
@@ -46,10 +47,13 @@
 #include <utils/Vector.hpp>
 
 #include <boost/range/algorithm/copy.hpp>
+#include <boost/range/algorithm/transform.hpp>
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <functional>
 #include <utility>
 
 /** Pressure tensor of the system */
@@ -84,27 +88,37 @@ void pressure_calc() {
     add_kinetic_virials(p, obs_pressure);
   }
 
-  short_range_loop(
-      [](Particle &p1, int bond_id, Utils::Span<Particle *> partners) {
-        auto const &iaparams = bonded_ia_params[bond_id];
-        auto const result = calc_bonded_pressure_tensor(iaparams, p1, partners);
-        if (result) {
-          auto const &tensor = result.get();
-          /* pressure tensor part */
-          for (int k = 0; k < 3; k++)
-            for (int l = 0; l < 3; l++)
-              obs_pressure.bonded_contribution(bond_id)[k * 3 + l] +=
-                  tensor(k, l);
-
-          return false;
-        }
-        return true;
-      },
-      [](Particle &p1, Particle &p2, Distance const &d) {
-        add_non_bonded_pair_virials(p1, p2, d.vec21, sqrt(d.dist2),
-                                    obs_pressure);
-      },
-      maximal_cutoff(), maximal_cutoff_bonded());
+  /* the short-range virials may have been accumulated by the last force
+   * calculation */
+  if (fused_observables.valid(FUSED_OBSERVABLE_PRESSURE)) {
+    auto const &fused = fused_observables.pressure;
+    assert(fused.data_().size() == obs_pressure.data_().size());
+    boost::transform(fused.data_(), obs_pressure.data_(),
+                     obs_pressure.data_().begin(), std::plus<>{});
+  } else {
+    short_range_loop(
+        [](Particle &p1, int bond_id, Utils::Span<Particle *> partners) {
+          auto const &iaparams = bonded_ia_params[bond_id];
+          auto const result =
+              calc_bonded_pressure_tensor(iaparams, p1, partners);
+          if (result) {
+            auto const &tensor = result.get();
+            /* pressure tensor part */
+            for (int k = 0; k < 3; k++)
+              for (int l = 0; l < 3; l++)
+                obs_pressure.bonded_contribution(bond_id)[k * 3 + l] +=
+                    tensor(k, l);
+
+            return false;
+          }
+          return true;
+        },
+        [](Particle &p1, Particle &p2, Distance const &d) {
+          add_non_bonded_pair_virials(p1, p2, d.vec21, sqrt(d.dist2),
+                                      obs_pressure);
+        },
+        maximal_cutoff(), maximal_cutoff_bonded());
+  }
 
   calc_long_range_virials(cell_structure.local_particles());
 
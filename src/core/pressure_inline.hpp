@@ -48,28 +48,24 @@
 #include <string>
 #include <tuple>
 
-/** Calculate non-bonded energies between a pair of particles.
+/** Calculate non-bonded virials between a pair of particles from their
+ *  non-bonded pair force.
  *  @param p1        pointer to particle 1.
  *  @param p2        pointer to particle 2.
  *  @param d         vector between p1 and p2.
  *  @param dist      distance between p1 and p2.
+ *  @param force     force of the non-bonded pair potentials on p1.
  *  @param[in,out] obs_pressure   pressure observable.
  */
 inline void add_non_bonded_pair_virials(Particle const &p1, Particle const &p2,
                                         Utils::Vector3d const &d, double dist,
+                                        Utils::Vector3d const &force,
                                         Observable_stat &obs_pressure) {
-#ifdef EXCLUSIONS
-  if (do_nonbonded(p1, p2))
-#endif
-  {
-    IA_parameters const &ia_params = *get_ia_param(p1.p.type, p2.p.type);
-    auto const force = calc_non_bonded_pair_force(p1, p2, ia_params, d, dist).f;
-    auto const stress = tensor_product(d, force);
+  auto const stress = tensor_product(d, force);
 
-    auto const type1 = p1.p.mol_id;
-    auto const type2 = p2.p.mol_id;
-    obs_pressure.add_non_bonded_contribution(type1, type2, flatten(stress));
-  }
+  auto const type1 = p1.p.mol_id;
+  auto const type2 = p2.p.mol_id;
+  obs_pressure.add_non_bonded_contribution(type1, type2, flatten(stress));
 
 #ifdef ELECTROSTATICS
   if (!obs_pressure.coulomb.empty()) {
@@ -93,7 +89,28 @@ inline void add_non_bonded_pair_virials(Particle const &p1, Particle const &p2,
 #endif /*ifdef DIPOLES */
 }
 
-boost::optional<Utils::Matrix<double, 3, 3>>
+/** Calculate non-bonded virials between a pair of particles.
+ *  @param p1        pointer to particle 1.
+ *  @param p2        pointer to particle 2.
+ *  @param d         vector between p1 and p2.
+ *  @param dist      distance between p1 and p2.
+ *  @param[in,out] obs_pressure   pressure observable.
+ */
+inline void add_non_bonded_pair_virials(Particle const &p1, Particle const &p2,
+                                        Utils::Vector3d const &d, double dist,
+                                        Observable_stat &obs_pressure) {
+  Utils::Vector3d force{};
+#ifdef EXCLUSIONS
+  if (do_nonbonded(p1, p2))
+#endif
+  {
+    IA_parameters const &ia_params = *get_ia_param(p1.p.type, p2.p.type);
+    force = calc_non_bonded_pair_force(p1, p2, ia_params, d, dist).f;
+  }
+  add_non_bonded_pair_virials(p1, p2, d, dist, force, obs_pressure);
+}
+
+inline boost::optional<Utils::Matrix<double, 3, 3>>
 calc_bonded_virial_pressure_tensor(Bonded_IA_Parameters const &iaparams,
                                    Particle const &p1, Particle const &p2) {
   auto const dx = get_mi_vector(p1.r.p, p2.r.p, box_geo);
@@ -107,7 +124,7 @@ calc_bonded_virial_pressure_tensor(Bonded_IA_Parameters const &iaparams,
   return {};
 }
 
-boost::optional<Utils::Matrix<double, 3, 3>>
+inline boost::optional<Utils::Matrix<double, 3, 3>>
 calc_bonded_three_body_pressure_tensor(Bonded_IA_Parameters const &iaparams,
                                        Particle const &p1, Particle const &p2,
                                        Particle const &p3) {
@@ -26,6 +26,7 @@
  *  Random number generation using Philox.
  */
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
 #include <utils/u32_to_u64.hpp>
@@ -33,7 +34,12 @@
 
 #include <Random123/philox.h>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 #include <random>
 #include <vector>
 
@@ -57,10 +63,71 @@ enum class RNGSalt : uint32_t {
   NPTISO0_HALF_STEP2,
   NPTISOV,
   SALT_DPD,
-  THERMALIZED_BOND
+  THERMALIZED_BOND,
+  POLYMER
 };
 
 namespace Random {
+namespace detail {
+/** Output of the Philox RNG */
+using philox_4x64 = r123::Philox4x64::ctr_type;
+
+/** Number of keys whose random numbers are kept in a temporary buffer
+ *  by the batched generators.
+ */
+constexpr std::size_t batch_size = 64;
+
+/** @brief Convert random integers to Gaussian noise.
+ *
+ * The Box-Muller transform is used to convert from uniform to normal
+ * distribution. The transform is only valid, if the uniformly distributed
+ * random numbers are not zero (approx one in 2^64). To avoid this case,
+ * such numbers are replaced by std::numeric_limits<double>::min()
+ * This breaks statistics in rare cases but allows for consistent RNG
+ * counters across MPI ranks.
+ */
+template <size_t N, class Integers>
+Utils::VectorXd<N> box_muller(Integers const &integers) {
+  static const double epsilon = std::numeric_limits<double>::min();
+
+  constexpr size_t M = (N <= 2) ? 2 : 4;
+  Utils::VectorXd<M> u{};
+  std::transform(integers.begin(), integers.begin() + M, u.begin(),
+                 [](size_t value) {
+                   auto u = Utils::uniform(value);
+                   return (u < epsilon) ? epsilon : u;
+                 });
+
+  // Box-Muller transform code adapted from
+  // https://en.wikipedia.org/wiki/Box%E2%80%93Muller_transform
+  // optimizations: the modulo is cached (logarithms are expensive), the
+  // sin/cos are evaluated simultaneously by gcc or separately by Clang
+  Utils::VectorXd<N> noise{};
+  constexpr double two_pi = 2.0 * Utils::pi();
+  auto const modulo = sqrt(-2.0 * log(u[0]));
+  auto const angle = two_pi * u[1];
+  noise[0] = modulo * cos(angle);
+  if (N > 1) {
+    noise[1] = modulo * sin(angle);
+  }
+  if (N > 2) {
+    auto const modulo = sqrt(-2.0 * log(u[2]));
+    auto const angle = two_pi * u[3];
+    noise[2] = modulo * cos(angle);
+    if (N > 3) {
+      noise[3] = modulo * sin(angle);
+    }
+  }
+  return noise;
+}
+
+/** Keys of a block, or no keys if @p keys is empty. */
+inline Utils::Span<const int> block(Utils::Span<const int> keys,
+                                    std::size_t begin, std::size_t n) {
+  return keys.empty() ? keys : Utils::Span<const int>{keys.data() + begin, n};
+}
+} // namespace detail
+
 /**
  * @brief get 4 random uint 64 from the Philox RNG
  *
@@ -150,37 +217,100 @@ template <RNGSalt salt, size_t N = 3,
 auto noise_gaussian(uint64_t counter, uint32_t seed, int key1, int key2 = 0) {
 
   auto const integers = philox_4_uint64s<salt>(counter, seed, key1, key2);
-  static const double epsilon = std::numeric_limits<double>::min();
+  return detail::box_muller<N>(integers);
+}
 
-  constexpr size_t M = (N <= 2) ? 2 : 4;
-  Utils::VectorXd<M> u{};
-  std::transform(integers.begin(), integers.begin() + M, u.begin(),
-                 [](size_t value) {
-                   auto u = Utils::uniform(value);
-                   return (u < epsilon) ? epsilon : u;
-                 });
+/** @brief Batched @ref philox_4_uint64s.
+ *
+ *  Draws the random numbers of all pairs of keys for a common counter,
+ *  such that @p out[i] holds the same bits as
+ *  <tt>philox_4_uint64s<salt>(counter, seed, key1[i], key2[i])</tt>.
+ *  The keys are processed in blocks: the Philox rounds of the particles
+ *  of a block are independent and overlap in the pipeline.
+ *
+ *  @tparam salt RNG salt
+ *  @param counter counter for random number generation
+ *  @param seed seed for random number generation
+ *  @param key1 first keys, e.g. the particle ids
+ *  @param key2 second keys, empty for all zero
+ *  @param out output, same size as @p key1
+ */
+template <RNGSalt salt>
+void philox_4_uint64s(uint64_t counter, uint32_t seed,
+                      Utils::Span<const int> key1, Utils::Span<const int> key2,
+                      Utils::Span<detail::philox_4x64> out) {
+  assert(key2.empty() or key2.size() == key1.size());
+  assert(out.size() == key1.size());
 
-  // Box-Muller transform code adapted from
-  // https://en.wikipedia.org/wiki/Box%E2%80%93Muller_transform
-  // optimizations: the modulo is cached (logarithms are expensive), the
-  // sin/cos are evaluated simultaneously by gcc or separately by Clang
-  Utils::VectorXd<N> noise{};
-  constexpr double two_pi = 2.0 * Utils::pi();
-  auto const modulo = sqrt(-2.0 * log(u[0]));
-  auto const angle = two_pi * u[1];
-  noise[0] = modulo * cos(angle);
-  if (N > 1) {
-    noise[1] = modulo * sin(angle);
+  using rng_type = r123::Philox4x64;
+  using key_type = rng_type::key_type;
+
+  const rng_type::ctr_type c{counter};
+  auto const salt_seed = Utils::u32_to_u64(static_cast<uint32_t>(salt), seed);
+  auto const rng = rng_type{};
+
+  for (std::size_t i = 0; i < key1.size(); ++i) {
+    auto const id1 = static_cast<uint32_t>(key1[i]);
+    auto const id2 = static_cast<uint32_t>(key2.empty() ? 0 : key2[i]);
+    out[i] = rng(c, key_type{Utils::u32_to_u64(id1, id2), salt_seed});
   }
-  if (N > 2) {
-    auto const modulo = sqrt(-2.0 * log(u[2]));
-    auto const angle = two_pi * u[3];
-    noise[2] = modulo * cos(angle);
-    if (N > 3) {
-      noise[3] = modulo * sin(angle);
+}
+
+/** @brief Batched @ref noise_uniform.
+ *
+ *  The noise of the i-th pair of keys is bitwise identical to
+ *  <tt>noise_uniform<salt, N>(counter, seed, key1[i], key2[i])</tt>.
+ *  See @ref philox_4_uint64s(uint64_t, uint32_t, Utils::Span<const int>,
+ *  Utils::Span<const int>, Utils::Span<detail::philox_4x64>)
+ *  for the parameters.
+ */
+template <RNGSalt salt, size_t N = 3,
+          class = std::enable_if_t<(N >= 1) and (N <= 4)>>
+void noise_uniform(uint64_t counter, uint32_t seed, Utils::Span<const int> key1,
+                   Utils::Span<const int> key2,
+                   Utils::Span<Utils::VectorXd<N>> out) {
+  assert(out.size() == key1.size());
+  std::array<detail::philox_4x64, detail::batch_size> integers;
+  for (std::size_t begin = 0; begin < key1.size();
+       begin += detail::batch_size) {
+    auto const n = std::min(detail::batch_size, key1.size() - begin);
+    philox_4_uint64s<salt>(counter, seed, detail::block(key1, begin, n),
+                           detail::block(key2, begin, n),
+                           {integers.data(), n});
+    for (std::size_t i = 0; i < n; ++i) {
+      auto &noise = out[begin + i];
+      for (std::size_t j = 0; j < N; ++j) {
+        noise[j] = Utils::uniform(integers[i][j]) - 0.5;
+      }
+    }
+  }
+}
+
+/** @brief Batched @ref noise_gaussian.
+ *
+ *  The noise of the i-th pair of keys is bitwise identical to
+ *  <tt>noise_gaussian<salt, N>(counter, seed, key1[i], key2[i])</tt>.
+ *  See @ref philox_4_uint64s(uint64_t, uint32_t, Utils::Span<const int>,
+ *  Utils::Span<const int>, Utils::Span<detail::philox_4x64>)
+ *  for the parameters.
+ */
+template <RNGSalt salt, size_t N = 3,
+          class = std::enable_if_t<(N >= 1) and (N <= 4)>>
+void noise_gaussian(uint64_t counter, uint32_t seed,
+                    Utils::Span<const int> key1, Utils::Span<const int> key2,
+                    Utils::Span<Utils::VectorXd<N>> out) {
+  assert(out.size() == key1.size());
+  std::array<detail::philox_4x64, detail::batch_size> integers;
+  for (std::size_t begin = 0; begin < key1.size();
+       begin += detail::batch_size) {
+    auto const n = std::min(detail::batch_size, key1.size() - begin);
+    philox_4_uint64s<salt>(counter, seed, detail::block(key1, begin, n),
+                           detail::block(key2, begin, n),
+                           {integers.data(), n});
+    for (std::size_t i = 0; i < n; ++i) {
+      out[begin + i] = detail::box_muller<N>(integers[i]);
     }
   }
-  return noise;
 }
 
 /** Mersenne Twister with warmup.
@@ -29,9 +29,44 @@
 #include "errorhandling.hpp"
 #include "grid.hpp"
 
+#include <utils/Vector.hpp>
+#include <utils/math/sqr.hpp>
+
 #include <boost/mpi/collectives/all_reduce.hpp>
 #include <boost/range/algorithm.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+static ConstraintSolverParameters solver_params{};
+
+ConstraintSolverParameters const &constraint_solver_parameters() {
+  return solver_params;
+}
+
+void mpi_set_constraint_solver_local(ConstraintSolverParameters const &params) {
+  solver_params = params;
+}
+
+REGISTER_CALLBACK(mpi_set_constraint_solver_local)
+
+void mpi_set_constraint_solver(ConstraintSolver solver, int order,
+                               int iterations) {
+  if (order < 0) {
+    throw std::domain_error("LINCS expansion order must be >= 0");
+  }
+  if (iterations < 0) {
+    throw std::domain_error("LINCS iterations must be >= 0");
+  }
+  ConstraintSolverParameters params;
+  params.solver = solver;
+  params.lincs_order = order;
+  params.lincs_iterations = iterations;
+  mpi_call_all(mpi_set_constraint_solver_local, params);
+}
+
 /**
  * @brief copy current position
  *
@@ -230,4 +265,241 @@ void correct_velocity_shake(CellStructure &cs) {
   }
 }
 
+/** @brief A rigid bond as seen by the LINCS solver. */
+struct LincsConstraint {
+  Particle *p1;
+  Particle *p2;
+  /** Constrained bond length */
+  double length;
+  /** Bond direction (unit vector from @p p2 to @p p1) */
+  Utils::Vector3d direction;
+  /** Normalization: @f$ 1/\sqrt{1/m_1 + 1/m_2} @f$ */
+  double scale;
+};
+
+/**
+ * @brief Collect the rigid bonds of the local particles.
+ *
+ * The constraint directions are taken from the positions at the
+ * beginning of the time step (position correction) or from the current
+ * positions (velocity correction).
+ *
+ * @param cs cell structure
+ * @param old_positions whether to use the positions of the last time step
+ */
+static std::vector<LincsConstraint> collect_constraints(CellStructure &cs,
+                                                        bool old_positions) {
+  std::vector<LincsConstraint> constraints;
+  cs.bond_loop([&constraints, old_positions](Particle &p1, int bond_id,
+                                             Utils::Span<Particle *> partners) {
+    auto const &iaparams = bonded_ia_params[bond_id];
+
+    if (auto const *bond = boost::get<RigidBond>(&iaparams)) {
+      auto &p2 = *partners[0];
+      auto const r_ij =
+          old_positions
+              ? get_mi_vector(p1.r.p_last_timestep, p2.r.p_last_timestep,
+                              box_geo)
+              : get_mi_vector(p1.r.p, p2.r.p, box_geo);
+      auto const scale = 1. / std::sqrt(1. / p1.p.mass + 1. / p2.p.mass);
+      constraints.push_back(
+          {&p1, &p2, std::sqrt(bond->d2), r_ij / r_ij.norm(), scale});
+    }
+
+    /* Rigid bonds cannot break */
+    return false;
+  });
+
+  return constraints;
+}
+
+/**
+ * @brief Accumulate @f$ M B^T S x @f$ into the correction vectors.
+ *
+ * Contributions to ghost particles are reduced onto their real
+ * counterparts. If @p update_ghosts is set, the resulting sums are also
+ * communicated back to the ghosts. Only neighboring nodes communicate.
+ *
+ * @param cs cell structure
+ * @param constraints local constraints
+ * @param x value per constraint
+ * @param update_ghosts whether the ghosts need the reduced values
+ */
+static void scatter_constraint_values(
+    CellStructure &cs, std::vector<LincsConstraint> const &constraints,
+    std::vector<double> const &x, bool update_ghosts) {
+  auto ghost_particles = cs.ghost_particles();
+  init_correction_vector(cs.local_particles(), ghost_particles);
+
+  for (std::size_t i = 0; i < constraints.size(); ++i) {
+    auto const &c = constraints[i];
+    auto const g = c.scale * x[i] * c.direction;
+    c.p1->rattle.correction += g;
+    c.p2->rattle.correction -= g;
+  }
+
+  cs.ghosts_reduce_rattle_correction();
+
+  if (update_ghosts) {
+    /* ghost communication adds the correction of the real particle */
+    boost::for_each(ghost_particles,
+                    [](Particle &p) { p.rattle.correction.fill(0); });
+    cs.ghosts_update(Cells::DATA_PART_RATTLE);
+  }
+}
+
+/**
+ * @brief Solve the coupled constraint equations by a matrix expansion.
+ *
+ * With the normalized coupling matrix
+ * @f$ A = I - S B M^{-1} B^T S @f$, the solution of
+ * @f$ (I - A) x = \mathrm{rhs} @f$ is approximated by
+ * @f$ x = \sum_{k=0}^{n} A^k \mathrm{rhs} @f$. Each power of @f$ A @f$
+ * only couples constraints that share a particle, so that the
+ * expansion needs a fixed number of neighbor communications and no
+ * global reduction.
+ *
+ * @param cs cell structure
+ * @param constraints local constraints
+ * @param rhs right-hand side per constraint
+ * @param order expansion order @f$ n @f$
+ * @return solution per constraint
+ */
+static std::vector<double>
+solve_constraint_equations(CellStructure &cs,
+                           std::vector<LincsConstraint> const &constraints,
+                           std::vector<double> const &rhs, int order) {
+  auto sol = rhs;
+  auto term = rhs;
+  for (int k = 0; k < order; ++k) {
+    scatter_constraint_values(cs, constraints, term, true);
+    for (std::size_t i = 0; i < constraints.size(); ++i) {
+      auto const &c = constraints[i];
+      auto const &p1 = *c.p1;
+      auto const &p2 = *c.p2;
+      auto const projection =
+          c.scale * c.direction *
+          (p1.rattle.correction / p1.p.mass - p2.rattle.correction / p2.p.mass);
+      /* the diagonal of S B M^-1 B^T S is one */
+      term[i] = term[i] - projection;
+    }
+    for (std::size_t i = 0; i < constraints.size(); ++i) {
+      sol[i] += term[i];
+    }
+  }
+  return sol;
+}
+
+/**
+ * @brief Apply the correction @f$ -M^{-1} B^T S x @f$ to the real
+ * particles.
+ *
+ * As in the RATTLE algorithm, the positional correction is also added
+ * to the velocity.
+ *
+ * @param cs cell structure
+ * @param constraints local constraints
+ * @param sol solution of the constraint equations
+ * @param positions whether to correct positions (and velocities)
+ *                  or velocities only
+ */
+static void apply_lincs_correction(
+    CellStructure &cs, std::vector<LincsConstraint> const &constraints,
+    std::vector<double> const &sol, bool positions) {
+  scatter_constraint_values(cs, constraints, sol, false);
+  boost::for_each(cs.local_particles(), [positions](Particle &p) {
+    auto const correction = p.rattle.correction / p.p.mass;
+    if (positions)
+      p.r.p -= correction;
+    p.m.v -= correction;
+  });
+}
+
+void correct_position_lincs(CellStructure &cs) {
+  cells_update_ghosts(Cells::DATA_PART_POSITION | Cells::DATA_PART_PROPERTIES);
+
+  auto const constraints = collect_constraints(cs, true);
+  std::vector<double> rhs(constraints.size());
+
+  for (std::size_t i = 0; i < constraints.size(); ++i) {
+    auto const &c = constraints[i];
+    auto const r_ij = get_mi_vector(c.p1->r.p, c.p2->r.p, box_geo);
+    rhs[i] = c.scale * (c.direction * r_ij - c.length);
+  }
+  apply_lincs_correction(
+      cs, constraints,
+      solve_constraint_equations(cs, constraints, rhs,
+                                 solver_params.lincs_order),
+      true);
+  cs.ghosts_update(Cells::DATA_PART_POSITION | Cells::DATA_PART_MOMENTUM);
+
+  /* Correct for the lengthening of rotated bonds */
+  bool too_large_rotation = false;
+  for (int iter = 0; iter < solver_params.lincs_iterations; ++iter) {
+    for (std::size_t i = 0; i < constraints.size(); ++i) {
+      auto const &c = constraints[i];
+      auto const r_ij2 =
+          get_mi_vector(c.p1->r.p, c.p2->r.p, box_geo).norm2();
+      auto const p2 = 2. * Utils::sqr(c.length) - r_ij2;
+      if (p2 < 0.) {
+        too_large_rotation = true;
+      }
+      rhs[i] = c.scale * (c.length - std::sqrt(std::max(p2, 0.)));
+    }
+    apply_lincs_correction(
+        cs, constraints,
+        solve_constraint_equations(cs, constraints, rhs,
+                                   solver_params.lincs_order),
+        true);
+    cs.ghosts_update(Cells::DATA_PART_POSITION | Cells::DATA_PART_MOMENTUM);
+  }
+
+  if (too_large_rotation) {
+    runtimeErrorMsg() << "LINCS: rigid bond rotated by more than 45 degrees "
+                         "within one time step";
+  }
+
+  check_resort_particles();
+}
+
+void correct_velocity_lincs(CellStructure &cs) {
+  cs.ghosts_update(Cells::DATA_PART_POSITION | Cells::DATA_PART_MOMENTUM);
+
+  auto const constraints = collect_constraints(cs, false);
+  std::vector<double> rhs(constraints.size());
+
+  for (std::size_t i = 0; i < constraints.size(); ++i) {
+    auto const &c = constraints[i];
+    rhs[i] = c.scale * (c.direction * (c.p1->m.v - c.p2->m.v));
+  }
+  apply_lincs_correction(
+      cs, constraints,
+      solve_constraint_equations(cs, constraints, rhs,
+                                 solver_params.lincs_order),
+      false);
+  cs.ghosts_update(Cells::DATA_PART_MOMENTUM);
+}
+
+void correct_position_constraints(CellStructure &cs) {
+  switch (solver_params.solver) {
+  case ConstraintSolver::RATTLE:
+    correct_position_shake(cs);
+    break;
+  case ConstraintSolver::LINCS:
+    correct_position_lincs(cs);
+    break;
+  }
+}
+
+void correct_velocity_constraints(CellStructure &cs) {
+  switch (solver_params.solver) {
+  case ConstraintSolver::RATTLE:
+    correct_velocity_shake(cs);
+    break;
+  case ConstraintSolver::LINCS:
+    correct_velocity_lincs(cs);
+    break;
+  }
+}
+
 #endif
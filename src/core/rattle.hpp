@@ -22,7 +22,8 @@
 #define RATTLE_H
 
 /** \file
- *  RATTLE algorithm (@cite andersen83a).
+ *  Bond constraint solvers: RATTLE algorithm (@cite andersen83a) and
+ *  a parallel linear constraint solver (LINCS, @cite hess97a).
  *
  *  For more information see \ref rattle.cpp.
  */
@@ -34,6 +35,45 @@
 
 #ifdef BOND_CONSTRAINT
 
+#include <boost/serialization/access.hpp>
+
+/** Algorithms to enforce rigid bonds. */
+enum class ConstraintSolver : int {
+  /** Iterative SHAKE/RATTLE, converged to the bond tolerances. */
+  RATTLE = 0,
+  /** Matrix expansion of fixed order, no global convergence check. */
+  LINCS = 1
+};
+
+/** Parameters of the bond constraint solver. */
+struct ConstraintSolverParameters {
+  ConstraintSolver solver = ConstraintSolver::RATTLE;
+  /** Order of the matrix expansion (LINCS only). */
+  int lincs_order = 4;
+  /** Number of corrections for bond rotation (LINCS only). */
+  int lincs_iterations = 1;
+
+private:
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &solver;
+    ar &lincs_order;
+    ar &lincs_iterations;
+  }
+};
+
+/** Current parameters of the bond constraint solver. */
+ConstraintSolverParameters const &constraint_solver_parameters();
+
+/** Select the bond constraint solver on all nodes.
+ *
+ *  @param solver      constraint algorithm
+ *  @param order       order of the LINCS matrix expansion
+ *  @param iterations  number of LINCS corrections for bond rotation
+ */
+void mpi_set_constraint_solver(ConstraintSolver solver, int order,
+                               int iterations);
+
 /** Transfer the current particle positions from @ref ParticlePosition::p
  *  "Particle::r::p" to @ref ParticlePosition::p_last_timestep
  *  "Particle::r::p_last_timestep"
@@ -56,5 +96,35 @@ void correct_position_shake(CellStructure &cs);
  */
 void correct_velocity_shake(CellStructure &cs);
 
+/**
+ * @brief Correction of current positions using the LINCS algorithm.
+ *
+ * @param cs cell structure
+ */
+void correct_position_lincs(CellStructure &cs);
+
+/**
+ * @brief Correction of current velocities using the LINCS algorithm.
+ *
+ * @param cs cell structure
+ */
+void correct_velocity_lincs(CellStructure &cs);
+
+/**
+ * @brief Correct positions of rigidly bonded particles with the
+ * selected solver.
+ *
+ * @param cs cell structure
+ */
+void correct_position_constraints(CellStructure &cs);
+
+/**
+ * @brief Correct velocities of rigidly bonded particles with the
+ * selected solver.
+ *
+ * @param cs cell structure
+ */
+void correct_velocity_constraints(CellStructure &cs);
+
 #endif
 #endif
@@ -23,9 +23,8 @@
 
 #include "energy.hpp"
 #include "grid.hpp"
-#include "partCfg_global.hpp"
 #include "particle_data.hpp"
-#include "statistics.hpp"
+#include "spatial_queries.hpp"
 
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
@@ -409,7 +408,7 @@ void ReactionAlgorithm::replace_particle(int p_id, int desired_type) {
 void ReactionAlgorithm::hide_particle(int p_id, int previous_type) {
 
   auto const part = get_particle_data(p_id);
-  auto const d_min = distto(partCfg(), part.r.p, p_id);
+  auto const d_min = mpi_distto(part.r.p, p_id);
   if (d_min < exclusion_radius)
     particle_inside_exclusion_radius_touched = true;
 
@@ -518,7 +517,7 @@ int ReactionAlgorithm::create_particle(int desired_type) {
 #endif
   // set velocities
   set_particle_v(p_id, vel);
-  double d_min = distto(partCfg(), pos_vec, p_id);
+  double d_min = mpi_distto(pos_vec, p_id);
   if (d_min < exclusion_radius) {
     // setting of a minimal distance is allowed to avoid overlapping
     // configurations if there is a repulsive potential. States with
@@ -590,7 +589,7 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
     vel[2] = prefactor * m_normal_distribution(m_generator);
     set_particle_v(p_id, vel);
     place_particle(p_id, new_pos.data());
-    auto const d_min = distto(partCfg(), new_pos, p_id);
+    auto const d_min = mpi_distto(new_pos, p_id);
     if (d_min < exclusion_radius)
       particle_inside_exclusion_radius_touched = true;
   }
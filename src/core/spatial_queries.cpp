@@ -0,0 +1,472 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Distributed proximity queries on the particle configuration.
+ *
+ *  The corresponding header file is spatial_queries.hpp.
+ */
+
+#include "spatial_queries.hpp"
+
+#include "DomainDecomposition.hpp"
+#include "Particle.hpp"
+#include "SpatialGrid.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "event.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/as_const.hpp>
+#include <utils/contains.hpp>
+#include <utils/index.hpp>
+#include <utils/mpi/gather_buffer.hpp>
+
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/all_to_all.hpp>
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/mpi/operations.hpp>
+#include <boost/range/algorithm/min_element.hpp>
+#include <boost/serialization/utility.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+bool in_set(std::vector<int> const &set, int type) {
+  return set.empty() or Utils::contains(set, type);
+}
+
+/** Membership of a particle in the two type sets (bit 0: set1, bit1: set2).
+ */
+unsigned set_flags(std::vector<int> const &set1, std::vector<int> const &set2,
+                   int type) {
+  return (in_set(set1, type) ? 1u : 0u) | (in_set(set2, type) ? 2u : 0u);
+}
+
+/** Distance of the coordinate @p x along @p dim to the interval between
+ *  @p lower and @p upper, with the minimum image convention in the
+ *  periodic directions.
+ */
+double distance_to_interval(double x, double lower, double upper, int dim) {
+  if (box_geo.periodic(dim)) {
+    auto const l = box_geo.length()[dim];
+    x = lower + Algorithm::periodic_fold(x - lower, l);
+    return std::min(std::max(0., x - upper), lower + l - x);
+  }
+  return std::max({0., lower - x, x - upper});
+}
+
+/** Distance of @p pos to the box between @p lower and @p upper, with the
+ *  minimum image convention in the periodic directions.
+ */
+double distance_to_box(Utils::Vector3d const &pos,
+                       Utils::Vector3d const &lower,
+                       Utils::Vector3d const &upper) {
+  Utils::Vector3d d{};
+  for (int i = 0; i < 3; ++i) {
+    d[i] = distance_to_interval(pos[i], lower[i], upper[i], i);
+  }
+  return d.norm();
+}
+
+/** Call @p kernel with each local particle within @p radius of @p pos
+ *  (inclusive) and its distance vector from @p pos.
+ *
+ *  With a domain decomposition whose particles are sorted, only the
+ *  cells within @p radius of @p pos are visited. The cells are widened by
+ *  half the skin, by which particles can move before they are resorted.
+ *  Otherwise all local particles are visited.
+ */
+template <class Kernel>
+void for_each_local_in_radius(Utils::Vector3d const &pos, double radius,
+                              Kernel &&kernel) {
+  auto const radius2 = radius * radius;
+  auto const visit = [&](Particle const &p) {
+    auto const d = get_mi_vector(p.r.p, pos, box_geo);
+    if (d.norm2() <= radius2) {
+      kernel(p, d);
+    }
+  };
+
+  auto const *dd = dynamic_cast<DomainDecomposition const *>(
+      &Utils::as_const(cell_structure).decomposition());
+  if (not dd or cell_structure.get_resort_particles() != Cells::RESORT_NONE) {
+    for (auto const &p : cell_structure.local_particles()) {
+      visit(p);
+    }
+    return;
+  }
+
+  auto const n_ghost = dd->params.cells_per_range;
+  auto const slack = 0.5 * skin;
+  std::array<std::vector<int>, 3> cells;
+  for (int i = 0; i < 3; ++i) {
+    for (int c = 0; c < dd->cell_grid[i]; ++c) {
+      auto lower = local_geo.my_left()[i] + c * dd->cell_size[i] - slack;
+      auto upper = lower + dd->cell_size[i] + 2. * slack;
+      /* the outermost cells also hold the particles outside of the box */
+      if (not box_geo.periodic(i)) {
+        if (c == 0 and local_geo.boundary()[2 * i])
+          lower = -std::numeric_limits<double>::infinity();
+        if (c == dd->cell_grid[i] - 1 and local_geo.boundary()[2 * i + 1])
+          upper = std::numeric_limits<double>::infinity();
+      }
+      if (distance_to_interval(pos[i], lower, upper, i) <= radius) {
+        cells[i].push_back(c + n_ghost);
+      }
+    }
+  }
+
+  for (auto const z : cells[2])
+    for (auto const y : cells[1])
+      for (auto const x : cells[0]) {
+        auto const &cell =
+            dd->cells[Utils::get_linear_index(x, y, z, dd->ghost_cell_grid)];
+        for (auto const &p : cell.particles()) {
+          visit(p);
+        }
+      }
+}
+
+/** Ids of the local particles within @p r_catch of @p pos. */
+std::vector<int> local_nbhood_ids(Utils::Vector3d const &pos, double r_catch,
+                                  Utils::Vector3i const &planedims) {
+  std::vector<int> ids;
+  auto const r2 = r_catch * r_catch;
+
+  if ((planedims[0] + planedims[1] + planedims[2]) == 3) {
+    for_each_local_in_radius(
+        pos, r_catch, [&ids, r2](Particle const &p, Utils::Vector3d const &d) {
+          if (d.norm2() < r2)
+            ids.push_back(p.p.identity);
+        });
+    return ids;
+  }
+
+  for (auto const &p : cell_structure.local_particles()) {
+    /* Calculate the in plane distance */
+    Utils::Vector3d d;
+    for (int j = 0; j < 3; j++) {
+      d[j] = planedims[j] * (p.r.p[j] - pos[j]);
+    }
+
+    if (d.norm2() < r2) {
+      ids.push_back(p.p.identity);
+    }
+  }
+  return ids;
+}
+
+/** The @p k local particles closest to @p pos, except @p pid.
+ *  The search radius starts at the cell size and is doubled until enough
+ *  particles are found.
+ *  @return Pairs of squared distance and particle id, sorted by distance.
+ */
+std::vector<std::pair<double, int>>
+local_k_nearest(Utils::Vector3d const &pos, int k, int pid) {
+  std::vector<std::pair<double, int>> candidates;
+  if (k <= 0)
+    return candidates;
+
+  auto const *dd = dynamic_cast<DomainDecomposition const *>(
+      &Utils::as_const(cell_structure).decomposition());
+  auto const collect = [&candidates, &pos, pid](double radius) {
+    candidates.clear();
+    for_each_local_in_radius(
+        pos, radius,
+        [&candidates, pid](Particle const &p, Utils::Vector3d const &d) {
+          if (p.identity() != pid)
+            candidates.emplace_back(d.norm2(), p.identity());
+        });
+  };
+
+  if (dd) {
+    std::size_t n_local = 0;
+    for (auto const *cell : dd->m_local_cells) {
+      n_local += cell->particles().size();
+    }
+    if (pid >= 0) {
+      auto const *excluded = cell_structure.get_local_particle(pid);
+      if (excluded and not excluded->l.ghost)
+        --n_local;
+    }
+    auto const n_min = std::min(static_cast<std::size_t>(k), n_local);
+    auto radius = *boost::min_element(dd->cell_size);
+    collect(radius);
+    while (candidates.size() < n_min) {
+      radius *= 2.;
+      collect(radius);
+    }
+  } else {
+    collect(std::numeric_limits<double>::infinity());
+  }
+
+  auto const n = std::min(static_cast<std::size_t>(k), candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + n,
+                    candidates.end());
+  candidates.resize(n);
+  return candidates;
+}
+} // namespace
+
+/** Minimal squared distance between pairs found in the cell system.
+ *  The result is exact for distances below the range of the cell system.
+ */
+double local_mindist2(std::vector<int> set1, std::vector<int> set2) {
+  on_observable_calc();
+
+  auto mindist2 = std::numeric_limits<double>::infinity();
+  cell_structure.non_bonded_loop(
+      [&](Particle const &p1, Particle const &p2, Distance const &d) {
+        auto const f1 = set_flags(set1, set2, p1.p.type);
+        auto const f2 = set_flags(set1, set2, p2.p.type);
+        if (((f1 & 1u) and (f2 & 2u)) or ((f1 & 2u) and (f2 & 1u))) {
+          mindist2 = std::min(mindist2, d.dist2);
+        }
+      });
+
+  return mindist2;
+}
+
+REGISTER_CALLBACK_REDUCTION(local_mindist2, boost::mpi::minimum<double>())
+
+/** Minimal squared distance between the local particles of @p set1 and
+ *  the particles of @p set2, for distances beyond the range of the cell
+ *  system.
+ *
+ *  Every node receives the particles of @p set2 within a search range of
+ *  its local box from the other nodes as ghosts and searches them with an
+ *  auxiliary grid. The range is doubled until a pair is found within the
+ *  range on any node, or until every node holds all particles of
+ *  @p set2. Only the minimum is reduced over the nodes.
+ *
+ *  @param set1   types of particles
+ *  @param set2   types of particles
+ *  @param range  lower bound for the initial search range
+ */
+static double mpi_mindist2_sparse_local(std::vector<int> const &set1,
+                                        std::vector<int> const &set2,
+                                        double range) {
+  using Point = std::pair<Utils::Vector3d, int>;
+  std::vector<Point> targets;
+  std::vector<Point> sources;
+  for (auto const &p : cell_structure.local_particles()) {
+    if (in_set(set1, p.p.type))
+      targets.emplace_back(p.r.p, p.identity());
+    if (in_set(set2, p.p.type))
+      sources.emplace_back(p.r.p, p.identity());
+  }
+
+  std::vector<std::pair<Utils::Vector3d, Utils::Vector3d>> boxes;
+  boost::mpi::all_gather(
+      comm_cart, std::make_pair(local_geo.my_left(), local_geo.my_right()),
+      boxes);
+  auto const n_sources = boost::mpi::all_reduce(comm_cart, sources.size(),
+                                                std::plus<std::size_t>());
+  auto const n_nodes = static_cast<int>(boxes.size());
+  /* start from the mean distance of the particles of @p set2 */
+  range = std::max(range, std::cbrt(box_geo.volume() /
+                                    std::max<double>(n_sources, 1.)));
+
+  while (true) {
+    std::vector<std::vector<Point>> send(n_nodes);
+    for (auto const &point : sources) {
+      for (int node = 0; node < n_nodes; ++node) {
+        if (node != this_node and
+            distance_to_box(point.first, boxes[node].first,
+                            boxes[node].second) <= range) {
+          send[node].push_back(point);
+        }
+      }
+    }
+    std::vector<std::vector<Point>> ghosts;
+    boost::mpi::all_to_all(comm_cart, send, ghosts);
+
+    std::size_t n_points = sources.size();
+    for (auto const &node_ghosts : ghosts)
+      n_points += node_ghosts.size();
+    SpatialGrid<int> grid(box_geo, range, std::max<std::size_t>(n_points, 1));
+    for (auto const &point : sources)
+      grid.insert(point.first, point.second);
+    for (auto const &node_ghosts : ghosts)
+      for (auto const &point : node_ghosts)
+        grid.insert(point.first, point.second);
+
+    /* with all particles on every node, the search needs no range */
+    auto const complete = boost::mpi::all_reduce(
+        comm_cart, static_cast<int>(n_points == n_sources),
+        boost::mpi::minimum<int>());
+
+    auto mindist2 = std::numeric_limits<double>::infinity();
+    for (auto const &point : targets) {
+      auto const id = point.second;
+      if (complete) {
+        auto const nearest = grid.k_nearest(
+            point.first, 1, [id](int other) { return other != id; });
+        if (not nearest.empty())
+          mindist2 = std::min(mindist2, nearest.front().first);
+      } else {
+        grid.for_each_in_radius(
+            point.first, range,
+            [id, &mindist2](int other, Utils::Vector3d const &d) {
+              if (other != id)
+                mindist2 = std::min(mindist2, d.norm2());
+            });
+      }
+    }
+    mindist2 = boost::mpi::all_reduce(comm_cart, mindist2,
+                                      boost::mpi::minimum<double>());
+
+    if (complete or mindist2 <= range * range) {
+      return mindist2;
+    }
+    range *= 2.;
+  }
+}
+
+REGISTER_CALLBACK_MASTER_RANK(mpi_mindist2_sparse_local)
+
+double mpi_mindist(std::vector<int> const &set1, std::vector<int> const &set2) {
+  auto const mindist2 =
+      mpi_call(Communication::Result::reduction, boost::mpi::minimum<double>(),
+               local_mindist2, set1, set2);
+
+  /* All pairs closer than the cell system range have been found. */
+  auto const range = *boost::min_element(cell_structure.max_range());
+  if (not std::isfinite(range) or mindist2 < range * range) {
+    return std::sqrt(mindist2);
+  }
+
+  /* Sparse configuration: search beyond the cell system range. */
+  return std::sqrt(mpi_call(Communication::Result::master_rank,
+                            mpi_mindist2_sparse_local, set1, set2, range));
+}
+
+void mpi_nbhood_local(Utils::Vector3d const &pos, double r_catch,
+                      Utils::Vector3i const &planedims) {
+  auto ids = local_nbhood_ids(pos, r_catch, planedims);
+  Utils::Mpi::gather_buffer(ids, comm_cart);
+}
+
+REGISTER_CALLBACK(mpi_nbhood_local)
+
+std::vector<int> mpi_nbhood(Utils::Vector3d const &pos, double r_catch,
+                            Utils::Vector3i const &planedims) {
+  mpi_call(mpi_nbhood_local, pos, r_catch, planedims);
+  auto ids = local_nbhood_ids(pos, r_catch, planedims);
+  Utils::Mpi::gather_buffer(ids, comm_cart);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+double local_distto2(Utils::Vector3d pos, int pid) {
+  auto const nearest = local_k_nearest(pos, 1, pid);
+  return nearest.empty() ? std::numeric_limits<double>::infinity()
+                         : nearest.front().first;
+}
+
+REGISTER_CALLBACK_REDUCTION(local_distto2, boost::mpi::minimum<double>())
+
+double mpi_distto(Utils::Vector3d const &pos, int pid) {
+  return std::sqrt(mpi_call(Communication::Result::reduction,
+                            boost::mpi::minimum<double>(), local_distto2, pos,
+                            pid));
+}
+
+void mpi_k_nearest_local(Utils::Vector3d const &pos, int k, int pid) {
+  auto candidates = local_k_nearest(pos, k, pid);
+  Utils::Mpi::gather_buffer(candidates, comm_cart);
+}
+
+REGISTER_CALLBACK(mpi_k_nearest_local)
+
+std::vector<std::pair<double, int>>
+mpi_k_nearest(Utils::Vector3d const &pos, int k, int pid) {
+  mpi_call(mpi_k_nearest_local, pos, k, pid);
+  auto candidates = local_k_nearest(pos, k, pid);
+  Utils::Mpi::gather_buffer(candidates, comm_cart);
+
+  /* Merge the per-node candidates */
+  auto const n = std::min(static_cast<std::size_t>(std::max(k, 0)),
+                          candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + n,
+                    candidates.end());
+  candidates.resize(n);
+  for (auto &c : candidates) {
+    c.first = std::sqrt(c.first);
+  }
+  return candidates;
+}
+
+/** Flag trial positions that overlap with local particles.
+ *  The trial positions are binned, so that the cost is linear in the
+ *  number of local particles and trial positions.
+ */
+static std::vector<char>
+local_overlaps(std::vector<Utils::Vector3d> const &positions,
+               double min_distance) {
+  std::vector<char> overlaps(positions.size(), 0);
+  if (positions.empty() or min_distance <= 0.)
+    return overlaps;
+
+  SpatialGrid<int> grid(box_geo, min_distance, positions.size());
+  for (int i = 0; i < static_cast<int>(positions.size()); ++i) {
+    grid.insert(positions[i], i);
+  }
+
+  for (auto const &p : cell_structure.local_particles()) {
+    grid.for_each_in_radius(p.r.p, min_distance,
+                            [&overlaps, min_distance](
+                                int i, Utils::Vector3d const &d) {
+                              if (d.norm2() < min_distance * min_distance)
+                                overlaps[i] = 1;
+                            });
+  }
+
+  return overlaps;
+}
+
+void mpi_overlaps_local(std::vector<Utils::Vector3d> const &positions,
+                        double min_distance) {
+  auto const overlaps = local_overlaps(positions, min_distance);
+  boost::mpi::reduce(comm_cart, overlaps.data(),
+                     static_cast<int>(overlaps.size()),
+                     std::logical_or<char>(), 0);
+}
+
+REGISTER_CALLBACK(mpi_overlaps_local)
+
+std::vector<char> mpi_overlaps(std::vector<Utils::Vector3d> const &positions,
+                               double min_distance) {
+  mpi_call(mpi_overlaps_local, positions, min_distance);
+  auto const local = local_overlaps(positions, min_distance);
+  std::vector<char> overlaps(local.size());
+  boost::mpi::reduce(comm_cart, local.data(), static_cast<int>(local.size()),
+                     overlaps.data(), std::logical_or<char>(), 0);
+  return overlaps;
+}
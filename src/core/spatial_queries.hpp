@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SPATIAL_QUERIES_HPP
+#define ESPRESSO_SPATIAL_QUERIES_HPP
+/** \file
+ *  Distributed proximity queries on the particle configuration.
+ *
+ *  All queries are evaluated in parallel on the particles each node
+ *  holds in its cells, so that the particle configuration never has to
+ *  be gathered on the head node. Queries around a position only visit
+ *  the cells of the domain decomposition close to it. Pair queries whose
+ *  range exceeds the cell size fall back to an auxiliary @ref SpatialGrid.
+ *
+ *  Implementation in spatial_queries.cpp.
+ */
+
+#include <utils/Vector.hpp>
+
+#include <utility>
+#include <vector>
+
+/** Calculate the minimal distance between two particles with types in
+ *  @p set1 resp. @p set2. An empty set matches all types.
+ *  @param set1 types of particles
+ *  @param set2 types of particles
+ *  @return the minimal distance of two particles
+ */
+double mpi_mindist(std::vector<int> const &set1, std::vector<int> const &set2);
+
+/** Find all particles within a given radius @p r_catch around a position.
+ *  @param pos        position of sphere center
+ *  @param r_catch    the sphere radius
+ *  @param planedims  orientation of coordinate system
+ *
+ *  @return List of ids close to @p pos.
+ */
+std::vector<int> mpi_nbhood(Utils::Vector3d const &pos, double r_catch,
+                            Utils::Vector3i const &planedims);
+
+/** Calculate minimal distance to point.
+ *  @param pos  point
+ *  @param pid  if a valid particle id, this particle is omitted from
+ *              minimization (this is a good idea if @p pos is the
+ *              position of a particle).
+ *  @return the minimal distance of a particle to coordinates @p pos
+ */
+double mpi_distto(Utils::Vector3d const &pos, int pid = -1);
+
+/** Find the @p k particles closest to a position.
+ *  @param pos  point
+ *  @param k    number of particles to find
+ *  @param pid  if a valid particle id, this particle is omitted
+ *  @return Pairs of distance and particle id, sorted by distance.
+ */
+std::vector<std::pair<double, int>>
+mpi_k_nearest(Utils::Vector3d const &pos, int k, int pid = -1);
+
+/** Check trial positions for overlap with existing particles.
+ *  @param positions     trial positions
+ *  @param min_distance  minimal allowed distance to any particle
+ *  @return For each position whether a particle is closer than
+ *          @p min_distance.
+ */
+std::vector<char> mpi_overlaps(std::vector<Utils::Vector3d> const &positions,
+                               double min_distance);
+
+#endif
@@ -36,44 +36,14 @@
 
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
-#include <utils/contains.hpp>
 #include <utils/math/sqr.hpp>
 
 #include <cstdlib>
-#include <limits>
 
 /****************************************************************************************
  *                                 basic observables calculation
  ****************************************************************************************/
 
-double mindist(PartCfg &partCfg, const std::vector<int> &set1,
-               const std::vector<int> &set2) {
-  using Utils::contains;
-
-  auto mindist2 = std::numeric_limits<double>::infinity();
-
-  for (auto jt = partCfg.begin(); jt != partCfg.end(); ++jt) {
-    /* check which sets particle j belongs to (bit 0: set1, bit1: set2) */
-    auto in_set = 0u;
-    if (set1.empty() || contains(set1, jt->p.type))
-      in_set = 1u;
-    if (set2.empty() || contains(set2, jt->p.type))
-      in_set |= 2u;
-    if (in_set == 0)
-      continue;
-
-    for (auto it = std::next(jt); it != partCfg.end(); ++it)
-      /* accept a pair if particle j is in set1 and particle i in set2 or vice
-       * versa. */
-      if (((in_set & 1u) && (set2.empty() || contains(set2, it->p.type))) ||
-          ((in_set & 2u) && (set1.empty() || contains(set1, it->p.type))))
-        mindist2 = std::min(mindist2,
-                            get_mi_vector(jt->r.p, it->r.p, box_geo).norm2());
-  }
-
-  return std::sqrt(mindist2);
-}
-
 Utils::Vector3d local_particle_momentum() {
   auto const particles = cell_structure.local_particles();
   auto const momentum =
@@ -158,45 +128,6 @@ void momentofinertiamatrix(PartCfg &partCfg, int type, double *MofImatrix) {
   MofImatrix[7] = MofImatrix[5];
 }
 
-std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
-                        double r_catch, const Utils::Vector3i &planedims) {
-  std::vector<int> ids;
-
-  auto const r2 = r_catch * r_catch;
-  auto const pt = Utils::Vector3d{pos[0], pos[1], pos[2]};
-
-  Utils::Vector3d d;
-
-  for (auto const &p : partCfg) {
-    if ((planedims[0] + planedims[1] + planedims[2]) == 3) {
-      d = get_mi_vector(pt, p.r.p, box_geo);
-    } else {
-      /* Calculate the in plane distance */
-      for (int j = 0; j < 3; j++) {
-        d[j] = planedims[j] * (p.r.p[j] - pt[j]);
-      }
-    }
-
-    if (d.norm2() < r2) {
-      ids.push_back(p.p.identity);
-    }
-  }
-
-  return ids;
-}
-
-double distto(PartCfg &partCfg, const Utils::Vector3d &pos, int pid) {
-  auto mindist = std::numeric_limits<double>::infinity();
-
-  for (auto const &part : partCfg) {
-    if (pid != part.p.identity) {
-      auto const d = get_mi_vector({pos[0], pos[1], pos[2]}, part.r.p, box_geo);
-      mindist = std::min(mindist, d.norm2());
-    }
-  }
-  return std::sqrt(mindist);
-}
-
 void calc_part_distribution(PartCfg &partCfg, std::vector<int> const &p1_types,
                             std::vector<int> const &p2_types, double r_min,
                             double r_max, int r_bins, bool log_flag,
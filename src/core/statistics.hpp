@@ -30,37 +30,6 @@
 
 #include <vector>
 
-/** Calculate the minimal distance of two particles with types in set1 resp.
- *  set2.
- *  @param partCfg particle collection.
- *  @param set1 types of particles
- *  @param set2 types of particles
- *  @return the minimal distance of two particles
- */
-double mindist(PartCfg &partCfg, const std::vector<int> &set1,
-               const std::vector<int> &set2);
-
-/** Find all particles within a given radius @p r_catch around a position.
- *  @param partCfg    @copybrief PartCfg
- *  @param pos        position of sphere center
- *  @param r_catch    the sphere radius
- *  @param planedims  orientation of coordinate system
- *
- *  @return List of ids close to @p pos.
- */
-std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
-                        double r_catch, const Utils::Vector3i &planedims);
-
-/** Calculate minimal distance to point.
- *  @param partCfg particle selection
- *  @param pos  point
- *  @param pid  if a valid particle id, this particle is omitted from
- *              minimization (this is a good idea if @p pos is the
- *              position of a particle).
- *  @return the minimal distance of a particle to coordinates @p pos
- */
-double distto(PartCfg &partCfg, const Utils::Vector3d &pos, int pid = -1);
-
 /** Calculate the distribution of particles around others.
  *
  *  Calculates the distance distribution of particles with types given
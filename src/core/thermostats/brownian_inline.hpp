@@ -25,13 +25,16 @@
 #include "config.hpp"
 
 #include "Particle.hpp"
+#include "ParticleRange.hpp"
 #include "random.hpp"
 #include "rotation.hpp"
 #include "thermostat.hpp"
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <cmath>
+#include <vector>
 
 /** Determine position: viscous drag driven by conservative forces.
  *  From eq. (14.39) in @cite Schlick2010.
@@ -164,9 +167,11 @@ inline Utils::Vector3d bd_drag_vel(Thermostat::GammaType const &brownian_gamma,
  *  @param[in]     brownian       Parameters
  *  @param[in]     p              %Particle
  *  @param[in]     dt             Time interval
+ *  @param[in]     noise          Gaussian noise of the particle
  */
 inline Utils::Vector3d bd_random_walk(BrownianThermostat const &brownian,
-                                      Particle const &p, double dt) {
+                                      Particle const &p, double dt,
+                                      Utils::Vector3d const &noise) {
   // skip the translation thermalizing for virtual sites unless enabled
   if (p.p.is_virtual && !thermo_virtual)
     return {};
@@ -186,8 +191,6 @@ inline Utils::Vector3d bd_random_walk(BrownianThermostat const &brownian,
   // Eq. (14.37) is factored by the Gaussian noise (12.22) with its squared
   // magnitude defined in the second eq. (14.38), Schlick2010.
   Utils::Vector3d delta_pos_body{};
-  auto const noise = Random::noise_gaussian<RNGSalt::BROWNIAN_WALK>(
-      brownian.rng_counter(), brownian.rng_seed(), p.p.identity);
   for (int j = 0; j < 3; j++) {
 #ifdef EXTERNAL_FORCES
     if (!(p.p.ext_flag & COORD_FIXED(j)))
@@ -235,19 +238,35 @@ inline Utils::Vector3d bd_random_walk(BrownianThermostat const &brownian,
   return position;
 }
 
+/** Determine the positions: random walk part.
+ *  @param[in]     brownian       Parameters
+ *  @param[in]     p              %Particle
+ *  @param[in]     dt             Time interval
+ */
+inline Utils::Vector3d bd_random_walk(BrownianThermostat const &brownian,
+                                      Particle const &p, double dt) {
+  // skip the translation thermalizing for virtual sites unless enabled
+  if (p.p.is_virtual && !thermo_virtual)
+    return {};
+
+  auto const noise = Random::noise_gaussian<RNGSalt::BROWNIAN_WALK>(
+      brownian.rng_counter(), brownian.rng_seed(), p.p.identity);
+  return bd_random_walk(brownian, p, dt, noise);
+}
+
 /** Determine the velocities: random walk part.
  *  From eq. (10.2.16) in @cite Pottier2010.
  *  @param[in]     brownian       Parameters
  *  @param[in]     p              %Particle
+ *  @param[in]     noise          Gaussian noise of the particle
  */
 inline Utils::Vector3d bd_random_walk_vel(BrownianThermostat const &brownian,
-                                          Particle const &p) {
+                                          Particle const &p,
+                                          Utils::Vector3d const &noise) {
   // skip the translation thermalizing for virtual sites unless enabled
   if (p.p.is_virtual && !thermo_virtual)
     return {};
 
-  auto const noise = Random::noise_gaussian<RNGSalt::BROWNIAN_INC>(
-      brownian.rng_counter(), brownian.rng_seed(), p.identity());
   Utils::Vector3d velocity = {};
   for (int j = 0; j < 3; j++) {
 #ifdef EXTERNAL_FORCES
@@ -267,6 +286,21 @@ inline Utils::Vector3d bd_random_walk_vel(BrownianThermostat const &brownian,
   return velocity;
 }
 
+/** Determine the velocities: random walk part.
+ *  @param[in]     brownian       Parameters
+ *  @param[in]     p              %Particle
+ */
+inline Utils::Vector3d bd_random_walk_vel(BrownianThermostat const &brownian,
+                                          Particle const &p) {
+  // skip the translation thermalizing for virtual sites unless enabled
+  if (p.p.is_virtual && !thermo_virtual)
+    return {};
+
+  auto const noise = Random::noise_gaussian<RNGSalt::BROWNIAN_INC>(
+      brownian.rng_counter(), brownian.rng_seed(), p.identity());
+  return bd_random_walk_vel(brownian, p, noise);
+}
+
 #ifdef ROTATION
 
 /** Determine quaternions: viscous drag driven by conservative torques.
@@ -353,10 +387,11 @@ bd_drag_vel_rot(Thermostat::GammaType const &brownian_gamma_rotation,
  *  @param[in]     brownian       Parameters
  *  @param[in]     p              %Particle
  *  @param[in]     dt             Time interval
+ *  @param[in]     noise          Gaussian noise of the particle
  */
 inline Utils::Quaternion<double>
 bd_random_walk_rot(BrownianThermostat const &brownian, Particle const &p,
-                   double dt) {
+                   double dt, Utils::Vector3d const &noise) {
 
   Thermostat::GammaType sigma_pos = brownian.sigma_pos_rotation;
 #ifdef THERMOSTAT_PER_PARTICLE
@@ -371,8 +406,6 @@ bd_random_walk_rot(BrownianThermostat const &brownian, Particle const &p,
 #endif // THERMOSTAT_PER_PARTICLE
 
   Utils::Vector3d dphi = {};
-  auto const noise = Random::noise_gaussian<RNGSalt::BROWNIAN_ROT_INC>(
-      brownian.rng_counter(), brownian.rng_seed(), p.p.identity);
   for (int j = 0; j < 3; j++) {
 #ifdef EXTERNAL_FORCES
     if (!(p.p.ext_flag & COORD_FIXED(j)))
@@ -399,18 +432,31 @@ bd_random_walk_rot(BrownianThermostat const &brownian, Particle const &p,
   return p.r.quat;
 }
 
+/** Determine the quaternions: random walk part.
+ *  @param[in]     brownian       Parameters
+ *  @param[in]     p              %Particle
+ *  @param[in]     dt             Time interval
+ */
+inline Utils::Quaternion<double>
+bd_random_walk_rot(BrownianThermostat const &brownian, Particle const &p,
+                   double dt) {
+  auto const noise = Random::noise_gaussian<RNGSalt::BROWNIAN_ROT_INC>(
+      brownian.rng_counter(), brownian.rng_seed(), p.p.identity);
+  return bd_random_walk_rot(brownian, p, dt, noise);
+}
+
 /** Determine the angular velocities: random walk part.
  *  An analogy of eq. (10.2.16) in @cite Pottier2010.
  *  @param[in]     brownian       Parameters
  *  @param[in]     p              %Particle
+ *  @param[in]     noise          Gaussian noise of the particle
  */
 inline Utils::Vector3d
-bd_random_walk_vel_rot(BrownianThermostat const &brownian, Particle const &p) {
+bd_random_walk_vel_rot(BrownianThermostat const &brownian, Particle const &p,
+                       Utils::Vector3d const &noise) {
   auto const sigma_vel = brownian.sigma_vel_rotation;
 
   Utils::Vector3d domega{};
-  auto const noise = Random::noise_gaussian<RNGSalt::BROWNIAN_ROT_WALK>(
-      brownian.rng_counter(), brownian.rng_seed(), p.p.identity);
   for (int j = 0; j < 3; j++) {
 #ifdef EXTERNAL_FORCES
     if (!(p.p.ext_flag & COORD_FIXED(j)))
@@ -421,6 +467,64 @@ bd_random_walk_vel_rot(BrownianThermostat const &brownian, Particle const &p) {
   }
   return mask(p.p.rotation, domega);
 }
+
+/** Determine the angular velocities: random walk part.
+ *  @param[in]     brownian       Parameters
+ *  @param[in]     p              %Particle
+ */
+inline Utils::Vector3d
+bd_random_walk_vel_rot(BrownianThermostat const &brownian, Particle const &p) {
+  auto const noise = Random::noise_gaussian<RNGSalt::BROWNIAN_ROT_WALK>(
+      brownian.rng_counter(), brownian.rng_seed(), p.p.identity);
+  return bd_random_walk_vel_rot(brownian, p, noise);
+}
 #endif // ROTATION
 
+/** Gaussian noise of the Brownian thermostat for a range of particles.
+ *  The noise is drawn in batches, one vector per thermalized particle,
+ *  in the order of the particles in the range. It is bit-identical to
+ *  the noise drawn particle by particle.
+ */
+struct BrownianNoise {
+  /** Noise of the positions and velocities */
+  std::vector<Utils::Vector3d> pos, vel;
+#ifdef ROTATION
+  /** Noise of the orientations and angular velocities */
+  std::vector<Utils::Vector3d> pos_rot, vel_rot;
+#endif
+
+  BrownianNoise(BrownianThermostat const &brownian,
+                ParticleRange const &particles) {
+    std::vector<int> ids;
+#ifdef ROTATION
+    std::vector<int> ids_rot;
+#endif
+    for (auto const &p : particles) {
+      if (!p.p.is_virtual or thermo_virtual)
+        ids.push_back(p.p.identity);
+#ifdef ROTATION
+      if (p.p.rotation)
+        ids_rot.push_back(p.p.identity);
+#endif
+    }
+
+    auto const counter = brownian.rng_counter();
+    auto const seed = brownian.rng_seed();
+    pos.resize(ids.size());
+    vel.resize(ids.size());
+    Random::noise_gaussian<RNGSalt::BROWNIAN_WALK>(counter, seed, ids, {},
+                                                   Utils::make_span(pos));
+    Random::noise_gaussian<RNGSalt::BROWNIAN_INC>(counter, seed, ids, {},
+                                                  Utils::make_span(vel));
+#ifdef ROTATION
+    pos_rot.resize(ids_rot.size());
+    vel_rot.resize(ids_rot.size());
+    Random::noise_gaussian<RNGSalt::BROWNIAN_ROT_INC>(
+        counter, seed, ids_rot, {}, Utils::make_span(pos_rot));
+    Random::noise_gaussian<RNGSalt::BROWNIAN_ROT_WALK>(
+        counter, seed, ids_rot, {}, Utils::make_span(vel_rot));
+#endif
+  }
+};
+
 #endif // THERMOSTATS_BROWNIAN_INLINE_HPP
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE Correlator engine test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "accumulators/CorrelatorEngine.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using Accumulators::CompressionFunction;
+using Accumulators::CorrelationOperation;
+using Accumulators::CorrelatorEngine;
+using Accumulators::CorrelatorMethod;
+
+namespace {
+using Series = std::vector<std::vector<double>>;
+
+Series random_series(std::size_t length, std::size_t dim, std::mt19937 &rng) {
+  std::normal_distribution<double> dist(2., 1.);
+  Series series(length, std::vector<double>(dim));
+  for (auto &sample : series)
+    for (auto &value : sample)
+      value = dist(rng);
+  return series;
+}
+
+/* sums of the operation over all pairs of samples with lags 0 to tau_max */
+std::vector<double> reference_sums(CorrelationOperation op, Series const &A,
+                                   Series const &B, int tau_max,
+                                   Utils::Vector3d const &args) {
+  auto const dim_A = A[0].size();
+  auto const dim_B = B[0].size();
+  auto const dim_corr = CorrelatorEngine::dim_corr(op, dim_A, dim_B);
+  std::vector<double> sums((tau_max + 1) * dim_corr, 0.);
+  for (std::size_t t = 0; t < A.size(); t++) {
+    for (std::size_t tau = 0; tau <= static_cast<std::size_t>(tau_max) and
+                              tau <= t;
+         tau++) {
+      auto const &a = A[t - tau];
+      auto const &b = B[t];
+      auto out = sums.begin() + tau * dim_corr;
+      switch (op) {
+      case CorrelationOperation::SCALAR_PRODUCT:
+        for (std::size_t k = 0; k < dim_A; k++)
+          out[0] += a[k] * b[k];
+        break;
+      case CorrelationOperation::COMPONENTWISE_PRODUCT:
+        for (std::size_t k = 0; k < dim_A; k++)
+          out[k] += a[k] * b[k];
+        break;
+      case CorrelationOperation::TENSOR_PRODUCT:
+        for (std::size_t i = 0; i < dim_A; i++)
+          for (std::size_t j = 0; j < dim_B; j++)
+            out[i * dim_B + j] += a[i] * b[j];
+        break;
+      case CorrelationOperation::SQUARE_DISTANCE_COMPONENTWISE:
+        for (std::size_t k = 0; k < dim_A; k++)
+          out[k] += Utils::sqr(a[k] - b[k]);
+        break;
+      case CorrelationOperation::FCS_ACF:
+        for (std::size_t i = 0; i < dim_A / 3; i++) {
+          double c = 0.;
+          for (int j = 0; j < 3; j++)
+            c -= Utils::sqr(a[3 * i + j] - b[3 * i + j]) / args[j];
+          out[i] += std::exp(c);
+        }
+        break;
+      }
+    }
+  }
+  return sums;
+}
+
+CorrelatorEngine make_engine(CorrelatorMethod method, int tau_lin,
+                             CorrelationOperation op, std::size_t dim_A,
+                             std::size_t dim_B,
+                             Utils::Vector3d const &args = {}) {
+  return {method,
+          tau_lin,
+          1,
+          dim_A,
+          dim_B,
+          op,
+          CompressionFunction::DISCARD2,
+          CompressionFunction::DISCARD2,
+          args};
+}
+
+void check_sums(CorrelatorEngine const &engine, Series const &A,
+                Series const &B, CorrelationOperation op, int tau_lin,
+                Utils::Vector3d const &args, double tol) {
+  std::vector<double> sums;
+  std::vector<std::size_t> sample_sizes;
+  engine.get_sums(sums, sample_sizes);
+  auto const ref = reference_sums(op, A, B, tau_lin, args);
+  BOOST_REQUIRE_EQUAL(sums.size(), ref.size());
+  for (std::size_t i = 0; i < ref.size(); i++) {
+    BOOST_CHECK_SMALL(sums[i] - ref[i], tol * (1. + std::abs(ref[i])));
+  }
+  BOOST_REQUIRE_EQUAL(sample_sizes.size(),
+                      static_cast<std::size_t>(tau_lin + 1));
+  for (std::size_t tau = 0; tau < sample_sizes.size(); tau++) {
+    auto const expected = (A.size() > tau) ? A.size() - tau : 0;
+    BOOST_CHECK_EQUAL(sample_sizes[tau], expected);
+  }
+  BOOST_CHECK(engine.sample_sizes() == sample_sizes);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(linear_correlation) {
+  std::mt19937 rng(42);
+  auto const tau_lin = 16;
+  auto const A = random_series(50, 6, rng);
+  auto const B = random_series(50, 6, rng);
+  auto const args = Utils::Vector3d{1.5, 2., 2.5};
+
+  for (auto const op : {CorrelationOperation::SCALAR_PRODUCT,
+                        CorrelationOperation::COMPONENTWISE_PRODUCT,
+                        CorrelationOperation::TENSOR_PRODUCT,
+                        CorrelationOperation::SQUARE_DISTANCE_COMPONENTWISE,
+                        CorrelationOperation::FCS_ACF}) {
+    auto engine =
+        make_engine(CorrelatorMethod::MULTI_TAU, tau_lin, op, 6, 6, args);
+    for (std::size_t t = 0; t < A.size(); t++)
+      engine.update(A[t], B[t]);
+    check_sums(engine, A, B, op, tau_lin, args, 1e-12);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fft_correlation) {
+  std::mt19937 rng(43);
+  auto const tau_lin = 20;
+  auto const args = Utils::Vector3d{};
+
+  for (auto const op : {CorrelationOperation::SCALAR_PRODUCT,
+                        CorrelationOperation::COMPONENTWISE_PRODUCT,
+                        CorrelationOperation::TENSOR_PRODUCT,
+                        CorrelationOperation::SQUARE_DISTANCE_COMPONENTWISE}) {
+    auto const A = random_series(75, 4, rng);
+    auto const B = random_series(75, 4, rng);
+    auto engine = make_engine(CorrelatorMethod::FFT, tau_lin, op, 4, 4);
+    /* incomplete first block, complete blocks and an incomplete block */
+    for (std::size_t length : {5u, 20u, 47u, 60u, 75u}) {
+      auto const begin = engine.sample_sizes()[0];
+      for (std::size_t t = begin; t < length; t++)
+        engine.update(A[t], B[t]);
+      Series const A_part(A.begin(), A.begin() + length);
+      Series const B_part(B.begin(), B.begin() + length);
+      check_sums(engine, A_part, B_part, op, tau_lin, args, 1e-10);
+    }
+    engine.finalize();
+    check_sums(engine, A, B, op, tau_lin, args, 1e-10);
+    BOOST_CHECK_THROW(engine.update(A[0], B[0]), std::runtime_error);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fft_square_distance_offset) {
+  /* the square distance of values with a large common offset */
+  auto const tau_lin = 32;
+  Series A(200, std::vector<double>(1));
+  for (std::size_t t = 0; t < A.size(); t++)
+    A[t][0] = 1e6 + 0.01 * static_cast<double>(t);
+  auto engine =
+      make_engine(CorrelatorMethod::FFT, tau_lin,
+                  CorrelationOperation::SQUARE_DISTANCE_COMPONENTWISE, 1, 1);
+  for (auto const &a : A)
+    engine.update(a, a);
+  std::vector<double> sums;
+  std::vector<std::size_t> sample_sizes;
+  engine.get_sums(sums, sample_sizes);
+  for (int tau = 0; tau <= tau_lin; tau++) {
+    auto const expected = Utils::sqr(0.01 * tau);
+    BOOST_CHECK_SMALL(sums[tau] / static_cast<double>(sample_sizes[tau]) -
+                          expected,
+                      1e-7 * (expected + 1e-4));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(multi_tau_hierarchy) {
+  /* uniform motion: the square displacement is exact on all levels */
+  auto const tau_lin = 8;
+  auto const depth = 4;
+  CorrelatorEngine engine(CorrelatorMethod::MULTI_TAU, tau_lin, depth, 3, 3,
+                          CorrelationOperation::SQUARE_DISTANCE_COMPONENTWISE,
+                          CompressionFunction::DISCARD2,
+                          CompressionFunction::DISCARD2, {});
+  Utils::Vector3d const v{1., 2., 3.};
+  for (int t = 0; t < 500; t++) {
+    auto const pos = static_cast<double>(t) * v;
+    engine.update(pos, pos);
+  }
+  engine.finalize();
+
+  std::vector<double> sums;
+  std::vector<std::size_t> sample_sizes;
+  engine.get_sums(sums, sample_sizes);
+  BOOST_REQUIRE_EQUAL(engine.n_values(), 21u);
+
+  /* lag times of the levels */
+  std::vector<int> tau;
+  for (int i = 0; i <= tau_lin; i++)
+    tau.push_back(i);
+  for (int j = 1; j < depth; j++)
+    for (int k = 0; k < tau_lin / 2; k++)
+      tau.push_back((k + tau_lin / 2 + 1) * (1 << j));
+
+  for (std::size_t i = 0; i < engine.n_values(); i++) {
+    BOOST_REQUIRE(sample_sizes[i] > 0);
+    for (std::size_t k = 0; k < 3; k++) {
+      auto const value = sums[3 * i + k] / static_cast<double>(sample_sizes[i]);
+      BOOST_CHECK_CLOSE(value + 1., Utils::sqr(v[k] * tau[i]) + 1., 1e-10);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(serialization) {
+  std::mt19937 rng(44);
+  auto const A = random_series(100, 3, rng);
+  for (auto const method :
+       {CorrelatorMethod::MULTI_TAU, CorrelatorMethod::FFT}) {
+    auto const depth = (method == CorrelatorMethod::FFT) ? 1 : 3;
+    CorrelatorEngine engine(method, 8, depth, 3, 3,
+                            CorrelationOperation::COMPONENTWISE_PRODUCT,
+                            CompressionFunction::LINEAR,
+                            CompressionFunction::LINEAR, {});
+    for (std::size_t t = 0; t < 45; t++)
+      engine.update(A[t], A[t]);
+
+    std::stringstream ss;
+    {
+      boost::archive::binary_oarchive oa(ss);
+      oa << engine;
+    }
+    CorrelatorEngine restored(method, 8, depth, 3, 3,
+                              CorrelationOperation::COMPONENTWISE_PRODUCT,
+                              CompressionFunction::LINEAR,
+                              CompressionFunction::LINEAR, {});
+    {
+      boost::archive::binary_iarchive ia(ss);
+      ia >> restored;
+    }
+
+    for (std::size_t t = 45; t < A.size(); t++) {
+      engine.update(A[t], A[t]);
+      restored.update(A[t], A[t]);
+    }
+    std::vector<double> sums, sums_restored;
+    std::vector<std::size_t> sizes, sizes_restored;
+    engine.get_sums(sums, sizes);
+    restored.get_sums(sums_restored, sizes_restored);
+    BOOST_CHECK(sums == sums_restored);
+    BOOST_CHECK(sizes == sizes_restored);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(empty_samples) {
+  /* nodes without particles of a distributed correlator */
+  std::vector<double> const empty;
+  for (auto const method :
+       {CorrelatorMethod::MULTI_TAU, CorrelatorMethod::FFT}) {
+    for (auto const op : {CorrelationOperation::SCALAR_PRODUCT,
+                          CorrelationOperation::COMPONENTWISE_PRODUCT}) {
+      auto engine = make_engine(method, 4, op, 0, 0);
+      for (int t = 0; t < 10; t++)
+        engine.update(empty, empty);
+      engine.finalize();
+      std::vector<double> sums;
+      std::vector<std::size_t> sample_sizes;
+      engine.get_sums(sums, sample_sizes);
+      BOOST_CHECK_EQUAL(sums.size(), 5u * engine.dim_corr());
+      BOOST_CHECK(std::all_of(sums.begin(), sums.end(),
+                              [](double v) { return v == 0.; }));
+      BOOST_CHECK_EQUAL(sample_sizes[4], 6u);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(exceptions) {
+  BOOST_CHECK_THROW(
+      make_engine(CorrelatorMethod::MULTI_TAU, 4,
+                  CorrelationOperation::COMPONENTWISE_PRODUCT, 3, 6),
+      std::runtime_error);
+  BOOST_CHECK_THROW(make_engine(CorrelatorMethod::MULTI_TAU, 4,
+                                CorrelationOperation::FCS_ACF, 4, 4),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(make_engine(CorrelatorMethod::FFT, 4,
+                                CorrelationOperation::FCS_ACF, 3, 3),
+                    std::runtime_error);
+  auto engine = make_engine(CorrelatorMethod::MULTI_TAU, 4,
+                            CorrelationOperation::SCALAR_PRODUCT, 3, 3);
+  engine.finalize();
+  BOOST_CHECK_THROW(engine.finalize(), std::runtime_error);
+}
@@ -30,10 +30,15 @@
 
 #include <boost/mpi.hpp>
 #include <boost/optional.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/variant.hpp>
+#include <boost/variant.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <string>
+#include <vector>
 
 static bool called = false;
 
@@ -284,6 +289,66 @@ BOOST_AUTO_TEST_CASE(call_all) {
   BOOST_CHECK(called);
 }
 
+static std::vector<int> deferred_log;
+using DeferredArg = boost::variant<int, std::string>;
+
+BOOST_AUTO_TEST_CASE(deferred_callbacks) {
+  auto deferred = [](DeferredArg const &v) {
+    auto const i = boost::get<int>(&v);
+    deferred_log.push_back(i ? *i : -1);
+  };
+  auto check = [](int n) {
+    BOOST_CHECK_EQUAL(deferred_log.size(), static_cast<std::size_t>(n));
+  };
+  auto const fp_deferred =
+      static_cast<void (*)(DeferredArg const &)>(deferred);
+  auto const fp_check = static_cast<void (*)(int)>(check);
+
+  Communication::MpiCallbacks::add_static(fp_deferred, true);
+  Communication::MpiCallbacks::add_static(fp_check);
+
+  boost::mpi::communicator world;
+  deferred_log.clear();
+  {
+    Communication::MpiCallbacks cbs(world);
+
+    if (0 == world.rank()) {
+      /* calls are not queued unless deferred mode is enabled */
+      cbs.call_all(fp_deferred, DeferredArg{0});
+      BOOST_CHECK_EQUAL(cbs.queue_size(), 0u);
+
+      cbs.set_deferred(true);
+      BOOST_CHECK(cbs.deferred());
+      for (DeferredArg arg : {DeferredArg{1}, DeferredArg{"2"}, DeferredArg{3}})
+        cbs.call_all(fp_deferred, arg);
+      BOOST_CHECK_GT(cbs.queue_size(), 0u);
+      /* a non-deferrable call sends the queue first */
+      cbs.call_all(fp_check, 4);
+      BOOST_CHECK_EQUAL(cbs.queue_size(), 0u);
+
+      cbs.call_all(fp_deferred, DeferredArg{4});
+      cbs.flush();
+      BOOST_CHECK_EQUAL(cbs.queue_size(), 0u);
+      cbs.flush();
+      cbs.call_all(fp_check, 5);
+
+      /* leaving deferred mode sends the queue */
+      cbs.call_all(fp_deferred, DeferredArg{5});
+      cbs.set_deferred(false);
+      BOOST_CHECK_EQUAL(cbs.queue_size(), 0u);
+      cbs.call_all(fp_check, 6);
+
+      /* pending calls are run before the loop is aborted */
+      cbs.set_deferred(true);
+      cbs.call_all(fp_deferred, DeferredArg{6});
+    } else {
+      cbs.loop();
+    }
+  }
+
+  BOOST_CHECK((deferred_log == std::vector<int>{0, 1, -1, 3, 4, 5, 6}));
+}
+
 int main(int argc, char **argv) {
   boost::mpi::environment mpi_env(argc, argv);
 
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Shape grids test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "constraints/ShapeGrids.hpp"
+
+#include <shapes/Sphere.hpp>
+#include <shapes/Union.hpp>
+#include <shapes/Wall.hpp>
+
+#include <utils/Vector.hpp>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+using Constraints::CullingGrid;
+using Constraints::SignedDistanceGrid;
+
+namespace {
+/* two spheres in a box with a wall at z = 1 */
+std::shared_ptr<Shapes::Union> make_union() {
+  auto wall = std::make_shared<Shapes::Wall>();
+  wall->set_normal({0., 0., 1.});
+  wall->d() = 1.;
+  auto union_ = std::make_shared<Shapes::Union>();
+  union_->add(wall);
+  for (auto const &center :
+       {Utils::Vector3d{3., 3., 5.}, Utils::Vector3d{7., 6., 6.}}) {
+    auto sphere = std::make_shared<Shapes::Sphere>();
+    sphere->pos() = center;
+    sphere->rad() = 1.5;
+    union_->add(sphere);
+  }
+  return union_;
+}
+
+Utils::Vector3d random_position(std::mt19937 &rng) {
+  std::uniform_real_distribution<double> dist(-1., 11.);
+  return {dist(rng), dist(rng), dist(rng)};
+}
+
+/* distance, or NaN inside of one of the shapes of a union */
+double exact_dist(Shapes::Shape const &shape, Utils::Vector3d const &pos,
+                  Utils::Vector3d &vec) {
+  double dist;
+  try {
+    shape.calculate_dist(pos, dist, vec);
+  } catch (std::domain_error const &) {
+    return std::nan("");
+  }
+  return dist;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(culling) {
+  auto const shape = make_union();
+  Utils::Vector3d const lower{0., 0., 0.}, upper{10., 10., 10.};
+  auto const cutoff = 1.2;
+  std::mt19937 rng(42);
+
+  for (auto const penetrable : {false, true}) {
+    for (auto const only_positive : {false, true}) {
+      CullingGrid const grid(*shape, lower, upper, cutoff, penetrable,
+                             only_positive);
+      /* most of the box is far from the shapes */
+      BOOST_CHECK_LT(grid.active_fraction(), 0.6);
+      BOOST_CHECK_GT(grid.active_fraction(), 0.);
+
+      /* no position at which the constraint acts is culled */
+      for (int i = 0; i < 20000; i++) {
+        auto const pos = random_position(rng);
+        Utils::Vector3d vec;
+        auto const dist = exact_dist(*shape, pos, vec);
+        auto const acts = std::isnan(dist) or
+                          (dist > 0. and dist < cutoff) or
+                          (dist <= 0. and not penetrable) or
+                          (dist < 0. and penetrable and not only_positive and
+                           -dist < cutoff);
+        if (acts) {
+          BOOST_REQUIRE(grid.may_interact(pos));
+        }
+      }
+    }
+  }
+
+  CullingGrid const grid(*shape, lower, upper, cutoff, false, false);
+  BOOST_CHECK(grid.may_interact({5., 5., 1.5}));
+  BOOST_CHECK(not grid.may_interact({5., 8., 9.}));
+  /* positions outside of the grid are never culled */
+  BOOST_CHECK(grid.may_interact({5., 8., 10.5}));
+  BOOST_CHECK(grid.may_interact({-0.1, 8., 9.}));
+}
+
+BOOST_AUTO_TEST_CASE(signed_distance) {
+  auto const shape = make_union();
+  Utils::Vector3d const lower{0., 0., 0.}, upper{10., 10., 10.};
+  auto const spacing = 0.1;
+  SignedDistanceGrid const grid(*shape, lower, upper, spacing);
+  std::mt19937 rng(42);
+
+  int n_valid = 0, n_outside = 0;
+  for (int i = 0; i < 20000; i++) {
+    auto const pos = random_position(rng);
+    Utils::Vector3d vec, ref_vec;
+    double dist;
+    auto const ref_dist = exact_dist(*shape, pos, ref_vec);
+    auto const in_box = pos[0] >= 0. and pos[0] < 10. and pos[1] >= 0. and
+                        pos[1] < 10. and pos[2] >= 0. and pos[2] < 10.;
+    if (not grid.calculate_dist(pos, dist, vec)) {
+      n_outside += in_box ? 0 : 1;
+      continue;
+    }
+    BOOST_REQUIRE(not std::isnan(ref_dist));
+    n_valid++;
+    /* the interpolation error is of the order of the squared grid
+     * spacing divided by the radius of curvature */
+    BOOST_CHECK_SMALL(dist - ref_dist, 0.1 * spacing);
+    BOOST_CHECK_SMALL(std::abs(vec.norm() - std::abs(dist)), 1e-12);
+    if (std::abs(ref_dist) > 0.5) {
+      BOOST_CHECK_GT(vec * ref_vec, 0.99 * vec.norm() * ref_vec.norm());
+    }
+  }
+  /* the grid covers the box, and positions inside of the spheres are
+   * rejected */
+  BOOST_CHECK_GT(n_valid, 10000);
+  BOOST_CHECK_GT(n_outside, 0);
+
+  BOOST_CHECK_EQUAL(SignedDistanceGrid::size(lower, upper, spacing),
+                    103 * 103 * 103);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE SpatialGrid test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "BoxGeometry.hpp"
+#include "SpatialGrid.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace {
+BoxGeometry make_box(bool periodic) {
+  BoxGeometry box;
+  box.set_length({10., 12., 14.});
+  for (unsigned i = 0; i < 3; ++i)
+    box.set_periodic(i, periodic);
+  return box;
+}
+
+std::vector<Utils::Vector3d> random_points(BoxGeometry const &box, int n) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(0., 1.);
+  std::vector<Utils::Vector3d> points(n);
+  for (auto &p : points)
+    for (int i = 0; i < 3; ++i)
+      p[i] = box.length()[i] * dist(rng);
+  return points;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(radius_query) {
+  for (auto const periodic : {true, false}) {
+    auto const box = make_box(periodic);
+    auto const points = random_points(box, 500);
+    SpatialGrid<int> grid(box, 1.5);
+    for (int i = 0; i < points.size(); ++i)
+      grid.insert(points[i], i);
+    BOOST_CHECK_EQUAL(grid.size(), points.size());
+
+    for (auto const radius : {0.5, 1.5, 4., 30.}) {
+      auto const &pos = points.front();
+      std::vector<int> expected;
+      for (int i = 0; i < points.size(); ++i)
+        if (get_mi_vector(points[i], pos, box).norm() <= radius)
+          expected.push_back(i);
+
+      std::vector<int> found;
+      grid.for_each_in_radius(
+          pos, radius, [&found](int i, Utils::Vector3d const &) {
+            found.push_back(i);
+          });
+      std::sort(found.begin(), found.end());
+      BOOST_CHECK(found == expected);
+      BOOST_CHECK_EQUAL(grid.any_closer_than(pos, radius,
+                                             [](int i) { return i != 0; }),
+                        expected.size() > 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(k_nearest_query) {
+  auto const box = make_box(true);
+  auto const points = random_points(box, 300);
+  SpatialGrid<int> grid(box, 1.);
+  for (int i = 0; i < points.size(); ++i)
+    grid.insert(points[i], i);
+
+  Utils::Vector3d const pos{0.1, 11.9, 7.};
+  std::vector<double> dist2;
+  for (auto const &p : points)
+    dist2.push_back(get_mi_vector(p, pos, box).norm2());
+  std::sort(dist2.begin(), dist2.end());
+
+  auto const nearest = grid.k_nearest(pos, 7, [](int) { return true; });
+  BOOST_REQUIRE_EQUAL(nearest.size(), 7);
+  for (std::size_t i = 0; i < nearest.size(); ++i)
+    BOOST_CHECK_CLOSE(nearest[i].first, dist2[i], 1e-12);
+
+  /* more than available */
+  BOOST_CHECK_EQUAL(grid.k_nearest(pos, 1000, [](int) { return true; }).size(),
+                    points.size());
+}
+
+BOOST_AUTO_TEST_CASE(erase) {
+  auto const box = make_box(true);
+  SpatialGrid<int> grid(box, 1.);
+  grid.insert({1., 1., 1.}, 1);
+  grid.insert({1., 1., 1.}, 2);
+  BOOST_CHECK(not grid.erase({1., 1., 1.}, 3));
+  BOOST_CHECK(grid.erase({1., 1., 1.}, 1));
+  BOOST_CHECK_EQUAL(grid.size(), 1);
+  BOOST_CHECK(grid.any_closer_than({1.5, 1., 1.}, 1.));
+  BOOST_CHECK(grid.erase({1., 1., 1.}, 2));
+  BOOST_CHECK(grid.empty());
+  BOOST_CHECK(not grid.any_closer_than({1.5, 1., 1.}, 1.));
+}
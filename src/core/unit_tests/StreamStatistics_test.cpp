@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE Stream statistics test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "accumulators/StreamStatistics.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Accumulators::make_stream_statistics;
+using Accumulators::StreamParameters;
+using Accumulators::StreamQuery;
+using Accumulators::StreamStatisticsType;
+
+namespace {
+using Series = std::vector<std::vector<double>>;
+
+Series random_series(std::size_t length, std::size_t dim) {
+  std::mt19937 rng(42);
+  std::normal_distribution<double> dist(3., 2.);
+  Series series(length, std::vector<double>(dim));
+  for (auto &sample : series)
+    for (auto &value : sample)
+      value = dist(rng);
+  return series;
+}
+
+StreamParameters parameters(StreamStatisticsType type) {
+  StreamParameters params;
+  params.type = type;
+  return params;
+}
+
+/* mean and standard error of the mean of one component */
+std::pair<double, double> mean_error(Series const &series, std::size_t i) {
+  auto const n = static_cast<double>(series.size());
+  double mean = 0.;
+  for (auto const &sample : series)
+    mean += sample[i] / n;
+  double var = 0.;
+  for (auto const &sample : series)
+    var += (sample[i] - mean) * (sample[i] - mean) / (n - 1.);
+  return {mean, std::sqrt(var / n)};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(mean_variance) {
+  auto const series = random_series(100, 3);
+  auto statistics = make_stream_statistics(
+      parameters(StreamStatisticsType::MEAN_VARIANCE), 3);
+  for (auto const &sample : series)
+    statistics->update(sample);
+
+  BOOST_CHECK_EQUAL(statistics->n_samples(), 100u);
+  auto const mean = statistics->query(StreamQuery::MEAN);
+  auto const error = statistics->query(StreamQuery::STD_ERROR);
+  for (std::size_t i = 0; i < 3; i++) {
+    auto const ref = mean_error(series, i);
+    BOOST_CHECK_CLOSE(mean[i], ref.first, 1e-10);
+    BOOST_CHECK_CLOSE(error[i], ref.second, 1e-10);
+  }
+  BOOST_CHECK_THROW(statistics->query(StreamQuery::HISTOGRAM),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(blocking) {
+  auto const series = random_series(1000, 2);
+  auto statistics =
+      make_stream_statistics(parameters(StreamStatisticsType::BLOCKING), 2);
+  for (auto const &sample : series)
+    statistics->update(sample);
+
+  auto const mean = statistics->query(StreamQuery::MEAN);
+  auto const block_errors = statistics->query(StreamQuery::BLOCK_ERRORS);
+  /* block sizes 1 to 256 have at least two blocks */
+  std::size_t const n_levels = 9;
+  BOOST_REQUIRE_EQUAL(block_errors.size(), 2 * n_levels);
+  for (std::size_t i = 0; i < 2; i++) {
+    BOOST_CHECK_CLOSE(mean[i], mean_error(series, i).first, 1e-10);
+    for (std::size_t k = 0; k < n_levels; k++) {
+      /* averages of the complete blocks */
+      auto const block_size = std::size_t{1} << k;
+      Series blocks(series.size() / block_size, std::vector<double>(2, 0.));
+      for (std::size_t t = 0; t < blocks.size() * block_size; t++)
+        blocks[t / block_size][i] += series[t][i] / block_size;
+      BOOST_CHECK_CLOSE(block_errors[i * n_levels + k],
+                        mean_error(blocks, i).second, 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(blocking_correlated_samples) {
+  /* each value repeats 16 times, so the naive error is 4 times too small */
+  auto const values = random_series(4096, 1);
+  auto statistics =
+      make_stream_statistics(parameters(StreamStatisticsType::BLOCKING), 1);
+  for (auto const &value : values)
+    for (int j = 0; j < 16; j++)
+      statistics->update(value);
+
+  auto const error = statistics->query(StreamQuery::STD_ERROR)[0];
+  auto const reference = mean_error(values, 0).second;
+  BOOST_CHECK_CLOSE(error, reference, 25.);
+  auto const naive = statistics->query(StreamQuery::BLOCK_ERRORS)[0];
+  BOOST_CHECK_LT(naive, 0.5 * reference);
+}
+
+BOOST_AUTO_TEST_CASE(histogram) {
+  auto params = parameters(StreamStatisticsType::HISTOGRAM);
+  params.n_bins = 4;
+  params.min = 0.;
+  params.max = 2.;
+  auto statistics = make_stream_statistics(params, 2);
+  auto const nan = std::numeric_limits<double>::quiet_NaN();
+  for (auto const &sample : Series{{0., -1.},
+                                   {0.49, 2.},
+                                   {0.5, 2.5},
+                                   {1.99, nan},
+                                   {1.2, 1.2}})
+    statistics->update(sample);
+
+  auto const counts = statistics->query(StreamQuery::HISTOGRAM);
+  auto const outliers = statistics->query(StreamQuery::OUTLIERS);
+  std::vector<double> const ref_counts{2., 1., 1., 1., 0., 0., 1., 1.};
+  std::vector<double> const ref_outliers{0., 0., 2., 1.};
+  BOOST_CHECK(counts == ref_counts);
+  BOOST_CHECK(outliers == ref_outliers);
+
+  statistics->clear();
+  BOOST_CHECK_EQUAL(statistics->n_samples(), 0u);
+  for (auto const count : statistics->query(StreamQuery::HISTOGRAM))
+    BOOST_CHECK_EQUAL(count, 0.);
+
+  params.max = 0.;
+  BOOST_CHECK_THROW(make_stream_statistics(params, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(sample_buffer) {
+  auto const series = random_series(25, 3);
+  auto const check_samples = [&series](std::vector<double> const &samples,
+                                       std::size_t first) {
+    auto const n = series.size() - first;
+    BOOST_REQUIRE_EQUAL(samples.size(), 3 * n);
+    for (std::size_t i = 0; i < 3; i++)
+      for (std::size_t t = 0; t < n; t++)
+        BOOST_CHECK_EQUAL(samples[i * n + t], series[first + t][i]);
+  };
+  auto params = parameters(StreamStatisticsType::SAMPLE_BUFFER);
+
+  /* all samples in memory */
+  auto unbounded = make_stream_statistics(params, 3);
+  for (auto const &sample : series)
+    unbounded->update(sample);
+  check_samples(unbounded->query(StreamQuery::SAMPLES), 0);
+
+  /* the last samples in memory */
+  params.buffer_size = 8;
+  auto ring = make_stream_statistics(params, 3);
+  for (auto const &sample : series)
+    ring->update(sample);
+  BOOST_CHECK_EQUAL(ring->n_samples(), 8u);
+  check_samples(ring->query(StreamQuery::SAMPLES), series.size() - 8);
+
+  /* the samples which don't fit into memory in a file */
+  params.filename = "StreamStatistics_test.spill";
+  auto spill = make_stream_statistics(params, 3);
+  for (auto const &sample : series)
+    spill->update(sample);
+  BOOST_CHECK_EQUAL(spill->n_samples(), series.size());
+  check_samples(spill->query(StreamQuery::SAMPLES), 0);
+
+  /* the state doesn't include the spilled samples */
+  auto restored = make_stream_statistics(params, 3);
+  restored->set_state(spill->get_state());
+  check_samples(restored->query(StreamQuery::SAMPLES), 0);
+
+  /* a truncated or missing spill file is an error */
+  {
+    std::ofstream truncated(params.filename, std::ios::binary);
+    double const value = 0.;
+    truncated.write(reinterpret_cast<char const *>(&value), sizeof(value));
+  }
+  BOOST_CHECK_THROW(spill->query(StreamQuery::SAMPLES), std::runtime_error);
+  std::remove(params.filename.c_str());
+  BOOST_CHECK_THROW(spill->query(StreamQuery::SAMPLES), std::runtime_error);
+
+  /* the file is overwritten after clear() */
+  spill->clear();
+  for (std::size_t t = 0; t < 20; t++)
+    spill->update(series[t]);
+  auto const samples = spill->query(StreamQuery::SAMPLES);
+  BOOST_REQUIRE_EQUAL(samples.size(), 60u);
+  BOOST_CHECK_EQUAL(samples[19], series[19][0]);
+  std::remove(params.filename.c_str());
+
+  params.buffer_size = 0;
+  BOOST_CHECK_THROW(make_stream_statistics(params, 3), std::runtime_error);
+}
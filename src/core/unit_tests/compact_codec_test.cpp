@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE compact trajectory codec test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "io/mpiio/compact_codec.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace Mpiio::Compact;
+
+BOOST_AUTO_TEST_CASE(varint) {
+  for (std::int64_t v : {std::int64_t{0}, std::int64_t{1}, std::int64_t{-1},
+                         std::int64_t{63}, std::int64_t{-64},
+                         std::numeric_limits<std::int64_t>::max(),
+                         std::numeric_limits<std::int64_t>::min()}) {
+    BOOST_CHECK_EQUAL(unzigzag(zigzag(v)), v);
+    std::vector<char> buf;
+    put_varint(buf, zigzag(v));
+    char const *it = buf.data();
+    BOOST_CHECK_EQUAL(unzigzag(get_varint(it, buf.data() + buf.size())), v);
+    BOOST_CHECK(it == buf.data() + buf.size());
+  }
+  /* small magnitudes take a single byte */
+  std::vector<char> buf;
+  put_varint(buf, zigzag(-64));
+  BOOST_CHECK_EQUAL(buf.size(), 1);
+
+  char const *it = buf.data();
+  BOOST_CHECK_THROW(get_varint(it, it), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(block_round_trip) {
+  std::mt19937 rng(42);
+  std::normal_distribution<double> step(0., 1.);
+
+  Block block;
+  Utils::Vector3d pos{};
+  for (int id : {3, 4, 5, 6, 10, 11, 1000, 1001, 1002}) {
+    pos += Utils::Vector3d{step(rng), step(rng), step(rng)};
+    block.ids.push_back(id);
+    block.positions.push_back(pos);
+    block.velocities.push_back({step(rng), step(rng), -step(rng)});
+  }
+
+  auto const precision = 1e-3, vel_precision = 1e-2;
+  for (auto const with_vel : {true, false}) {
+    auto input = block;
+    if (not with_vel)
+      input.velocities.clear();
+    auto const buf = encode_block(input, precision, vel_precision);
+    /* chain-like data compresses well below 24 bytes per vector */
+    BOOST_CHECK_LT(buf.size(), (with_vel ? 12 : 8) * input.ids.size());
+
+    Block out;
+    decode_block(buf.data(), buf.data() + buf.size(), precision, vel_precision,
+                 with_vel, out);
+    BOOST_CHECK(out.ids == input.ids);
+    BOOST_REQUIRE_EQUAL(out.positions.size(), input.positions.size());
+    BOOST_REQUIRE_EQUAL(out.velocities.size(), input.velocities.size());
+    for (std::size_t i = 0; i < out.ids.size(); ++i) {
+      for (int j = 0; j < 3; ++j) {
+        BOOST_CHECK_LE(std::abs(out.positions[i][j] - input.positions[i][j]),
+                       0.5 * precision + 1e-12);
+        if (with_vel)
+          BOOST_CHECK_LE(
+              std::abs(out.velocities[i][j] - input.velocities[i][j]),
+              0.5 * vel_precision + 1e-12);
+      }
+    }
+
+    /* truncated input */
+    Block broken;
+    BOOST_CHECK_THROW(decode_block(buf.data(), buf.data() + buf.size() / 2,
+                                   precision, vel_precision, with_vel, broken),
+                      std::runtime_error);
+  }
+
+  /* empty block */
+  auto const buf = encode_block(Block{}, precision, vel_precision);
+  Block out;
+  decode_block(buf.data(), buf.data() + buf.size(), precision, vel_precision,
+               false, out);
+  BOOST_CHECK(out.ids.empty());
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Dipolar octree test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "electrostatics_magnetostatics/dipolar_octree.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace {
+struct System {
+  std::vector<Utils::Vector3d> pos;
+  std::vector<Utils::Vector3d> dip;
+};
+
+System random_system(std::size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> uniform(0., 10.);
+  std::normal_distribution<double> normal;
+  System system;
+  for (std::size_t i = 0; i < n; i++) {
+    system.pos.push_back({uniform(rng), uniform(rng), uniform(rng)});
+    system.dip.push_back({normal(rng), normal(rng), normal(rng)});
+  }
+  return system;
+}
+
+/* exact sum over all other dipoles */
+DipolarOctree::Result direct_sum(System const &system, int target) {
+  DipolarOctree::Result result;
+  for (std::size_t j = 0; j < system.pos.size(); j++) {
+    if (static_cast<int>(j) != target) {
+      DipolarOctree::kernel(system.dip[target], system.dip[j],
+                            system.pos[target] - system.pos[j], true, result);
+    }
+  }
+  return result;
+}
+
+/* largest force error relative to the largest force */
+double max_force_error(System const &system, DipolarOctree const &tree,
+                       double theta) {
+  double max_error = 0., max_force = 0.;
+  for (std::size_t i = 0; i < system.pos.size(); i++) {
+    auto const target = static_cast<int>(i);
+    auto const ref = direct_sum(system, target);
+    DipolarOctree::Result result;
+    tree.interaction(system.pos[i], system.dip[i], theta, target, true,
+                     result);
+    max_error = std::max(max_error, (result.force - ref.force).norm());
+    max_force = std::max(max_force, ref.force.norm());
+  }
+  return max_error / max_force;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(exact_sum) {
+  auto const system = random_system(200, 42);
+  for (int leaf_size : {1, 4, 16, 1000}) {
+    DipolarOctree const tree(system.pos, system.dip, leaf_size);
+    for (std::size_t i = 0; i < system.pos.size(); i++) {
+      auto const target = static_cast<int>(i);
+      auto const ref = direct_sum(system, target);
+      DipolarOctree::Result result;
+      tree.interaction(system.pos[i], system.dip[i], 0., target, true,
+                       result);
+      BOOST_CHECK_CLOSE(result.energy, ref.energy, 1e-9);
+      BOOST_CHECK_SMALL((result.force - ref.force).norm(),
+                        1e-11 * ref.force.norm());
+      BOOST_CHECK_SMALL((result.torque - ref.torque).norm(),
+                        1e-11 * ref.torque.norm());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(opening_angle) {
+  auto const system = random_system(1000, 7);
+  DipolarOctree const tree(system.pos, system.dip, 1);
+
+  /* the error decreases with the opening angle */
+  auto const error_large = max_force_error(system, tree, 0.8);
+  auto const error_medium = max_force_error(system, tree, 0.4);
+  auto const error_small = max_force_error(system, tree, 0.2);
+  BOOST_CHECK_LT(error_medium, error_large);
+  BOOST_CHECK_LT(error_small, error_medium);
+  BOOST_CHECK_LT(error_small, 1e-2);
+}
+
+BOOST_AUTO_TEST_CASE(external_target) {
+  /* a distant target sees the whole tree as one dipole */
+  auto const system = random_system(50, 3);
+  DipolarOctree const tree(system.pos, system.dip, 4);
+  Utils::Vector3d const pos = {1000., 0., 0.};
+  Utils::Vector3d const dip = {0., 0., 1.};
+
+  Utils::Vector3d total_dip = {};
+  Utils::Vector3d center = {};
+  double weight = 0.;
+  for (std::size_t i = 0; i < system.pos.size(); i++) {
+    total_dip += system.dip[i];
+    center += system.dip[i].norm() * system.pos[i];
+    weight += system.dip[i].norm();
+  }
+  DipolarOctree::Result ref;
+  DipolarOctree::kernel(dip, total_dip, pos - center / weight, true, ref);
+
+  DipolarOctree::Result result;
+  tree.interaction(pos, dip, 0.5, -1, true, result);
+  BOOST_CHECK_CLOSE(result.energy, ref.energy, 1e-9);
+  BOOST_CHECK_SMALL((result.force - ref.force).norm(), 1e-9 * ref.force.norm());
+}
+
+BOOST_AUTO_TEST_CASE(coincident_dipoles) {
+  /* the depth limit stops the subdivision of coincident dipoles */
+  System system;
+  for (int i = 0; i < 10; i++) {
+    system.pos.push_back({1., 1., 1.});
+    system.dip.push_back({0., 0., 1.});
+  }
+  system.pos.push_back({3., 1., 1.});
+  system.dip.push_back({0., 0., 1.});
+  DipolarOctree const tree(system.pos, system.dip, 2);
+  BOOST_CHECK_LE(tree.n_nodes(), 2u * (DipolarOctree::max_depth + 1));
+
+  auto const ref = direct_sum(system, 10);
+  DipolarOctree::Result result;
+  tree.interaction(system.pos[10], system.dip[10], 0., 10, true, result);
+  BOOST_CHECK_CLOSE(result.energy, ref.energy, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(empty_tree) {
+  DipolarOctree const tree({}, {}, 8);
+  DipolarOctree::Result result;
+  tree.interaction({0., 0., 0.}, {0., 0., 1.}, 0.5, -1, true, result);
+  BOOST_CHECK_EQUAL(result.energy, 0.);
+  BOOST_CHECK_EQUAL(tree.n_nodes(), 0u);
+}
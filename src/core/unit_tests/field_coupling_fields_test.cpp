@@ -36,6 +36,7 @@
 #include <cstddef>
 #include <limits>
 #include <type_traits>
+#include <vector>
 
 using namespace FieldCoupling::Fields;
 
@@ -403,3 +404,74 @@ BOOST_AUTO_TEST_CASE(interpolated_vector_field) {
         3 * std::numeric_limits<double>::epsilon());
   }
 }
+
+BOOST_AUTO_TEST_CASE(interpolated_stencil_indices) {
+  using FieldCoupling::Fields::detail::stencil_indices;
+  using Indices = std::vector<int>;
+
+  /* grid points at -0.5, 0.5, ..., 10.5 in a box of length 10 */
+  auto const n = 12;
+  auto const h = 1.;
+  auto const origin = -0.5;
+
+  BOOST_CHECK(stencil_indices(n, h, origin, 2.2, 4.1, 10., false) ==
+              (Indices{2, 3, 4, 5}));
+  /* the interval is clamped to the grid */
+  BOOST_CHECK(stencil_indices(n, h, origin, -3., 0.2, 10., false) ==
+              (Indices{0, 1}));
+  /* periodic intervals wrap around */
+  BOOST_CHECK(stencil_indices(n, h, origin, 8.7, 10.7, 10., true) ==
+              (Indices{0, 1, 2, 9, 10, 11}));
+  BOOST_CHECK(stencil_indices(n, h, origin, -1.2, 0.3, 10., true) ==
+              (Indices{0, 1, 9, 10, 11}));
+  BOOST_CHECK(stencil_indices(n, h, origin, -1., 12., 10., true).size() ==
+              static_cast<std::size_t>(n));
+}
+
+BOOST_AUTO_TEST_CASE(interpolated_distributed_field) {
+  using Field = Interpolated<double, 2>;
+
+  const Utils::Vector3d grid_spacing = {.1, .2, .3};
+  const Utils::Vector3d origin = {-1., 2., -1.4};
+  auto const n_nodes = Utils::Vector3i{10, 11, 12};
+
+  auto const x0 = origin + 0.57 * 10 * grid_spacing;
+  auto const sigma = 2.;
+
+  auto const data = Utils::raster<double>(
+      origin, grid_spacing, n_nodes, [&](auto x) {
+        return Utils::Vector2d{{gaussian(x, x0, sigma), x[0]}};
+      });
+
+  Field const field(data, grid_spacing, origin);
+  BOOST_CHECK(not field.is_distributed());
+
+  /* a block of the grid with a gap in the second direction */
+  std::array<std::vector<int>, 3> const indices = {
+      {{2, 3, 4, 5}, {0, 1, 2, 7, 8}, {3, 4, 5, 6, 7}}};
+  auto const local = field.subgrid(indices);
+
+  BOOST_CHECK(local.is_distributed());
+  BOOST_CHECK(local.shape() == field.shape());
+  BOOST_CHECK_EQUAL(local.field_data().num_elements(), 4 * 5 * 5);
+
+  for (auto const &p : {Utils::Vector3d{-.7, 2.1, -.4},
+                        Utils::Vector3d{-.51, 3.5, -.31}}) {
+    BOOST_CHECK(local.covers(p));
+    BOOST_CHECK(local(p) == field(p));
+    BOOST_CHECK(local.jacobian(p) == field.jacobian(p));
+  }
+
+  /* the stencil needs grid points which aren't stored */
+  for (auto const &p :
+       {Utils::Vector3d{-.85, 2.1, -.4}, Utils::Vector3d{-.7, 2.5, -.4},
+        Utils::Vector3d{-.7, 2.1, 0.8}, Utils::Vector3d{-.7, 4.5, -.4}}) {
+    BOOST_CHECK(not local.covers(p));
+  }
+
+  /* copies keep the index maps */
+  auto const copy = local;
+  BOOST_CHECK(copy.is_distributed());
+  auto const p = Utils::Vector3d{-.6, 3.5, -.2};
+  BOOST_CHECK(copy(p) == field(p));
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE HDF5 field reader test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "io/reader/field_hdf5.hpp"
+
+#include <boost/mpi.hpp>
+
+#include <hdf5.h>
+
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+std::array<hsize_t, 4> const dims = {{4, 3, 5, 2}};
+
+double value(int i, int j, int k, int c) {
+  return 1000. * i + 100. * j + 10. * k + c;
+}
+
+/** Write a (4, 3, 5, 2) field and a 3D dataset with the serial driver. */
+void write_file(std::string const &file_name) {
+  std::vector<double> data;
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 3; j++)
+      for (int k = 0; k < 5; k++)
+        for (int c = 0; c < 2; c++)
+          data.push_back(value(i, j, k, c));
+
+  auto const file =
+      H5Fcreate(file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  BOOST_REQUIRE(file >= 0);
+  for (int ndims : {4, 3}) {
+    auto const space = H5Screate_simple(ndims, dims.data(), nullptr);
+    auto const name = (ndims == 4) ? "/field" : "/flat";
+    auto const dataset = H5Dcreate2(file, name, H5T_NATIVE_DOUBLE, space,
+                                    H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    BOOST_REQUIRE(H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL,
+                           H5P_DEFAULT, data.data()) >= 0);
+    H5Dclose(dataset);
+    H5Sclose(space);
+  }
+  H5Fclose(file);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(read_field) {
+  boost::mpi::communicator world;
+  std::string const file_name = "field_hdf5_test.h5";
+  if (world.rank() == 0) {
+    write_file(file_name);
+  }
+  world.barrier();
+
+  auto const shape = Reader::field_shape(world, file_name, "/field");
+  BOOST_CHECK_EQUAL_COLLECTIONS(shape.begin(), shape.end(), dims.begin(),
+                                dims.end());
+
+  /* every node reads a different selection, with gaps in all directions */
+  std::array<std::vector<int>, 3> const indices = {
+      {{0, 1, 3}, {world.rank() % 3}, {0, 2, 3, 4}}};
+  auto const data = Reader::read_field(world, file_name, "/field", indices);
+  BOOST_REQUIRE_EQUAL(data.size(), 3 * 1 * 4 * 2);
+  auto it = data.begin();
+  for (auto const i : indices[0])
+    for (auto const j : indices[1])
+      for (auto const k : indices[2])
+        for (int c = 0; c < 2; c++)
+          BOOST_CHECK_EQUAL(*it++, value(i, j, k, c));
+
+  /* nodes without grid points take part in the collective read */
+  std::array<std::vector<int>, 3> no_indices = indices;
+  if (world.rank() == 1) {
+    no_indices[1].clear();
+  }
+  auto const partial =
+      Reader::read_field(world, file_name, "/field", no_indices);
+  BOOST_CHECK_EQUAL(partial.size(), (world.rank() == 1) ? 0 : data.size());
+
+  BOOST_CHECK_THROW(Reader::field_shape(world, file_name, "/flat"),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(Reader::field_shape(world, file_name, "/missing"),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(Reader::field_shape(world, "missing.h5", "/field"),
+                    std::runtime_error);
+
+  world.barrier();
+  if (world.rank() == 0) {
+    std::remove(file_name.c_str());
+  }
+}
+
+int main(int argc, char **argv) {
+  boost::mpi::environment mpi_env(argc, argv);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
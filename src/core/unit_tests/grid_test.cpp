@@ -25,9 +25,11 @@
 
 #include <utils/Vector.hpp>
 
+#include <array>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 template <class T> auto const epsilon = std::numeric_limits<T>::epsilon();
 
@@ -232,3 +234,42 @@ BOOST_AUTO_TEST_CASE(regular_decomposition_test) {
         }
   }
 }
+
+BOOST_AUTO_TEST_CASE(balanced_decomposition_test) {
+  auto const box_l = Utils::Vector3d{10, 20, 30};
+  auto box = BoxGeometry();
+  box.set_length(box_l);
+  auto const node_grid = Utils::Vector3i{1, 2, 3};
+  std::array<std::vector<double>, 3> const boundaries{
+      {{}, {}, {0., 0.1, 0.7, 1.}}};
+
+  /* axes without boundaries are split regularly */
+  {
+    for (int i = 0; i < 2; i++) {
+      auto const result =
+          balanced_decomposition(box, {0, 1, i}, node_grid, boundaries);
+      auto const regular = regular_decomposition(box, {0, 1, i}, node_grid);
+      BOOST_CHECK_EQUAL(result.my_left()[0], regular.my_left()[0]);
+      BOOST_CHECK_EQUAL(result.my_left()[1], regular.my_left()[1]);
+      BOOST_CHECK_EQUAL(result.length()[1], regular.length()[1]);
+      auto const &boundary = result.boundary();
+      auto const &regular_boundary = regular.boundary();
+      BOOST_CHECK_EQUAL_COLLECTIONS(boundary.begin(), boundary.end(),
+                                    regular_boundary.begin(),
+                                    regular_boundary.end());
+    }
+  }
+
+  /* the local boxes tile the axis without gaps */
+  {
+    for (int i = 0; i < 3; i++) {
+      auto const result =
+          balanced_decomposition(box, {0, 0, i}, node_grid, boundaries);
+      BOOST_CHECK_EQUAL(result.my_left()[2], boundaries[2][i] * box_l[2]);
+      BOOST_CHECK_GE(result.my_right()[2], boundaries[2][i + 1] * box_l[2]);
+      BOOST_CHECK_CLOSE(result.length()[2],
+                        (boundaries[2][i + 1] - boundaries[2][i]) * box_l[2],
+                        1e-10);
+    }
+  }
+}
@@ -72,3 +72,37 @@ BOOST_AUTO_TEST_CASE(link_cell) {
       ++it;
     }
 }
+
+BOOST_AUTO_TEST_CASE(link_cell_neighbors) {
+  const auto n_part_per_cell = 5;
+
+  /* cell 0 has cells 1 and 2 as red neighbors */
+  std::vector<Cell> cells(3);
+  std::vector<Cell *> const red_neighbors{&cells[1], &cells[2]};
+  std::vector<Cell *> const black_neighbors;
+  cells[0].m_neighbors = Neighbors<Cell *>(red_neighbors, black_neighbors);
+
+  auto id = 0;
+  for (auto &c : cells) {
+    c.particles().resize(n_part_per_cell);
+    for (auto &p : c.particles()) {
+      p.p.identity = id++;
+    }
+  }
+
+  std::vector<std::pair<int, int>> lc_pairs;
+  Algorithm::link_cell_neighbors(
+      cells.begin(), std::next(cells.begin()),
+      [&lc_pairs](Particle const &p1, Particle const &p2) {
+        lc_pairs.emplace_back(p1.p.identity, p2.p.identity);
+      });
+
+  /* only the pairs with the neighbors, not within cell 0 */
+  BOOST_REQUIRE_EQUAL(lc_pairs.size(), n_part_per_cell * 2 * n_part_per_cell);
+  auto it = lc_pairs.begin();
+  for (int i = 0; i < n_part_per_cell; i++)
+    for (int j = n_part_per_cell; j < 3 * n_part_per_cell; j++) {
+      BOOST_CHECK((it->first == i) && (it->second == j));
+      ++it;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Load balancing test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "load_balancing.hpp"
+
+#include <cstddef>
+#include <vector>
+
+using LoadBalancing::balance_boundaries;
+
+BOOST_AUTO_TEST_CASE(balanced_load) {
+  /* an even load does not move the boundaries */
+  std::vector<double> const boundaries{0., 0.25, 0.5, 0.75, 1.};
+  auto const result =
+      balance_boundaries(boundaries, {2., 2., 2., 2.}, 0.01, 1.);
+  for (std::size_t i = 0; i < boundaries.size(); i++) {
+    BOOST_CHECK_CLOSE(result[i], boundaries[i], 1e-12);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(uneven_load) {
+  std::vector<double> const boundaries{0., 0.5, 1.};
+
+  /* the load is assumed to be uniform within a slab */
+  {
+    auto const result = balance_boundaries(boundaries, {3., 1.}, 0.01, 1.);
+    BOOST_CHECK_EQUAL(result.front(), 0.);
+    BOOST_CHECK_CLOSE(result[1], 1. / 3., 1e-12);
+    BOOST_CHECK_EQUAL(result.back(), 1.);
+  }
+
+  /* relaxation */
+  {
+    auto const result = balance_boundaries(boundaries, {3., 1.}, 0.01, 0.5);
+    BOOST_CHECK_CLOSE(result[1], 0.5 * (0.5 + 1. / 3.), 1e-12);
+  }
+
+  /* empty slabs are skipped */
+  {
+    auto const result = balance_boundaries({0., 0.25, 0.5, 0.75, 1.},
+                                           {0., 4., 0., 4.}, 0.01, 1.);
+    BOOST_CHECK_CLOSE(result[1], 0.375, 1e-12);
+    BOOST_CHECK_CLOSE(result[2], 0.5, 1e-12);
+    BOOST_CHECK_CLOSE(result[3], 0.875, 1e-12);
+  }
+
+  /* no load, no change */
+  {
+    auto const result = balance_boundaries(boundaries, {0., 0.}, 0.01, 1.);
+    BOOST_CHECK(result == boundaries);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(minimal_width) {
+  /* all load in the first slab */
+  std::vector<double> const boundaries{0., 0.25, 0.5, 0.75, 1.};
+  auto const min_width = 0.1;
+  auto const result =
+      balance_boundaries(boundaries, {1., 0., 0., 0.}, min_width, 1.);
+  BOOST_CHECK_EQUAL(result.front(), 0.);
+  BOOST_CHECK_EQUAL(result.back(), 1.);
+  for (std::size_t i = 1; i < result.size(); i++) {
+    BOOST_CHECK_GE(result[i] - result[i - 1], min_width - 1e-12);
+  }
+  BOOST_CHECK_CLOSE(result[1], 0.1, 1e-12);
+  BOOST_CHECK_CLOSE(result[2], 0.2, 1e-12);
+  BOOST_CHECK_CLOSE(result[3], 0.3, 1e-12);
+}
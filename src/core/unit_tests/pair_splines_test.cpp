@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Pair splines test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "nonbonded_interactions/pair_splines.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <utility>
+
+namespace {
+/* Lennard-Jones with a kink at the switching distance 1.5 */
+double force_factor(double r) {
+  if (r < 1.5)
+    return 48. * (std::pow(r, -14) - 0.5 * std::pow(r, -8));
+  return 0.2 / r;
+}
+
+double energy(double r) {
+  if (r < 1.5)
+    return 4. * (std::pow(r, -12) - std::pow(r, -6));
+  return 0.2 * (2.5 - r) + 4. * (std::pow(1.5, -12) - std::pow(1.5, -6)) -
+         0.2;
+}
+
+/* largest relative deviations of the spline at random distances */
+std::pair<double, double> max_deviation(PairSpline const &spline,
+                                        double r_min, double r_max) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(r_min, r_max);
+  auto force_error = 0., energy_error = 0.;
+  for (int i = 0; i < 10000; i++) {
+    auto const r = dist(rng);
+    double t = 0.;
+    if (auto const interval = spline.find(r * r, t)) {
+      force_error = std::max(
+          force_error,
+          std::abs(PairSpline::evaluate(interval->force_factor, t) -
+                   force_factor(r)));
+      energy_error = std::max(
+          energy_error,
+          std::abs(PairSpline::evaluate(interval->energy, t) - energy(r)));
+    }
+  }
+  return {force_error / std::abs(force_factor(r_min)),
+          energy_error / std::abs(energy(r_min))};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(tolerance) {
+  auto const r_min = 0.9, r_max = 2.5;
+  std::size_t size = 0;
+  for (auto const tolerance : {1e-4, 1e-6, 1e-8}) {
+    auto const spline = make_pair_spline(force_factor, energy, r_min, r_max,
+                                         {1.5, 0.5, 3.}, tolerance);
+    BOOST_REQUIRE(spline);
+    BOOST_CHECK_GT(spline->size(), size);
+    size = spline->size();
+    auto const deviation = max_deviation(*spline, r_min, r_max);
+    BOOST_CHECK_LE(deviation.first, tolerance);
+    BOOST_CHECK_LE(deviation.second, tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ranges) {
+  auto const r_min = 0.9, r_max = 2.5;
+  auto const spline =
+      make_pair_spline(force_factor, energy, r_min, r_max, {1.5}, 1e-6);
+  BOOST_REQUIRE(spline);
+  BOOST_CHECK_EQUAL(spline->dist2_min(), r_min * r_min);
+  BOOST_CHECK_EQUAL(spline->dist2_max(), r_max * r_max);
+  double t = 0.;
+  /* below the tabulated range and around the kink */
+  BOOST_CHECK(not spline->find(0.8 * 0.8, t));
+  BOOST_CHECK(not spline->find(1.5 * 1.5, t));
+  /* at and beyond the cutoff */
+  for (auto const r : {r_max, 2.6, 10.}) {
+    auto const interval = spline->find(r * r, t);
+    BOOST_REQUIRE(interval);
+    BOOST_CHECK_EQUAL(PairSpline::evaluate(interval->force_factor, t), 0.);
+    BOOST_CHECK_EQUAL(PairSpline::evaluate(interval->energy, t), 0.);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(failure) {
+  /* an undeclared kink needs more intervals */
+  BOOST_CHECK(not make_pair_spline(force_factor, energy, 0.9, 2.5, {}, 1e-6,
+                                   128));
+  BOOST_CHECK(make_pair_spline(force_factor, energy, 0.9, 2.5, {1.5}, 1e-6,
+                               PAIR_SPLINE_MAX_INTERVALS));
+  /* singular functions */
+  auto const inf = [](double) {
+    return std::numeric_limits<double>::infinity();
+  };
+  BOOST_CHECK(not make_pair_spline(inf, energy, 0.9, 2.5, {1.5}, 1e-6));
+}
@@ -26,10 +26,12 @@
 #include "random.hpp"
 #include "random_test.hpp"
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <tuple>
 #include <vector>
 
@@ -181,3 +183,46 @@ BOOST_AUTO_TEST_CASE(test_uncorrelated_consecutive_seeds) {
   BOOST_CHECK_SMALL(std::abs(correlation[x][z]), 1e-2);
   BOOST_CHECK_SMALL(std::abs(correlation[y][z]), 1e-2);
 }
+
+BOOST_AUTO_TEST_CASE(test_batched_noise) {
+  // the batched generators reproduce the bits of the scalar generators,
+  // across several blocks and with or without second keys
+  constexpr uint64_t counter = 42;
+  constexpr uint32_t seed = 7;
+  std::vector<int> key1(150), key2(150);
+  for (int i = 0; i < 150; ++i) {
+    key1[i] = 3 * i - 10;
+    key2[i] = 150 - i;
+  }
+
+  std::vector<Random::detail::philox_4x64> integers(key1.size());
+  std::vector<Utils::Vector3d> uniform(key1.size()), gaussian(key1.size());
+  std::vector<Utils::VectorXd<1>> gaussian_1d(key1.size());
+
+  Random::philox_4_uint64s<RNGSalt::LANGEVIN>(counter, seed, key1, key2,
+                                              Utils::make_span(integers));
+  Random::noise_uniform<RNGSalt::LANGEVIN>(counter, seed, key1, key2,
+                                           Utils::make_span(uniform));
+  Random::noise_gaussian<RNGSalt::BROWNIAN_WALK>(counter, seed, key1, {},
+                                                 Utils::make_span(gaussian));
+  Random::noise_gaussian<RNGSalt::BROWNIAN_INC, 1>(
+      counter, seed, key1, key2, Utils::make_span(gaussian_1d));
+
+  for (std::size_t i = 0; i < key1.size(); ++i) {
+    auto const ref_integers = Random::philox_4_uint64s<RNGSalt::LANGEVIN>(
+        counter, seed, key1[i], key2[i]);
+    auto const ref_uniform = Random::noise_uniform<RNGSalt::LANGEVIN>(
+        counter, seed, key1[i], key2[i]);
+    auto const ref_gaussian =
+        Random::noise_gaussian<RNGSalt::BROWNIAN_WALK>(counter, seed, key1[i]);
+    auto const ref_gaussian_1d =
+        Random::noise_gaussian<RNGSalt::BROWNIAN_INC, 1>(counter, seed,
+                                                         key1[i], key2[i]);
+    for (std::size_t j = 0; j < 4; ++j) {
+      BOOST_CHECK_EQUAL(integers[i][j], ref_integers[j]);
+    }
+    BOOST_CHECK(uniform[i] == ref_uniform);
+    BOOST_CHECK(gaussian[i] == ref_gaussian);
+    BOOST_CHECK(gaussian_1d[i] == ref_gaussian_1d);
+  }
+}
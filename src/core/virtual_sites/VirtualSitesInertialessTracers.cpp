@@ -22,6 +22,7 @@
 #include "VirtualSitesInertialessTracers.hpp"
 #include "cells.hpp"
 #include "errorhandling.hpp"
+#include "fused_observables.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "virtual_sites/lb_inertialess_tracers.hpp"
 #include <algorithm>
@@ -50,6 +51,8 @@ void VirtualSitesInertialessTracers::after_force_calc() {
 void VirtualSitesInertialessTracers::after_lb_propagation() {
 #ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
   IBM_UpdateParticlePositions(cell_structure.local_particles());
+  /* the tracers moved since the force calculation */
+  fused_observables.invalidate();
 #endif // VS inertialess tracers
 }
 #endif
@@ -29,6 +29,10 @@ class MeanVarianceCalculator(ScriptInterfaceHelper):
     obs : :class:`espressomd.observables.Observable`
     delta_N : :obj:`int`
         Number of timesteps between subsequent samples for the auto update mechanism.
+    distributed : :obj:`bool`, optional
+        Evaluate the observable and keep the statistics on the nodes which
+        own the particles, see :ref:`Distributed accumulators`. Defaults
+        to ``False``.
 
     Methods
     -------
@@ -75,6 +79,21 @@ class TimeSeries(ScriptInterfaceHelper):
     obs : :class:`espressomd.observables.Observable`
     delta_N : :obj:`int`
         Number of timesteps between subsequent samples for the auto update mechanism.
+    buffer_size : :obj:`int`, optional
+        Maximal number of samples kept in memory. When the buffer is full,
+        it is written to ``filename``, or, without ``filename``, the oldest
+        samples are dropped. Defaults to 0, which keeps all samples in
+        memory.
+    filename : :obj:`str`, optional
+        File for the samples which don't fit into the buffer. The samples
+        are stored as native double precision numbers, sample by sample.
+        The file is overwritten by the first samples written to it.
+        :meth:`time_series` reads the whole file into memory.
+    distributed : :obj:`bool`, optional
+        Evaluate the observable and keep the samples on the nodes which
+        own the particles, see :ref:`Distributed accumulators`. Every node
+        writes the samples of its particles to its own file, with the
+        rank appended to ``filename``. Defaults to ``False``.
 
     Methods
     -------
@@ -99,6 +118,132 @@ class TimeSeries(ScriptInterfaceHelper):
         return np.array(self.call_method("time_series")).reshape(self.shape())
 
 
+@script_interface_register
+class BlockAverage(ScriptInterfaceHelper):
+
+    """
+    Mean of an observable, with the standard error of the mean of
+    correlated samples estimated by block averaging
+    :cite:`flyvbjerg89a`.
+
+    The samples are averaged over blocks of 1, 2, 4, ... samples. The
+    memory doesn't grow with the number of samples beyond one set of
+    averages per block size.
+
+    Parameters
+    ----------
+    obs : :class:`espressomd.observables.Observable`
+    delta_N : :obj:`int`
+        Number of timesteps between subsequent samples for the auto update mechanism.
+    distributed : :obj:`bool`, optional
+        Evaluate the observable and keep the statistics on the nodes which
+        own the particles, see :ref:`Distributed accumulators`. Defaults
+        to ``False``.
+
+    Methods
+    -------
+    update()
+        Update the accumulator (get the current values from the observable).
+
+    """
+    _so_name = "Accumulators::BlockAverage"
+    _so_bind_methods = (
+        "update",
+        "shape",
+    )
+    _so_creation_policy = "LOCAL"
+
+    def mean(self):
+        """
+        Returns the mean values of the observable.
+        """
+        return np.array(self.call_method("mean")).reshape(self.shape())
+
+    def std_error(self):
+        """
+        Returns the standard error of the mean, the largest estimate
+        of the block sizes with at least 32 blocks. It is reliable when
+        the estimates of the large block sizes agree, see
+        :meth:`block_errors`.
+        """
+        return np.array(self.call_method("std_error")).reshape(self.shape())
+
+    def block_errors(self):
+        """
+        Returns the standard error of the mean estimated from the block
+        averages, for each block size in :meth:`block_sizes`.
+        """
+        return np.array(self.call_method("block_errors")).reshape(
+            [-1] + list(self.shape()))
+
+    def block_sizes(self):
+        """
+        Returns the block sizes of :meth:`block_errors`.
+        """
+        return 2**np.arange(self.block_errors().shape[0])
+
+
+@script_interface_register
+class RunningHistogram(ScriptInterfaceHelper):
+
+    """
+    Histogram of each value of an observable. The memory doesn't grow with
+    the number of samples.
+
+    Parameters
+    ----------
+    obs : :class:`espressomd.observables.Observable`
+    delta_N : :obj:`int`
+        Number of timesteps between subsequent samples for the auto update mechanism.
+    n_bins : :obj:`int`
+        Number of bins, shared by all values of the observable.
+    range : (2,) array_like of :obj:`float`
+        Lower and upper limit of the bins. The upper limit belongs to the
+        last bin, values outside of the range are only counted, see
+        :meth:`outliers`.
+    distributed : :obj:`bool`, optional
+        Evaluate the observable and keep the histograms on the nodes which
+        own the particles, see :ref:`Distributed accumulators`. Defaults
+        to ``False``.
+
+    Methods
+    -------
+    update()
+        Update the accumulator (get the current values from the observable).
+    clear()
+        Clear the data
+
+    """
+    _so_name = "Accumulators::RunningHistogram"
+    _so_bind_methods = (
+        "update",
+        "shape",
+        "clear"
+    )
+    _so_creation_policy = "LOCAL"
+
+    def histogram(self):
+        """
+        Returns the counts of the bins, with the shape of the observable
+        followed by the bins.
+        """
+        return np.array(self.call_method("histogram")).reshape(self.shape())
+
+    def outliers(self):
+        """
+        Returns the number of values below and above the range, with the
+        shape of the observable followed by the two counts.
+        """
+        return np.array(self.call_method("outliers")).reshape(
+            list(self.shape()[:-1]) + [2])
+
+    def bin_edges(self):
+        """
+        Returns the edges of the bins.
+        """
+        return np.linspace(self.range[0], self.range[1], self.n_bins + 1)
+
+
 @script_interface_register
 class Correlator(ScriptInterfaceHelper):
 
@@ -255,6 +400,30 @@ class Correlator(ScriptInterfaceHelper):
         update these weights with ``obs.args = [...]``, you'll have to
         provide already squared values! Other correlation operations
         will ignore these values.
+
+    method : :obj:`str`, optional
+        The correlation algorithm:
+
+        * ``"multi_tau"``: (default value) the multiple tau correlator
+
+        * ``"fft"``: all lag times up to ``tau_max`` are computed blockwise
+          with fast Fourier transforms, which is much faster than the
+          linear correlator for large ``tau_max``. Requires
+          ``tau_max <= dt * delta_N * tau_lin``. Not available for
+          ``"fcs_acf"``.
+
+    distributed : :obj:`bool`, optional
+        Sample and correlate the observables on the nodes that own the
+        particles instead of on the head node. Only available for the
+        per-particle observables
+        :class:`espressomd.observables.ParticlePositions`,
+        :class:`espressomd.observables.ParticleVelocities`,
+        :class:`espressomd.observables.ParticleForces`,
+        :class:`espressomd.observables.ParticleAngularVelocities`,
+        :class:`espressomd.observables.ParticleBodyVelocities` and
+        :class:`espressomd.observables.ParticleBodyAngularVelocities`
+        of the same particles, and not for ``"tensor_product"``.
+        Defaults to ``False``.
     """
 
     _so_name = "Accumulators::Correlator"
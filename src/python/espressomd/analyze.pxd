@@ -24,6 +24,7 @@ import numpy as np
 from .utils cimport Vector3i, Vector3d, Vector9d, Span
 from .utils cimport create_nparray_from_double_span
 from libcpp.vector cimport vector  # import std::vector as vector
+from libcpp.utility cimport pair
 from libcpp cimport bool as cbool
 
 cdef extern from "<array>" namespace "std" nogil:
@@ -60,11 +61,14 @@ cdef extern from "Observable_stat.hpp":
         Span[double] non_bonded_inter_contribution(int type1, int type2)
         size_t chunk_size()
 
+cdef extern from "spatial_queries.hpp":
+    cdef double mpi_mindist(const vector[int] & set1, const vector[int] & set2)
+    cdef vector[int] mpi_nbhood(const Vector3d & pos, double r_catch, const Vector3i & planedims)
+    cdef vector[pair[double, int]] mpi_k_nearest(const Vector3d & pos, int k, int pid)
+
 cdef extern from "statistics.hpp":
     cdef vector[double] calc_structurefactor(PartCfg & , const vector[int] & p_types, int order)
     cdef vector[vector[double]] modify_stucturefactor(int order, double * sf)
-    cdef double mindist(PartCfg & , const vector[int] & set1, const vector[int] & set2)
-    cdef vector[int] nbhood(PartCfg & , const Vector3d & pos, double r_catch, const Vector3i & planedims)
     cdef vector[double] calc_linear_momentum(int include_particles, int include_lbfluid)
     cdef vector[double] centerofmass(PartCfg & , int part_type)
 
@@ -20,6 +20,7 @@
 include "myconfig.pxi"
 from . cimport analyze
 from libcpp.vector cimport vector  # import std::vector as vector
+from libcpp.utility cimport pair
 from libcpp cimport bool as cbool
 from .interactions cimport bonded_ia_params_is_type
 from .interactions cimport bonded_ia_params_size
@@ -236,7 +237,7 @@ class Analysis:
         """
 
         if p1 == 'default' and p2 == 'default':
-            return analyze.mindist(analyze.partCfg(), [], [])
+            return analyze.mpi_mindist([], [])
         elif p1 == 'default' or p2 == 'default':
             raise ValueError("Both p1 and p2 have to be specified")
         else:
@@ -250,7 +251,7 @@ class Analysis:
                     raise TypeError(
                         f"Particle types in p2 have to be of type int, got: {repr(p2[i])}")
 
-            return analyze.mindist(analyze.partCfg(), p1, p2)
+            return analyze.mpi_mindist(p1, p2)
 
     #
     # Analyze Linear Momentum
@@ -355,7 +356,51 @@ class Analysis:
         for i in range(3):
             c_pos[i] = pos[i]
 
-        return analyze.nbhood(analyze.partCfg(), c_pos, r_catch, planedims)
+        return analyze.mpi_nbhood(c_pos, r_catch, planedims)
+
+    def k_nearest(self, pos=None, k=None, pid=None):
+        """
+        Get the particles closest to a position.
+
+        Parameters
+        ----------
+        pos : array of :obj:`float`
+            Reference position.
+        k : :obj:`int`
+            Number of particles to find.
+        pid : :obj:`int`, optional
+            Id of a particle to omit, e.g. the particle at ``pos``.
+
+        Returns
+        -------
+        ids : array of :obj:`int`
+            Ids of the at most ``k`` closest particles, sorted by distance.
+        distances : array of :obj:`float`
+            Distances of these particles to ``pos``.
+
+        """
+
+        cdef Vector3d c_pos
+        cdef vector[pair[double, int]] nearest
+
+        check_type_or_throw_except(
+            pos, 3, float, "pos=(float,float,float) must be passed to k_nearest")
+        check_type_or_throw_except(
+            k, 1, int, "k=int needs to be passed to k_nearest")
+        if k < 0:
+            raise ValueError("k has to be >= 0")
+        if pid is None:
+            pid = -1
+        else:
+            check_type_or_throw_except(pid, 1, int, "pid has to be an int")
+
+        for i in range(3):
+            c_pos[i] = pos[i]
+
+        nearest = analyze.mpi_k_nearest(c_pos, k, pid)
+        ids = np.array([n.second for n in nearest], dtype=int)
+        distances = np.array([n.first for n in nearest], dtype=float)
+        return ids, distances
 
     def pressure(self):
         """Calculate the instantaneous pressure (in parallel). This is only
@@ -42,11 +42,41 @@ cdef extern from "cells.hpp":
     vector[int] mpi_resort_particles(int global_flag)
     void mpi_bcast_cell_structure(int cs)
     void mpi_set_use_verlet_lists(bool use_verlet_lists)
+    void mpi_set_domain_decomposition_parameters(bool eighth_shell, int cells_per_range) except +
+
+cdef extern from "<array>" namespace "std" nogil:
+    cdef cppclass boundaries_array "std::array<std::vector<double>, 3>":
+        vector[double] & operator[](size_t)
+
+cdef extern from "grid.hpp":
+    boundaries_array node_boundaries
+
+cdef extern from "load_balancing.hpp" namespace "LoadBalancing":
+    ctypedef enum Metric "LoadBalancing::Metric":
+        PARTICLES "LoadBalancing::Metric::PARTICLES"
+        FORCE_TIME "LoadBalancing::Metric::FORCE_TIME"
+
+    cdef cppclass Parameters:
+        int interval
+        Metric metric
+        double tolerance
+        double relaxation
+
+    const Parameters & parameters()
+    void mpi_set_parameters(int interval, Metric metric, double tolerance, double relaxation) except +
+    double mpi_rebalance()
+    void mpi_reset() except +
+    double last_imbalance()
 
 cdef extern from "tuning.hpp":
     cdef void c_tune_skin "tune_skin" (double min_skin, double max_skin, double tol, int int_steps, bool adjust_max_skin)
 
 cdef extern from "DomainDecomposition.hpp":
+    cppclass DomainDecompositionParameters:
+        bool eighth_shell
+        int cells_per_range
+
     cppclass  DomainDecomposition:
         Vector3i cell_grid
         double cell_size[3]
+        DomainDecompositionParameters params
@@ -25,12 +25,17 @@ from .globals cimport verlet_reuse, skin
 from .globals cimport mpi_bcast_parameter
 from libcpp.vector cimport vector
 from .cellsystem cimport cell_structure
+from .cellsystem cimport node_boundaries
+from .cellsystem cimport Parameters, parameters, PARTICLES, FORCE_TIME
+from .cellsystem cimport mpi_set_parameters, mpi_rebalance, mpi_reset
+from .cellsystem cimport last_imbalance
 from .utils import handle_errors
 from .utils cimport Vector3i, check_type_or_throw_except
 
 
 cdef class CellSystem:
-    def set_domain_decomposition(self, use_verlet_lists=True):
+    def set_domain_decomposition(self, use_verlet_lists=True,
+                                 eighth_shell=False, cells_per_range=1):
         """
         Activates domain decomposition cell system.
 
@@ -39,9 +44,19 @@ cdef class CellSystem:
         use_verlet_lists : :obj:`bool`, optional
             Activates or deactivates the usage of Verlet lists
             in the algorithm.
+        eighth_shell : :obj:`bool`, optional
+            Import ghost particles only from the upper neighbors,
+            which halves the ghost volume. Only supports pair
+            interactions.
+        cells_per_range : :obj:`int`, optional
+            Number of cells per interaction range. Smaller cells
+            reduce the number of pair distances to evaluate.
 
         """
+        check_type_or_throw_except(
+            cells_per_range, 1, int, "cells_per_range must be an integer")
         mpi_set_use_verlet_lists(use_verlet_lists)
+        mpi_set_domain_decomposition_parameters(eighth_shell, cells_per_range)
         mpi_bcast_cell_structure(CELL_STRUCTURE_DOMDEC)
 
         handle_errors("Error while initializing the cell system.")
@@ -73,6 +88,8 @@ cdef class CellSystem:
                 [dd.cell_grid[0], dd.cell_grid[1], dd.cell_grid[2]])
             s["cell_size"] = np.array(
                 [dd.cell_size[0], dd.cell_size[1], dd.cell_size[2]])
+            s["eighth_shell"] = dd.params.eighth_shell
+            s["cells_per_range"] = dd.params.cells_per_range
 
         if cell_structure.decomposition_type() == CELL_STRUCTURE_NSQUARE:
             s["type"] = "nsquare"
@@ -81,6 +98,9 @@ cdef class CellSystem:
         s["verlet_reuse"] = verlet_reuse
         s["n_nodes"] = n_nodes
         s["node_grid"] = np.array([node_grid[0], node_grid[1], node_grid[2]])
+        s["node_boundaries"] = self.node_boundaries
+        s["load_balancing"] = self.get_load_balancing()
+        s["load_imbalance"] = last_imbalance()
 
         return s
 
@@ -88,12 +108,16 @@ cdef class CellSystem:
         s = {"use_verlet_list": cell_structure.use_verlet_list}
 
         if cell_structure.decomposition_type() == CELL_STRUCTURE_DOMDEC:
+            dd = get_domain_decomposition()
             s["type"] = "domain_decomposition"
+            s["eighth_shell"] = dd.params.eighth_shell
+            s["cells_per_range"] = dd.params.cells_per_range
         if cell_structure.decomposition_type() == CELL_STRUCTURE_NSQUARE:
             s["type"] = "nsquare"
 
         s["skin"] = skin
         s["node_grid"] = np.array([node_grid[0], node_grid[1], node_grid[2]])
+        s["load_balancing"] = self.get_load_balancing()
         return s
 
     def __setstate__(self, d):
@@ -104,11 +128,15 @@ cdef class CellSystem:
             elif key == "type":
                 if d[key] == "domain_decomposition":
                     self.set_domain_decomposition(
-                        use_verlet_lists=use_verlet_lists)
+                        use_verlet_lists=use_verlet_lists,
+                        eighth_shell=d.get("eighth_shell", False),
+                        cells_per_range=d.get("cells_per_range", 1))
                 elif d[key] == "nsquare":
                     self.set_n_square(use_verlet_lists=use_verlet_lists)
         self.skin = d['skin']
         self.node_grid = d['node_grid']
+        if 'load_balancing' in d:
+            self.set_load_balancing(**d['load_balancing'])
 
     def get_pairs(self, distance, types='all'):
         """
@@ -175,6 +203,85 @@ cdef class CellSystem:
 
         return mpi_resort_particles(int(global_flag))
 
+    def set_load_balancing(self, interval=100, metric="particles",
+                           tolerance=0.1, relaxation=0.5):
+        """
+        Balance the load of the domain decomposition by moving the
+        boundaries between the nodes along each axis of the node grid.
+        All nodes in a slab of the node grid share the same boundaries.
+
+        Parameters
+        ----------
+        interval : :obj:`int`
+            Number of integration steps between two rebalancing attempts,
+            0 disables the automatic rebalancing.
+        metric : :obj:`str`, \{'particles', 'force_time'\}
+            Measure of the load of a node: the number of local particles,
+            or the time spent in the short-range force calculation.
+        tolerance : :obj:`float`
+            The boundaries are only moved if the ratio of the maximal to
+            the mean load exceeds ``1 + tolerance``.
+        relaxation : :obj:`float`
+            Fraction of the way towards the balanced boundaries that is
+            moved in one rebalancing, in (0, 1].
+
+        """
+        if metric not in ("particles", "force_time"):
+            raise ValueError("metric must be one of particles, force_time")
+        check_type_or_throw_except(
+            interval, 1, int, "interval must be an integer")
+        cdef Metric c_metric = PARTICLES
+        if metric == "force_time":
+            c_metric = FORCE_TIME
+        mpi_set_parameters(interval, c_metric, tolerance, relaxation)
+
+    def get_load_balancing(self):
+        """
+        Parameters of the load balancer, see :meth:`set_load_balancing`.
+
+        """
+        cdef Parameters params = parameters()
+        return {"interval": params.interval,
+                "metric": "force_time" if params.metric == FORCE_TIME
+                else "particles",
+                "tolerance": params.tolerance,
+                "relaxation": params.relaxation}
+
+    def rebalance(self):
+        """
+        Move the boundaries between the nodes now, regardless of the
+        tolerance. Only supported for the domain decomposition, and
+        neither with lattice-Boltzmann nor with P3M or ScaFaCoS.
+
+        Returns
+        -------
+        :obj:`float` :
+            Ratio of the maximal to the mean node load before the
+            rebalancing.
+
+        """
+        imbalance = mpi_rebalance()
+        handle_errors("Error during load balancing")
+        return imbalance
+
+    def reset_node_boundaries(self):
+        """
+        Restore the regular decomposition into subdomains of equal size.
+
+        """
+        mpi_reset()
+        handle_errors("Error while resetting the node boundaries")
+
+    property node_boundaries:
+        """
+        Boundaries between the nodes along each axis, in units of the box
+        length. An empty list means the axis is split regularly.
+
+        """
+
+        def __get__(self):
+            return [list(node_boundaries[i]) for i in range(3)]
+
     # setter deprecated
     property node_grid:
         """
@@ -16,12 +16,15 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
+from libcpp cimport bool
 from libcpp.memory cimport shared_ptr
 from boost cimport environment
 
 cdef extern from "MpiCallbacks.hpp" namespace "Communication":
     cppclass MpiCallbacks:
-        pass
+        void set_deferred(bool) except +
+        bool deferred()
+        void flush() except +
 
 cdef extern from "communication.hpp":
     shared_ptr[environment] mpi_init()
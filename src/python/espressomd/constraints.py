@@ -98,6 +98,13 @@ class ShapeBasedConstraint(Constraint):
 
     Attributes
     ----------
+    distance_grid_spacing : :obj:`float`
+        If positive, the distance to the shape is tabulated on a grid
+        with this spacing on the local box of each MPI rank and
+        interpolated linearly, which is faster for complex shapes, e.g.
+        unions of many shapes. Positions where the interpolation isn't
+        reliable are evaluated on the shape. Defaults to 0, i.e. the
+        distance is always evaluated on the shape.
     only_positive : :obj:`bool`
         Act only in the direction of positive normal,
         only useful if penetrable is ``True``.
@@ -214,12 +221,28 @@ class _Interpolated(Constraint):
     box + 0.5 * grid_spacing. There are convenience functions on this
     class that can calculate the required grid dimensions and the coordinates.
 
+    A distributed field only keeps the grid points on each MPI rank
+    which are needed within ``halo`` of the local box of that rank.
+    The field can also be read from a dataset of shape (M, N, O, P)
+    in an HDF5 file, in which case every rank reads only its part
+    of the grid. This requires the feature ``H5MD``.
+
     Arguments
     ----------
     field : (M, N, O, P) array_like of :obj:`float`
         The actual field on a grid of size (M, N, O) with dimension P.
+    file : :obj:`str`, optional
+        Path to an HDF5 file to read the field from instead of ``field``.
+    dataset : :obj:`str`, optional
+        Path of the field in ``file``.
     grid_spacing : (3,) array_like of :obj:`float`
         Spacing of the grid points.
+    distributed : :obj:`bool`, optional
+        Whether each rank only keeps the grid points near its local box.
+        Defaults to ``False``.
+    halo : :obj:`float`, optional
+        Distance beyond the local box up to which a distributed field can
+        be evaluated. Defaults to the current skin.
 
     Attributes
     ----------
@@ -228,23 +251,30 @@ class _Interpolated(Constraint):
         The actual field on a grid of size (M, N, O) with dimension P.
         Please be aware that depending on the interpolation
         order additional points are used on the boundaries.
+        Not available for distributed fields.
 
     grid_spacing : array_like of :obj:`float`
         Spacing of the grid points.
 
+    distributed : :obj:`bool`
+        Whether each rank only keeps the grid points near its local box.
+
     origin : (3,) array_like of :obj:`float`
         Coordinates of the grid origin.
 
     """
 
     def __init__(self, **kwargs):
-        if "sip" not in kwargs:
+        if "sip" in kwargs:
+            super().__init__(**kwargs)
+        elif "file" in kwargs:
+            super().__init__(_field_file=kwargs.pop("file"),
+                             _field_dataset=kwargs.pop("dataset"), **kwargs)
+        else:
             field = kwargs.pop("field")
             shape, codim = self._unpack_dims(field)
             super().__init__(_field_shape=shape, _field_codim=codim,
                              _field_data=field.flatten(), **kwargs)
-        else:
-            super().__init__(**kwargs)
 
     @classmethod
     def required_dims(cls, box_size, grid_spacing):
@@ -323,6 +353,9 @@ class _Interpolated(Constraint):
 
     @property
     def field(self):
+        if self.distributed:
+            raise RuntimeError(
+                "The data of a distributed field is only known piecewise")
         shape = self._field_shape
         return np.reshape(self._field_data,
                           (shape[0], shape[1], shape[2], self._field_codim))
@@ -36,6 +36,7 @@ IF ELECTROSTATICS and P3M:
             vector[Vector3d] normals
             Vector3d ext_field
             double relax
+            int anderson_depth
             int citeration
             int first_id
 
@@ -43,8 +44,8 @@ IF ELECTROSTATICS and P3M:
         cdef extern icc_struct icc_cfg
 
         void icc_set_params(int n_icc, double convergence, double relaxation,
-                            Vector3d & ext_field, int max_iterations,
-                            int first_id, double eps_out,
+                            int anderson_depth, Vector3d & ext_field,
+                            int max_iterations, int first_id, double eps_out,
                             vector[double] & areas,
                             vector[double] & e_in,
                             vector[double] & sigma,
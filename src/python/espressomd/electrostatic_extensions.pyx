@@ -48,7 +48,11 @@ IF ELECTROSTATICS and P3M:
             Abort criteria of the iteration. It corresponds to the maximum relative
             change of any of the interface particle's charge.
         relaxation : :obj:`float`, optional
-            SOR relaxation parameter.
+            SOR relaxation parameter. With Anderson mixing, this is the
+            mixing parameter.
+        anderson_depth : :obj:`int`, optional
+            Number of previous iterations used for Anderson mixing of the
+            induced charges. The default value 0 disables Anderson mixing.
         ext_field : :obj:`float`, optional
             Homogeneous electric field added to the calculation of dielectric boundary forces.
         max_iterations : :obj:`int`, optional
@@ -79,6 +83,9 @@ IF ELECTROSTATICS and P3M:
             check_type_or_throw_except(
                 self._params["relaxation"], 1, float, "")
 
+            check_type_or_throw_except(
+                self._params["anderson_depth"], 1, int, "")
+
             check_type_or_throw_except(
                 self._params["ext_field"], 3, float, "")
 
@@ -111,9 +118,9 @@ IF ELECTROSTATICS and P3M:
                 self._params["epsilons"], n_icc, float, "Error in epsilon list.")
 
         def valid_keys(self):
-            return ["n_icc", "convergence", "relaxation", "ext_field",
-                    "max_iterations", "first_id", "eps_out", "normals",
-                    "areas", "sigmas", "epsilons", "check_neutrality"]
+            return ["n_icc", "convergence", "relaxation", "anderson_depth",
+                    "ext_field", "max_iterations", "first_id", "eps_out",
+                    "normals", "areas", "sigmas", "epsilons", "check_neutrality"]
 
         def required_keys(self):
             return ["n_icc", "normals", "areas", "epsilons"]
@@ -121,6 +128,7 @@ IF ELECTROSTATICS and P3M:
         def default_params(self):
             return {"convergence": 1e-3,
                     "relaxation": 0.7,
+                    "anderson_depth": 0,
                     "ext_field": [0, 0, 0],
                     "max_iterations": 100,
                     "first_id": 0,
@@ -134,6 +142,7 @@ IF ELECTROSTATICS and P3M:
             params["max_iterations"] = icc_cfg.num_iteration
             params["convergence"] = icc_cfg.convergence
             params["relaxation"] = icc_cfg.relax
+            params["anderson_depth"] = icc_cfg.anderson_depth
             params["eps_out"] = icc_cfg.eout
             params["normals"] = make_array_locked_vector(icc_cfg.normals)
             params["areas"] = array_locked(icc_cfg.areas)
@@ -163,6 +172,7 @@ IF ELECTROSTATICS and P3M:
             icc_set_params(self._params["n_icc"],
                            self._params["convergence"],
                            self._params["relaxation"],
+                           self._params["anderson_depth"],
                            ext_field,
                            self._params["max_iterations"],
                            self._params["first_id"],
@@ -27,11 +27,16 @@ cdef extern from "config.hpp":
 
 cdef extern from "integrate.hpp" nogil:
     cdef int python_integrate(int n_steps, cbool recalc_forces, int reuse_forces)
-    cdef int mpi_steepest_descent(int max_steps)
+    cdef int mpi_minimize_energy(int max_steps)
     cdef void integrate_set_sd() except +
     cdef void integrate_set_nvt()
+    cdef void integrate_set_respa(int bonded, int short_range, int long_range) except +
     cdef void integrate_set_steepest_descent(const double f_max, const double gamma,
                                              const double max_displacement) except +
+    cdef void integrate_set_fire(double f_max, double dt_max, double dt_min,
+                                 double max_displacement, int n_delay,
+                                 double f_inc, double f_dec, double alpha_start,
+                                 double f_alpha) except +
     cdef extern cbool skin_set
     cdef extern cbool set_py_interrupt
     cdef void integrate_set_bd()
@@ -42,6 +47,20 @@ IF NPT:
                                               cbool xdir_rescale, cbool ydir_rescale,
                                               cbool zdir_rescale, cbool cubic_box) except +
 
+IF BOND_CONSTRAINT:
+    cdef extern from "rattle.hpp":
+        ctypedef enum ConstraintSolver "ConstraintSolver":
+            RATTLE "ConstraintSolver::RATTLE"
+            LINCS "ConstraintSolver::LINCS"
+
+        cdef cppclass ConstraintSolverParameters:
+            ConstraintSolver solver
+            int lincs_order
+            int lincs_iterations
+
+        const ConstraintSolverParameters & constraint_solver_parameters()
+        void mpi_set_constraint_solver(ConstraintSolver solver, int order, int iterations) except +
+
 IF STOKESIAN_DYNAMICS:
     cdef extern from "stokesian_dynamics/sd_interface.hpp":
         void set_sd_viscosity(double eta) except +
@@ -67,6 +67,14 @@ cdef class IntegratorHandle:
         """
         self._integrator = SteepestDescent(*args, **kwargs)
 
+    def set_fire(self, *args, **kwargs):
+        """
+        Set the integration method to the fast inertial relaxation engine
+        (:class:`FIRE`).
+
+        """
+        self._integrator = FIRE(*args, **kwargs)
+
     def set_vv(self):
         """
         Set the integration method to velocity Verlet, which is suitable for
@@ -83,6 +91,14 @@ cdef class IntegratorHandle:
         """
         self._integrator = VelocityVerlet()
 
+    def set_respa(self, *args, **kwargs):
+        """
+        Set the integration method to the multiple time step velocity Verlet
+        (:class:`VelocityVerletRespa`).
+
+        """
+        self._integrator = VelocityVerletRespa(*args, **kwargs)
+
     def set_isotropic_npt(self, *args, **kwargs):
         """
         Set the integration method to a modified velocity Verlet designed for
@@ -105,6 +121,47 @@ cdef class IntegratorHandle:
         """
         self._integrator = StokesianDynamics(*args, **kwargs)
 
+    IF BOND_CONSTRAINT:
+        def set_constraint_solver(self, solver="RATTLE", order=4,
+                                  iterations=1):
+            """
+            Select the algorithm that enforces rigid bonds
+            (:class:`espressomd.interactions.RigidBond`).
+
+            Parameters
+            ----------
+            solver : :obj:`str`, \{'RATTLE', 'LINCS'\}
+                ``'RATTLE'`` iterates until the bond tolerances are met.
+                ``'LINCS'`` uses a matrix expansion of fixed order, which
+                only needs communication between neighboring nodes.
+            order : :obj:`int`
+                Order of the LINCS matrix expansion.
+            iterations : :obj:`int`
+                Number of LINCS corrections for bond rotation.
+
+            """
+            if solver not in ("RATTLE", "LINCS"):
+                raise ValueError("solver must be one of RATTLE, LINCS")
+            check_type_or_throw_except(
+                order, 1, int, "order must be an integer")
+            check_type_or_throw_except(
+                iterations, 1, int, "iterations must be an integer")
+            cdef ConstraintSolver c_solver = RATTLE
+            if solver == "LINCS":
+                c_solver = LINCS
+            mpi_set_constraint_solver(c_solver, order, iterations)
+
+        def get_constraint_solver(self):
+            """
+            Parameters of the rigid bond algorithm, see
+            :meth:`set_constraint_solver`.
+
+            """
+            cdef ConstraintSolverParameters params = constraint_solver_parameters()
+            return {"solver": "LINCS" if params.solver == LINCS else "RATTLE",
+                    "order": params.lincs_order,
+                    "iterations": params.lincs_iterations}
+
 
 cdef class Integrator:
     """
@@ -278,7 +335,106 @@ cdef class SteepestDescent(Integrator):
         check_type_or_throw_except(steps, 1, int, "steps must be an int")
         assert steps >= 0, "steps has to be positive"
 
-        integrated = mpi_steepest_descent(steps)
+        integrated = mpi_minimize_energy(steps)
+
+        handle_errors("Encountered errors during integrate")
+
+        return integrated
+
+
+cdef class FIRE(Integrator):
+    """
+    Fast inertial relaxation engine (FIRE 2.0) for energy minimization.
+
+    The particles follow damped molecular dynamics with an adaptive time
+    step. The velocities are turned towards the forces as long as the
+    power :math:`P = \\vec{F} \\cdot \\vec{v}` is positive. When it becomes
+    negative, the particles are moved back by half a step, the velocities
+    are set to zero and the time step is reduced. The particle velocities
+    are part of the state of the minimizer.
+
+    Parameters
+    ----------
+    f_max : :obj:`float`
+        Convergence criterion. Minimization stops when the maximal force on
+        particles in the system is lower than this threshold.
+    dt_max : :obj:`float`
+        Maximal time step of the minimizer. The minimization starts with
+        one tenth of this value.
+    max_displacement : :obj:`float`
+        Maximal displacement and rotation angle of a particle per step.
+    dt_min : :obj:`float`, optional
+        Minimal time step of the minimizer, defaults to ``dt_max / 500``.
+    n_delay : :obj:`int`, optional
+        Number of steps with positive power before the time step grows.
+    f_inc : :obj:`float`, optional
+        Growth factor of the time step.
+    f_dec : :obj:`float`, optional
+        Reduction factor of the time step.
+    alpha_start : :obj:`float`, optional
+        Initial mixing coefficient of velocities and forces.
+    f_alpha : :obj:`float`, optional
+        Reduction factor of the mixing coefficient.
+
+    """
+
+    def default_params(self):
+        return {"dt_min": None, "n_delay": 20, "f_inc": 1.1, "f_dec": 0.5,
+                "alpha_start": 0.25, "f_alpha": 0.99}
+
+    def valid_keys(self):
+        """All parameters that can be set.
+
+        """
+        return {"f_max", "dt_max", "dt_min", "max_displacement", "n_delay",
+                "f_inc", "f_dec", "alpha_start", "f_alpha"}
+
+    def required_keys(self):
+        """Parameters that have to be set.
+
+        """
+        return {"f_max", "dt_max", "max_displacement"}
+
+    def validate_params(self):
+        if self._params["dt_min"] is None:
+            self._params["dt_min"] = self._params["dt_max"] / 500.
+        for key in ("f_max", "dt_max", "dt_min", "max_displacement", "f_inc",
+                    "f_dec", "alpha_start", "f_alpha"):
+            check_type_or_throw_except(
+                self._params[key], 1, float, key + " must be a float")
+        check_type_or_throw_except(
+            self._params["n_delay"], 1, int, "n_delay must be an int")
+
+    def _set_params_in_es_core(self):
+        integrate_set_fire(self._params["f_max"],
+                           self._params["dt_max"],
+                           self._params["dt_min"],
+                           self._params["max_displacement"],
+                           self._params["n_delay"],
+                           self._params["f_inc"],
+                           self._params["f_dec"],
+                           self._params["alpha_start"],
+                           self._params["f_alpha"])
+
+    def run(self, steps=1, **kwargs):
+        """
+        Run the minimization.
+
+        Parameters
+        ----------
+        steps : :obj:`int`
+            Maximal number of time steps to integrate.
+
+        Returns
+        -------
+        :obj:`int`
+            Number of integrated steps.
+
+        """
+        check_type_or_throw_except(steps, 1, int, "steps must be an int")
+        assert steps >= 0, "steps has to be positive"
+
+        integrated = mpi_minimize_energy(steps)
 
         handle_errors("Encountered errors during integrate")
 
@@ -313,6 +469,50 @@ cdef class VelocityVerlet(Integrator):
         integrate_set_nvt()
 
 
+cdef class VelocityVerletRespa(Integrator):
+    """
+    Velocity Verlet integrator with multiple time steps (r-RESPA). The
+    forces are split into groups, each group is evaluated every ``n``-th
+    time step and applied as an impulse of ``n`` times its force.
+
+    Parameters
+    ----------
+    bonded : :obj:`int`, optional
+        Time step interval of the bonded forces.
+    short_range : :obj:`int`, optional
+        Time step interval of the short-range non-bonded forces, including
+        the real-space part of electrostatics and magnetostatics.
+    long_range : :obj:`int`, optional
+        Time step interval of the k-space part of the long-range methods.
+
+    """
+
+    def default_params(self):
+        return {"bonded": 1, "short_range": 1, "long_range": 1}
+
+    def valid_keys(self):
+        """All parameters that can be set.
+
+        """
+        return {"bonded", "short_range", "long_range"}
+
+    def required_keys(self):
+        """Parameters that have to be set.
+
+        """
+        return set()
+
+    def validate_params(self):
+        for key in ("bonded", "short_range", "long_range"):
+            check_type_or_throw_except(
+                self._params[key], 1, int, key + " must be an int")
+
+    def _set_params_in_es_core(self):
+        integrate_set_respa(self._params["bonded"],
+                            self._params["short_range"],
+                            self._params["long_range"])
+
+
 IF NPT:
     cdef class VelocityVerletIsotropicNPT(Integrator):
         """
@@ -195,6 +195,15 @@ cdef extern from "nonbonded_interactions/nonbonded_interaction_data.hpp":
     cdef void ia_params_set_state(string)
     cdef void reset_ia_params()
 
+cdef extern from "nonbonded_interactions/pair_splines.hpp":
+    cdef struct PairSplineParameters:
+        cbool active
+        double tolerance
+        double r_min
+
+    const PairSplineParameters & pair_spline_params()
+    void mpi_set_pair_spline_params(cbool active, double tolerance, double r_min)
+
 cdef extern from "bonded_interactions/bonded_interaction_data.hpp":
     cdef void make_bond_type_exist(int type)
 
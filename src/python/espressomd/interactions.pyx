@@ -1653,6 +1653,58 @@ cdef class NonBondedInteractions:
 
         reset_ia_params()
 
+    def tabulate(self, min_dist, tolerance=1e-6):
+        """
+        Tabulate the isotropic pair potentials of all pairs of particle types.
+
+        The forces and energies of the Lennard-Jones, WCA, generic
+        Lennard-Jones, smooth step, Hertzian, Gaussian, BMHTF, Morse,
+        Buckingham, soft-sphere, hat, Lennard-Jones cosine and tabulated
+        potentials of a pair of types are summed into one cubic spline in
+        the squared distance, which the force and energy calculations
+        evaluate instead of the individual potentials. The splines are
+        rebuilt whenever the interactions change.
+
+        Parameters
+        ----------
+        min_dist : :obj:`float`
+            Smallest tabulated distance, has to be positive. Closer pairs
+            are evaluated analytically.
+        tolerance : :obj:`float`, optional
+            Largest deviation of the splines from the forces and energies
+            of the potentials, relative to their largest magnitude in the
+            tabulated range.
+
+        """
+        check_type_or_throw_except(
+            min_dist, 1, float, "min_dist has to be a float")
+        check_type_or_throw_except(
+            tolerance, 1, float, "tolerance has to be a float")
+        if min_dist <= 0.:
+            raise ValueError("min_dist has to be positive")
+        if tolerance <= 0.:
+            raise ValueError("tolerance has to be positive")
+        mpi_set_pair_spline_params(True, tolerance, min_dist)
+
+    def get_tabulation(self):
+        """
+        Parameters of the tabulation of the pair potentials, or ``None``
+        if the potentials are evaluated analytically.
+
+        """
+        cdef PairSplineParameters params = pair_spline_params()
+        if not params.active:
+            return None
+        return {"min_dist": params.r_min, "tolerance": params.tolerance}
+
+    def clear_tabulation(self):
+        """
+        Evaluate the pair potentials analytically.
+
+        """
+        cdef PairSplineParameters params = pair_spline_params()
+        mpi_set_pair_spline_params(False, params.tolerance, params.r_min)
+
 cdef class BondedInteraction:
     """
     Base class for bonded interactions.
@@ -14,6 +14,8 @@
 #
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
+import numpy as np
+
 from ..script_interface import PScriptInterface
 
 
@@ -99,5 +101,104 @@ class Mpiio:
         self._instance.call_method(
             "read", prefix=prefix, pos=positions, vel=velocities, typ=types, bond=bonds)
 
+    def write_checkpoint(self, path):
+        """Write the dynamic state of the system into a single file.
+
+        The checkpoint contains all particle properties including bonds and
+        exclusions, the simulation time, the RNG state of the thermostats
+        and of the LB fluid, and the LB populations. All MPI ranks write
+        their part of the data concurrently. An existing checkpoint is
+        only replaced once the new one has been written completely.
+
+        Static parameters (interactions, thermostat and integrator
+        settings, actors, ...) are not included, they can be stored with
+        :class:`espressomd.checkpointing.Checkpoint`.
+
+        Parameters
+        ----------
+        path : :obj:`str`
+            Checkpoint file name.
+        """
+        self._instance.call_method("write_checkpoint", path=path)
+
+    def read_checkpoint(self, path):
+        """Restore the state written by :meth:`write_checkpoint`.
+
+        All particles are replaced. The number of MPI ranks may differ
+        from the one at the time of writing. If the checkpoint contains an
+        LB fluid, an LB fluid with the same grid has to be set up before.
+
+        Parameters
+        ----------
+        path : :obj:`str`
+            Checkpoint file name.
+        """
+        self._instance.call_method("read_checkpoint", path=path)
+
+    def write_compact(self, prefix=None, precision=1e-3, velocities=False,
+                      vel_precision=1e-3):
+        """Append a frame to a compact trajectory.
+
+        The unfolded positions (and optionally the velocities) are
+        quantized to multiples of ``precision`` and stored delta-encoded
+        in the order of the particle ids, which typically needs 4 to
+        8 bytes per vector instead of 24. Frames are appended to the file
+        ``prefix.ctrj``, their offsets are recorded in the index file
+        ``prefix.cidx``. If no index file exists, a new trajectory is
+        started.
+
+        Parameters
+        ----------
+        prefix : :obj:`str`
+            Common prefix for the filenames.
+        precision : :obj:`float`, optional
+            Quantization step of the positions.
+        velocities : :obj:`bool`, optional
+            Indicates if velocities should be written.
+        vel_precision : :obj:`float`, optional
+            Quantization step of the velocities.
+        """
+        if prefix is None:
+            raise ValueError(
+                "Need to supply output prefix via the 'prefix' argument.")
+        if precision <= 0. or (velocities and vel_precision <= 0.):
+            raise ValueError("The precision has to be positive.")
+        self._instance.call_method(
+            "write_compact", prefix=prefix, precision=precision,
+            vel=velocities, vel_precision=vel_precision)
+
+    def n_compact_frames(self, prefix):
+        """Number of frames in the compact trajectory ``prefix``."""
+        return self._instance.call_method("n_compact_frames", prefix=prefix)
+
+    def read_compact(self, prefix, frame):
+        """Read a frame of a compact trajectory written by
+        :meth:`write_compact`. The frame is located via the index file,
+        so that the cost does not depend on the length of the trajectory.
+
+        Parameters
+        ----------
+        prefix : :obj:`str`
+            Common prefix for the filenames.
+        frame : :obj:`int`
+            Index of the frame, negative values count from the end.
+
+        Returns
+        -------
+        :obj:`dict`
+            With keys ``time``, ``box_l``, ``id`` (sorted), ``pos``
+            (unfolded) and, if they were written, ``v``.
+        """
+        if frame < 0:
+            frame += self.n_compact_frames(prefix)
+        time, box_l, ids, pos, vel = self._instance.call_method(
+            "read_compact", prefix=prefix, frame=frame)
+        data = {"time": time, "box_l": np.array(box_l),
+                "id": np.array(ids, dtype=int),
+                "pos": np.array(pos).reshape((-1, 3))}
+        if len(vel):
+            data["v"] = np.array(vel).reshape((-1, 3))
+        return data
+
 
 mpiio = Mpiio()
@@ -31,6 +31,7 @@ IF DIPOLES == 1:
             DIPOLAR_ALL_WITH_ALL_AND_NO_REPLICA,
             DIPOLAR_DS,
             DIPOLAR_MDLC_DS,
+            DIPOLAR_BH_CPU,
             DIPOLAR_SCAFACOS
 
         ctypedef struct Dipole_parameters:
@@ -48,6 +49,16 @@ IF DIPOLES == 1:
         int mdds_set_params(int n_cut)
         int Ncut_off_magnetic_dipolar_direct_sum
 
+    cdef extern from "electrostatics_magnetostatics/magnetic_barnes_hut.hpp":
+        ctypedef struct DipolarBarnesHut_params:
+            double theta
+            int leaf_size
+            int n_replica
+
+        cdef extern DipolarBarnesHut_params dbh_params
+
+        void dipolar_barnes_hut_set_params(double theta, int leaf_size, int n_replica) except +
+
     IF(CUDA == 1) and (ROTATION == 1):
         cdef extern from "actor/DipolarDirectSum.hpp":
             void activate_dipolar_direct_sum_gpu()
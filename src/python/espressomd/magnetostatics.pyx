@@ -261,6 +261,66 @@ IF DIPOLES == 1:
             handle_errors("Could not activate magnetostatics method "
                           + self.__class__.__name__)
 
+    cdef class DipolarBarnesHutCpu(MagnetostaticInteraction):
+        """
+        Calculate magnetostatic interactions with a Barnes-Hut octree sum.
+        See :ref:`Barnes-Hut octree sum on CPU` for more details.
+
+        If the system has periodic boundaries, ``n_replica`` copies of the
+        system are taken into account in the respective directions, as in
+        :class:`espressomd.magnetostatics.DipolarDirectSumWithReplicaCpu`.
+
+        Parameters
+        ----------
+        prefactor : :obj:`float`
+            Magnetostatics prefactor (:math:`\\mu_0/(4\\pi)`)
+        theta : :obj:`float`, optional
+            Opening angle. A cell of the octree is treated as a single
+            dipole when its edge length is smaller than ``theta`` times
+            its distance to the particle. 0 yields the exact sum.
+        leaf_size : :obj:`int`, optional
+            Maximal number of particles in a leaf of the octree.
+        n_replica : :obj:`int`, optional
+            Number of replicas to be taken into account at periodic
+            boundaries.
+
+        """
+
+        def validate_params(self):
+            super().validate_params()
+            if self._params["theta"] < 0.:
+                raise ValueError("theta should be a non-negative float")
+            if self._params["leaf_size"] < 1:
+                raise ValueError("leaf_size should be a positive integer")
+            if self._params["n_replica"] < 0:
+                raise ValueError("n_replica should be a non-negative integer")
+
+        def default_params(self):
+            return {"theta": 0.5, "leaf_size": 8, "n_replica": 0}
+
+        def required_keys(self):
+            return ()
+
+        def valid_keys(self):
+            return ("prefactor", "theta", "leaf_size", "n_replica")
+
+        def _get_params_from_es_core(self):
+            return {"prefactor": dipole.prefactor,
+                    "theta": dbh_params.theta,
+                    "leaf_size": dbh_params.leaf_size,
+                    "n_replica": dbh_params.n_replica}
+
+        def _activate_method(self):
+            self._set_params_in_es_core()
+
+        def _set_params_in_es_core(self):
+            self.set_magnetostatics_prefactor()
+            dipolar_barnes_hut_set_params(self._params["theta"],
+                                          self._params["leaf_size"],
+                                          self._params["n_replica"])
+            handle_errors("Could not activate magnetostatics method "
+                          + self.__class__.__name__)
+
     IF SCAFACOS_DIPOLES == 1:
         class Scafacos(ScafacosConnector, MagnetostaticInteraction):
 
@@ -22,7 +22,20 @@ include "myconfig.pxi"
 
 from libcpp.vector cimport vector
 from .utils cimport Vector3d
-from .analyze cimport PartCfg, partCfg
+from libcpp cimport bool
 
 cdef extern from "polymer.hpp":
-    vector[vector[Vector3d]] draw_polymer_positions(PartCfg &, int n_polymers, int beads_per_polymer, double bond_length, vector[Vector3d] & start_positions, double min_distance, int max_tries, int use_bond_angle, double bond_angle, int respect_constraints, int seed) except +
+    cppclass PolymerParameters:
+        int n_polymers
+        int beads_per_chain
+        double bond_length
+        vector[Vector3d] start_positions
+        double min_distance
+        int max_tries
+        bool use_bond_angle
+        double bond_angle
+        bool respect_constraints
+        int seed
+
+    vector[vector[Vector3d]] draw_polymer_positions(int n_polymers, int beads_per_polymer, double bond_length, vector[Vector3d] & start_positions, double min_distance, int max_tries, int use_bond_angle, double bond_angle, int respect_constraints, int seed) except +
+    void create_polymers(const PolymerParameters & params, int start_id, int type, int bond_id) except +
@@ -56,49 +56,8 @@ def validate_params(_params, default):
         raise ValueError(
             "seed has to be an integer")
 
-# wrapper function to expose to the user interface
-
-
-def linear_polymer_positions(**kwargs):
-    """
-    Generates particle positions for polymer creation.
-
-    Parameters
-    ----------
-    n_polymers : :obj:`int`, required
-        Number of polymer chains
-    beads_per_chain : :obj:`int`, required
-        Number of monomers per chain
-    bond_length : :obj:`float`, required
-        distance between adjacent monomers in a chain
-    seed : :obj:`int`, required
-        Seed for the RNG used to generate the particle positions.
-    bond_angle : :obj:`float`, optional
-        If set, this parameter defines the angle between adjacent bonds
-        within a polymer.
-    start_positions : array_like :obj:`float`.
-        If set, this vector defines the start positions for the polymers, i.e.,
-        the position of each polymer's first monomer bead.
-        Here, a numpy array of shape (n_polymers, 3) is expected.
-    min_distance : :obj:`float`, optional
-        Minimum distance between all generated positions. Defaults to 0
-    respect_constraints : :obj:`bool`, optional
-        If True, the particle setup tries to obey previously defined constraints.
-        Default value is False.
-    max_tries : :obj:`int`, optional
-        Maximal number of attempts to generate every monomer position,
-        as well as maximal number of retries per polymer, if choosing
-        suitable monomer positions fails. Default value is 1000.
-        Depending on the total number of beads and constraints,
-        this value needs to be adapted.
 
-    Returns
-    -------
-    :obj:`ndarray`
-        Three-dimensional numpy array, namely a list of polymers containing the
-        coordinates of the respective monomers.
-
-    """
+def _polymer_params(kwargs):
     params = dict()
     default_params = dict()
     default_params["n_polymers"] = 0
@@ -142,6 +101,53 @@ def linear_polymer_positions(**kwargs):
 
     validate_params(params, default_params)
 
+    return params
+
+# wrapper function to expose to the user interface
+
+
+def linear_polymer_positions(**kwargs):
+    """
+    Generates particle positions for polymer creation.
+
+    Parameters
+    ----------
+    n_polymers : :obj:`int`, required
+        Number of polymer chains
+    beads_per_chain : :obj:`int`, required
+        Number of monomers per chain
+    bond_length : :obj:`float`, required
+        distance between adjacent monomers in a chain
+    seed : :obj:`int`, required
+        Seed for the RNG used to generate the particle positions.
+    bond_angle : :obj:`float`, optional
+        If set, this parameter defines the angle between adjacent bonds
+        within a polymer.
+    start_positions : array_like :obj:`float`.
+        If set, this vector defines the start positions for the polymers, i.e.,
+        the position of each polymer's first monomer bead.
+        Here, a numpy array of shape (n_polymers, 3) is expected.
+    min_distance : :obj:`float`, optional
+        Minimum distance between all generated positions. Defaults to 0
+    respect_constraints : :obj:`bool`, optional
+        If True, the particle setup tries to obey previously defined constraints.
+        Default value is False.
+    max_tries : :obj:`int`, optional
+        Maximal number of attempts to generate every monomer position,
+        as well as maximal number of retries per polymer, if choosing
+        suitable monomer positions fails. Default value is 1000.
+        Depending on the total number of beads and constraints,
+        this value needs to be adapted.
+
+    Returns
+    -------
+    :obj:`ndarray`
+        Three-dimensional numpy array, namely a list of polymers containing the
+        coordinates of the respective monomers.
+
+    """
+    params = _polymer_params(kwargs)
+
     cdef vector[Vector3d] start_positions
     if (params["start_positions"].size > 0):
         for i in range(len(params["start_positions"])):
@@ -149,7 +155,6 @@ def linear_polymer_positions(**kwargs):
                 make_Vector3d(params["start_positions"][i]))
 
     data = draw_polymer_positions(
-        partCfg(),
         params["n_polymers"],
         params["beads_per_chain"],
         params["bond_length"],
@@ -170,6 +175,65 @@ def linear_polymer_positions(**kwargs):
     return np.array(positions)
 
 
+def setup_linear_polymers(system=None, bond=None, start_id='auto',
+                          type=0, **kwargs):
+    """
+    Generates polymer chains and creates their monomers as particles.
+
+    The chains are generated in parallel as in
+    :func:`linear_polymer_positions` and created in bulk on the node
+    which generated them. Monomer ``m`` of chain ``p`` gets the id
+    ``start_id + p * beads_per_chain + m``.
+
+    Parameters
+    ----------
+    system : :class:`espressomd.system.System`, required
+        System to which the particles will be added.
+    bond : :class:`espressomd.interactions.BondedInteraction`, optional
+        The bond to be created between consecutive monomers. If omitted,
+        the particles are not bonded.
+    start_id : :obj:`int` or ``'auto'``, optional
+        Id of the first monomer. If ``'auto'``, particle ids will start
+        after the highest id of particles already in the system.
+    type : :obj:`int`, optional
+        Type assigned to the monomers. Defaults to 0.
+    \*\*kwargs :
+        Parameters of :func:`linear_polymer_positions`.
+
+    """
+    if not isinstance(system, System):
+        raise TypeError(
+            "System argument must be an instance of an espressomd System")
+    if bond is not None and not isinstance(bond, BondedInteraction):
+        raise TypeError(
+            "bond argument must be an instance of espressomd.interaction.BondedInteraction")
+    if start_id == 'auto':
+        start_id = system.part.highest_particle_id + 1
+    check_type_or_throw_except(
+        start_id, 1, int, "start_id must be one int or 'auto'")
+    check_type_or_throw_except(type, 1, int, "type must be one int")
+    if type < 0:
+        raise ValueError("type has to be a non-negative integer")
+
+    params = _polymer_params(kwargs)
+
+    cdef PolymerParameters c_params
+    c_params.n_polymers = params["n_polymers"]
+    c_params.beads_per_chain = params["beads_per_chain"]
+    c_params.bond_length = params["bond_length"]
+    for pos in params["start_positions"]:
+        c_params.start_positions.push_back(make_Vector3d(pos))
+    c_params.min_distance = params["min_distance"]
+    c_params.max_tries = params["max_tries"]
+    c_params.use_bond_angle = params["use_bond_angle"]
+    c_params.bond_angle = params["bond_angle"]
+    c_params.respect_constraints = params["respect_constraints"]
+    c_params.seed = params["seed"]
+
+    create_polymers(c_params, start_id, type,
+                    -1 if bond is None else bond._bond_id)
+
+
 def setup_diamond_polymer(system=None, bond=None, MPC=0,
                           dist_cM=1, val_cM=0.0, val_nodes=0.0,
                           start_id='auto', no_bonds=False,
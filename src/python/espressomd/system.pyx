@@ -48,6 +48,7 @@ from .globals cimport integ_switch, max_oif_objects
 from .globals cimport maximal_cutoff_bonded, maximal_cutoff_nonbonded, mpi_bcast_parameter
 from .utils cimport check_type_or_throw_except
 from .utils import is_valid_type, handle_errors
+from .communication cimport mpiCallbacks
 IF VIRTUAL_SITES:
     from .virtual_sites import ActiveVirtualSitesHandle, VirtualSitesOff
 
@@ -64,6 +65,23 @@ if VIRTUAL_SITES:
 
 cdef bool _system_created = False
 
+
+cdef class _DeferredUpdates:
+    """Context manager returned by :meth:`System.deferred_updates`."""
+    cdef bool previous
+
+    def __enter__(self):
+        self.previous = mpiCallbacks().deferred()
+        mpiCallbacks().set_deferred(True)
+        return self
+
+    def __exit__(self, *args):
+        mpiCallbacks().set_deferred(self.previous)
+
+    def flush(self):
+        """Send the pending updates to the other MPI ranks."""
+        mpiCallbacks().flush()
+
 cdef class System:
     """The ESPResSo system class.
 
@@ -417,6 +435,26 @@ cdef class System:
             """
             auto_exclusions(distance)
 
+    def deferred_updates(self):
+        """
+        Batch particle updates sent to the other MPI ranks.
+
+        Within the returned context manager, changes of particle properties,
+        positions, exclusions and particle removals are queued and sent to
+        the other MPI ranks in a single message on the next operation that
+        needs them, e.g. reading particle data or integrating. On exit, the
+        pending updates are sent. This avoids one round trip per update
+        when setting up large systems in parallel simulations.
+
+        Examples
+        --------
+        >>> with system.deferred_updates():
+        ...     for p in system.part:
+        ...         p.v = [0., 0., 1.]
+
+        """
+        return _DeferredUpdates()
+
     def setup_type_map(self, type_list=None):
         """
         For using ESPResSo conveniently for simulations in the grand canonical
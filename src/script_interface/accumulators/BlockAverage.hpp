@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SCRIPT_INTERFACE_ACCUMULATORS_BLOCK_AVERAGE_HPP
+#define SCRIPT_INTERFACE_ACCUMULATORS_BLOCK_AVERAGE_HPP
+
+#include "AccumulatorBase.hpp"
+#include "script_interface/ScriptInterface.hpp"
+#include "script_interface/observables/Observable.hpp"
+
+#include "core/accumulators/BlockAverage.hpp"
+
+#include <utils/as_const.hpp>
+
+#include <memory>
+#include <string>
+
+namespace ScriptInterface {
+namespace Accumulators {
+
+class BlockAverage : public AccumulatorBase {
+public:
+  BlockAverage() {
+    add_parameters({{"obs", Utils::as_const(m_obs)},
+                    {"distributed", AutoParameter::read_only,
+                     [this]() { return m_accumulator->distributed(); }}});
+  }
+
+  void do_construct(VariantMap const &params) override {
+    set_from_args(m_obs, params, "obs");
+
+    if (m_obs)
+      m_accumulator = std::make_shared<::Accumulators::BlockAverage>(
+          m_obs->observable(), get_value_or<int>(params, "delta_N", 1),
+          get_value_or<bool>(params, "distributed", false));
+  }
+
+  Variant do_call_method(std::string const &method,
+                         VariantMap const &parameters) override {
+    if (method == "update")
+      m_accumulator->update();
+    if (method == "mean")
+      return m_accumulator->mean();
+    if (method == "std_error")
+      return m_accumulator->std_error();
+    if (method == "block_errors")
+      return m_accumulator->block_errors();
+    return AccumulatorBase::call_method(method, parameters);
+  }
+
+  std::shared_ptr<::Accumulators::AccumulatorBase> accumulator() override {
+    return m_accumulator;
+  }
+
+  std::shared_ptr<const ::Accumulators::AccumulatorBase>
+  accumulator() const override {
+    return std::static_pointer_cast<::Accumulators::AccumulatorBase>(
+        m_accumulator);
+  }
+
+private:
+  std::shared_ptr<::Accumulators::BlockAverage> m_accumulator;
+  std::shared_ptr<Observables::Observable> m_obs;
+
+  std::string get_internal_state() const override {
+    return m_accumulator->get_internal_state();
+  }
+
+  void set_internal_state(std::string const &state) override {
+    m_accumulator->set_internal_state(state);
+  }
+};
+
+} // namespace Accumulators
+} // namespace ScriptInterface
+
+#endif
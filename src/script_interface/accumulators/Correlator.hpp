@@ -50,6 +50,8 @@ public:
          {"compress1", m_correlator, &CoreCorr::compress1},
          {"compress2", m_correlator, &CoreCorr::compress2},
          {"corr_operation", m_correlator, &CoreCorr::correlation_operation},
+         {"method", m_correlator, &CoreCorr::method},
+         {"distributed", m_correlator, &CoreCorr::distributed},
          {"args", m_correlator, &CoreCorr::set_correlation_args,
           &CoreCorr::correlation_args},
          {"obs1", Utils::as_const(m_obs1)},
@@ -70,7 +72,9 @@ public:
         get_value_or<std::string>(args, "compress1", ""),
         get_value_or<std::string>(args, "compress2", ""),
         get_value<std::string>(args, "corr_operation"), m_obs1->observable(),
-        m_obs2->observable(), get_value_or<Utils::Vector3d>(args, "args", {}));
+        m_obs2->observable(), get_value_or<Utils::Vector3d>(args, "args", {}),
+        get_value_or<std::string>(args, "method", "multi_tau"),
+        get_value_or<bool>(args, "distributed", false));
   }
 
   std::shared_ptr<::Accumulators::Correlator> correlator() {
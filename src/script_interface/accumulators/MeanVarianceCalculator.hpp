@@ -38,7 +38,9 @@ class MeanVarianceCalculator : public AccumulatorBase {
 public:
   /* as_const is to make obs read-only. */
   MeanVarianceCalculator() {
-    add_parameters({{"obs", Utils::as_const(m_obs)}});
+    add_parameters({{"obs", Utils::as_const(m_obs)},
+                    {"distributed", AutoParameter::read_only,
+                     [this]() { return m_accumulator->distributed(); }}});
   }
 
   void do_construct(VariantMap const &params) override {
@@ -46,7 +48,8 @@ public:
 
     if (m_obs)
       m_accumulator = std::make_shared<::Accumulators::MeanVarianceCalculator>(
-          m_obs->observable(), get_value_or<int>(params, "delta_N", 1));
+          m_obs->observable(), get_value_or<int>(params, "delta_N", 1),
+          get_value_or<bool>(params, "distributed", false));
   }
 
   std::shared_ptr<::Accumulators::MeanVarianceCalculator>
@@ -27,7 +27,10 @@
 #include <boost/range/algorithm/transform.hpp>
 #include <utils/as_const.hpp>
 
+#include <cstddef>
 #include <memory>
+#include <stdexcept>
+#include <string>
 
 namespace ScriptInterface {
 namespace Accumulators {
@@ -35,14 +38,31 @@ namespace Accumulators {
 class TimeSeries : public AccumulatorBase {
 public:
   /* as_const is to make obs read-only. */
-  TimeSeries() { add_parameters({{"obs", Utils::as_const(m_obs)}}); }
+  TimeSeries() {
+    add_parameters(
+        {{"obs", Utils::as_const(m_obs)},
+         {"buffer_size", AutoParameter::read_only,
+          [this]() { return static_cast<int>(m_accumulator->buffer_size()); }},
+         {"filename", AutoParameter::read_only,
+          [this]() { return m_accumulator->filename(); }},
+         {"distributed", AutoParameter::read_only,
+          [this]() { return m_accumulator->distributed(); }}});
+  }
 
   void do_construct(VariantMap const &params) override {
     set_from_args(m_obs, params, "obs");
 
-    if (m_obs)
+    if (m_obs) {
+      auto const buffer_size = get_value_or<int>(params, "buffer_size", 0);
+      if (buffer_size < 0) {
+        throw std::runtime_error("buffer_size must be >= 0");
+      }
       m_accumulator = std::make_shared<::Accumulators::TimeSeries>(
-          m_obs->observable(), get_value_or<int>(params, "delta_N", 1));
+          m_obs->observable(), get_value_or<int>(params, "delta_N", 1),
+          static_cast<std::size_t>(buffer_size),
+          get_value_or<std::string>(params, "filename", ""),
+          get_value_or<bool>(params, "distributed", false));
+    }
   }
 
   Variant do_call_method(std::string const &method,
@@ -51,7 +71,7 @@ public:
       m_accumulator->update();
     }
     if (method == "time_series") {
-      auto const &series = m_accumulator->time_series();
+      auto const series = m_accumulator->time_series();
       std::vector<Variant> ret(series.size());
 
       boost::transform(
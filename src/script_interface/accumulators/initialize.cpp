@@ -18,8 +18,10 @@
  */
 
 #include "AutoUpdateAccumulators.hpp"
+#include "BlockAverage.hpp"
 #include "Correlator.hpp"
 #include "MeanVarianceCalculator.hpp"
+#include "RunningHistogram.hpp"
 #include "TimeSeries.hpp"
 
 namespace ScriptInterface {
@@ -34,6 +36,10 @@ void initialize(Utils::Factory<ObjectHandle> *om) {
 
   om->register_new<TimeSeries>("Accumulators::TimeSeries");
 
+  om->register_new<BlockAverage>("Accumulators::BlockAverage");
+
+  om->register_new<RunningHistogram>("Accumulators::RunningHistogram");
+
   om->register_new<Correlator>("Accumulators::Correlator");
 }
 } /* namespace Accumulators */
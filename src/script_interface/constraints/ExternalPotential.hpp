@@ -56,12 +56,17 @@ public:
   Variant do_call_method(const std::string &name,
                          VariantMap const &args) override {
     if (name == "_eval_field") {
-      return m_constraint->field()(get_value<Utils::Vector3d>(args, "x"),
-                                   get_value_or<double>(args, "t", 0.));
+      auto const &field = m_constraint->field();
+      auto const x = get_value<Utils::Vector3d>(args, "x");
+      auto const t = get_value_or<double>(args, "t", 0.);
+      return detail::evaluate_on_head(field, x,
+                                      [&]() { return field(x, t); });
     }
     if (name == "_eval_jacobian") {
-      return m_constraint->field().jacobian(
-          get_value<Utils::Vector3d>(args, "x"));
+      auto const &field = m_constraint->field();
+      auto const x = get_value<Utils::Vector3d>(args, "x");
+      return detail::evaluate_on_head(field, x,
+                                      [&]() { return field.jacobian(x); });
     }
 
     return none;
@@ -55,7 +55,19 @@ public:
                        };
                      },
                      [this]() { return m_shape; }},
-                    {"particle_velocity", m_constraint->velocity()}});
+                    {"particle_velocity", m_constraint->velocity()},
+                    {"distance_grid_spacing",
+                     [this](Variant const &value) {
+                       auto const spacing = get_value<double>(value);
+                       if (spacing < 0.) {
+                         throw Exception(
+                             "The distance grid spacing must be >= 0");
+                       }
+                       m_constraint->set_distance_grid_spacing(spacing);
+                     },
+                     [this]() {
+                       return m_constraint->distance_grid_spacing();
+                     }}});
   }
 
   Variant do_call_method(std::string const &name, VariantMap const &) override {
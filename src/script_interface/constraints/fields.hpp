@@ -23,15 +23,24 @@
 #include "core/field_coupling/fields/Constant.hpp"
 #include "core/field_coupling/fields/Interpolated.hpp"
 #include "core/field_coupling/fields/PlaneWave.hpp"
+#include "core/communication.hpp"
+#include "core/grid.hpp"
+#include "core/integrate.hpp"
+#include "core/io/reader/field_hdf5.hpp"
+#include "core/load_balancing.hpp"
 
 #include "script_interface/ScriptInterface.hpp"
 
 #include <utils/Vector.hpp>
 
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/operations.hpp>
 #include <boost/multi_array.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -107,14 +116,37 @@ struct field_params_impl<PlaneWave<T, codim>> {
   }
 };
 
+/**
+ * @brief Global grid indices which the interpolation needs on the local
+ *        box of this node.
+ *
+ * @param shape         Shape of the global grid.
+ * @param grid_spacing  Grid spacing.
+ * @param origin        Position of the first grid point.
+ * @param halo          Distance beyond the local box up to which the
+ *                      field can be evaluated.
+ */
+inline std::array<std::vector<int>, 3>
+local_grid_indices(Utils::Vector3i const &shape,
+                   Utils::Vector3d const &grid_spacing,
+                   Utils::Vector3d const &origin, double halo) {
+  std::array<std::vector<int>, 3> indices;
+  for (unsigned int i = 0; i < 3; i++) {
+    indices[i] = ::FieldCoupling::Fields::detail::stencil_indices(
+        shape[i], grid_spacing[i], origin[i], local_geo.my_left()[i] - halo,
+        local_geo.my_right()[i] + halo, box_geo.length()[i],
+        box_geo.periodic(i));
+  }
+  return indices;
+}
+
 template <typename T, size_t codim>
 struct field_params_impl<Interpolated<T, codim>> {
-  static Interpolated<T, codim> make(const VariantMap &params) {
-    auto const field_data =
-        get_value<std::vector<double>>(params, "_field_data");
-    auto const field_shape = get_value<Utils::Vector3i>(params, "_field_shape");
-    auto const field_codim = get_value<int>(params, "_field_codim");
+  using field_data_type =
+      typename Utils::decay_to_scalar<Utils::Vector<T, codim>>::type;
 
+  static void check_shape(Utils::Vector3i const &field_shape,
+                          int field_codim) {
     if (field_codim != codim) {
       throw std::runtime_error(
           "Field data has the wrong dimensions, needs to be [n, m, o, " +
@@ -125,18 +157,104 @@ struct field_params_impl<Interpolated<T, codim>> {
       throw std::runtime_error("Field is too small, needs to be at least "
                                "one in all directions.");
     }
+  }
+
+#ifdef H5MD
+  static Interpolated<T, codim>
+  read_file(std::string const &file_name, std::string const &dataset,
+            Utils::Vector3d const &grid_spacing, Utils::Vector3d const &origin,
+            bool distributed, double halo) {
+    auto const shape = Reader::field_shape(comm_cart, file_name, dataset);
+    Utils::Vector3i const field_shape{shape[0], shape[1], shape[2]};
+    check_shape(field_shape, shape[3]);
+
+    std::array<std::vector<int>, 3> indices;
+    if (distributed) {
+      indices = local_grid_indices(field_shape, grid_spacing, origin, halo);
+    } else {
+      for (int i = 0; i < 3; i++) {
+        indices[i].resize(static_cast<std::size_t>(field_shape[i]));
+        std::iota(indices[i].begin(), indices[i].end(), 0);
+      }
+    }
+    auto const field_data =
+        Reader::read_field(comm_cart, file_name, dataset, indices);
+    auto const array_ref = boost::const_multi_array_ref<field_data_type, 3>(
+        reinterpret_cast<const field_data_type *>(field_data.data()),
+        std::array<std::size_t, 3>{
+            {indices[0].size(), indices[1].size(), indices[2].size()}});
+
+    if (distributed) {
+      return {array_ref, indices, field_shape, grid_spacing, origin};
+    }
+    return {array_ref, grid_spacing, origin};
+  }
+#endif
 
+  static Interpolated<T, codim>
+  make_from_file(const VariantMap &params, Utils::Vector3d const &grid_spacing,
+                 Utils::Vector3d const &origin, bool distributed,
+                 double halo) {
+#ifdef H5MD
+    auto const file_name = get_value<std::string>(params, "_field_file");
+    auto const dataset = get_value<std::string>(params, "_field_dataset");
+    /* Errors are detected on all nodes, only the head node reports them */
+    try {
+      return read_file(file_name, dataset, grid_spacing, origin, distributed,
+                       halo);
+    } catch (std::runtime_error const &e) {
+      throw Exception(e.what());
+    }
+#else
+    (void)params;
+    (void)grid_spacing;
+    (void)origin;
+    (void)distributed;
+    (void)halo;
+    throw Exception("Reading fields from files requires HDF5 "
+                    "support (feature H5MD)");
+#endif
+  }
+
+  static Interpolated<T, codim> make(const VariantMap &params) {
     auto const grid_spacing =
         get_value<Utils::Vector3d>(params, "grid_spacing");
     auto const origin = -0.5 * grid_spacing;
+    auto const distributed = get_value_or<bool>(params, "distributed", false);
+    auto const halo = get_value_or<double>(params, "halo", skin);
+    /* the local grid is only valid while the local box doesn't move */
+    if (distributed and LoadBalancing::parameters().interval > 0) {
+      throw Exception(
+          "Distributed fields are not supported with load balancing");
+    }
+
+    if (params.count("_field_file")) {
+      return make_from_file(params, grid_spacing, origin, distributed, halo);
+    }
+
+    auto const field_data =
+        get_value<std::vector<double>>(params, "_field_data");
+    auto const field_shape = get_value<Utils::Vector3i>(params, "_field_shape");
+    auto const field_codim = get_value<int>(params, "_field_codim");
+    check_shape(field_shape, field_codim);
+
+    if (field_data.size() != static_cast<std::size_t>(field_shape[0]) *
+                                 static_cast<std::size_t>(field_shape[1]) *
+                                 static_cast<std::size_t>(field_shape[2]) *
+                                 codim) {
+      throw Exception("Field data doesn't match the field shape");
+    }
 
-    using field_data_type =
-        typename Utils::decay_to_scalar<Utils::Vector<T, codim>>::type;
     auto array_ref = boost::const_multi_array_ref<field_data_type, 3>(
         reinterpret_cast<const field_data_type *>(field_data.data()),
         field_shape);
 
-    return Interpolated<T, codim>{array_ref, grid_spacing, origin};
+    Interpolated<T, codim> field{array_ref, grid_spacing, origin};
+    if (distributed) {
+      return field.subgrid(
+          local_grid_indices(field_shape, grid_spacing, origin, halo));
+    }
+    return field;
   }
 
   template <typename This>
@@ -145,15 +263,58 @@ struct field_params_impl<Interpolated<T, codim>> {
              [this_]() { return this_().grid_spacing(); }},
             {"origin", AutoParameter::read_only,
              [this_]() { return this_().origin(); }},
+            {"distributed", AutoParameter::read_only,
+             [this_]() { return this_().is_distributed(); }},
             {"_field_shape", AutoParameter::read_only,
              [this_]() { return this_().shape(); }},
             {"_field_codim", AutoParameter::read_only,
              []() { return static_cast<int>(codim); }},
-            {"_field_data", AutoParameter::read_only,
-             [this_]() { return this_().field_data_flat(); }}};
+            {"_field_data", AutoParameter::read_only, [this_]() {
+               /* a distributed field is only known piecewise */
+               if (this_().is_distributed())
+                 return std::vector<T>{};
+               return this_().field_data_flat();
+             }}};
   }
 };
 
+/**
+ * @brief Evaluate a field on the head node.
+ *
+ * Collective. A distributed field is evaluated on the first node which
+ * stores the grid points at the position, and the result is sent to the
+ * head node.
+ *
+ * @param field  The field.
+ * @param pos    The position.
+ * @param f      Evaluation of the field at the position.
+ * @return the result on the head node, default-constructed elsewhere.
+ */
+template <typename Field, typename F>
+auto evaluate_on_head(Field const &field, Utils::Vector3d const &pos,
+                      F const &f) -> decltype(f()) {
+  using result_type = decltype(f());
+  auto const owner = boost::mpi::all_reduce(
+      comm_cart, field.covers(pos) ? this_node : comm_cart.size(),
+      boost::mpi::minimum<int>());
+  if (owner == comm_cart.size()) {
+    if (this_node == 0) {
+      throw std::domain_error("No node stores the field at this position");
+    }
+    return result_type{};
+  }
+  if (owner == 0) {
+    return (this_node == 0) ? f() : result_type{};
+  }
+  result_type result{};
+  if (this_node == owner) {
+    comm_cart.send(0, 0, f());
+  } else if (this_node == 0) {
+    comm_cart.recv(owner, 0, result);
+  }
+  return result;
+}
+
 template <typename Field, typename T>
 static std::vector<AutoParameter> field_parameters(const T &this_) {
   return field_params_impl<Field>::params(this_);
@@ -24,10 +24,17 @@
 
 #include "config.hpp"
 #include "io/mpiio/mpiio.hpp"
+#include "script_interface/Exception.hpp"
 #include "script_interface/ScriptInterface.hpp"
 #include "script_interface/auto_parameters/AutoParameters.hpp"
 #include "script_interface/get_value.hpp"
 #include <core/cells.hpp>
+#include <core/communication.hpp>
+#include <core/integrate.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #define field_value(use, v) ((use) ? (v) : 0u)
 
@@ -41,6 +48,54 @@ public:
   Variant do_call_method(const std::string &name,
                          const VariantMap &parameters) override {
 
+    if (name == "write_checkpoint" or name == "read_checkpoint") {
+      auto const path = get_value<std::string>(parameters.at("path"));
+      /* Errors are detected on all nodes, only the head node reports them */
+      try {
+        if (name == "write_checkpoint")
+          Mpiio::mpi_checkpoint_write(path.c_str());
+        else
+          Mpiio::mpi_checkpoint_read(path.c_str());
+      } catch (std::runtime_error const &e) {
+        throw Exception(e.what());
+      }
+      return {};
+    }
+    if (name == "write_compact") {
+      auto const prefix = get_value<std::string>(parameters.at("prefix"));
+      auto const precision = get_value<double>(parameters.at("precision"));
+      auto const vel = get_value<bool>(parameters.at("vel"));
+      auto const vel_precision =
+          get_value<double>(parameters.at("vel_precision"));
+      Mpiio::mpi_compact_write(prefix.c_str(), precision, vel, vel_precision,
+                               sim_time, cell_structure.local_particles());
+      return {};
+    }
+    if (name == "n_compact_frames") {
+      auto const prefix = get_value<std::string>(parameters.at("prefix"));
+      return static_cast<int>(Mpiio::compact_n_frames(prefix.c_str()));
+    }
+    if (name == "read_compact") {
+      if (this_node != 0)
+        return {};
+      auto const prefix = get_value<std::string>(parameters.at("prefix"));
+      auto const frame = get_value<int>(parameters.at("frame"));
+      if (frame < 0)
+        throw std::domain_error("frame must be non-negative");
+      auto const data = Mpiio::compact_read_frame(
+          prefix.c_str(), static_cast<std::size_t>(frame));
+      auto const flatten = [](std::vector<Utils::Vector3d> const &v) {
+        std::vector<double> flat;
+        flat.reserve(3 * v.size());
+        for (auto const &x : v)
+          flat.insert(flat.end(), x.begin(), x.end());
+        return flat;
+      };
+      return std::vector<Variant>{data.time, data.box_l, data.ids,
+                                  flatten(data.positions),
+                                  flatten(data.velocities)};
+    }
+
     auto pref = get_value<std::string>(parameters.at("prefix"));
     auto pos = get_value<bool>(parameters.at("pos"));
     auto vel = get_value<bool>(parameters.at("vel"));
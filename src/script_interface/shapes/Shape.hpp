@@ -22,6 +22,7 @@
 #ifndef SCRIPT_INTERFACE_SHAPES_SHAPE_HPP
 #define SCRIPT_INTERFACE_SHAPES_SHAPE_HPP
 
+#include "core/event.hpp"
 #include "script_interface/auto_parameters/AutoParameters.hpp"
 #include <shapes/Shape.hpp>
 
@@ -41,6 +42,13 @@ public:
    */
   virtual std::shared_ptr<::Shapes::Shape> shape() const = 0;
 
+  void do_set_parameter(const std::string &name,
+                        const Variant &value) override {
+    AutoParameters<Shape>::do_set_parameter(name, value);
+    /* constraints cache data derived from their shapes */
+    on_constraint_change();
+  }
+
   Variant do_call_method(std::string const &name,
                          VariantMap const &params) override {
     if (name == "calc_distance") {
@@ -37,9 +37,11 @@ public:
 private:
   void add_in_core(const std::shared_ptr<Shape> &obj_ptr) override {
     m_core_shape->add(obj_ptr->shape());
+    on_constraint_change();
   }
   void remove_in_core(const std::shared_ptr<Shape> &obj_ptr) override {
     m_core_shape->remove(obj_ptr->shape());
+    on_constraint_change();
   }
 
 public:
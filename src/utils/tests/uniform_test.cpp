@@ -34,3 +34,17 @@ BOOST_AUTO_TEST_CASE(limits) {
   BOOST_CHECK_EQUAL(Utils::uniform(0ul) - Utils::uniform(5ul),
                     Utils::uniform(10000ul) - Utils::uniform(10005ul));
 }
+
+BOOST_AUTO_TEST_CASE(conversion) {
+  auto constexpr const max = std::numeric_limits<uint64_t>::max();
+  /* values around the rounding boundaries of the double mantissa */
+  for (uint64_t k = 0; k < 4096; ++k) {
+    for (uint64_t const value :
+         {k, max - k, (uint64_t{1} << 63) + k, (uint64_t{1} << 63) - k,
+          (uint64_t{1} << 53) + k, (uint64_t{1} << 54) - k,
+          k * 0x9E3779B97F4A7C15ul}) {
+      BOOST_CHECK_EQUAL(Utils::uint64_to_double(value),
+                        static_cast<double>(value));
+    }
+  }
+}
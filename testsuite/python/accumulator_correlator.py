@@ -200,6 +200,61 @@ class CorrelatorTest(ut.TestCase):
         acc.args = w_squared
         np.testing.assert_array_almost_equal(np.copy(acc.args), w_squared)
 
+    def test_fft_and_distributed(self):
+        s = self.system
+        np.random.seed(42)
+        p = s.part.add(pos=np.random.random((6, 3)) * s.box_l,
+                       v=np.random.random((6, 3)) - 0.5)
+        s.integrator.run(100)
+
+        def make_accumulators(obs, corr_operation):
+            accumulators = {}
+            for method, distributed in [("multi_tau", False), ("fft", False),
+                                        ("multi_tau", True), ("fft", True)]:
+                accumulators[(method, distributed)] = \
+                    espressomd.accumulators.Correlator(
+                        obs1=obs, tau_lin=24, tau_max=0.2, delta_N=1,
+                        corr_operation=corr_operation, method=method,
+                        distributed=distributed)
+            return accumulators
+
+        obs = espressomd.observables.ParticleVelocities(ids=p.id)
+        groups = [make_accumulators(obs, "componentwise_product"),
+                  make_accumulators(obs, "scalar_product")]
+        for accumulators in groups:
+            for acc in accumulators.values():
+                s.auto_update_accumulators.add(acc)
+        s.integrator.run(150)
+
+        for accumulators in groups:
+            ref = accumulators[("multi_tau", False)]
+            self.assertEqual(ref.result().shape[0], ref.tau_lin + 1)
+            for (method, distributed), acc in accumulators.items():
+                self.assertEqual(acc.method, method)
+                self.assertEqual(acc.distributed, distributed)
+                np.testing.assert_array_equal(acc.lag_times(),
+                                              ref.lag_times())
+                np.testing.assert_array_equal(acc.sample_sizes(),
+                                              ref.sample_sizes())
+                np.testing.assert_allclose(acc.result(), ref.result(),
+                                           rtol=1e-10, atol=1e-12)
+                self.check_pickling(acc)
+
+        # unsupported combinations
+        with self.assertRaises(RuntimeError):
+            espressomd.accumulators.Correlator(
+                obs1=obs, tau_lin=10, tau_max=1., delta_N=1,
+                corr_operation="scalar_product", method="fft")
+        with self.assertRaises(RuntimeError):
+            espressomd.accumulators.Correlator(
+                obs1=obs, tau_lin=10, tau_max=0.1, delta_N=1,
+                corr_operation="tensor_product", distributed=True)
+        with self.assertRaises(RuntimeError):
+            espressomd.accumulators.Correlator(
+                obs1=espressomd.observables.ComPosition(ids=p.id),
+                tau_lin=10, tau_max=0.1, delta_N=1,
+                corr_operation="scalar_product", distributed=True)
+
     def test_correlator_interface(self):
         # test setters and getters
         obs = espressomd.observables.ParticleVelocities(ids=(123,))
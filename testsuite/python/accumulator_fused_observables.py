@@ -0,0 +1,123 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import unittest as ut
+import unittest_decorators as utx
+
+import numpy as np
+
+import espressomd
+import espressomd.accumulators
+import espressomd.interactions
+import espressomd.observables
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class FusedObservablesTest(ut.TestCase):
+
+    """
+    Check that the energies and pressures sampled by automatically updated
+    accumulators, which the force calculation accumulates in the same pass
+    as the forces, match a separate calculation.
+
+    """
+    system = espressomd.System(box_l=[8.0] * 3)
+    system.cell_system.skin = 0.4
+    system.time_step = 0.01
+
+    def setUp(self):
+        np.random.seed(seed=42)
+        system = self.system
+        system.thermostat.set_langevin(kT=1.0, gamma=1.0, seed=42)
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1.0, sigma=1.0, cutoff=2.5, shift="auto")
+        system.non_bonded_inter[0, 1].lennard_jones.set_params(
+            epsilon=1.0, sigma=1.0, cutoff=2**(1. / 6.), shift="auto")
+        harmonic = espressomd.interactions.HarmonicBond(k=10.0, r_0=1.0)
+        angle = espressomd.interactions.AngleHarmonic(bend=2.0, phi0=np.pi)
+        system.bonded_inter.add(harmonic)
+        system.bonded_inter.add(angle)
+
+        # chains of 8 particles along z
+        grid = np.mgrid[0:4, 0:8, 0:8].reshape(3, -1).T * [2.0, 1.0, 1.0]
+        system.part.add(pos=grid + 0.5, type=np.arange(len(grid)) % 2)
+        for i in range(0, len(grid), 8):
+            for j in range(i, i + 7):
+                system.part[j].add_bond((harmonic, j + 1))
+            for j in range(i + 1, i + 7):
+                system.part[j].add_bond((angle, j - 1, j + 1))
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.auto_update_accumulators.clear()
+        self.system.thermostat.turn_off()
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=0.0, sigma=0.0, cutoff=0.0, shift=0.0)
+        self.system.non_bonded_inter[0, 1].lennard_jones.set_params(
+            epsilon=0.0, sigma=0.0, cutoff=0.0, shift=0.0)
+
+    def separate_calculation(self, obs):
+        # new forces discard the observables of the last force calculation
+        self.system.integrator.run(0, recalc_forces=True)
+        return obs.calculate()
+
+    def check_observable(self, obs, delta_N):
+        system = self.system
+        acc = espressomd.accumulators.TimeSeries(obs=obs, delta_N=delta_N)
+        system.auto_update_accumulators.add(acc)
+        # the first update is due after one step
+        for steps in [1, delta_N, delta_N, delta_N]:
+            system.integrator.run(steps)
+            np.testing.assert_allclose(
+                acc.time_series()[-1], self.separate_calculation(obs),
+                rtol=1e-10, atol=1e-10)
+        self.assertEqual(len(acc.time_series()), 4)
+
+    def test_energy(self):
+        self.check_observable(espressomd.observables.Energy(), 5)
+
+    def test_pressure(self):
+        self.check_observable(espressomd.observables.Pressure(), 3)
+
+    def test_pressure_tensor(self):
+        self.check_observable(espressomd.observables.PressureTensor(), 4)
+
+    def test_mixed_schedule(self):
+        # the accumulators are due at steps 1, 3, 5, 7 and 1, 4, 7
+        system = self.system
+        energy = espressomd.observables.Energy()
+        pressure = espressomd.observables.PressureTensor()
+        acc_energy = espressomd.accumulators.TimeSeries(obs=energy, delta_N=2)
+        acc_pressure = espressomd.accumulators.TimeSeries(
+            obs=pressure, delta_N=3)
+        system.auto_update_accumulators.add(acc_energy)
+        system.auto_update_accumulators.add(acc_pressure)
+        system.integrator.run(7)
+        np.testing.assert_allclose(
+            acc_energy.time_series()[-1], self.separate_calculation(energy),
+            rtol=1e-10, atol=1e-10)
+        np.testing.assert_allclose(
+            acc_pressure.time_series()[-1],
+            self.separate_calculation(pressure), rtol=1e-10, atol=1e-10)
+        self.assertEqual(len(acc_energy.time_series()), 4)
+        self.assertEqual(len(acc_pressure.time_series()), 3)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -0,0 +1,191 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+#
+
+import unittest as ut
+
+import numpy as np
+import os
+import pickle
+
+import espressomd
+import espressomd.observables
+import espressomd.accumulators
+
+N_PART = 20
+N_SAMPLES = 200
+
+
+class StreamingAccumulatorTest(ut.TestCase):
+
+    """
+    Test class for the accumulators with bounded memory, on the head node
+    and distributed over the MPI ranks.
+
+    """
+    system = espressomd.System(box_l=[10.0] * 3)
+    system.cell_system.skin = 0.4
+    system.time_step = 0.01
+
+    def setUp(self):
+        np.random.seed(seed=42)
+        self.system.part.add(pos=np.zeros((N_PART, 3)))
+        self.obs = espressomd.observables.ParticlePositions(
+            ids=range(N_PART))
+        self.positions = np.copy(self.system.box_l) * np.random.random(
+            (N_SAMPLES, N_PART, 3))
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.auto_update_accumulators.clear()
+
+    def sample(self, *accumulators):
+        for pos in self.positions:
+            self.system.part[:].pos = pos
+            for acc in accumulators:
+                acc.update()
+
+    def block_errors(self, series):
+        errors = []
+        blocks = series
+        while len(blocks) >= 2:
+            errors.append(np.std(blocks, axis=0, ddof=1) / np.sqrt(len(blocks)))
+            n_blocks = len(blocks) // 2
+            blocks = 0.5 * (blocks[:2 * n_blocks:2] + blocks[1:2 * n_blocks:2])
+        return np.array(errors)
+
+    def test_mean_variance(self):
+        accs = [espressomd.accumulators.MeanVarianceCalculator(
+            obs=self.obs, distributed=distributed)
+            for distributed in (False, True)]
+        self.sample(*accs)
+        for acc in accs:
+            np.testing.assert_allclose(
+                acc.mean(), np.mean(self.positions, axis=0), atol=1e-12)
+            np.testing.assert_allclose(
+                acc.variance(), np.var(self.positions, axis=0, ddof=1),
+                atol=1e-12)
+        self.assertTrue(accs[1].distributed)
+
+    def test_block_average(self):
+        accs = [espressomd.accumulators.BlockAverage(
+            obs=self.obs, distributed=distributed)
+            for distributed in (False, True)]
+        self.sample(*accs)
+        ref_errors = self.block_errors(self.positions)
+        for acc in accs:
+            np.testing.assert_allclose(
+                acc.mean(), np.mean(self.positions, axis=0), atol=1e-12)
+            np.testing.assert_allclose(acc.block_errors(), ref_errors,
+                                       rtol=1e-8)
+            np.testing.assert_array_equal(
+                acc.block_sizes(), 2**np.arange(len(ref_errors)))
+            # 200 samples give at least 32 blocks for the block sizes 1-4
+            np.testing.assert_allclose(
+                acc.std_error(), np.max(ref_errors[:3], axis=0), rtol=1e-8)
+
+        # Check pickling
+        for acc in accs:
+            acc_unpkl = pickle.loads(pickle.dumps(acc))
+            np.testing.assert_allclose(acc_unpkl.mean(), acc.mean(),
+                                       atol=1e-12)
+            np.testing.assert_allclose(acc_unpkl.block_errors(),
+                                       acc.block_errors(), atol=1e-12)
+
+    def test_running_histogram(self):
+        accs = [espressomd.accumulators.RunningHistogram(
+            obs=self.obs, n_bins=7, range=[1., 9.], distributed=distributed)
+            for distributed in (False, True)]
+        self.sample(*accs)
+        ref_hist = np.zeros((N_PART, 3, 7))
+        ref_outliers = np.zeros((N_PART, 3, 2))
+        for i in range(N_PART):
+            for j in range(3):
+                values = self.positions[:, i, j]
+                ref_hist[i, j] = np.histogram(values, bins=7, range=(1., 9.))[0]
+                ref_outliers[i, j] = [np.sum(values < 1.), np.sum(values > 9.)]
+        for acc in accs:
+            self.assertEqual(acc.n_bins, 7)
+            np.testing.assert_array_equal(acc.histogram(), ref_hist)
+            np.testing.assert_array_equal(acc.outliers(), ref_outliers)
+            np.testing.assert_allclose(acc.bin_edges(),
+                                       np.linspace(1., 9., 8))
+
+        # Check pickling
+        for acc in accs:
+            acc_unpkl = pickle.loads(pickle.dumps(acc))
+            np.testing.assert_array_equal(acc_unpkl.histogram(), ref_hist)
+
+        for acc in accs:
+            acc.clear()
+            np.testing.assert_array_equal(acc.histogram(), 0)
+
+    def test_time_series(self):
+        shape = (N_SAMPLES, N_PART, 3)
+        for distributed in (False, True):
+            acc = espressomd.accumulators.TimeSeries(
+                obs=self.obs, distributed=distributed)
+            self.sample(acc)
+            np.testing.assert_array_equal(acc.time_series(), self.positions)
+
+            # only the last samples are kept without a spill file
+            acc = espressomd.accumulators.TimeSeries(
+                obs=self.obs, buffer_size=30, distributed=distributed)
+            self.sample(acc)
+            self.assertEqual(acc.buffer_size, 30)
+            np.testing.assert_array_equal(
+                acc.time_series(), self.positions[-30:])
+
+            # the other samples are written to the spill file
+            filename = "accumulator_streaming.bin"
+            acc = espressomd.accumulators.TimeSeries(
+                obs=self.obs, buffer_size=30, filename=filename,
+                distributed=distributed)
+            self.sample(acc)
+            self.assertEqual(acc.filename, filename)
+            np.testing.assert_array_equal(acc.time_series(), self.positions)
+            n_spilled = (N_SAMPLES // 30) * 30
+            if distributed:
+                # one file per rank with the samples of its particles
+                n_nodes = self.system.cell_system.get_state()["n_nodes"]
+                filenames = [f"{filename}.{rank}" for rank in range(n_nodes)]
+                spilled = np.concatenate(
+                    [np.fromfile(name).reshape((n_spilled, -1, 3))
+                     for name in filenames], axis=1)
+            else:
+                filenames = [filename]
+                spilled = np.fromfile(filename).reshape((-1,) + shape[1:])
+            np.testing.assert_array_equal(spilled, self.positions[:n_spilled])
+            for name in filenames:
+                os.remove(name)
+            with self.assertRaisesRegex(RuntimeError, f"Could not read the samples from the file '{filenames[0]}'"):
+                acc.time_series()
+            acc.clear()
+            self.assertEqual(acc.time_series().shape[0], 0)
+
+        with self.assertRaisesRegex(RuntimeError, "buffer_size must be >= 0"):
+            espressomd.accumulators.TimeSeries(obs=self.obs, buffer_size=-1)
+
+    def test_distributed_requires_particle_observable(self):
+        obs = espressomd.observables.ParticleDistances(ids=[0, 1, 2])
+        with self.assertRaises(RuntimeError):
+            espressomd.accumulators.MeanVarianceCalculator(
+                obs=obs, distributed=True)
+
+
+if __name__ == "__main__":
+    ut.main()
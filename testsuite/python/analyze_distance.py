@@ -25,6 +25,8 @@ BOX_L = 50.
 @utx.skipIfMissingFeatures("LENNARD_JONES")
 class AnalyzeDistance(ut.TestCase):
     system = espressomd.System(box_l=3 * [BOX_L])
+    system.cell_system.skin = 0.4
+    system.time_step = 0.01
     np.random.seed(1234)
 
     def setUp(self):
@@ -45,6 +47,21 @@ class AnalyzeDistance(ut.TestCase):
         dist = np.sum(r_ij**2, axis=1)
         return np.sqrt(np.min(dist))
 
+    # python version of the espresso core function, between two type sets
+    def min_dist_types(self, types1, types2):
+        parts = self.system.part[:]
+        ids1 = parts.id[np.isin(parts.type, types1)]
+        ids2 = parts.id[np.isin(parts.type, types2)]
+        pos = np.array(parts.pos)
+        dist = np.fabs(pos[ids1][:, np.newaxis, :] - pos[ids2][np.newaxis])
+        # check smaller distances via PBC
+        dist = np.where(
+            dist > 0.5 * self.system.box_l, self.system.box_l - dist, dist)
+        dist = np.sqrt(np.sum(dist**2, axis=-1))
+        # a particle in both sets has no distance to itself
+        dist[ids1[:, np.newaxis] == ids2[np.newaxis]] = np.inf
+        return np.min(dist)
+
     # python version of the espresso core function
     def nbhood(self, pos, r_catch):
         dist = np.fabs(np.array(self.system.part[:].pos) - pos)
@@ -82,6 +99,40 @@ class AnalyzeDistance(ut.TestCase):
                                    self.min_dist(),
                                    delta=1e-7)
 
+    def test_min_dist_types(self):
+        self.system.part[:].type = np.random.randint(3, size=100)
+        for types1, types2 in (([0], [1]), ([0], [0]), ([0, 2], [1, 2]),
+                               ([2], [0, 1])):
+            self.system.part[:].pos = np.random.random(
+                (len(self.system.part), 3)) * BOX_L
+            self.assertAlmostEqual(
+                self.system.analysis.min_dist(types1, types2),
+                self.min_dist_types(types1, types2), delta=1e-7)
+
+    def test_min_dist_sparse(self):
+        # the closest pair is much farther apart than the mean distance,
+        # so that the search range has to grow over several node boxes
+        self.system.part[:].type = 0
+        self.system.part[:].pos = np.random.random((100, 3)) * BOX_L
+        self.system.part.add(pos=[0.3 * BOX_L, 0.1, 0.2], type=1)
+        self.system.part.add(pos=[0.8 * BOX_L, 0.7 * BOX_L, 0.2], type=2)
+        self.assertAlmostEqual(self.system.analysis.min_dist([1], [2]),
+                               self.min_dist_types([1], [2]), delta=1e-7)
+        self.assertAlmostEqual(self.system.analysis.min_dist([1], [0, 2]),
+                               self.min_dist_types([1], [0, 2]), delta=1e-7)
+        # a single particle has no partner
+        self.assertEqual(self.system.analysis.min_dist([1], [1]),
+                         float("inf"))
+
+    def test_min_dist_dense(self):
+        # pairs within the interaction range are found by the cell system
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=3., shift="auto")
+        self.system.part[:].pos = np.random.random((100, 3)) * 10.
+        self.assertAlmostEqual(self.system.analysis.min_dist(),
+                               self.min_dist(), delta=1e-7)
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(epsilon=0.)
+
     def test_min_dist_empty(self):
         self.system.part.clear()
         self.assertEqual(self.system.analysis.min_dist(), float("inf"))
@@ -95,6 +146,40 @@ class AnalyzeDistance(ut.TestCase):
                 self.system.analysis.nbhood([i, i, i], i * 2),
                 self.nbhood([i, i, i], i * 2))
 
+    def test_k_nearest(self):
+        system = self.system
+        system.part[:].pos = np.random.random((len(system.part), 3)) * BOX_L
+        system.part[:].v = np.random.random((len(system.part), 3)) - 0.5
+
+        def check(pos, pid=None):
+            dist = np.fabs(np.array(system.part[:].pos) - pos)
+            dist = np.where(dist > 0.5 * BOX_L, BOX_L - dist, dist)
+            dist = np.linalg.norm(dist, axis=1)
+            ids = np.argsort(dist)
+            ids = ids[ids != pid]
+            for k in (0, 1, 7, 99, 150):
+                k_ids, k_dist = system.analysis.k_nearest(pos, k, pid=pid)
+                np.testing.assert_array_equal(k_ids, ids[:k])
+                np.testing.assert_allclose(k_dist, dist[ids[:k]], atol=1e-10)
+
+        def check_all():
+            for pos in ([1., 2., 3.], [0., 0., 0.], [49.9, 25., 0.1],
+                        [-10., 70., 20.]):
+                check(pos)
+                np.testing.assert_array_equal(
+                    system.analysis.nbhood(pos, 8.), self.nbhood(pos, 8.))
+            check(system.part[5].pos, pid=5)
+
+        # unsorted particles are searched exhaustively
+        check_all()
+        # sorted particles are searched in the cells around the position,
+        # also after moving less than half the skin without a resort
+        system.integrator.run(0)
+        check_all()
+        system.integrator.run(10)
+        check_all()
+        system.part[:].v = [0., 0., 0.]
+
     def test_distance_to_pos(self):
         parts = self.system.part
         # try five times
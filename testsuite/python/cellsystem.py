@@ -18,6 +18,7 @@
 #
 import unittest as ut
 import espressomd
+import espressomd.interactions
 import numpy as np
 
 
@@ -45,6 +46,174 @@ class CellSystem(ut.TestCase):
             node_grid = self.system.cell_system.get_state()['node_grid']
             np.testing.assert_array_equal(node_grid, node_grid_ref)
 
+    def test_load_balancing_parameters(self):
+        cs = self.system.cell_system
+        cs.set_load_balancing(interval=20, metric="force_time",
+                              tolerance=0.2, relaxation=1.)
+        self.assertEqual(cs.get_load_balancing(),
+                         {"interval": 20, "metric": "force_time",
+                          "tolerance": 0.2, "relaxation": 1.})
+        with self.assertRaises(ValueError):
+            cs.set_load_balancing(metric="unknown")
+        with self.assertRaises(ValueError):
+            cs.set_load_balancing(interval=-1)
+        with self.assertRaises(ValueError):
+            cs.set_load_balancing(relaxation=0.)
+        cs.set_load_balancing(interval=0)
+        self.assertEqual(cs.get_load_balancing()["interval"], 0)
+
+    @ut.skipIf(n_nodes == 1, "Skipping test: only runs for n_nodes >= 2")
+    @ut.skipIf(not espressomd.has_features("LENNARD_JONES"),
+               "Skipping test: LENNARD_JONES required")
+    def test_load_balancing(self):
+        system = self.system
+        cs = system.cell_system
+        cs.set_domain_decomposition()
+        cs.node_grid = [self.n_nodes, 1, 1]
+        cs.set_load_balancing(interval=0, metric="particles")
+        system.time_step = 0.001
+        system.force_cap = 10.
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.2, cutoff=0.4, shift="auto")
+
+        # all particles in the first fifth of the box along x
+        np.random.seed(42)
+        pos = np.random.random((200, 3)) * np.copy(system.box_l)
+        pos[:, 0] *= 0.2
+        system.part.add(pos=pos)
+        system.integrator.run(0)
+        forces_ref = np.copy(system.part[:].f)
+        energy_ref = system.analysis.energy()["total"]
+        counts_ref = cs.resort()
+
+        imbalance = cs.rebalance()
+        self.assertAlmostEqual(imbalance, max(counts_ref) / 200 * self.n_nodes,
+                               delta=1e-10)
+        boundaries = cs.node_boundaries
+        self.assertEqual(len(boundaries[0]), self.n_nodes + 1)
+        self.assertEqual(boundaries[1:], [[], []])
+        self.assertTrue(np.all(np.diff(boundaries[0]) > 0.))
+        self.assertLess(max(cs.resort()), max(counts_ref))
+
+        # the decomposition does not change the physics
+        system.integrator.run(0)
+        np.testing.assert_allclose(system.part[:].f, forces_ref, atol=1e-10)
+        self.assertAlmostEqual(system.analysis.energy()["total"], energy_ref,
+                               delta=1e-8)
+
+        # automatic rebalancing converges to an even distribution
+        cs.set_load_balancing(interval=1, tolerance=0., relaxation=1.)
+        system.integrator.run(5)
+        cs.set_load_balancing(interval=0)
+        counts = cs.resort()
+        self.assertLess(max(counts), 0.5 * max(counts_ref))
+
+        cs.reset_node_boundaries()
+        self.assertEqual(cs.node_boundaries, [[], [], []])
+        self.assertEqual(sum(cs.resort()), 200)
+
+        system.part.clear()
+        system.force_cap = 0.
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(epsilon=0.)
+
+    def test_domain_decomposition_parameters(self):
+        cs = self.system.cell_system
+        cs.set_domain_decomposition(eighth_shell=True, cells_per_range=2)
+        s = cs.get_state()
+        self.assertTrue(s['eighth_shell'])
+        self.assertEqual(s['cells_per_range'], 2)
+        with self.assertRaises(ValueError):
+            cs.set_domain_decomposition(cells_per_range=0)
+        cs.set_domain_decomposition()
+        s = cs.get_state()
+        self.assertFalse(s['eighth_shell'])
+        self.assertEqual(s['cells_per_range'], 1)
+
+    @ut.skipIf(not espressomd.has_features("LENNARD_JONES"),
+               "Skipping test: LENNARD_JONES required")
+    def test_eighth_shell(self):
+        system = self.system
+        cs = system.cell_system
+        cs.set_domain_decomposition()
+        system.time_step = 0.001
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.2, cutoff=0.5, shift="auto")
+
+        # particles on a jittered lattice
+        np.random.seed(42)
+        grid = np.mgrid[0:10, 0:10, 0:10].reshape(3, -1).T
+        pos = (grid + 0.3 * np.random.random(grid.shape)) * 0.5
+        system.part.add(pos=pos)
+        system.integrator.run(0)
+        forces_ref = np.copy(system.part[:].f)
+        energy_ref = system.analysis.energy()["total"]
+        pressure_ref = system.analysis.pressure()["total"]
+
+        # the decomposition does not change the physics
+        for eighth_shell, cells_per_range in [
+                (True, 1), (True, 2), (False, 2), (True, 3)]:
+            for use_verlet_lists in [True, False]:
+                cs.set_domain_decomposition(
+                    use_verlet_lists=use_verlet_lists,
+                    eighth_shell=eighth_shell,
+                    cells_per_range=cells_per_range)
+                system.integrator.run(0)
+                np.testing.assert_allclose(
+                    system.part[:].f, forces_ref, atol=1e-10)
+                self.assertAlmostEqual(system.analysis.energy()["total"],
+                                       energy_ref, delta=1e-8)
+                self.assertAlmostEqual(system.analysis.pressure()["total"],
+                                       pressure_ref, delta=1e-8)
+
+        # bonds need the ghosts on both sides
+        harmonic = espressomd.interactions.HarmonicBond(k=1., r_0=0.)
+        system.bonded_inter.add(harmonic)
+        system.part[0].add_bond((harmonic, 1))
+        with self.assertRaises(Exception):
+            system.integrator.run(0)
+
+        system.part.clear()
+        cs.set_domain_decomposition()
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(epsilon=0.)
+
+    @ut.skipIf(n_nodes == 1, "Skipping test: only runs for n_nodes >= 2")
+    @ut.skipIf(not espressomd.has_features("LENNARD_JONES"),
+               "Skipping test: LENNARD_JONES required")
+    def test_load_balancing_min_width(self):
+        system = self.system
+        cs = system.cell_system
+        cs.set_domain_decomposition()
+        cs.node_grid = [self.n_nodes, 1, 1]
+        cs.set_load_balancing(interval=0, metric="particles", relaxation=1.)
+        system.time_step = 0.001
+        system.force_cap = 10.
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.2, cutoff=0.4, shift="auto")
+
+        # all particles in the first 2% of the box along x
+        np.random.seed(42)
+        pos = np.random.random((100, 3)) * np.copy(system.box_l)
+        pos[:, 0] *= 0.02
+        system.part.add(pos=pos)
+        system.integrator.run(0)
+        forces_ref = np.copy(system.part[:].f)
+        min_width = cs.get_state()["cells_per_range"] * \
+            cs.get_state()["cell_size"][0]
+
+        # the slabs are clamped to the cells of the regular grid
+        cs.rebalance()
+        widths = np.diff(cs.node_boundaries[0]) * system.box_l[0]
+        self.assertGreaterEqual(min(widths), min_width - 1e-10)
+        self.assertAlmostEqual(min(widths), min_width, delta=1e-10)
+        self.assertGreaterEqual(cs.get_state()["cell_grid"][0], 1)
+        system.integrator.run(0)
+        np.testing.assert_allclose(system.part[:].f, forces_ref, atol=1e-10)
+
+        cs.reset_node_boundaries()
+        system.part.clear()
+        system.force_cap = 0.
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(epsilon=0.)
+
 
 if __name__ == "__main__":
     ut.main()
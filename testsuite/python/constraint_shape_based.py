@@ -1049,6 +1049,70 @@ class ShapeBasedConstraintTest(ut.TestCase):
         system.non_bonded_inter[0, 1].lennard_jones.set_params(
             epsilon=0.0, sigma=0.0, cutoff=0.0, shift=0)
 
+    def test_union_culling_and_distance_grid(self):
+        system = self.system
+        system.time_step = 0.01
+        system.cell_system.skin = 0.4
+        system.non_bonded_inter[0, 1].lennard_jones.set_params(
+            epsilon=1.0, sigma=1.0, cutoff=2.5, shift=0)
+
+        centers = np.array([[10., 10., 10.], [20., 10., 10.],
+                            [10., 20., 10.], [20., 20., 20.]])
+        spheres = [espressomd.shapes.Sphere(center=c, radius=2.0)
+                   for c in centers]
+        union = espressomd.shapes.Union()
+        for sphere in spheres:
+            union.add(sphere)
+        constraint = espressomd.constraints.ShapeBasedConstraint(
+            shape=union, particle_type=1)
+        system.constraints.add(constraint)
+
+        np.random.seed(42)
+        pos = np.random.random((2000, 3)) * self.box_l
+        pos = pos[np.min(np.linalg.norm(
+            pos[:, np.newaxis] - centers, axis=2), axis=1) > 3.2][:500]
+        partcls = system.part.add(pos=pos)
+
+        def expected_forces(radii):
+            dist = np.linalg.norm(pos[:, np.newaxis] - centers, axis=2) - radii
+            nearest = np.argmin(dist, axis=1)
+            r = dist[np.arange(len(pos)), nearest]
+            direction = pos - centers[nearest]
+            direction /= np.linalg.norm(direction, axis=1)[:, np.newaxis]
+            magnitude = np.where(
+                r < 2.5, 24. * (2. * r**-13 - r**-7), 0.)
+            return magnitude[:, np.newaxis] * direction
+
+        def forces():
+            system.integrator.run(0, recalc_forces=True)
+            return np.copy(partcls.f)
+
+        # culled cells don't lose any interactions
+        radii = np.array([2.0, 2.0, 2.0, 2.0])
+        np.testing.assert_allclose(forces(), expected_forces(radii),
+                                   rtol=1e-10, atol=1e-8)
+        # the culling follows changes of the shapes
+        spheres[0].radius = 2.3
+        radii[0] = 2.3
+        np.testing.assert_allclose(forces(), expected_forces(radii),
+                                   rtol=1e-10, atol=1e-8)
+
+        # tabulated distances, the grid has to fit into 2^21 points
+        self.assertEqual(constraint.distance_grid_spacing, 0.)
+        constraint.distance_grid_spacing = 0.25
+        self.assertAlmostEqual(constraint.distance_grid_spacing, 0.25,
+                               delta=1e-12)
+        tabulated = forces()
+        self.assertGreater(
+            np.max(np.abs(tabulated - expected_forces(radii))), 1e-8)
+        np.testing.assert_allclose(tabulated, expected_forces(radii),
+                                   rtol=2e-2, atol=2e-2)
+        with self.assertRaisesRegex(RuntimeError, "must be >= 0"):
+            constraint.distance_grid_spacing = -1.
+
+        system.non_bonded_inter[0, 1].lennard_jones.set_params(
+            epsilon=0.0, sigma=0.0, cutoff=0.0, shift=0)
+
 
 if __name__ == "__main__":
     ut.main()
@@ -0,0 +1,128 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.magnetostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+from tests_common import abspath, random_dipoles, dipolar_direct_sum
+OPEN_BOUNDARIES_REF_ENERGY = abspath("data/dipolar_open_boundaries_energy.npy")
+OPEN_BOUNDARIES_REF_ARRAYS = abspath("data/dipolar_open_boundaries_arrays.npy")
+
+
+@utx.skipIfMissingFeatures(["DIPOLES"])
+class BarnesHutCpu(ut.TestCase):
+
+    system = espressomd.System(box_l=[3, 3, 3])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.1
+
+    def setUp(self):
+        self.system.periodicity = [False, False, False]
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.actors.clear()
+
+    def compute(self, **kwargs):
+        system = self.system
+        bh = espressomd.magnetostatics.DipolarBarnesHutCpu(
+            prefactor=1.2, **kwargs)
+        system.actors.add(bh)
+        system.integrator.run(steps=0, recalc_forces=True)
+        energy = system.analysis.energy()["dipolar"]
+        forces = np.copy(system.part[:].f)
+        torques = np.copy(system.part[:].torque_lab)
+        system.actors.clear()
+        return energy, forces, torques
+
+    def add_reference_particles(self):
+        array_data = np.load(OPEN_BOUNDARIES_REF_ARRAYS)
+        self.system.part.add(pos=array_data[:, :3], dip=array_data[:, 3:6],
+                             rotation=[[1, 1, 1]] * len(array_data))
+        ref_e = np.load(OPEN_BOUNDARIES_REF_ENERGY)[0]
+        return ref_e, array_data[:, 6:9], array_data[:, 9:12]
+
+    def test_exact_sum(self):
+        ref_e, ref_f, ref_t = self.add_reference_particles()
+        for leaf_size in [1, 8]:
+            e, f, t = self.compute(theta=0., leaf_size=leaf_size)
+            self.assertAlmostEqual(e, ref_e, delta=1e-10)
+            np.testing.assert_allclose(f, ref_f, atol=1e-10)
+            np.testing.assert_allclose(t, ref_t, atol=1e-10)
+
+    def test_opening_angle(self):
+        ref_e, ref_f, ref_t = self.add_reference_particles()
+        errors = []
+        for theta in [0.2, 0.5, 1.]:
+            e, f, t = self.compute(theta=theta, leaf_size=1)
+            errors.append(np.max(np.linalg.norm(f - ref_f, axis=1)))
+            # only the total dipole moment of a node is kept, hence the
+            # error grows linearly with the opening angle
+            if theta <= 0.5:
+                self.assertAlmostEqual(e, ref_e, delta=0.1 * abs(ref_e))
+        self.assertLess(errors[0], errors[-1])
+        self.assertLess(errors[0], 1e-2 * np.max(np.abs(ref_f)))
+
+    def test_replicas(self):
+        system = self.system
+        system.periodicity = [True, True, False]
+        np.random.seed(42)
+        n_part = 10
+        pos = np.random.random((n_part, 3)) * system.box_l
+        dip = 1.3 * random_dipoles(n_part)
+        system.part.add(pos=pos, dip=dip, rotation=n_part * [(1, 1, 1)])
+        ref_e, ref_f, ref_t = dipolar_direct_sum(
+            pos, dip, system.box_l, system.periodicity, 1, 1.2)
+        e, f, t = self.compute(theta=0., n_replica=1)
+        self.assertAlmostEqual(e, ref_e, delta=1e-10)
+        np.testing.assert_allclose(f, ref_f, atol=1e-10)
+        np.testing.assert_allclose(t, ref_t, atol=1e-10)
+
+    def test_parameters(self):
+        bh = espressomd.magnetostatics.DipolarBarnesHutCpu(
+            prefactor=1.2, theta=0.3, leaf_size=4, n_replica=2)
+        self.system.actors.add(bh)
+        params = bh.get_params()
+        self.assertAlmostEqual(params["prefactor"], 1.2, delta=1e-12)
+        self.assertAlmostEqual(params["theta"], 0.3, delta=1e-12)
+        self.assertEqual(params["leaf_size"], 4)
+        self.assertEqual(params["n_replica"], 2)
+        self.system.actors.clear()
+
+        for key, value in [("theta", -0.1), ("leaf_size", 0),
+                           ("n_replica", -1)]:
+            with self.assertRaises(ValueError):
+                self.system.actors.add(
+                    espressomd.magnetostatics.DipolarBarnesHutCpu(
+                        prefactor=1., **{key: value}))
+            self.system.actors.clear()
+
+    def test_periodic_without_replicas(self):
+        self.system.periodicity = [True, True, True]
+        self.system.part.add(pos=[[0., 0., 0.], [1., 0., 0.]],
+                             dip=[[0., 0., 1.], [0., 0., 1.]])
+        self.system.actors.add(espressomd.magnetostatics.DipolarBarnesHutCpu(
+            prefactor=1., n_replica=0))
+        with self.assertRaisesRegex(Exception, "zero replica"):
+            self.system.integrator.run(0)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -0,0 +1,84 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.magnetostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+from tests_common import random_dipoles, dipolar_direct_sum
+
+
+@utx.skipIfMissingFeatures(["DIPOLES"])
+class DirectSumWithReplica(ut.TestCase):
+    """
+    Check the MPI-parallel dipolar direct sum with replicas against a
+    reference implementation.
+    """
+
+    system = espressomd.System(box_l=[3, 4, 5])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.1
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.actors.clear()
+
+    def check(self, periodicity, n_replica, n_part=17):
+        system = self.system
+        system.periodicity = periodicity
+        np.random.seed(42)
+        pos = np.random.random((n_part, 3)) * system.box_l
+        dip = 1.3 * random_dipoles(n_part)
+        system.part.add(pos=pos, dip=dip, rotation=n_part * [(1, 1, 1)])
+        ref_e, ref_f, ref_t = dipolar_direct_sum(
+            pos, dip, system.box_l, periodicity, n_replica, 1.2)
+
+        system.actors.add(
+            espressomd.magnetostatics.DipolarDirectSumWithReplicaCpu(
+                prefactor=1.2, n_replica=n_replica))
+        system.integrator.run(steps=0, recalc_forces=True)
+        energy = system.analysis.energy()["dipolar"]
+        self.assertAlmostEqual(energy, ref_e, delta=1e-10)
+        np.testing.assert_allclose(np.copy(system.part[:].f), ref_f,
+                                   atol=1e-10)
+        np.testing.assert_allclose(np.copy(system.part[:].torque_lab), ref_t,
+                                   atol=1e-10)
+
+    def test_open(self):
+        self.check([False, False, False], 0)
+
+    def test_slab(self):
+        self.check([True, True, False], 2)
+
+    def test_periodic(self):
+        self.check([True, True, True], 1)
+
+    def test_periodic_without_replicas(self):
+        self.system.periodicity = [True, True, True]
+        self.system.part.add(pos=[[0., 0., 0.], [1., 0., 0.]],
+                             dip=[[0., 0., 1.], [0., 0., 1.]])
+        self.system.actors.add(
+            espressomd.magnetostatics.DipolarDirectSumWithReplicaCpu(
+                prefactor=1., n_replica=0))
+        with self.assertRaisesRegex(Exception, "zero replica"):
+            self.system.integrator.run(0)
+
+
+if __name__ == "__main__":
+    ut.main()
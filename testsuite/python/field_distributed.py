@@ -0,0 +1,146 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import unittest as ut
+
+import numpy as np
+
+import espressomd
+from espressomd import constraints
+
+
+class DistributedFieldTest(ut.TestCase):
+
+    """
+    Compare interpolated fields which are distributed over the MPI ranks
+    with replicated fields.
+
+    """
+    system = espressomd.System(box_l=[10., 10., 10.], time_step=0.01)
+    system.cell_system.skin = 0.4
+    h = np.array([.5, .5, .5])
+
+    def setUp(self):
+        np.random.seed(seed=42)
+        self.system.part.add(pos=np.random.random((200, 3)) * 10.)
+
+    def tearDown(self):
+        self.system.constraints.clear()
+        self.system.part.clear()
+
+    @staticmethod
+    def force(x):
+        return np.sin(x) + np.array([0.1, 0.2, 0.3]) * x
+
+    @staticmethod
+    def potential(x):
+        return np.sum(np.cos(x))
+
+    def forces(self, field):
+        self.system.constraints.add(field)
+        self.system.integrator.run(0, recalc_forces=True)
+        self.system.constraints.remove(field)
+        return np.copy(self.system.part[:].f)
+
+    def check(self, field_class, f):
+        box = self.system.box_l
+        data = field_class.field_from_fn(box, self.h, f)
+        replicated = field_class(field=data, grid_spacing=self.h,
+                                 default_scale=1.)
+        distributed = field_class(field=data, grid_spacing=self.h,
+                                  default_scale=1., distributed=True)
+        self.assertFalse(replicated.distributed)
+        self.assertTrue(distributed.distributed)
+        with self.assertRaises(RuntimeError):
+            distributed.field
+        np.testing.assert_array_equal(
+            distributed._field_shape, replicated._field_shape)
+
+        np.testing.assert_allclose(
+            self.forces(distributed), self.forces(replicated), atol=1e-12)
+        for x in np.random.random((20, 3)) * box:
+            np.testing.assert_allclose(
+                np.copy(distributed.call_method("_eval_field", x=x)),
+                np.copy(replicated.call_method("_eval_field", x=x)),
+                atol=1e-12)
+        return replicated, distributed
+
+    def test_force_field(self):
+        self.check(constraints.ForceField, self.force)
+
+    def test_potential_field(self):
+        replicated, distributed = self.check(
+            constraints.PotentialField, self.potential)
+        for x in np.random.random((20, 3)) * self.system.box_l:
+            np.testing.assert_allclose(
+                np.copy(distributed.call_method("_eval_jacobian", x=x)),
+                np.copy(replicated.call_method("_eval_jacobian", x=x)),
+                atol=1e-12)
+
+        self.system.constraints.add(replicated)
+        ref_energy = self.system.analysis.energy()["external_fields"]
+        self.system.constraints.clear()
+        self.system.constraints.add(distributed)
+        energy = self.system.analysis.energy()["external_fields"]
+        self.assertAlmostEqual(energy, ref_energy, delta=1e-10)
+
+    def test_outside_of_grid(self):
+        data = constraints.ForceField.field_from_fn(
+            self.system.box_l, self.h, self.force)
+        replicated = constraints.ForceField(field=data, grid_spacing=self.h,
+                                            default_scale=1.)
+        field = constraints.ForceField(field=data, grid_spacing=self.h,
+                                       default_scale=1., distributed=True,
+                                       halo=0.)
+        x = [1., 2., 3.]
+        np.testing.assert_allclose(
+            np.copy(field.call_method("_eval_field", x=x)),
+            np.copy(replicated.call_method("_eval_field", x=x)), atol=1e-12)
+        with self.assertRaises(Exception):
+            field.call_method("_eval_field", x=[-3., -3., -3.])
+
+    def test_load_balancing(self):
+        data = constraints.ForceField.field_from_fn(
+            self.system.box_l, self.h, self.force)
+        self.system.cell_system.set_load_balancing(interval=1)
+        with self.assertRaisesRegex(RuntimeError, "load balancing"):
+            constraints.ForceField(field=data, grid_spacing=self.h,
+                                   default_scale=1., distributed=True)
+        self.system.cell_system.set_load_balancing(interval=0)
+
+        field = constraints.ForceField(field=data, grid_spacing=self.h,
+                                       default_scale=1., distributed=True)
+        self.system.constraints.add(field)
+        with self.assertRaisesRegex(RuntimeError, "distributed fields"):
+            self.system.cell_system.set_load_balancing(interval=1)
+        self.assertEqual(
+            self.system.cell_system.get_load_balancing()["interval"], 0)
+        with self.assertRaisesRegex(Exception, "distributed fields"):
+            self.system.cell_system.rebalance()
+
+    def test_file_without_hdf5(self):
+        if espressomd.has_features("H5MD"):
+            return
+        with self.assertRaisesRegex(RuntimeError, "requires HDF5"):
+            constraints.ForceField(file="field.h5", dataset="force",
+                                   grid_spacing=self.h, default_scale=1.)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -83,6 +83,7 @@ class test_icc(ut.TestCase):
                   ({"convergence": -1}, 'ICC: invalid convergence value'),
                   ({"relaxation": -1}, 'ICC: invalid relaxation value'),
                   ({"relaxation": 2.1}, 'ICC: invalid relaxation value'),
+                  ({"anderson_depth": -1}, 'ICC: invalid anderson_depth'),
                   ({"eps_out": -1}, 'ICC: invalid eps_out'),
                   ({"ext_field": 0}, 'A single value was given but 3 were expected'), ]
 
@@ -109,8 +110,7 @@ class test_icc(ut.TestCase):
         for key, value in params.items():
             np.testing.assert_allclose(value, np.copy(icc_params[key]))
 
-    @utx.skipIfMissingFeatures(["P3M"])
-    def test_dipole_system(self):
+    def check_dipole_system(self, **icc_params):
         from espressomd.electrostatics import P3M
         from espressomd.electrostatic_extensions import ICC
 
@@ -148,8 +148,8 @@ class test_icc(ut.TestCase):
                   max_iterations=100,
                   first_id=part_slice_lower.id[0],
                   eps_out=1.,
-                  relaxation=0.75,
-                  ext_field=[0, 0, 0])
+                  ext_field=[0, 0, 0],
+                  **icc_params)
 
         # Dipole in the center of the simulation box
         BOX_L_HALF = BOX_L / 2
@@ -174,6 +174,28 @@ class test_icc(ut.TestCase):
 
         self.assertAlmostEqual(1, induced_dipole / testcharge_dipole, places=4)
 
+        # the induced charges are consistent with the full force calculation
+        icc_slice = self.system.part[part_slice_lower.id[0]:
+                                     part_slice_upper.id[-1] + 1]
+        sigma = icc_slice.q / areas
+        field = np.copy(icc_slice.f) / icc_slice.q[:, np.newaxis]
+        del_eps = (epsilons - 1.) / (epsilons + 1.)
+        sigma_ref = del_eps / (2. * np.pi) * np.sum(field * normals, axis=1)
+        np.testing.assert_allclose(
+            sigma, sigma_ref, rtol=0., atol=1e-4 * np.max(np.abs(sigma)))
+
+        return icc.last_iterations()
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_dipole_system(self):
+        self.check_dipole_system(relaxation=0.75)
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_dipole_system_anderson(self):
+        n_sor = self.check_dipole_system(relaxation=0.75)
+        n_anderson = self.check_dipole_system(relaxation=0.9, anderson_depth=6)
+        self.assertLess(n_anderson, n_sor)
+
 
 if __name__ == "__main__":
     ut.main()
@@ -0,0 +1,158 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+
+import espressomd
+import espressomd.integrate
+
+
+@utx.skipIfMissingFeatures("LENNARD_JONES")
+class IntegratorFire(ut.TestCase):
+
+    np.random.seed(42)
+    system = espressomd.System(box_l=[10.0, 10.0, 10.0])
+
+    test_rotation = espressomd.has_features(("ROTATION", "DIPOLES"))
+    if test_rotation:
+        from espressomd.constraints import HomogeneousMagneticField
+
+    box_l = 10.0
+    density = 0.6
+    n_part = int(box_l**3 * density)
+
+    lj_eps = 1.0
+    lj_sig = 1.0
+    lj_cut = 2**(1 / 6)
+
+    fire_params = {"f_max": 1e-4, "dt_max": 0.05, "max_displacement": 0.05}
+
+    def setUp(self):
+        self.system.box_l = 3 * [self.box_l]
+        self.system.cell_system.skin = 0.4
+        self.system.time_step = 0.01
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=self.lj_eps, sigma=self.lj_sig,
+            cutoff=self.lj_cut, shift="auto")
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.constraints.clear()
+        self.system.thermostat.turn_off()
+        self.system.integrator.set_vv()
+
+    def test_relaxation(self):
+        self.system.part.add(
+            pos=np.random.random((self.n_part, 3)) * self.system.box_l)
+        if self.test_rotation:
+            self.system.constraints.add(
+                self.HomogeneousMagneticField(H=[-0.5, 0, 0]))
+            self.system.part[:].dip = np.random.random((self.n_part, 3))
+            self.system.part[:].dipm = 1
+            self.system.part[:].rotation = (1, 1, 1)
+
+        self.assertNotAlmostEqual(
+            self.system.analysis.energy()["total"], 0, places=10)
+
+        self.system.integrator.set_fire(**self.fire_params)
+        steps = self.system.integrator.run(5000)
+        self.assertLess(steps, 5000)
+
+        # the forces and torques are below the threshold
+        forces = np.copy(self.system.part[:].f)
+        self.assertLess(np.max(np.linalg.norm(forces, axis=1)), 1e-4)
+        self.system.constraints.clear()
+        # the particles keep a residual velocity at convergence
+        energy = self.system.analysis.energy()
+        self.assertAlmostEqual(
+            energy["total"] - energy["kinetic"], 0, places=6)
+        if self.test_rotation:
+            np.testing.assert_allclose(np.copy(self.system.part[:].dip),
+                                       self.n_part * [(-1, 0, 0)], atol=1E-3)
+
+        # no displacement after convergence
+        positions = np.copy(self.system.part[:].pos)
+        self.assertEqual(self.system.integrator.run(10), 0)
+        np.testing.assert_allclose(np.copy(self.system.part[:].pos), positions)
+
+    def test_dimer(self):
+        # a dimer relaxes to the minimum of the potential
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=self.lj_eps, sigma=self.lj_sig, cutoff=2.5, shift="auto")
+        p1 = self.system.part.add(pos=[5., 5., 4.6])
+        p2 = self.system.part.add(pos=[5., 5., 5.4])
+        self.system.integrator.set_fire(**self.fire_params)
+        self.system.integrator.run(1000)
+        np.testing.assert_allclose(
+            np.linalg.norm(p2.pos - p1.pos), self.lj_cut, rtol=1e-5)
+        np.testing.assert_allclose(p1.pos[0:2], [5., 5.])
+
+    @utx.skipIfMissingFeatures("EXTERNAL_FORCES")
+    def test_fixed_coordinates(self):
+        p1 = self.system.part.add(pos=[5., 5., 5.], fix=[True, True, True])
+        p2 = self.system.part.add(pos=[5.5, 5., 5.], fix=[False, True, True])
+        self.system.integrator.set_fire(**self.fire_params)
+        self.system.integrator.run(1000)
+        np.testing.assert_allclose(p1.pos, [5., 5., 5.])
+        np.testing.assert_allclose(p2.pos[1:], [5., 5.])
+        self.assertGreaterEqual(p2.pos[0], 5. + self.lj_cut - 1e-6)
+
+    def test_max_displacement(self):
+        p1 = self.system.part.add(pos=[5., 5., 5.])
+        p2 = self.system.part.add(pos=[5., 5., 5.5])
+        self.system.integrator.set_fire(**self.fire_params)
+        positions = np.copy(self.system.part[:].pos)
+        self.assertEqual(self.system.integrator.run(0), 0)
+        np.testing.assert_allclose(np.copy(self.system.part[:].pos), positions)
+        # the first step is capped by the maximal displacement
+        self.system.integrator.run(1)
+        np.testing.assert_allclose(p1.pos, [5., 5., 4.95])
+        np.testing.assert_allclose(p2.pos, [5., 5., 5.55])
+        self.assertLess(p1.v[2], 0.)
+
+    def test_zero_force(self):
+        # without forces there is nothing to relax, even for f_max = 0
+        p = self.system.part.add(pos=[5., 5., 5.], v=[1., 0., 0.])
+        self.system.integrator.set_fire(**{**self.fire_params, "f_max": 0.})
+        self.assertEqual(self.system.integrator.run(10), 0)
+        np.testing.assert_array_equal(np.copy(p.pos), [5., 5., 5.])
+        np.testing.assert_array_equal(np.copy(p.v), [1., 0., 0.])
+
+    def test_integrator_exceptions(self):
+        params = self.fire_params
+        for key, value in (("f_max", -1.), ("dt_max", 0.), ("dt_min", 1.),
+                           ("max_displacement", 0.), ("n_delay", -1),
+                           ("f_inc", 0.5), ("f_dec", 1.),
+                           ("alpha_start", 2.), ("f_alpha", 0.)):
+            with self.assertRaises(ValueError):
+                self.system.integrator.set_fire(**{**params, key: value})
+        with self.assertRaises(ValueError):
+            self.system.integrator.set_fire(**{**params, "n_delay": 1.5})
+
+        self.system.part.add(pos=[0., 0., 0.])
+        self.system.thermostat.set_langevin(kT=1.0, gamma=1.0, seed=42)
+        self.system.integrator.set_fire(**params)
+        with self.assertRaisesRegex(Exception, "The FIRE integrator is incompatible with thermostats"):
+            self.system.integrator.run(0)
+        self.assertIsInstance(self.system.integrator.get_state(),
+                              espressomd.integrate.FIRE)
+
+
+if __name__ == "__main__":
+    ut.main()
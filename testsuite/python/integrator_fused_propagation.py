@@ -0,0 +1,113 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+
+import espressomd
+import espressomd.interactions
+import espressomd.virtual_sites
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES", "ROTATION", "EXTERNAL_FORCES",
+                            "VIRTUAL_SITES_RELATIVE", "BOND_CONSTRAINT"])
+class FusedPropagation(ut.TestCase):
+
+    """
+    The velocity Verlet integrator initializes the forces of the next force
+    calculation while propagating the particles, unless a feature modifies
+    the particles in between. Registering a rigid bond selects the unfused
+    propagation, which has to reproduce the same trajectory.
+    """
+
+    system = espressomd.System(box_l=[8.0, 8.0, 8.0])
+    system.cell_system.skin = 0.4
+    system.time_step = 0.01
+    system.min_global_cut = 0.5
+
+    def setup_system(self):
+        system = self.system
+        system.virtual_sites = espressomd.virtual_sites.VirtualSitesRelative()
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=2**(1. / 6.), shift="auto")
+
+        np.random.seed(42)
+        grid = np.arange(4) * 2.
+        pos = np.array(np.meshgrid(grid, grid, grid)).reshape(3, -1).T
+        n_part = len(pos)
+        partcls = system.part.add(
+            pos=pos + 0.1 * np.random.random(pos.shape),
+            v=np.random.random(pos.shape) - 0.5,
+            omega_body=np.random.random(pos.shape) - 0.5,
+            rotation=n_part * [(True, True, True)])
+        system.part[0:n_part:3].ext_force = [0.5, -0.2, 0.3]
+        system.part[0:n_part:4].ext_torque = [0.1, 0.2, -0.3]
+
+        vs = system.part.add(pos=system.part[0].pos + [0.4, 0., 0.])
+        vs.vs_auto_relate_to(0)
+
+        system.thermostat.set_langevin(
+            kT=1., gamma=1., gamma_rotation=1.5, seed=42)
+        return partcls
+
+    def state(self):
+        partcls = self.system.part[:]
+        return {"pos": np.copy(partcls.pos), "v": np.copy(partcls.v),
+                "omega": np.copy(partcls.omega_lab),
+                "quat": np.copy(partcls.quat), "f": np.copy(partcls.f)}
+
+    def trajectory(self):
+        states = []
+        for _ in range(10):
+            self.system.integrator.run(10)
+            states.append(self.state())
+        return states
+
+    def test_unfused_trajectory(self):
+        system = self.system
+        partcls = self.setup_system()
+        pos = np.copy(partcls.pos)
+        v = np.copy(partcls.v)
+        omega = np.copy(partcls.omega_body)
+        quat = np.copy(partcls.quat)
+        thermostat = system.thermostat.__getstate__()
+
+        fused = self.trajectory()
+
+        system.bonded_inter.add(
+            espressomd.interactions.RigidBond(r=1.2, ptol=1e-6, vtol=1e-6))
+        partcls.pos = pos
+        partcls.v = v
+        partcls.omega_body = omega
+        partcls.quat = quat
+        system.thermostat.__setstate__(thermostat)
+
+        unfused = self.trajectory()
+
+        for ref, state in zip(fused, unfused):
+            for key in ref:
+                np.testing.assert_allclose(
+                    state[key], ref[key], rtol=1e-10, atol=1e-10)
+        # the trajectories are not trivial
+        self.assertGreater(np.linalg.norm(fused[-1]["pos"] - fused[0]["pos"]),
+                           0.1)
+
+
+if __name__ == "__main__":
+    ut.main()
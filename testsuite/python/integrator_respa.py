@@ -0,0 +1,144 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+
+import espressomd
+import espressomd.interactions
+
+
+@utx.skipIfMissingFeatures("LENNARD_JONES")
+class IntegratorRespa(ut.TestCase):
+
+    system = espressomd.System(box_l=[10.0, 10.0, 10.0])
+    system.cell_system.skin = 0.3
+    system.time_step = 0.002
+
+    def setUp(self):
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=2.5, shift="auto")
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=0., sigma=0., cutoff=0.)
+        self.system.integrator.set_vv()
+
+    def setup_lattice(self):
+        np.random.seed(42)
+        grid = np.arange(8) * 1.25
+        pos = np.array(np.meshgrid(grid, grid, grid)).reshape(3, -1).T
+        self.system.part.add(pos=pos, v=np.random.random(pos.shape) - 0.5)
+
+    def trajectory(self, n_steps):
+        pos = []
+        for _ in range(n_steps):
+            self.system.integrator.run(10)
+            pos.append(np.copy(self.system.part[:].pos))
+        return np.array(pos)
+
+    def test_velocity_verlet_limit(self):
+        self.setup_lattice()
+        pos0 = np.copy(self.system.part[:].pos)
+        v0 = np.copy(self.system.part[:].v)
+        ref = self.trajectory(10)
+        self.system.part[:].pos = pos0
+        self.system.part[:].v = v0
+        self.system.integrator.set_respa()
+        np.testing.assert_allclose(self.trajectory(10), ref, atol=1e-10)
+
+    def test_energy_conservation(self):
+        self.setup_lattice()
+        self.system.integrator.set_respa(short_range=2)
+        self.system.integrator.run(0)
+        energies = []
+        for _ in range(20):
+            self.system.integrator.run(10)
+            energies.append(self.system.analysis.energy()["total"])
+        e0 = energies[0]
+        np.testing.assert_allclose(energies, e0, rtol=1e-3)
+
+    @utx.skipIfMissingFeatures("EXTERNAL_FORCES")
+    def test_force_weights(self):
+        system = self.system
+        harmonic = espressomd.interactions.HarmonicBond(k=10., r_0=1.)
+        system.bonded_inter.add(harmonic)
+        p1 = system.part.add(pos=[1., 1., 1.], fix=3 * [True])
+        p2 = system.part.add(pos=[2.2, 1., 1.], fix=3 * [True])
+        p1.add_bond((harmonic, p2))
+
+        system.integrator.run(0, recalc_forces=True)
+        f_total = np.copy(p1.f)
+        p1.delete_bond((harmonic, p2))
+        system.integrator.run(0, recalc_forces=True)
+        f_pair = np.copy(p1.f)
+        p1.add_bond((harmonic, p2))
+        f_bond = f_total - f_pair
+        self.assertGreater(np.linalg.norm(f_pair), 0.)
+        self.assertGreater(np.linalg.norm(f_bond), 0.)
+
+        system.integrator.set_respa(bonded=1, short_range=2)
+        system.integrator.run(0)
+        np.testing.assert_allclose(np.copy(p1.f), f_bond + 2. * f_pair)
+        np.testing.assert_allclose(np.copy(p2.f), -f_bond - 2. * f_pair)
+        for step in range(1, 5):
+            system.integrator.run(1)
+            weight = 2. if step % 2 == 0 else 0.
+            np.testing.assert_allclose(
+                np.copy(p1.f), f_bond + weight * f_pair, atol=1e-12)
+
+        system.integrator.set_respa(bonded=3, short_range=1)
+        system.integrator.run(0)
+        np.testing.assert_allclose(np.copy(p1.f), 3. * f_bond + f_pair)
+        for step in range(1, 6):
+            system.integrator.run(1)
+            weight = 3. if step % 3 == 0 else 0.
+            np.testing.assert_allclose(
+                np.copy(p1.f), weight * f_bond + f_pair, atol=1e-12)
+
+    def test_exceptions(self):
+        for key in ("bonded", "short_range", "long_range"):
+            with self.assertRaisesRegex(ValueError, "intervals must be >= 1"):
+                self.system.integrator.set_respa(**{key: 0})
+            with self.assertRaises(ValueError):
+                self.system.integrator.set_respa(**{key: 1.5})
+
+    @utx.skipIfMissingFeatures("COLLISION_DETECTION")
+    def test_collision_detection(self):
+        system = self.system
+        harmonic = espressomd.interactions.HarmonicBond(k=1., r_0=0.1)
+        system.bonded_inter.add(harmonic)
+        system.part.add(pos=[[1., 1., 1.], [1.05, 1., 1.]], type=[1, 1])
+        system.collision_detection.set_params(
+            mode="bind_centers", distance=0.11, bond_centers=harmonic)
+        try:
+            # collisions are only detected in the steps with pair forces
+            system.integrator.set_respa(bonded=2, long_range=4)
+            system.integrator.run(1)
+            self.assertEqual(len(system.part[0].bonds), 1)
+            system.integrator.set_respa(short_range=2)
+            with self.assertRaisesRegex(Exception, "The r-RESPA integrator is incompatible with collision detection"):
+                system.integrator.run(1)
+        finally:
+            system.collision_detection.set_params(mode="off")
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -0,0 +1,119 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.interactions
+import numpy as np
+import unittest as ut
+
+
+class BondedNetwork(ut.TestCase):
+    """
+    Forces of a chain with pair, angle and dihedral bonds of several types,
+    which are evaluated grouped by bond type, compared against the
+    numerical gradient of the bonded energy.
+    """
+    system = espressomd.System(box_l=[12., 12., 12.])
+    system.time_step = 0.005
+    system.cell_system.skin = 0.2
+    n_part = 30
+
+    def setUp(self):
+        system = self.system
+        self.harmonic = espressomd.interactions.HarmonicBond(k=10., r_0=1.)
+        self.fene = espressomd.interactions.FeneBond(k=10., d_r_max=2.)
+        self.angle_harmonic = espressomd.interactions.AngleHarmonic(
+            bend=3., phi0=2.)
+        self.angle_cosine = espressomd.interactions.AngleCosine(
+            bend=2., phi0=2.5)
+        self.dihedral = espressomd.interactions.Dihedral(
+            mult=2, bend=1.5, phase=0.3)
+        # evaluated bond by bond
+        self.quartic = espressomd.interactions.QuarticBond(
+            k0=1., k1=0.5, r=1.5, r_cut=1.9)
+        for bond in [self.harmonic, self.fene, self.angle_harmonic,
+                     self.angle_cosine, self.dihedral, self.quartic]:
+            system.bonded_inter.add(bond)
+
+        np.random.seed(42)
+        steps = np.random.normal([1., 0., 0.], 0.6, (self.n_part, 3))
+        steps /= np.linalg.norm(steps, axis=1)[:, np.newaxis]
+        pos = np.cumsum(steps, axis=0)
+        self.parts = system.part.add(pos=pos)
+        p = list(self.parts)
+        for i in range(self.n_part - 1):
+            p[i].add_bond((self.harmonic if i % 2 else self.fene, p[i + 1]))
+            if i % 5 == 0:
+                p[i].add_bond((self.quartic, p[i + 1]))
+        for i in range(1, self.n_part - 1):
+            angle = self.angle_harmonic if i % 2 else self.angle_cosine
+            p[i].add_bond((angle, p[i - 1], p[i + 1]))
+        for i in range(1, self.n_part - 2):
+            p[i].add_bond((self.dihedral, p[i - 1], p[i + 1], p[i + 2]))
+
+    def tearDown(self):
+        self.system.part.clear()
+
+    def check_forces(self):
+        system = self.system
+        system.integrator.run(0, recalc_forces=True)
+        forces = np.copy(self.parts.f)
+        positions = np.copy(self.parts.pos)
+        h = 1e-6
+        ref = np.zeros_like(forces)
+        for i, p in enumerate(self.parts):
+            for d in range(3):
+                shift = np.zeros(3)
+                shift[d] = h
+                p.pos = positions[i] + shift
+                e_plus = system.analysis.energy()["bonded"]
+                p.pos = positions[i] - shift
+                e_minus = system.analysis.energy()["bonded"]
+                ref[i, d] = -(e_plus - e_minus) / (2. * h)
+            p.pos = positions[i]
+        np.testing.assert_allclose(forces, ref, atol=1e-5)
+
+    def test_forces(self):
+        self.check_forces()
+
+    def test_resort(self):
+        # particles move across cells and nodes
+        self.system.integrator.run(200)
+        self.check_forces()
+
+    def test_topology_change(self):
+        self.check_forces()
+        p = list(self.parts)
+        p[0].add_bond((self.harmonic, p[3]))
+        self.check_forces()
+        p[0].delete_bond((self.fene, p[1]))
+        self.check_forces()
+        # replace the parameters of the harmonic bond
+        self.system.bonded_inter[0] = espressomd.interactions.HarmonicBond(
+            k=20., r_0=1.2)
+        self.check_forces()
+
+    def test_broken_bond(self):
+        self.system.bonded_inter[1] = espressomd.interactions.FeneBond(
+            k=10., d_r_max=0.1)
+        with self.assertRaisesRegex(Exception, "bond broken between"):
+            self.system.integrator.run(0, recalc_forces=True)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -0,0 +1,115 @@
+#
+# Copyright (C) 2021 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import unittest as ut
+import unittest_decorators as utx
+
+import numpy as np
+
+import espressomd
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES", "GAUSSIAN", "SOFT_SPHERE"])
+class TabulationTest(ut.TestCase):
+
+    """
+    Compare the forces, energies and pressures of tabulated pair potentials
+    with the analytic potentials.
+
+    """
+    system = espressomd.System(box_l=[8.0] * 3)
+    system.cell_system.skin = 0.4
+    system.time_step = 0.01
+
+    def setUp(self):
+        np.random.seed(seed=42)
+        system = self.system
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1.0, sigma=1.0, cutoff=2.5, shift="auto")
+        system.non_bonded_inter[0, 1].lennard_jones.set_params(
+            epsilon=1.0, sigma=1.0, cutoff=2**(1. / 6.), shift="auto")
+        system.non_bonded_inter[0, 1].gaussian.set_params(
+            eps=2.0, sig=1.0, cutoff=2.5)
+        system.non_bonded_inter[1, 1].soft_sphere.set_params(
+            a=1.0, n=6.0, cutoff=2.0, offset=0.2)
+        # jittered lattice without overlaps
+        grid = np.mgrid[0:8, 0:8, 0:8].reshape(3, -1).T + 0.5
+        system.part.add(pos=grid + 0.2 * (np.random.random(grid.shape) - 0.5),
+                        type=np.random.randint(2, size=len(grid)))
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.non_bonded_inter.reset()
+        self.system.non_bonded_inter.clear_tabulation()
+
+    def calculate(self):
+        system = self.system
+        system.integrator.run(0, recalc_forces=True)
+        return (np.copy(system.part[:].f),
+                system.analysis.energy()["non_bonded"],
+                system.analysis.pressure_tensor()["non_bonded"])
+
+    def check(self, tolerance):
+        ref_f, ref_e, ref_p = self.calculate()
+        self.system.non_bonded_inter.tabulate(min_dist=0.9,
+                                              tolerance=tolerance)
+        f, e, p = self.calculate()
+        # the tolerance is relative to the largest magnitude of the
+        # potentials, which they reach at the smallest tabulated distance,
+        # and the deviations add up over the neighbors of a particle
+        np.testing.assert_allclose(f, ref_f, rtol=0., atol=1e4 * tolerance)
+        self.assertAlmostEqual(e, ref_e, delta=1e5 * tolerance)
+        np.testing.assert_allclose(p, ref_p, rtol=0., atol=1e4 * tolerance)
+        self.system.non_bonded_inter.clear_tabulation()
+        return np.max(np.abs(f - ref_f))
+
+    def test_accuracy(self):
+        errors = [self.check(tolerance) for tolerance in [1e-4, 1e-6, 1e-8]]
+        self.assertLess(errors[2], errors[0])
+
+    def test_interaction_change(self):
+        system = self.system
+        system.non_bonded_inter.tabulate(min_dist=0.9, tolerance=1e-8)
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=0.5, sigma=1.2, cutoff=3.0, shift=0.0)
+        f, e, p = self.calculate()
+        system.non_bonded_inter.clear_tabulation()
+        ref_f, ref_e, ref_p = self.calculate()
+        np.testing.assert_allclose(f, ref_f, rtol=0., atol=1e-4)
+        self.assertAlmostEqual(e, ref_e, delta=1e-4)
+
+    def test_interface(self):
+        inter = self.system.non_bonded_inter
+        self.assertIsNone(inter.get_tabulation())
+        inter.tabulate(min_dist=0.7, tolerance=1e-5)
+        params = inter.get_tabulation()
+        self.assertAlmostEqual(params["min_dist"], 0.7, delta=1e-12)
+        self.assertAlmostEqual(params["tolerance"], 1e-5, delta=1e-12)
+        with self.assertRaises(ValueError):
+            inter.tabulate(min_dist=-0.1)
+        with self.assertRaises(ValueError):
+            inter.tabulate(min_dist=0.)
+        with self.assertRaises(ValueError):
+            inter.tabulate(min_dist=0.7, tolerance=0.)
+        inter.clear_tabulation()
+        self.assertIsNone(inter.get_tabulation())
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -101,6 +101,7 @@ class MPIIOTest(ut.TestCase):
                 self.s.part[p.id].add_bond(b)
 
     def tearDown(self):
+        self.s.part.clear()
         clean_files()
 
     def check_files_exist(self):
@@ -136,6 +137,72 @@ class MPIIOTest(ut.TestCase):
 
         self.check_sample_system()
 
+    def test_checkpoint(self):
+        path = filename + ".checkpoint"
+        types = sorted({p.type for p in self.test_particles})
+        self.s.setup_type_map(types)
+        self.s.time = 4.2
+        espressomd.io.mpiio.mpiio.write_checkpoint(path)
+        self.assertTrue(os.path.isfile(path))
+
+        self.s.part.clear()
+        self.s.time = 0.
+        # a stray particle, not part of the checkpoint
+        self.s.part.add(id=npart, type=types[0], pos=[0.5, 0.5, 0.5])
+        espressomd.io.mpiio.mpiio.read_checkpoint(path)
+        self.assertAlmostEqual(self.s.time, 4.2, delta=1e-12)
+        self.check_sample_system()
+        # the type maps are rebuilt from the restored particles
+        for t in types:
+            self.assertEqual(
+                self.s.number_of_particles(type=t),
+                sum(p.type == t for p in self.test_particles))
+        os.remove(path)
+
+        with self.assertRaisesRegex(Exception, "Could not open checkpoint"):
+            espressomd.io.mpiio.mpiio.read_checkpoint(path)
+
+    def test_compact(self):
+        prefix = filename + ".compact"
+        for ext in ["ctrj", "cidx"]:
+            if os.path.isfile(prefix + "." + ext):
+                os.remove(prefix + "." + ext)
+        precision = 1e-4
+        frames = []
+        for i in range(3):
+            self.s.part[:].pos = self.s.part[:].pos + [0.7, -0.3, 1.1]
+            self.s.time = i
+            espressomd.io.mpiio.mpiio.write_compact(
+                prefix, precision=precision, velocities=(i == 1),
+                vel_precision=1e-2)
+            frames.append((np.copy(self.s.part[:].id),
+                           np.copy(self.s.part[:].pos),
+                           np.copy(self.s.part[:].v)))
+
+        mpiio = espressomd.io.mpiio.mpiio
+        self.assertEqual(mpiio.n_compact_frames(prefix), 3)
+        for i in [2, 0, -2]:
+            data = mpiio.read_compact(prefix, i)
+            ids, pos, vel = frames[i]
+            order = np.argsort(ids)
+            self.assertAlmostEqual(data["time"], i % 3)
+            np.testing.assert_array_equal(data["id"], ids[order])
+            np.testing.assert_allclose(data["box_l"], np.copy(self.s.box_l))
+            np.testing.assert_allclose(data["pos"], pos[order],
+                                       atol=0.5 * precision + 1e-12)
+            if i % 3 == 1:
+                np.testing.assert_allclose(data["v"], vel[order], atol=5e-3)
+            else:
+                self.assertNotIn("v", data)
+
+        with self.assertRaises(Exception):
+            mpiio.read_compact(prefix, 3)
+        with self.assertRaises(ValueError):
+            mpiio.write_compact(prefix, precision=0.)
+
+        for ext in ["ctrj", "cidx"]:
+            os.remove(prefix + "." + ext)
+
 
 if __name__ == '__main__':
     ut.main()
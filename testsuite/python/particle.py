@@ -293,6 +293,30 @@ class ParticleProperties(ut.TestCase):
             # Cause a different mpi callback to uncover deadlock immediately
             _ = getattr(s.part[:], p)
 
+    def test_deferred_updates(self):
+        s = self.system
+        s.part.clear()
+        pos = np.copy(s.box_l) * np.random.random((100, 3))
+        s.part.add(pos=pos)
+        with s.deferred_updates() as batch:
+            for i in range(100):
+                s.part[i].v = [i, 0, 0]
+                s.part[i].type = i % 3
+            # reading particle data sends the pending updates
+            np.testing.assert_equal(s.part[:].v[:, 0], np.arange(100))
+            for i in range(100):
+                s.part[i].pos = pos[99 - i]
+            batch.flush()
+            s.part[5].remove()
+            if espressomd.has_features(["EXCLUSIONS"]):
+                s.part[6].exclusions = [7]
+        np.testing.assert_equal(s.part[:].type, np.delete(np.arange(100) % 3, 5))
+        np.testing.assert_allclose(np.copy(s.part[7].pos), pos[92])
+        self.assertFalse(s.part.exists(5))
+        if espressomd.has_features(["EXCLUSIONS"]):
+            self.assertEqual(list(s.part[7].exclusions), [6])
+        s.integrator.run(0)
+
     def test_remove_particle(self):
         """Tests that if a particle is removed,
         it no longer exists and bonds to the removed particle are
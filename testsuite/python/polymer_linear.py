@@ -19,8 +19,19 @@ import numpy as np
 import random
 import espressomd
 from espressomd import polymer
+import espressomd.interactions
 import espressomd.shapes
 
+# linear_polymer_positions(n_polymers=2, beads_per_chain=3, bond_length=0.9,
+#                          min_distance=0.85, seed=42) in a box of length 15
+REFERENCE = np.array([
+    [[12.679510407117673, 14.694646056573394, 12.00950001523732],
+     [12.353941217572602, 15.241621319990124, 12.645756853337442],
+     [11.585853658220309, 15.252450159141961, 12.176796047500899]],
+    [[4.121318690494976, 6.5251423440103755, 2.236208247480956],
+     [4.181725970791433, 6.989743995864165, 3.0046457957449095],
+     [3.3752177065149667, 6.8862389429614845, 3.3904321662628094]]])
+
 
 class LinearPolymerPositions(ut.TestCase):
     """
@@ -198,6 +209,59 @@ class LinearPolymerPositions(ut.TestCase):
                 respect_constraints=True, seed=self.seed)
         self.system.constraints.remove(wall_constraint)
 
+    def test_seed(self):
+        """
+        Check that the positions only depend on the seed, and not on the
+        number of MPI ranks.
+
+        """
+        params = dict(n_polymers=2, beads_per_chain=3, bond_length=0.9,
+                      min_distance=0.85)
+        positions = polymer.linear_polymer_positions(seed=42, **params)
+        np.testing.assert_array_equal(
+            positions, polymer.linear_polymer_positions(seed=42, **params))
+        self.assertFalse(np.array_equal(
+            positions, polymer.linear_polymer_positions(seed=43, **params)))
+        # reference generated on a single rank
+        np.testing.assert_allclose(positions, REFERENCE, atol=1e-10)
+
+    def test_setup_linear_polymers(self):
+        """
+        Check the particles created by setup_linear_polymers().
+
+        """
+        num_poly = 8
+        num_mono = 20
+        bond_length = 0.97
+        params = dict(n_polymers=num_poly, beads_per_chain=num_mono,
+                      bond_length=bond_length, min_distance=0.9,
+                      seed=self.seed)
+        bond = espressomd.interactions.HarmonicBond(k=1., r_0=bond_length)
+        self.system.bonded_inter.add(bond)
+        self.system.part.add(id=0, pos=[0., 0., 0.])
+        positions = polymer.linear_polymer_positions(**params)
+        polymer.setup_linear_polymers(system=self.system, bond=bond, type=3,
+                                      **params)
+        # the existing particle is not part of the chains
+        polymer_ids = range(1, num_poly * num_mono + 1)
+        created = self.system.part[polymer_ids]
+        np.testing.assert_allclose(
+            np.copy(created.pos), positions.reshape((-1, 3)), atol=1e-10)
+        np.testing.assert_array_equal(created.type, 3)
+        self.assertBondLength(positions, bond_length)
+        self.assertMinDistGreaterEqual(positions, 0.9 - 1e-10)
+
+        # consecutive monomers of a chain are bonded
+        for pid in polymer_ids:
+            bonds = self.system.part[pid].bonds
+            if (pid - 1) % num_mono == 0:
+                self.assertEqual(len(bonds), 0)
+            else:
+                self.assertEqual(len(bonds), 1)
+                self.assertEqual(bonds[0][1], pid - 1)
+
+        self.system.part.clear()
+
     def test_failure(self):
         """
         Check the runtime error message.
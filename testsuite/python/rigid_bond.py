@@ -26,11 +26,16 @@ import itertools
 
 @utx.skipIfMissingFeatures("BOND_CONSTRAINT")
 class RigidBondTest(ut.TestCase):
+    s = espressomd.System(box_l=[1.0, 1.0, 1.0])
 
-    def test(self):
+    def tearDown(self):
+        self.s.part.clear()
+        self.s.integrator.set_constraint_solver("RATTLE")
+
+    def check_rigid_bonds(self):
         target_acc = 1E-3
         tol = 1.2 * target_acc
-        s = espressomd.System(box_l=[1.0, 1.0, 1.0])
+        s = self.s
         s.box_l = [10, 10, 10]
         s.cell_system.skin = 0.4
         s.time_step = 0.01
@@ -59,6 +64,22 @@ class RigidBondTest(ut.TestCase):
             vel_proj = np.dot(p2.v - p1.v, v_d) / d
             self.assertLess(vel_proj, tol)
 
+    def test_rattle(self):
+        self.check_rigid_bonds()
+
+    def test_lincs(self):
+        self.s.integrator.set_constraint_solver(
+            "LINCS", order=32, iterations=2)
+        self.assertEqual(self.s.integrator.get_constraint_solver(),
+                         {"solver": "LINCS", "order": 32, "iterations": 2})
+        self.check_rigid_bonds()
+
+    def test_exceptions(self):
+        with self.assertRaises(ValueError):
+            self.s.integrator.set_constraint_solver("SHAKE")
+        with self.assertRaises(ValueError):
+            self.s.integrator.set_constraint_solver("LINCS", order=-1)
+
 
 if __name__ == "__main__":
     ut.main()
@@ -14,6 +14,7 @@
 #
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
+import itertools
 import os
 import numpy as np
 
@@ -633,3 +634,32 @@ def random_dipoles(n_particles):
                     sin_theta * np.sin(phi),
                     cos_theta]).T
     return dip
+
+
+def dipolar_direct_sum(pos, dip, box_l, periodicity, n_replica, prefactor):
+    """
+    Dipolar energy, forces and torques of all particles, summed over the
+    periodic images within ``n_replica`` box lengths.
+    """
+    n_cut = [n_replica if p else 0 for p in periodicity]
+    shifts = [np.array(n) * box_l for n in itertools.product(
+        *[range(-n, n + 1) for n in n_cut]) if np.dot(n, n) <= n_replica**2]
+    energy = 0.
+    forces = np.zeros((len(pos), 3))
+    torques = np.zeros((len(pos), 3))
+    for i, j in itertools.product(range(len(pos)), repeat=2):
+        for shift in shifts:
+            if i == j and not np.any(shift):
+                continue
+            dr = pos[i] - pos[j] + shift
+            r = np.linalg.norm(dr)
+            pe1 = np.dot(dip[i], dip[j])
+            pe2 = np.dot(dip[i], dr)
+            pe3 = np.dot(dip[j], dr)
+            energy += 0.5 * (pe1 / r**3 - 3. * pe2 * pe3 / r**5)
+            ab = 3. * pe1 / r**5 - 15. * pe2 * pe3 / r**7
+            forces[i] += ab * dr + 3. * pe3 / r**5 * dip[i] + \
+                3. * pe2 / r**5 * dip[j]
+            torques[i] += -np.cross(dip[i], dip[j]) / r**3 + \
+                3. * pe3 / r**5 * np.cross(dip[i], dr)
+    return prefactor * energy, prefactor * forces, prefactor * torques